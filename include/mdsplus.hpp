@@ -23,19 +23,38 @@
 #define MDSPLUS_HPP
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <charconv>
+#include <chrono>
 #include <climits>
+#include <cmath>
 #include <complex>
+#include <condition_variable>
+#include <cstddef>
 #include <cstdint>
+#include <cstdio>
 #include <cstring>
+#include <deque>
+#include <exception>
+#include <filesystem>
 #include <functional>
+#include <future>
+#include <iterator>
+#include <limits>
+#include <list>
 #include <map>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
 #include <stdexcept>
 #include <string>
 #include <string_view>
+#include <thread>
+#include <tuple>
 #include <type_traits>
-#include <typeindex>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 #if __has_include(<optional>)
@@ -46,6 +65,10 @@
     #include <span>
 #endif
 
+#if __has_include(<mdspan>)
+    #include <mdspan>
+#endif
+
 extern "C" {
 
     #include <camshr_messages.h>
@@ -64,15 +87,27 @@ extern "C" {
 
     // Needed for MdsRelease
 
+    // Needed for MDSplusSUCCESS
+
+    // Needed for mdsdsc*_t, <dtypedef.h>, <classdef.h>
+
     int TdiConvert(mdsdsc_a_t * dsc, mdsdsc_a_t * convert);
     int TdiCall(dtype_t rtype, int narg, mdsdsc_t *list[], mdsdsc_xd_t *out_ptr);
     int _TdiIntrinsic(void **ctx, opcode_t opcode, int narg, mdsdsc_t *list[], mdsdsc_xd_t *out_ptr);
     int TdiIntrinsic(opcode_t opcode, int narg, mdsdsc_t *list[], mdsdsc_xd_t *out_ptr);
 
+    // Needed for mdsdsc*_t, <dtypedef.h>, <classdef.h>
+
+    // Needed for mdsdsc*_t, <dtypedef.h>, <classdef.h>
+
+    // Needed for mdsdsc*_t, <dtypedef.h>, <classdef.h>
+
     int _TreeFileName(void *, char *, int, struct descriptor_xd *);
 
     // Needed for mdsdsc*_t, <dtypedef.h>, <classdef.h>
 
+    // Needed for MdsCompress()
+
     int ConnectToMds(char *host);
     void DisconnectFromMds(int sockId);
     int SetCompressionLevel(int level);
@@ -3070,6 +3105,568 @@ inline const char * GetVersion() {
     return MdsRelease();
 }
 
+enum class TraceEvent
+{
+    // Tree::open()
+    Open,
+
+    // Reading records and segments from a tree
+    Read,
+
+    // Writing records and segments to a tree
+    Write,
+
+    // Compiling or executing TDI expressions
+    TDI,
+
+    // A round trip to an mdsip server
+    Network,
+};
+
+inline std::string to_string(const TraceEvent& event)
+{
+    switch (event) {
+    case TraceEvent::Open: return "TraceEvent::Open";
+    case TraceEvent::Read: return "TraceEvent::Read";
+    case TraceEvent::Write: return "TraceEvent::Write";
+    case TraceEvent::TDI: return "TraceEvent::TDI";
+    case TraceEvent::Network: return "TraceEvent::Network";
+    }
+
+    return "?";
+}
+
+struct TraceSpan
+{
+    TraceEvent Event;
+
+    std::string Name = {};
+
+    int Status = MDSplusSUCCESS;
+
+    size_t Bytes = 0;
+
+    std::chrono::steady_clock::time_point Start = {};
+
+    std::chrono::nanoseconds Duration = {};
+
+    std::string Message = {};
+
+}; // struct TraceSpan
+
+class Trace
+{
+public:
+
+    using Sink = std::function<void(const TraceSpan&)>;
+
+    [[nodiscard]]
+    static inline bool isEnabled() {
+        return _getEnabled().load(std::memory_order_relaxed);
+    }
+
+    static inline void setSink(Sink sink)
+    {
+        std::lock_guard<std::mutex> lock(_getMutex());
+        _getSink() = (sink ? std::make_shared<Sink>(std::move(sink)) : nullptr);
+        _getEnabled().store(_getSink() != nullptr, std::memory_order_relaxed);
+    }
+
+    static inline void Print(const TraceSpan& span)
+    {
+        fprintf(
+            stderr,
+            "%s %s status=%d bytes=%zu duration=%.3fms%s%s\n",
+            to_string(span.Event).c_str(),
+            span.Name.c_str(),
+            span.Status,
+            span.Bytes,
+            std::chrono::duration<double, std::milli>(span.Duration).count(),
+            (span.Message.empty() ? "" : " "),
+            span.Message.c_str()
+        );
+    }
+
+    static inline void emit(const TraceSpan& span)
+    {
+        std::shared_ptr<Sink> sink;
+        {
+            std::lock_guard<std::mutex> lock(_getMutex());
+            sink = _getSink();
+        }
+
+        // Call the sink without holding the lock, so it can trace or change the sink itself
+        if (sink) {
+            (*sink)(span);
+        }
+    }
+
+    static inline size_t GetSize(const mdsdsc_t * dsc)
+    {
+        if (!dsc) {
+            return 0;
+        }
+
+        switch (dsc->class_) {
+        case CLASS_XD:
+            return reinterpret_cast<const mdsdsc_xd_t *>(dsc)->l_length;
+        case CLASS_A:
+        case CLASS_CA:
+        case CLASS_APD:
+            return reinterpret_cast<const mdsdsc_a_t *>(dsc)->arsize;
+        case CLASS_S:
+        case CLASS_D:
+            return dsc->length;
+        default: ;
+        }
+
+        return 0;
+    }
+
+private:
+
+    static inline std::atomic<bool>& _getEnabled() {
+        static std::atomic<bool> enabled = false;
+        return enabled;
+    }
+
+    static inline std::mutex& _getMutex() {
+        static std::mutex mutex;
+        return mutex;
+    }
+
+    static inline std::shared_ptr<Sink>& _getSink() {
+        static std::shared_ptr<Sink> sink;
+        return sink;
+    }
+
+}; // class Trace
+
+class TraceScope
+{
+public:
+
+    inline explicit TraceScope(TraceEvent event, std::string_view name = {})
+        : _enabled(Trace::isEnabled())
+    {
+        if (_enabled) {
+            _span.Event = event;
+            _span.Name = name;
+            _span.Start = std::chrono::steady_clock::now();
+        }
+    }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+    inline ~TraceScope()
+    {
+        if (_enabled) {
+            _span.Duration = std::chrono::steady_clock::now() - _span.Start;
+
+            // Exceptions can't escape a destructor, and a broken sink shouldn't break the caller
+            try {
+                Trace::emit(_span);
+            }
+            catch (...) { }
+        }
+    }
+
+    [[nodiscard]]
+    inline explicit operator bool() const {
+        return _enabled;
+    }
+
+    inline void setName(std::string_view name) {
+        if (_enabled) {
+            _span.Name = name;
+        }
+    }
+
+    inline void setStatus(int status) {
+        if (_enabled) {
+            _span.Status = status;
+        }
+    }
+
+    inline void addBytes(size_t bytes) {
+        if (_enabled) {
+            _span.Bytes += bytes;
+        }
+    }
+
+    inline void setMessage(std::string_view message) {
+        if (_enabled) {
+            _span.Message = message;
+        }
+    }
+
+private:
+
+    bool _enabled;
+
+    TraceSpan _span = { TraceEvent::Open };
+
+}; // class TraceScope
+
+template <typename ValueType>
+struct Decimated
+{
+    std::vector<ValueType> Min = {};
+
+    std::vector<ValueType> Max = {};
+
+    std::vector<double> Mean = {};
+
+}; // struct Decimated
+
+template <typename ValueType>
+Decimated<ValueType> decimate(const ValueType * values, size_t count, size_t factor)
+{
+    static constexpr size_t Lanes = 8;
+
+    Decimated<ValueType> result;
+    if (count == 0 || factor == 0) {
+        return result;
+    }
+
+    size_t groups = (count + factor - 1) / factor;
+    result.Min.resize(groups);
+    result.Max.resize(groups);
+    result.Mean.resize(groups);
+
+    for (size_t group = 0; group < groups; ++group) {
+        const ValueType * first = values + group * factor;
+        size_t size = std::min(factor, count - group * factor);
+
+        ValueType min[Lanes];
+        ValueType max[Lanes];
+        double sum[Lanes];
+        for (size_t lane = 0; lane < Lanes; ++lane) {
+            min[lane] = first[0];
+            max[lane] = first[0];
+            sum[lane] = 0.0;
+        }
+
+        size_t i = 0;
+        for (; i + Lanes <= size; i += Lanes) {
+            for (size_t lane = 0; lane < Lanes; ++lane) {
+                ValueType value = first[i + lane];
+                min[lane] = (value < min[lane] ? value : min[lane]);
+                max[lane] = (value > max[lane] ? value : max[lane]);
+                sum[lane] += double(value);
+            }
+        }
+
+        // Remainder that doesn't fill all of the lanes
+        for (size_t lane = 0; i < size; ++i, ++lane) {
+            ValueType value = first[i];
+            min[lane] = (value < min[lane] ? value : min[lane]);
+            max[lane] = (value > max[lane] ? value : max[lane]);
+            sum[lane] += double(value);
+        }
+
+        result.Min[group] = *std::min_element(min, min + Lanes);
+        result.Max[group] = *std::max_element(max, max + Lanes);
+
+        double total = 0.0;
+        for (size_t lane = 0; lane < Lanes; ++lane) {
+            total += sum[lane];
+        }
+        result.Mean[group] = total / double(size);
+    }
+
+    return result;
+}
+
+class Data;
+
+class ScopedArena
+{
+public:
+
+    static constexpr size_t DefaultBlockSize = 64 * 1024;
+
+    [[nodiscard]]
+    static inline ScopedArena * GetActive() {
+        return _getActive();
+    }
+
+    explicit inline ScopedArena(size_t blockSize = DefaultBlockSize)
+        : _blockSize(blockSize)
+        , _previous(_getActive())
+    {
+        _getActive() = this;
+    }
+
+    // Data in the arena refers to this object
+    ScopedArena(const ScopedArena&) = delete;
+    ScopedArena& operator=(const ScopedArena&) = delete;
+
+    ~ScopedArena();
+
+    [[nodiscard]]
+    inline size_t getBytesUsed() const {
+        return _bytesUsed;
+    }
+
+    [[nodiscard]]
+    inline size_t getBlockCount() const {
+        return _blocks.size();
+    }
+
+    [[nodiscard]]
+    inline size_t getLiveCount() const {
+        std::lock_guard<std::mutex> lock(_liveMutex);
+        return _liveCount;
+    }
+
+private:
+
+    friend class Data;
+
+    static constexpr size_t Alignment = alignof(std::max_align_t);
+
+    size_t _blockSize;
+
+    ScopedArena * _previous;
+
+    std::vector<std::unique_ptr<char[]>> _blocks;
+
+    char * _cursor = nullptr;
+
+    size_t _remaining = 0;
+
+    size_t _bytesUsed = 0;
+
+    // The Data that refer to values in the arena, linked through Data::_arenaPrevious and _arenaNext
+    // so that tracking them never allocates
+    Data * _live = nullptr;
+
+    size_t _liveCount = 0;
+
+    // Only allocation is tied to the arena's thread, a Data in it can be moved or destroyed anywhere
+    mutable std::mutex _liveMutex;
+
+    static inline ScopedArena *& _getActive() {
+        static thread_local ScopedArena * active = nullptr;
+        return active;
+    }
+
+    static constexpr size_t _align(size_t size) {
+        return (size + Alignment - 1) & ~(Alignment - 1);
+    }
+
+    void _register(Data * data);
+
+    void _unregister(Data * data);
+
+    // Put to in from's place in the list, when a Data is moved
+    void _replace(Data * from, Data * to);
+
+    inline char * _allocate(size_t size)
+    {
+        size = _align(size);
+        _bytesUsed += size;
+
+        // Large values get their own block, so the rest of the current block isn't wasted
+        if (size > _blockSize) {
+            _blocks.emplace_back(new char[size]);
+            return _blocks.back().get();
+        }
+
+        if (size > _remaining) {
+            _blocks.emplace_back(new char[_blockSize]);
+            _cursor = _blocks.back().get();
+            _remaining = _blockSize;
+        }
+
+        char * pointer = _cursor;
+        _cursor += size;
+        _remaining -= size;
+        return pointer;
+    }
+
+    inline bool _copyInto(const mdsdsc_t * dsc, mdsdsc_xd_t& xd)
+    {
+        size_t size = 0;
+        if (!dsc || !_measure(dsc, size)) {
+            return false;
+        }
+
+        char * cursor = _allocate(size);
+        xd.pointer = _copy(dsc, cursor);
+        xd.l_length = l_length_t(size);
+        return true;
+    }
+
+    // The size of an array descriptor, including a0, m and the bounds if they are present
+    static inline size_t _getArrayHeaderSize(const mdsdsc_a_t * dsc) {
+        if (!dsc->aflags.coeff) {
+            return sizeof(mdsdsc_a_t);
+        }
+
+        size_t size = offsetof(array_coeff, m) + (dsc->dimct * sizeof(uint32_t));
+        if (dsc->aflags.bounds) {
+            size += dsc->dimct * 2 * sizeof(int32_t);
+        }
+        return size;
+    }
+
+    // Add the space needed to copy dsc to size, false if it can't be copied into an arena
+    static bool _measure(const mdsdsc_t * dsc, size_t& size)
+    {
+        if (!dsc) {
+            return true;
+        }
+
+        switch (dsc->class_) {
+        case CLASS_XD:
+        case CLASS_XS:
+            return _measure(reinterpret_cast<const mdsdsc_xd_t *>(dsc)->pointer, size);
+
+        case CLASS_S:
+        case CLASS_D:
+            size += _align(sizeof(mdsdsc_s_t));
+            if (dsc->dtype == DTYPE_DSC) {
+                return _measure(reinterpret_cast<const mdsdsc_t *>(dsc->pointer), size);
+            }
+            size += _align(dsc->length);
+            return true;
+
+        case CLASS_A: {
+            const mdsdsc_a_t * dscArray = reinterpret_cast<const mdsdsc_a_t *>(dsc);
+            if (dscArray->dtype == DTYPE_DSC) {
+                return false;
+            }
+            size += _align(_getArrayHeaderSize(dscArray)) + _align(dscArray->arsize);
+            return true;
+        }
+
+        case CLASS_APD: {
+            const mdsdsc_a_t * dscArray = reinterpret_cast<const mdsdsc_a_t *>(dsc);
+            size += _align(_getArrayHeaderSize(dscArray)) + _align(dscArray->arsize);
+
+            mdsdsc_t ** dscList = reinterpret_cast<mdsdsc_t **>(dscArray->pointer);
+            for (size_t i = 0; i < dscArray->arsize / sizeof(mdsdsc_t *); ++i) {
+                if (!_measure(dscList[i], size)) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        case CLASS_R: {
+            const mdsdsc_r_t * dscRecord = reinterpret_cast<const mdsdsc_r_t *>(dsc);
+            size += _align(offsetof(mdsdsc_r_t, dscptrs) + (dscRecord->ndesc * sizeof(mdsdsc_t *)));
+            if (dscRecord->pointer) {
+                size += _align(dscRecord->length);
+            }
+
+            for (size_t i = 0; i < dscRecord->ndesc; ++i) {
+                if (!_measure(dscRecord->dscptrs[i], size)) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        default:
+            return false;
+        }
+    }
+
+    static inline char * _bump(char *& cursor, size_t size) {
+        char * pointer = cursor;
+        cursor += _align(size);
+        return pointer;
+    }
+
+    // Copy dsc to cursor, which must have the space counted by _measure()
+    static mdsdsc_t * _copy(const mdsdsc_t * dsc, char *& cursor)
+    {
+        if (!dsc) {
+            return nullptr;
+        }
+
+        switch (dsc->class_) {
+        case CLASS_XD:
+        case CLASS_XS:
+            return _copy(reinterpret_cast<const mdsdsc_xd_t *>(dsc)->pointer, cursor);
+
+        case CLASS_S:
+        case CLASS_D: {
+            mdsdsc_t * out = reinterpret_cast<mdsdsc_t *>(_bump(cursor, sizeof(mdsdsc_s_t)));
+            *out = *dsc;
+            out->class_ = CLASS_S;
+
+            if (dsc->dtype == DTYPE_DSC) {
+                out->pointer = reinterpret_cast<char *>(_copy(reinterpret_cast<const mdsdsc_t *>(dsc->pointer), cursor));
+            }
+            else {
+                out->pointer = _bump(cursor, dsc->length);
+                if (dsc->length > 0) {
+                    std::memcpy(out->pointer, dsc->pointer, dsc->length);
+                }
+            }
+            return out;
+        }
+
+        case CLASS_A:
+        case CLASS_APD: {
+            const mdsdsc_a_t * dscArray = reinterpret_cast<const mdsdsc_a_t *>(dsc);
+            size_t headerSize = _getArrayHeaderSize(dscArray);
+
+            mdsdsc_a_t * out = reinterpret_cast<mdsdsc_a_t *>(_bump(cursor, headerSize));
+            std::memcpy(out, dscArray, headerSize);
+
+            out->pointer = _bump(cursor, dscArray->arsize);
+            if (dscArray->arsize > 0) {
+                std::memcpy(out->pointer, dscArray->pointer, dscArray->arsize);
+            }
+
+            // a0 is the address of element zero, which may be outside of the array
+            if (dscArray->aflags.coeff) {
+                const array_coeff * in = reinterpret_cast<const array_coeff *>(dscArray);
+                reinterpret_cast<array_coeff *>(out)->a0 = out->pointer + (in->a0 - in->pointer);
+            }
+
+            if (dsc->class_ == CLASS_APD) {
+                mdsdsc_t ** dscList = reinterpret_cast<mdsdsc_t **>(out->pointer);
+                for (size_t i = 0; i < dscArray->arsize / sizeof(mdsdsc_t *); ++i) {
+                    dscList[i] = _copy(dscList[i], cursor);
+                }
+            }
+            return reinterpret_cast<mdsdsc_t *>(out);
+        }
+
+        case CLASS_R: {
+            const mdsdsc_r_t * dscRecord = reinterpret_cast<const mdsdsc_r_t *>(dsc);
+            size_t headerSize = offsetof(mdsdsc_r_t, dscptrs) + (dscRecord->ndesc * sizeof(mdsdsc_t *));
+
+            mdsdsc_r_t * out = reinterpret_cast<mdsdsc_r_t *>(_bump(cursor, headerSize));
+            std::memcpy(out, dscRecord, headerSize);
+
+            if (dscRecord->pointer) {
+                out->pointer = reinterpret_cast<uint8_t *>(_bump(cursor, dscRecord->length));
+                std::memcpy(out->pointer, dscRecord->pointer, dscRecord->length);
+            }
+
+            for (size_t i = 0; i < dscRecord->ndesc; ++i) {
+                out->dscptrs[i] = _copy(dscRecord->dscptrs[i], cursor);
+            }
+            return reinterpret_cast<mdsdsc_t *>(out);
+        }
+
+        default:
+            // Rejected by _measure()
+            assert(false);
+            return nullptr;
+        }
+    }
+
+}; // class ScopedArena
+
 enum class Class : uint8_t
 {
     Missing = CLASS_MISSING,
@@ -3163,14 +3760,45 @@ inline constexpr bool operator==(const DType lhs, const dtype_t rhs) {
 
 class Tree;
 
-class Data
-{
+inline mdsdsc_t * _unwrapDescriptor(mdsdsc_t * dsc) {
+    if (dsc && dsc->class_ == CLASS_S && dsc->dtype == DTYPE_DSC) {
+        return reinterpret_cast<mdsdsc_t *>(dsc->pointer);
+    }
+    return dsc;
+}
+
+inline const mdsdsc_t * _unwrapDescriptor(const mdsdsc_t * dsc) {
+    return _unwrapDescriptor(const_cast<mdsdsc_t *>(dsc));
+}
+
+template <typename CType>
+inline constexpr dtype_t _getDTypeForCType()
+{
+    if constexpr (std::is_same_v<CType, int8_t>) return DTYPE_B;
+    else if constexpr (std::is_same_v<CType, int16_t>) return DTYPE_W;
+    else if constexpr (std::is_same_v<CType, int32_t>) return DTYPE_L;
+    else if constexpr (std::is_same_v<CType, int64_t>) return DTYPE_Q;
+    else if constexpr (std::is_same_v<CType, uint8_t>) return DTYPE_BU;
+    else if constexpr (std::is_same_v<CType, uint16_t>) return DTYPE_WU;
+    else if constexpr (std::is_same_v<CType, uint32_t>) return DTYPE_LU;
+    else if constexpr (std::is_same_v<CType, uint64_t>) return DTYPE_QU;
+    else if constexpr (std::is_same_v<CType, float>) return DTYPE_FS;
+    else if constexpr (std::is_same_v<CType, double>) return DTYPE_FT;
+    else if constexpr (std::is_same_v<CType, std::complex<float>>) return DTYPE_FSC;
+    else if constexpr (std::is_same_v<CType, std::complex<double>>) return DTYPE_FTC;
+    else return DTYPE_MISSING;
+}
+
+class Data
+{
 public:
 
     typedef std::nullptr_t __ctype;
     static constexpr Class __class = Class::Missing;
     static constexpr DType __dtype = DType::Missing;
 
+    static constexpr size_t InlineSize = 16;
+
     template <typename ResultType = Data, typename ...ArgTypes>
     static ResultType Compile(const std::string& expression, const ArgTypes& ...args);
 
@@ -3201,7 +3829,8 @@ public:
         return Execute<ResultType>(expression, args...);
     }
 
-    inline Data() = default;
+    // Not defaulted, so _inline is left uninitialized until it is used
+    inline Data() { }
 
     inline Data(mdsdsc_xd_t && xd, Tree * tree = nullptr)
         : _xd(xd)
@@ -3211,7 +3840,7 @@ public:
     }
 
     inline virtual ~Data() {
-        MdsFree1Dx(&_xd, nullptr);
+        _free();
     }
 
     // Disallow copy and assign
@@ -3221,8 +3850,7 @@ public:
     // Enable move operators
     inline Data(Data&& other)
     {
-        _xd = other._xd;
-        other._xd = MDSDSC_XD_INITIALIZER;
+        _take(other);
 
         _tree = other._tree;
         other._tree = nullptr;
@@ -3230,10 +3858,12 @@ public:
 
     Data& operator=(Data&& other)
     {
-        MdsFree1Dx(&_xd, nullptr);
+        if (this == &other) {
+            return *this;
+        }
 
-        _xd = other._xd;
-        other._xd = MDSDSC_XD_INITIALIZER;
+        _free();
+        _take(other);
 
         _tree = other._tree;
         other._tree = nullptr;
@@ -3263,6 +3893,21 @@ public:
         return _xd.pointer;
     }
 
+    [[nodiscard]]
+    inline size_t getTotalSize() const {
+        if (_isInline()) {
+            return sizeof(_inline.Descriptor) + _inline.Descriptor.length;
+        }
+
+        size_t size = _xd.l_length;
+        if (_adopted) {
+            for (const Data& child : *_adopted) {
+                size += child.getTotalSize();
+            }
+        }
+        return size;
+    }
+
     [[nodiscard]]
     inline length_t getLength() const {
         mdsdsc_t * dsc = getDescriptor();
@@ -3289,6 +3934,17 @@ public:
 
     [[nodiscard]]
     inline mdsdsc_xd_t release() {
+        if (_isInline() || _arena || _adopted) {
+            mdsdsc_xd_t xd = MDSDSC_XD_INITIALIZER;
+            int status = MdsCopyDxXd(getDescriptor(), &xd);
+            if (IS_NOT_OK(status)) {
+                throwException(status);
+            }
+
+            _free();
+            return xd;
+        }
+
         mdsdsc_xd_t tmp = std::move(_xd);
         _xd = MDSDSC_XD_INITIALIZER;
         return tmp;
@@ -3579,10 +4235,141 @@ protected:
 
     Tree * _tree = nullptr;
 
+    inline bool _setInline(dtype_t dtype, const void * value, length_t length)
+    {
+        if (length > InlineSize) {
+            return false;
+        }
+
+        // The value may point into the one being freed, e.g. a substring of this String
+        alignas(16) char buffer[InlineSize];
+        std::memcpy(buffer, value, length);
+
+        _free();
+
+        std::memcpy(_inline.Value, buffer, length);
+        _inline.Descriptor = {
+            .length = length,
+            .dtype = dtype,
+            .class_ = CLASS_S,
+            .pointer = _inline.Value,
+        };
+
+        _xd.pointer = reinterpret_cast<mdsdsc_t *>(&_inline.Descriptor);
+        _xd.l_length = 0;
+        return true;
+    }
+
+    [[nodiscard]]
+    inline bool _isInline() const {
+        return (_xd.pointer == reinterpret_cast<const mdsdsc_t *>(&_inline.Descriptor));
+    }
+
+    virtual void _onValueReplaced() noexcept { }
+
+    // Free the XD, if it was allocated, must be used instead of MdsFree1Dx(&_xd)
+    inline void _free()
+    {
+        _onValueReplaced();
+
+        if (_isInline()) {
+            _xd = MDSDSC_XD_INITIALIZER;
+        }
+        else if (_arena) {
+            // The arena frees the memory itself once it is destroyed
+            _arena->_unregister(this);
+            _arena = nullptr;
+            _xd = MDSDSC_XD_INITIALIZER;
+        }
+        else {
+            MdsFree1Dx(&_xd, nullptr);
+        }
+
+        // Only after the descriptors that refer to them are gone
+        _adopted.reset();
+    }
+
+    // Take the value from other, which is left empty
+    inline void _take(Data& other)
+    {
+        _xd = other._xd;
+        if (other._isInline()) {
+            _inline = other._inline;
+            _inline.Descriptor.pointer = _inline.Value;
+            _xd.pointer = reinterpret_cast<mdsdsc_t *>(&_inline.Descriptor);
+        }
+        else if (other._arena) {
+            _arena = other._arena;
+            _arena->_replace(&other, this);
+            other._arena = nullptr;
+        }
+
+        _adopted = std::move(other._adopted);
+        other._xd = MDSDSC_XD_INITIALIZER;
+    }
+
+    [[nodiscard]]
+    static inline bool _canAdopt(const Data& child) {
+        return (child.getDescriptor() && !child._isInline() && !child._arena);
+    }
+
+    inline mdsdsc_t * _adopt(Data&& child)
+    {
+        assert(_canAdopt(child));
+
+        if (!_adopted) {
+            _adopted = std::make_unique<std::vector<Data>>();
+        }
+
+        _adopted->push_back(std::move(child));
+        return _adopted->back().getDescriptor();
+    }
+
+    inline void _copyFrom(const mdsdsc_t * dsc)
+    {
+        mdsdsc_xd_t xd = MDSDSC_XD_INITIALIZER;
+
+        ScopedArena * arena = ScopedArena::GetActive();
+        if (arena && arena->_copyInto(dsc, xd)) {
+            _free();
+            _xd = xd;
+            _arena = arena;
+            _arena->_register(this);
+            return;
+        }
+
+        int status = MdsCopyDxXd(dsc, &xd);
+        if (IS_NOT_OK(status)) {
+            throwException(status);
+        }
+
+        _free();
+        _xd = xd;
+    }
+
     int _intrinsic(opcode_t opcode, int narg, mdsdsc_t *list[], mdsdsc_xd_t * out) const;
 
     template <typename ResultType>
     inline ResultType _clone() const {
+        // A copy of an inline value is also inline
+        if constexpr (std::is_default_constructible_v<ResultType>) {
+            if (_isInline()) {
+                ResultType result;
+                Data& data = result;
+                data._setInline(_inline.Descriptor.dtype, _inline.Value, _inline.Descriptor.length);
+                data._tree = _tree;
+                return result;
+            }
+
+            if (ScopedArena::GetActive()) {
+                ResultType result;
+                Data& data = result;
+                data._copyFrom(getDescriptor());
+                data._tree = _tree;
+                return result;
+            }
+        }
+
         mdsdsc_xd_t xd = MDSDSC_XD_INITIALIZER;
         int status = MdsCopyDxXd(getDescriptor(), &xd);
         if (IS_NOT_OK(status)) {
@@ -3609,6 +4396,47 @@ protected:
     template <typename ResultType>
     ResultType _convertToArray();
 
+private:
+
+    friend class ScopedArena;
+
+    // Set while _xd points into an arena, see _copyFrom()
+    ScopedArena * _arena = nullptr;
+
+    // The other Data in the same arena, see ScopedArena::_live
+    Data * _arenaPrevious = nullptr;
+
+    Data * _arenaNext = nullptr;
+
+    // Children that _xd refers to without owning them, see _adopt()
+    std::unique_ptr<std::vector<Data>> _adopted;
+
+    // Copy the value out of an arena that is being destroyed into a newly allocated XD
+    inline void _promote() noexcept
+    {
+        mdsdsc_xd_t xd = MDSDSC_XD_INITIALIZER;
+        int status = MdsCopyDxXd(_xd.pointer, &xd);
+
+        // There is nowhere to report a failure, so the value is lost instead of left dangling
+        _xd = (IS_NOT_OK(status) ? mdsdsc_xd_t(MDSDSC_XD_INITIALIZER) : xd);
+        _arena = nullptr;
+
+        // The copy includes any adopted children
+        _adopted.reset();
+
+        // Anything derived from the old descriptors, e.g. a Dictionary's index, refers to the arena
+        _onValueReplaced();
+    }
+
+    // Only initialized while _xd points at it, see _setInline()
+    struct
+    {
+        mdsdsc_s_t Descriptor;
+
+        alignas(16) char Value[InlineSize];
+
+    } _inline;
+
 }; // class Data
 
 static const Data EmptyData;
@@ -3629,1011 +4457,1876 @@ inline Data Data::FromScalar(std::nullptr_t) {
     return Data();
 }
 
-enum class Usage : uint8_t
-{
-    Any = TreeUSAGE_ANY,
-    Structure = TreeUSAGE_STRUCTURE,
-    Action = TreeUSAGE_ACTION,
-    Device = TreeUSAGE_DEVICE,
-    Dispatch = TreeUSAGE_DISPATCH,
-    Numeric = TreeUSAGE_NUMERIC,
-    Signal = TreeUSAGE_SIGNAL,
-    Task = TreeUSAGE_TASK,
-    Text = TreeUSAGE_TEXT,
-    Window = TreeUSAGE_WINDOW,
-    Axis = TreeUSAGE_AXIS,
-    Subtree = TreeUSAGE_SUBTREE,
-    CompoundData = TreeUSAGE_COMPOUND_DATA,
-
-}; // enum class Usage
-
-std::string to_string(const Usage& usage);
-
-struct TreeNodeFlags
-{
-    uint32_t State : 1;
-    uint32_t ParentState : 1;
-    uint32_t Essential : 1;
-    uint32_t Cached : 1;
-    uint32_t Versions : 1;
-    uint32_t Segmented : 1;
-    uint32_t SetupInformation : 1;
-    uint32_t WriteOnce : 1;
-    uint32_t Compressible : 1;
-    uint32_t DoNotCompress : 1;
-    uint32_t CompressOnPut : 1;
-    uint32_t NoWriteModel : 1;
-    uint32_t NoWriteShot : 1;
-    uint32_t PathReference : 1;
-    uint32_t NidReference : 1;
-    uint32_t IncludeInPulse : 1;
-    uint32_t CompressSegments : 1;
-    uint32_t : 15;
-
-}; // struct TreeNodeFlags
-
-static_assert(sizeof(TreeNodeFlags) == sizeof(uint32_t),
-    "sizeof(TreeNodeFlags) != sizeof(uint32_t)");
-
-std::string to_string(const TreeNodeFlags& flags);
-
-class Tree;
-class DataView;
-
-class TreeNode
+class Timebase
 {
-    friend class DataView;
-
 public:
 
-    TreeNode() = default;
+    static constexpr double Tolerance = 1e-6;
 
-    inline TreeNode(Tree * tree, int nid)
-        : _tree(tree)
-        , _nid(nid)
-    { }
+    [[nodiscard]]
+    static std::optional<Timebase> FromDescriptor(const mdsdsc_t * dsc);
 
-    virtual ~TreeNode() = default;
+    Timebase() = default;
 
-    TreeNode(const TreeNode& other) = default;
+    inline Timebase(double start, double delta, size_t count)
+        : _uniform(true)
+        , _start(start)
+        , _delta(delta)
+        , _count(count)
+    { }
 
-    TreeNode& operator=(const TreeNode& other) = default;
+    inline Timebase(std::vector<double>&& times)
+        : _count(times.size())
+        , _times(std::move(times))
+    { }
 
     [[nodiscard]]
-    inline Tree * getTree() const {
-        return _tree;
+    inline bool isUniform() const {
+        return _uniform;
     }
 
     [[nodiscard]]
-    void * getDBID() const;
-
-    [[nodiscard]]
-    void * getContext() const;
-
-    [[nodiscard]]
-    inline int getNID() const {
-        return _nid;
+    inline size_t size() const {
+        return _count;
     }
 
-    TreeNode getNode(const std::string& path) const;
-
-    std::vector<TreeNode> findNodeWild(const std::string& wildcard, std::vector<Usage> validUsages = {}) const;
-
-    TreeNode addNode(const std::string& path, Usage usage) const;
-
-    TreeNode addDevice(const std::string& path, const std::string& model) const;
-
-    template <typename ResultType = Data, typename ...ArgTypes>
-    ResultType doMethod(const std::string& method, const ArgTypes&... args);
-
     [[nodiscard]]
-    inline uint64_t getTimeInserted() const {
-        return _getNCI<uint64_t>(NciTIME_INSERTED);
+    inline bool empty() const {
+        return (_count == 0);
     }
 
     [[nodiscard]]
-    inline uint32_t getOwnerID() const {
-        return _getNCI<uint32_t>(NciOWNER_ID);
+    inline double getStart() const {
+        if (_uniform) {
+            return _start;
+        }
+        return (_times.empty() ? 0.0 : _times.front());
     }
 
     [[nodiscard]]
-    inline class_t getClass() const {
-        return _getNCI<class_t>(NciCLASS);
+    inline double getDelta() const {
+        return (_uniform ? _delta : 0.0);
     }
 
     [[nodiscard]]
-    inline dtype_t getDType() const {
-        return _getNCI<dtype_t>(NciDTYPE);
+    inline double getTime(size_t index) const {
+        if (index >= _count) {
+            throw TdiBadIndex();
+        }
+        return (_uniform ? _start + (double(index) * _delta) : _times[index]);
     }
 
     [[nodiscard]]
-    inline uint32_t getLength() const {
-        return _getNCI<uint32_t>(NciLENGTH);
+    inline double operator[](size_t index) const {
+        return getTime(index);
     }
 
     [[nodiscard]]
-    inline uint32_t getStatus() const {
-        return _getNCI<uint32_t>(NciSTATUS);
-    }
+    inline size_t getIndex(double time) const
+    {
+        if (_count == 0) {
+            return 0;
+        }
 
-    // TODO: Double check all the on/off functions
+        if (_uniform) {
+            // Clamped before the conversion, which is undefined for values that don't fit in a size_t, or NaN
+            double index = std::floor(((time - _start) / _delta) + Tolerance);
+            if (!(index > 0.0)) {
+                return 0;
+            }
+            return size_t(std::min(index, double(_count - 1)));
+        }
 
-    inline bool isOn() const {
-        uint32_t status = getStatus();
-        return ((status & (NciM_STATE)) == 0);
+        auto it = std::upper_bound(_times.begin(), _times.end(), time);
+        return (it == _times.begin() ? 0 : size_t(it - _times.begin()) - 1);
     }
 
-    inline bool isOff() const {
-        return !isOn();
-    }
+    [[nodiscard]]
+    inline std::pair<size_t, size_t> getIndexRange(double start, double end) const
+    {
+        if (_uniform) {
+            double first = std::ceil(((start - _start) / _delta) - Tolerance);
+            double last = std::floor(((end - _start) / _delta) + Tolerance) + 1.0;
 
-    inline bool isParentOn() const {
-        uint32_t status = getStatus();
-        return ((status & (NciM_PARENT_STATE)) == 0);
-    }
+            size_t begin = size_t(std::clamp(first, 0.0, double(_count)));
+            return { begin, std::max(begin, size_t(std::clamp(last, 0.0, double(_count)))) };
+        }
 
-    inline bool isParentOff() const {
-        return !isParentOn();
+        auto first = std::lower_bound(_times.begin(), _times.end(), start);
+        auto last = std::upper_bound(first, _times.end(), end);
+        return { size_t(first - _times.begin()), size_t(last - _times.begin()) };
     }
 
-    inline void turnOn() {
-        _TreeTurnOn(getDBID(), _nid);
-    }
+    template <typename TimeType = double>
+    inline void getTimes(TimeType * times) const
+    {
+        if (!_uniform) {
+            for (size_t i = 0; i < _count; ++i) {
+                times[i] = TimeType(_times[i]);
+            }
+            return;
+        }
 
-    inline void turnOff() {
-        _TreeTurnOff(getDBID(), _nid);
+        // Computed from the index instead of by accumulating delta, which would also drift
+        for (size_t i = 0; i < _count; ++i) {
+            times[i] = TimeType(_start + (double(i) * _delta));
+        }
     }
 
+    template <typename TimeType = double>
     [[nodiscard]]
-    inline uint16_t getConglomorateElements() const {
-        return _getNCI<uint16_t>(NciCONGLOMERATE_ELT);
+    inline std::vector<TimeType> getTimes() const
+    {
+        std::vector<TimeType> times(_count);
+        getTimes(times.data());
+        return times;
     }
 
-    [[nodiscard]]
-    inline TreeNodeFlags getFlags() const {
-        return _getNCI<TreeNodeFlags>(NciGET_FLAGS);
-    }
+private:
 
-    inline void setFlagsOn(TreeNodeFlags flags) const {
+    bool _uniform = false;
 
-    }
+    double _start = 0.0;
 
-    inline void setFlagsOff(TreeNodeFlags flags) const {
+    double _delta = 0.0;
 
-    }
+    size_t _count = 0;
 
-    inline void clearFlags(TreeNodeFlags flags) const {
-        setFlagsOff(flags);
+    // Only used if the timebase isn't uniform
+    std::vector<double> _times;
+
+    template <typename CType>
+    static inline double _read(const char * pointer) {
+        CType value;
+        std::memcpy(&value, pointer, sizeof(value));
+        return double(value);
     }
 
-    [[nodiscard]]
-    inline uint32_t getFlagsInt() const {
-        return _getNCI<uint32_t>(NciGET_FLAGS);
+    // Read a numeric scalar in place, false for anything else
+    static inline bool _getScalar(const mdsdsc_t * dsc, double& value)
+    {
+        dsc = _unwrapDescriptor(dsc);
+        if (!dsc || dsc->class_ != CLASS_S || !dsc->pointer) {
+            return false;
+        }
+
+        switch (dsc->dtype) {
+        case DTYPE_B: value = _read<int8_t>(dsc->pointer); return true;
+        case DTYPE_BU: value = _read<uint8_t>(dsc->pointer); return true;
+        case DTYPE_W: value = _read<int16_t>(dsc->pointer); return true;
+        case DTYPE_WU: value = _read<uint16_t>(dsc->pointer); return true;
+        case DTYPE_L: value = _read<int32_t>(dsc->pointer); return true;
+        case DTYPE_LU: value = _read<uint32_t>(dsc->pointer); return true;
+        case DTYPE_Q: value = _read<int64_t>(dsc->pointer); return true;
+        case DTYPE_QU: value = _read<uint64_t>(dsc->pointer); return true;
+        case DTYPE_FS: value = _read<float>(dsc->pointer); return true;
+        case DTYPE_FT: value = _read<double>(dsc->pointer); return true;
+        default: return false;
+        }
     }
 
-    [[nodiscard]]
-    std::string getNodeName() const;
+    // Read an argument that can be omitted, false if it is present but isn't a numeric scalar
+    static inline bool _getOptionalScalar(const mdsdsc_t * dsc, double& value, bool& present)
+    {
+        present = (_unwrapDescriptor(dsc) != nullptr);
+        return (!present || _getScalar(dsc, value));
+    }
 
-    [[nodiscard]]
-    inline std::string getPath() const {
-        return _getStringNCI(NciPATH, 1024);
+}; // class Timebase
+
+inline std::optional<Timebase> Timebase::FromDescriptor(const mdsdsc_t * dsc)
+{
+    dsc = _unwrapDescriptor(dsc);
+    if (!dsc || dsc->class_ != CLASS_R) {
+        return std::nullopt;
     }
 
-    [[nodiscard]]
-    inline uint32_t getDepth() const {
-        return _getNCI<uint32_t>(NciDEPTH);
+    const mdsdsc_r_t * dscRecord = reinterpret_cast<const mdsdsc_r_t *>(dsc);
+
+    const mdsdsc_t * dscWindow = nullptr;
+    const mdsdsc_t * dscAxis = dsc;
+    if (dsc->dtype == DTYPE_DIMENSION) {
+        if (dscRecord->ndesc < 2) {
+            return std::nullopt;
+        }
+
+        dscWindow = _unwrapDescriptor(dscRecord->dscptrs[0]);
+        dscAxis = _unwrapDescriptor(dscRecord->dscptrs[1]);
     }
 
-    [[nodiscard]]
-    inline int getParentNID() const {
-        return _getNCI<uint32_t>(NciPARENT);
+    if (!dscAxis || dscAxis->class_ != CLASS_R || dscAxis->dtype != DTYPE_RANGE) {
+        return std::nullopt;
     }
 
-    [[nodiscard]]
-    inline TreeNode getParent() const {
-        int nid = getParentNID();
-        if (nid == 0) {
-            throw TreeNodeNotFound();
-        }
-        return TreeNode(_tree, nid);
+    const mdsdsc_r_t * dscRange = reinterpret_cast<const mdsdsc_r_t *>(dscAxis);
+    if (dscRange->ndesc < 2) {
+        return std::nullopt;
     }
 
-    [[nodiscard]]
-    inline int getBrotherNID() const {
-        return _getNCI<uint32_t>(NciPARENT);
+    double begin = 0.0, ending = 0.0, delta = 1.0;
+    bool hasBegin, hasEnding, hasDelta;
+    if (!_getOptionalScalar(dscRange->dscptrs[0], begin, hasBegin) ||
+        !_getOptionalScalar(dscRange->dscptrs[1], ending, hasEnding) ||
+        !_getOptionalScalar(dscRange->ndesc > 2 ? dscRange->dscptrs[2] : nullptr, delta, hasDelta)) {
+        return std::nullopt;
     }
 
-    [[nodiscard]]
-    inline TreeNode getBrother() const {
-        int nid = getBrotherNID();
-        if (nid == 0) {
-            throw TreeNodeNotFound();
+    if (!(delta > 0.0)) {
+        return std::nullopt;
+    }
+
+    if (!dscWindow) {
+        if (!hasBegin || !hasEnding) {
+            return std::nullopt;
         }
-        return TreeNode(_tree, nid);
+
+        double last = std::floor(((ending - begin) / delta) + Tolerance);
+        return Timebase(begin, delta, (last < 0.0 ? 0 : size_t(last) + 1));
     }
 
-    [[nodiscard]]
-    inline int getMemberID() const {
-        return _getNCI<uint32_t>(NciPARENT);
+    if (dscWindow->class_ != CLASS_R || dscWindow->dtype != DTYPE_WINDOW) {
+        return std::nullopt;
     }
 
-    [[nodiscard]]
-    inline TreeNode getMember() const {
-        int nid = getMemberID();
-        if (nid == 0) {
-            throw TreeNodeNotFound();
-        }
-        return TreeNode(_tree, nid);
+    const mdsdsc_r_t * dscWindowRecord = reinterpret_cast<const mdsdsc_r_t *>(dscWindow);
+    if (dscWindowRecord->ndesc < 2) {
+        return std::nullopt;
     }
 
-    [[nodiscard]]
-    inline int getChildNID() const {
-        return _getNCI<uint32_t>(NciPARENT);
+    // An unbounded window can only be evaluated by TDI
+    double startIdx, endIdx, valueAtIdx0 = 0.0;
+    bool hasValueAtIdx0;
+    if (!_getScalar(dscWindowRecord->dscptrs[0], startIdx) ||
+        !_getScalar(dscWindowRecord->dscptrs[1], endIdx) ||
+        !_getOptionalScalar(dscWindowRecord->ndesc > 2 ? dscWindowRecord->dscptrs[2] : nullptr, valueAtIdx0, hasValueAtIdx0)) {
+        return std::nullopt;
     }
 
-    [[nodiscard]]
-    inline TreeNode getChild() const {
-        int nid = getChildNID();
-        if (nid == 0) {
-            throw TreeNodeNotFound();
+    // Index 0 is at the first point of the axis at or after valueAtIdx0
+    double origin;
+    if (hasBegin) {
+        origin = begin;
+        if (hasValueAtIdx0) {
+            origin += std::ceil(((valueAtIdx0 - begin) / delta) - Tolerance) * delta;
         }
-        return TreeNode(_tree, nid);
     }
-
-    [[nodiscard]]
-    inline ncik_t getParentRelationship() const {
-        return _getNCI<ncik_t>(NciPARENT_RELATIONSHIP);
+    else if (hasValueAtIdx0) {
+        origin = valueAtIdx0;
+    }
+    else {
+        return std::nullopt;
     }
 
-    [[nodiscard]]
-    inline std::vector<int> getConglomerateElementNIDs() const {
-        return _getNIDArrayNCI(NciCONGLOMERATE_NIDS, NciNUMBER_OF_ELTS);
+    // The window is clipped to the ends of the axis
+    double first = startIdx;
+    double last = endIdx;
+    if (hasBegin) {
+        first = std::max(first, std::ceil(((begin - origin) / delta) - Tolerance));
+    }
+    if (hasEnding) {
+        last = std::min(last, std::floor(((ending - origin) / delta) + Tolerance));
     }
 
+    size_t count = (last < first ? 0 : size_t(last - first) + 1);
+    return Timebase(origin + (first * delta), delta, count);
+}
+
+class DataRef
+{
+public:
+
+    DataRef() = default;
+
+    inline DataRef(mdsdsc_t * dsc, Tree * tree = nullptr)
+        : _dsc(dsc)
+        , _tree(tree)
+    { }
+
     [[nodiscard]]
-    inline std::vector<TreeNode> getConglomerateElements() const {
-        return _getTreeNodeArrayNCI(NciCONGLOMERATE_NIDS, NciNUMBER_OF_ELTS);
+    inline mdsdsc_t * getDescriptor() const {
+        return _dsc;
     }
 
     [[nodiscard]]
-    inline std::string getOriginalPartName() const {
-        return _getStringNCI(NciORIGINAL_PART_NAME, 1024);
+    inline Tree * getTree() const {
+        return _tree;
     }
 
-    [[nodiscard]]
-    inline uint32_t getNumberOfMembers() const {
-        return _getNCI<uint32_t>(NciNUMBER_OF_MEMBERS);
+    inline explicit operator bool() const {
+        return (_dsc != nullptr);
     }
 
     [[nodiscard]]
-    inline uint32_t getNumberOfChildren() const {
-        return _getNCI<uint32_t>(NciNUMBER_OF_CHILDREN);
+    inline length_t getLength() const {
+        return (_dsc ? _dsc->length : 0);
     }
 
     [[nodiscard]]
-    inline std::vector<int> getMemberNIDs() const {
-        return _getNIDArrayNCI(NciMEMBER_NIDS, NciNUMBER_OF_MEMBERS);
+    inline Class getClass() const {
+        return (_dsc ? Class(_dsc->class_) : Class::Missing);
     }
 
     [[nodiscard]]
-    inline std::vector<TreeNode> getMembers() const {
-        return _getTreeNodeArrayNCI(NciMEMBER_NIDS, NciNUMBER_OF_MEMBERS);
+    inline DType getDType() const {
+        return (_dsc ? DType(_dsc->dtype) : DType::Missing);
     }
 
     [[nodiscard]]
-    inline std::vector<int> getChildrenNIDs() const {
-        return _getNIDArrayNCI(NciCHILDREN_NIDS, NciNUMBER_OF_CHILDREN);
+    inline void * getPointer() const {
+        return (_dsc ? _dsc->pointer : nullptr);
     }
 
     [[nodiscard]]
-    inline std::vector<TreeNode> getChildren() const {
-        return _getTreeNodeArrayNCI(NciCHILDREN_NIDS, NciNUMBER_OF_CHILDREN);
+    inline std::string_view getStringView() const {
+        if (_dsc && _dsc->dtype == DTYPE_T && (_dsc->class_ == CLASS_S || _dsc->class_ == CLASS_D)) {
+            return std::string_view(_dsc->pointer, _dsc->length);
+        }
+
+        return {};
     }
 
+    template <typename ResultType = Data>
     [[nodiscard]]
-    std::vector<TreeNode> getMembersAndChildren(bool sortedNIDs = true) const;
+    inline ResultType clone() const {
+        mdsdsc_xd_t xd = MDSDSC_XD_INITIALIZER;
+        int status = MdsCopyDxXd(_dsc, &xd);
+        if (IS_NOT_OK(status)) {
+            throwException(status);
+        }
 
-    [[nodiscard]]
-    inline std::string getFullPath() const {
-        return _getStringNCI(NciFULLPATH, 1024);
+        return Data(std::move(xd), _tree).releaseAndConvert<ResultType>();
     }
 
+protected:
+
+    mdsdsc_t * _dsc = nullptr;
+
+    Tree * _tree = nullptr;
+
+}; // class DataRef
+
+class ScalarRef : public DataRef
+{
+public:
+
+    using DataRef::DataRef;
+
+    template <typename CType>
     [[nodiscard]]
-    inline std::string getMinPath() const {
-        return _getStringNCI(NciMINPATH, 1024);
+    inline bool holds() const {
+        return (_dsc && _dsc->dtype == _getDTypeForCType<CType>() && _dsc->length == sizeof(CType));
     }
 
+    template <typename CType>
     [[nodiscard]]
-    inline usage_t getUsage() const {
-        return _getNCI<usage_t>(NciUSAGE);
+    inline CType getValue() const {
+        if (!holds<CType>()) {
+            throw TdiInvalidDataType();
+        }
+
+        // The value is not necessarily aligned
+        CType value;
+        std::memcpy(&value, _dsc->pointer, sizeof(value));
+        return value;
     }
 
-    // setUsage
+}; // class ScalarRef
+
+class ArrayRef : public DataRef
+{
+public:
+
+    using DataRef::DataRef;
 
     [[nodiscard]]
-    inline std::string getParentTreeName() const {
-        return _getStringNCI(NciPARENT_TREE, 64);
+    inline mdsdsc_a_t * getArrayDescriptor() const {
+        return reinterpret_cast<mdsdsc_a_t *>(_dsc);
     }
 
     [[nodiscard]]
-    inline uint32_t getRecordLength() const {
-        return _getNCI<uint32_t>(NciRLENGTH);
+    inline size_t size() const {
+        mdsdsc_a_t * dsc = getArrayDescriptor();
+        return (dsc && dsc->length > 0 ? dsc->arsize / dsc->length : 0);
     }
 
     [[nodiscard]]
-    inline uint32_t getNumberOfElements() const {
-        return _getNCI<uint32_t>(NciNUMBER_OF_ELTS);
+    inline std::vector<uint32_t> getDims() const {
+        array_coeff * dsc = reinterpret_cast<array_coeff *>(_dsc);
+        if (!dsc) {
+            return {};
+        }
+
+        if (!dsc->aflags.coeff) {
+            return { uint32_t(size()) };
+        }
+
+        return std::vector<uint32_t>(dsc->m, dsc->m + dsc->dimct);
     }
 
+    template <typename CType>
     [[nodiscard]]
-    inline bool hasDataInNCI() const {
-        return _getNCI<bool>(NciDATA_IN_NCI);
+    inline bool holds() const {
+        return (_dsc && _dsc->dtype == _getDTypeForCType<CType>() && _dsc->length == sizeof(CType));
     }
 
+    template <typename CType>
     [[nodiscard]]
-    inline bool hasErrorOnPut() const {
-        return _getNCI<bool>(NciERROR_ON_PUT);
+    inline const CType * getValues() const {
+        if (!holds<CType>()) {
+            throw TdiInvalidDataType();
+        }
+
+        return reinterpret_cast<const CType *>(_dsc->pointer);
     }
 
+    #ifdef __cpp_lib_span
+
+        template <typename CType>
+        [[nodiscard]]
+        inline std::span<const CType> getSpan() const {
+            return std::span<const CType>(getValues<CType>(), size());
+        }
+
+    #endif
+
     [[nodiscard]]
-    inline uint64_t getRFA() const {
-        return _getNCI<uint64_t>(NciRFA);
+    inline std::string_view getStringViewAt(size_t index, bool trim = true) const {
+        if (_dsc && _dsc->dtype != DTYPE_T) {
+            throw TdiInvalidDataType();
+        }
+
+        if (index >= size()) {
+            throw TdiBadIndex();
+        }
+
+        std::string_view value(_dsc->pointer + (index * _dsc->length), _dsc->length);
+        if (trim) {
+            size_t end = value.find_last_not_of(' ');
+            value = value.substr(0, (end == std::string_view::npos ? 0 : end + 1));
+        }
+        return value;
     }
 
+}; // class ArrayRef
+
+class RecordRef : public DataRef
+{
+public:
+
+    using DataRef::DataRef;
+
     [[nodiscard]]
-    inline uint32_t getIOStatus() const {
-        return _getNCI<uint32_t>(NciIO_STATUS);
+    inline mdsdsc_r_t * getRecordDescriptor() const {
+        return reinterpret_cast<mdsdsc_r_t *>(_dsc);
     }
 
     [[nodiscard]]
-    inline uint32_t getIOSTV() const {
-        return _getNCI<uint32_t>(NciIO_STV);
+    inline size_t getNumDescriptors() const {
+        mdsdsc_r_t * dsc = getRecordDescriptor();
+        return (dsc ? dsc->ndesc : 0);
     }
 
     [[nodiscard]]
-    inline std::string getDTypeString() const {
-        return _getStringNCI(NciDTYPE_STR, 64);
+    inline DataRef getDescriptorAt(size_t index) const {
+        mdsdsc_r_t * dsc = getRecordDescriptor();
+        return DataRef((dsc && index < dsc->ndesc ? dsc->dscptrs[index] : nullptr), _tree);
     }
 
     [[nodiscard]]
-    inline std::string getUsageString() const {
-        return _getStringNCI(NciUSAGE_STR, 64);
+    inline opcode_t getOpcode() const {
+        mdsdsc_r_t * dsc = getRecordDescriptor();
+        if (!dsc || dsc->dtype != DTYPE_FUNCTION || !dsc->pointer) {
+            return 0;
+        }
+
+        opcode_t opcode;
+        std::memcpy(&opcode, dsc->pointer, sizeof(opcode));
+        return opcode;
     }
 
+}; // class RecordRef
+
+class APDRef : public DataRef
+{
+public:
+
+    using DataRef::DataRef;
+
     [[nodiscard]]
-    inline std::string getClassString() const {
-        return _getStringNCI(NciCLASS_STR, 64);
+    inline size_t size() const {
+        mdsdsc_a_t * dsc = reinterpret_cast<mdsdsc_a_t *>(_dsc);
+        return (dsc ? dsc->arsize / sizeof(mdsdsc_t *) : 0);
     }
 
     [[nodiscard]]
-    inline uint32_t getVersion() const {
-        return _getNCI<uint32_t>(NciVERSION);
+    inline DataRef at(size_t index) const {
+        if (index >= size()) {
+            throw TdiBadIndex();
+        }
+
+        return DataRef(reinterpret_cast<mdsdsc_t **>(_dsc->pointer)[index], _tree);
     }
 
     [[nodiscard]]
-    inline uint8_t getCompressionMethod() const {
-        return _getNCI<uint8_t>(NciCOMPRESSION_METHOD);
+    inline DataRef operator[](size_t index) const {
+        return at(index);
     }
 
-    // setCompressionMethod?
+}; // class APDRef
 
-    [[nodiscard]]
-    inline std::string getCompressionMethodString() const {
-        return _getStringNCI(NciCOMPRESSION_METHOD_STR, 64);
-    }
+class DataVisitor
+{
+public:
 
-    // setCompressionMethodString?
+    virtual ~DataVisitor() = default;
 
-    template <typename ValueType>
-    void setExtendedAttribute(const std::string& name, const ValueType& value) const;
+    virtual bool visitRecord(const RecordRef& record) {
+        return true;
+    }
 
-    template <typename ResultType = Data>
-    ResultType getExtendedAttribute(const std::string& name);
+    virtual void endRecord(const RecordRef& record) { }
 
-    void addTag(const std::string& tag);
+    virtual bool visitAPD(const APDRef& apd) {
+        return true;
+    }
 
-    virtual std::vector<std::string> getTags() const;
+    virtual void endAPD(const APDRef& apd) { }
 
-    [[nodiscard]]
-    Data getRecord() const;
+    virtual void visitScalar(const ScalarRef& scalar) { }
 
-    void putRecord(const Data& data) const;
+    virtual void visitString(const DataRef& string, std::string_view value) { }
 
-    template <typename DataType = Data>
-    [[nodiscard]]
-    DataType getData() const;
+    virtual void visitArray(const ArrayRef& array) { }
 
-    template <typename DataType = Data, typename UnitsType = Data>
-    [[nodiscard]]
-    std::tuple<DataType, UnitsType> getDataWithUnits() const;
+    virtual void visitCompressedArray(const DataRef& array) { }
 
-    template <typename DataType>
-    inline void setData(const DataType& value) const {
-        putRecord(Data::FromScalar(value));
-    }
+    virtual void visitMissing() { }
 
-    template <typename DataType, typename UnitsType>
-    inline void setDataWithUnits(const DataType& value, const UnitsType& units) const {
-        putRecord(WithUnits(Data::FromScalar(value), Data::FromScalar(units)));
-    }
+    virtual void visitOther(const DataRef& other) { }
 
-    // TODO: Fix to work with pointers
+}; // class DataVisitor
 
-#ifdef __cpp_lib_span
+inline void walk(const DataRef& ref, DataVisitor& visitor)
+{
+    mdsdsc_t * dsc = ref.getDescriptor();
+    while (dsc) {
+        mdsdsc_t * next = _unwrapDescriptor(dsc);
+        if (dsc->class_ == CLASS_XD || dsc->class_ == CLASS_XS) {
+            next = reinterpret_cast<mdsdsc_xd_t *>(dsc)->pointer;
+        }
 
-    template <typename DataType>
-    void setArrayData(const std::span<const DataType> values, const std::vector<uint32_t>& dims = {}) const {
-        if (dims.empty()) {
-            return setArrayData(values.data(), { static_cast<uint32_t>(values.size()) });
+        if (next == dsc) {
+            break;
         }
-        return setArrayData(values.data(), dims);
+        dsc = next;
     }
 
-    template <typename DataType, typename UnitsType>
-    void setArrayDataWithUnits(const std::span<const DataType> values, UnitsType units, const std::vector<uint32_t>& dims = {}) const {
-        if (dims.empty()) {
-            return setArrayDataWithUnits(values.data(), units, { static_cast<uint32_t>(values.size()) });
-        }
-        return setArrayDataWithUnits(values.data(), units, dims);
+    if (!dsc) {
+        visitor.visitMissing();
+        return;
     }
 
-#endif
+    Tree * tree = ref.getTree();
 
-    template <typename DataType>
-    inline void setArrayData(std::vector<DataType>& values, const std::vector<uint32_t>& dims = {}) const {
-        if (dims.empty()) {
-            return putRecord(Data::FromArray(values, { static_cast<uint32_t>(values.size()) }));
+    switch (dsc->class_) {
+    case CLASS_S:
+    case CLASS_D:
+        if (dsc->dtype == DTYPE_T || dsc->dtype == DTYPE_PATH || dsc->dtype == DTYPE_IDENT) {
+            visitor.visitString(DataRef(dsc, tree), std::string_view(dsc->pointer, dsc->length));
         }
-        return putRecord(Data::FromArray(values, dims));
-    }
+        else {
+            visitor.visitScalar(ScalarRef(dsc, tree));
+        }
+        break;
 
-    template <typename DataType, typename UnitsType>
-    inline void setArrayDataWithUnits(const std::vector<DataType>& values, UnitsType units, const std::vector<uint32_t>& dims = {}) const {
-        if (dims.empty()) {
-            return setArrayDataWithUnits(values.data(), units, { static_cast<uint32_t>(values.size()) });
+    case CLASS_A:
+        visitor.visitArray(ArrayRef(dsc, tree));
+        break;
+
+    case CLASS_CA:
+        visitor.visitCompressedArray(DataRef(dsc, tree));
+        break;
+
+    case CLASS_APD: {
+        APDRef apd(dsc, tree);
+        if (visitor.visitAPD(apd)) {
+            for (size_t i = 0; i < apd.size(); ++i) {
+                walk(apd[i], visitor);
+            }
+            visitor.endAPD(apd);
         }
-        return setArrayDataWithUnits(values.data(), units, dims);
+        break;
     }
 
-    template <typename DataType>
-    inline void setArrayData(const DataType * values, const std::vector<uint32_t>& dims) const {
-        putRecord(Data::FromArray(values, dims));
+    case CLASS_R: {
+        RecordRef record(dsc, tree);
+        if (visitor.visitRecord(record)) {
+            for (size_t i = 0; i < record.getNumDescriptors(); ++i) {
+                walk(record.getDescriptorAt(i), visitor);
+            }
+            visitor.endRecord(record);
+        }
+        break;
     }
 
-    template <typename DataType, typename UnitsType>
-    inline void setArrayDataWithUnits(const DataType * values, UnitsType units, const std::vector<uint32_t>& dims) const {
-        putRecord(WithUnits(Data::FromArray(values, dims), Data::FromScalar(units)));
+    default:
+        visitor.visitOther(DataRef(dsc, tree));
+        break;
     }
+}
 
-    template <typename ValueType>
-    void putRow(int segmentLength, const ValueType& value, int64_t timestamp);
+inline void walk(const Data& data, DataVisitor& visitor)
+{
+    walk(DataRef(data.getDescriptor(), data.getTree()), visitor);
+}
 
-    template <typename ValueArrayType>
-    void putSegment(const ValueArrayType& values, int index = -1);
+enum class Usage : uint8_t
+{
+    Any = TreeUSAGE_ANY,
+    Structure = TreeUSAGE_STRUCTURE,
+    Action = TreeUSAGE_ACTION,
+    Device = TreeUSAGE_DEVICE,
+    Dispatch = TreeUSAGE_DISPATCH,
+    Numeric = TreeUSAGE_NUMERIC,
+    Signal = TreeUSAGE_SIGNAL,
+    Task = TreeUSAGE_TASK,
+    Text = TreeUSAGE_TEXT,
+    Window = TreeUSAGE_WINDOW,
+    Axis = TreeUSAGE_AXIS,
+    Subtree = TreeUSAGE_SUBTREE,
+    CompoundData = TreeUSAGE_COMPOUND_DATA,
 
-    template <typename ValueArrayType>
-    inline void putTimestampedSegment(std::vector<int64_t> timestamps, const ValueArrayType& values) {
-        putTimestampedSegment(timestamps.data(), values);
-    }
+}; // enum class Usage
 
-    template <typename ValueArrayType>
-    void putTimestampedSegment(int64_t * timestamps, const ValueArrayType& values);
+std::string to_string(const Usage& usage);
 
-    template <
-        typename StartIndexType,
-        typename EndIndexType,
-        typename DimensionType,
-        typename ValueArrayType
-    >
-    void makeSegment(
-        const StartIndexType& startIndex,
-        const EndIndexType& endIndex,
-        const DimensionType& dimension,
-        const ValueArrayType& values,
-        int index = -1,
-        int rowsFilled = -1
-    ) const;
+struct TreeNodeFlags
+{
+    uint32_t State : 1;
+    uint32_t ParentState : 1;
+    uint32_t Essential : 1;
+    uint32_t Cached : 1;
+    uint32_t Versions : 1;
+    uint32_t Segmented : 1;
+    uint32_t SetupInformation : 1;
+    uint32_t WriteOnce : 1;
+    uint32_t Compressible : 1;
+    uint32_t DoNotCompress : 1;
+    uint32_t CompressOnPut : 1;
+    uint32_t NoWriteModel : 1;
+    uint32_t NoWriteShot : 1;
+    uint32_t PathReference : 1;
+    uint32_t NidReference : 1;
+    uint32_t IncludeInPulse : 1;
+    uint32_t CompressSegments : 1;
+    uint32_t : 15;
 
-    template <
-        typename StartIndexType,
-        typename EndIndexType,
-        typename DimensionType,
-        typename ValueArrayType
-    >
-    void makeSegmentResampled(
-        const StartIndexType& startIndex,
-        const EndIndexType& endIndex,
-        const DimensionType& dimension,
-        const ValueArrayType& values,
-        const TreeNode& resampleNode,
-        int resampleFactor,
-        int index = -1,
-        int rowsFilled = -1
-    ) const;
+}; // struct TreeNodeFlags
 
-    // template <typename StartIndexType, typename EndIndexType, typename DimensionType, typename ValueArrayType>
-    // void makeSegmentMinMax(
-    //     const StartIndexType& startIndex,
-    //     const EndIndexType& endIndex,
-    //     const DimensionType& dimension,
-    //     const ValueArrayType& values,
-    //     const TreeNode& resampleNode,
-    //     int resampleFactor,
-    //     int index = -1,
-    //     int rowsFilled = -1
-    // ) const;
+static_assert(sizeof(TreeNodeFlags) == sizeof(uint32_t),
+    "sizeof(TreeNodeFlags) != sizeof(uint32_t)");
 
-    // template <typename TimestampArrayType, typename ValueArrayType>
-    // inline void makeTimestampedSegment(
-    //     const TimestampArrayType& timestamps,
-    //     const ValueArrayType& values,
-    //     int index = -1,
-    //     int rowsFilled = -1
-    // ) const;
+std::string to_string(const TreeNodeFlags& flags);
 
-    // template <typename ValueArrayType>
-    // inline void makeTimestampedSegment(
-    //     const Int64Array& timestamps,
-    //     const ValueArrayType& values,
-    //     int index = -1,
-    //     int rowsFilled = -1
-    // ) const;
+struct SegmentInfo
+{
+    DType Type = DType::Missing;
 
-    template <typename ValueArrayType>
-    inline void makeTimestampedSegment(
-        std::vector<int64_t> timestamps,
-        const ValueArrayType& values,
-        int index = -1,
-        int rowsFilled = -1
-    ) const
-    {
-        makeTimestampedSegment(timestamps.data(), values, index, rowsFilled);
-    }
+    std::vector<uint32_t> Dimensions = {};
 
-    template <typename ValueArrayType>
-    void makeTimestampedSegment(
-        int64_t * timestamps,
-        const ValueArrayType& values,
-        int index = -1,
-        int rowsFilled = -1
-    ) const;
+    int RowsFilled = 0;
 
-    template <typename ValueType>
-    void setSegmentScale(const ValueType& value);
+}; // struct SegmentInfo
 
-    template <typename ResultType = Data>
-    ResultType getSegmentScale();
+class Tree;
+class DataView;
 
-    // TODO: Move
-    #ifdef __cpp_lib_optional
+class TreeNode
+{
+    friend class DataView;
 
-        [[nodiscard]]
-        std::optional<TreeNode> tryGetNode(const std::string& path) const
-        {
-            int nid = 0;
+public:
 
-            int status = _TreeFindNodeRelative(getDBID(), path.data(), _nid, &nid);
-            if (status == TreeNNF) {
-                return std::nullopt;
-            }
-            else if (IS_NOT_OK(status)) {
-                throwException(status);
-            }
+    TreeNode() = default;
 
-            return TreeNode(_tree, nid);
-        }
+    inline TreeNode(Tree * tree, int nid)
+        : _tree(tree)
+        , _nid(nid)
+    { }
 
-        [[nodiscard]]
-        inline std::optional<TreeNode> tryGetParent() const
-        {
-            int nid = getParentNID();
-            if (nid == 0) {
-                return std::nullopt;
-            }
-            return TreeNode(_tree, nid);
-        }
+    virtual ~TreeNode() = default;
 
-        [[nodiscard]]
-        inline std::optional<TreeNode> tryGetBrother() const
-        {
-            int nid = getBrotherNID();
-            if (nid == 0) {
-                return std::nullopt;
-            }
-            return TreeNode(_tree, nid);
-        }
+    TreeNode(const TreeNode& other) = default;
 
-        [[nodiscard]]
-        inline std::optional<TreeNode> tryGetMember() const
-        {
-            int nid = getMemberID();
-            if (nid == 0) {
-                return std::nullopt;
-            }
-            return TreeNode(_tree, nid);
-        }
+    TreeNode& operator=(const TreeNode& other) = default;
 
-        [[nodiscard]]
-        inline std::optional<TreeNode> tryGetChild() const
-        {
-            int nid = getChildNID();
-            if (nid == 0) {
-                return std::nullopt;
-            }
-            return TreeNode(_tree, nid);
-        }
+    [[nodiscard]]
+    inline Tree * getTree() const {
+        return _tree;
+    }
 
-        [[nodiscard]]
-        std::optional<Data> tryGetData() const
-        {
-            mdsdsc_xd_t xd = MDSDSC_XD_INITIALIZER;
-            int status = _TreeGetRecord(getDBID(), _nid, &xd);
-            if (status == TreeNODATA) {
-                return std::nullopt;
-            }
-            else if (IS_NOT_OK(status)) {
-                throwException(status);
-            }
+    [[nodiscard]]
+    void * getDBID() const;
 
-            return Data(std::move(xd));
-        }
+    [[nodiscard]]
+    void * getContext() const;
 
-    #endif
+    [[nodiscard]]
+    inline int getNID() const {
+        return _nid;
+    }
 
-protected:
+    TreeNode getNode(const std::string& path) const;
 
-    Tree * _tree = nullptr;
-
-    int _nid = -1;
-
-    template <typename ResultType>
-    ResultType _getNCI(nci_t code) const;
+    std::vector<TreeNode> findNodeWild(const std::string& wildcard, std::vector<Usage> validUsages = {}) const;
 
-    std::string _getStringNCI(nci_t code, int16_t size) const;
+    TreeNode addNode(const std::string& path, Usage usage) const;
 
-    std::vector<int> _getNIDArrayNCI(nci_t code, nci_t codeForNumberOf) const;
+    TreeNode addDevice(const std::string& path, const std::string& model) const;
 
-    std::vector<TreeNode> _getTreeNodeArrayNCI(nci_t code, nci_t codeForNumberOf) const;
+    template <typename ResultType = Data, typename ...ArgTypes>
+    ResultType doMethod(const std::string& method, const ArgTypes&... args);
 
-}; // class TreeNode
+    [[nodiscard]]
+    inline uint64_t getTimeInserted() const {
+        return _getNCI<uint64_t>(NciTIME_INSERTED);
+    }
 
-std::string to_string(const TreeNode * node);
+    [[nodiscard]]
+    inline uint32_t getOwnerID() const {
+        return _getNCI<uint32_t>(NciOWNER_ID);
+    }
 
-inline std::string to_string(const TreeNode& node) {
-    return to_string(&node);
-}
+    [[nodiscard]]
+    inline class_t getClass() const {
+        return _getNCI<class_t>(NciCLASS);
+    }
 
-enum class Mode
-{
-    Normal,
-    ReadOnly,
-    Edit,
-    New,
+    [[nodiscard]]
+    inline dtype_t getDType() const {
+        return _getNCI<dtype_t>(NciDTYPE);
+    }
 
-    // TODO: Rename
-    View,
-};
+    [[nodiscard]]
+    inline uint32_t getLength() const {
+        return _getNCI<uint32_t>(NciLENGTH);
+    }
 
-std::string to_string(const Mode& mode);
-Mode from_string(const std::string& mode); // TODO: Rename?
+    [[nodiscard]]
+    inline uint32_t getStatus() const {
+        return _getNCI<uint32_t>(NciSTATUS);
+    }
 
-// TODO: TreeView class
+    // TODO: Double check all the on/off functions
 
-class Tree : public TreeNode
-{
-public:
+    inline bool isOn() const {
+        uint32_t status = getStatus();
+        return ((status & (NciM_STATE)) == 0);
+    }
 
-    // TODO: Rename public? global? ~~current~~?
-    static Tree GetActive() {
-        return Tree(TreeDbid());
+    inline bool isOff() const {
+        return !isOn();
     }
-    inline void setActive() {
-        TreeSwitchDbid(getDBID());
+
+    inline bool isParentOn() const {
+        uint32_t status = getStatus();
+        return ((status & (NciM_PARENT_STATE)) == 0);
     }
 
-    static std::vector<int> getShotDB(
-        const std::string& treename,
-        const std::string& path = "",
-        int lower = INT_MIN,
-        int higher = INT_MAX
-    );
+    inline bool isParentOff() const {
+        return !isParentOn();
+    }
 
-    Tree() = default;
+    inline void turnOn() {
+        _TreeTurnOn(getDBID(), _nid);
+    }
 
-    inline Tree(const std::string& treename, int shot, Mode mode = Mode::Normal, const std::string& path = {})
-        : _path(path)
-    {
-        open(treename, shot, mode);
+    inline void turnOff() {
+        _TreeTurnOff(getDBID(), _nid);
     }
 
-    inline Tree(void * dbid)
-        : _mode(Mode::View)
-        , _dbid(dbid)
-    {
-        // TODO: Review
+    [[nodiscard]]
+    inline uint16_t getConglomorateElements() const {
+        return _getNCI<uint16_t>(NciCONGLOMERATE_ELT);
+    }
 
-        char name[64];
-        int retNameLength;
-        DBI_ITM itmList[] = {
-            { sizeof(name), DbiNAME, name, &retNameLength, },
-            { sizeof(_shot), DbiSHOTID, &_shot, nullptr, },
-            { 0, DbiEND_OF_LIST, nullptr, nullptr, },
-        };
+    [[nodiscard]]
+    inline TreeNodeFlags getFlags() const {
+        return _getNCI<TreeNodeFlags>(NciGET_FLAGS);
+    }
 
-        _treename = std::string(name, retNameLength);
+    inline void setFlagsOn(TreeNodeFlags flags) const {
 
-        int status = TreeGetDbi(itmList);
-        if (IS_NOT_OK(status)) {
-            throwException(status);
-        }
     }
 
-    // Disallow copy constructor and assignment operator
-    Tree(const Tree&) = delete;
-    Tree& operator=(const Tree&) = delete;
+    inline void setFlagsOff(TreeNodeFlags flags) const {
 
-    inline Tree(Tree&& other)
-    {
-        // TODO: Improve
-        std::swap(_treename, other._treename);
-        std::swap(_shot, other._shot);
-        std::swap(_mode, other._mode);
-        std::swap(_dbid, other._dbid);
     }
 
-    inline Tree& operator=(Tree&& other)
-    {
-        // TODO: Improve
-        std::swap(_treename, other._treename);
-        std::swap(_shot, other._shot);
-        std::swap(_mode, other._mode);
-        std::swap(_dbid, other._dbid);
-        return *this;
+    inline void clearFlags(TreeNodeFlags flags) const {
+        setFlagsOff(flags);
     }
 
-    inline ~Tree()
-    {
-        if (_mode != Mode::View) {
-            TreeFreeDbid(_dbid);
-            _dbid = nullptr;
-        }
+    [[nodiscard]]
+    inline uint32_t getFlagsInt() const {
+        return _getNCI<uint32_t>(NciGET_FLAGS);
     }
 
     [[nodiscard]]
-    inline void * getDBID() const {
-        return _dbid;
-    }
+    std::string getNodeName() const;
 
     [[nodiscard]]
-    inline void ** getContext() const {
-        return const_cast<void **>(&_dbid);
+    inline std::string getPath() const {
+        return _getStringNCI(NciPATH, 1024);
     }
 
     [[nodiscard]]
-    inline std::string getTreeName() const {
-        // Return _treename?
-        return _getStringDBI(DbiNAME, 64);
+    inline uint32_t getDepth() const {
+        return _getNCI<uint32_t>(NciDEPTH);
     }
 
     [[nodiscard]]
-    inline int getShot() const {
-        // Return _shot?
-        return _getDBI<int>(DbiSHOTID);
+    inline int getParentNID() const {
+        return _getNCI<uint32_t>(NciPARENT);
     }
 
     [[nodiscard]]
-    inline Mode getMode() const {
-        return _mode;
+    inline TreeNode getParent() const {
+        int nid = getParentNID();
+        if (nid == 0) {
+            throw TreeNodeNotFound();
+        }
+        return TreeNode(_tree, nid);
     }
 
-    inline int64_t getDatafileSize() {
-        return _TreeGetDatafileSize(getDBID());
+    [[nodiscard]]
+    inline int getBrotherNID() const {
+        return _getNCI<uint32_t>(NciPARENT);
     }
 
-    std::string getFileName(const std::string& subtree = {});
+    [[nodiscard]]
+    inline TreeNode getBrother() const {
+        int nid = getBrotherNID();
+        if (nid == 0) {
+            throw TreeNodeNotFound();
+        }
+        return TreeNode(_tree, nid);
+    }
 
-    void open(const std::string& treename, int shot, Mode mode = Mode::Normal);
+    [[nodiscard]]
+    inline int getMemberID() const {
+        return _getNCI<uint32_t>(NciPARENT);
+    }
 
-    inline void reopen() {
-        open(getTreeName(), getShot(), getMode());
+    [[nodiscard]]
+    inline TreeNode getMember() const {
+        int nid = getMemberID();
+        if (nid == 0) {
+            throw TreeNodeNotFound();
+        }
+        return TreeNode(_tree, nid);
     }
 
-    void close();
+    [[nodiscard]]
+    inline int getChildNID() const {
+        return _getNCI<uint32_t>(NciPARENT);
+    }
 
-    void write();
+    [[nodiscard]]
+    inline TreeNode getChild() const {
+        int nid = getChildNID();
+        if (nid == 0) {
+            throw TreeNodeNotFound();
+        }
+        return TreeNode(_tree, nid);
+    }
 
-    void createPulse(int shot) const;
+    [[nodiscard]]
+    inline ncik_t getParentRelationship() const {
+        return _getNCI<ncik_t>(NciPARENT_RELATIONSHIP);
+    }
 
-    // std::vector<TreeNode> findNodeWild(const std::string& wildcard) const;
+    [[nodiscard]]
+    inline std::vector<int> getConglomerateElementNIDs() const {
+        return _getNIDArrayNCI(NciCONGLOMERATE_NIDS, NciNUMBER_OF_ELTS);
+    }
 
-    std::vector<std::string> findTagWild(const std::string& wildcard) const;
+    [[nodiscard]]
+    inline std::vector<TreeNode> getConglomerateElements() const {
+        return _getTreeNodeArrayNCI(NciCONGLOMERATE_NIDS, NciNUMBER_OF_ELTS);
+    }
 
-    inline std::vector<std::string> getTags() const override {
-        return findTagWild("*");
+    [[nodiscard]]
+    inline std::string getOriginalPartName() const {
+        return _getStringNCI(NciORIGINAL_PART_NAME, 1024);
     }
 
-    bool isOpen() const {
-        return (_dbid != nullptr);
+    [[nodiscard]]
+    inline uint32_t getNumberOfMembers() const {
+        return _getNCI<uint32_t>(NciNUMBER_OF_MEMBERS);
     }
 
-    bool isOpenForEdit() const {
-        return _getDBI<int>(DbiOPEN_FOR_EDIT);
+    [[nodiscard]]
+    inline uint32_t getNumberOfChildren() const {
+        return _getNCI<uint32_t>(NciNUMBER_OF_CHILDREN);
     }
 
-    bool isModified() const {
-        return _getDBI<int>(DbiMODIFIED);
+    [[nodiscard]]
+    inline std::vector<int> getMemberNIDs() const {
+        return _getNIDArrayNCI(NciMEMBER_NIDS, NciNUMBER_OF_MEMBERS);
     }
 
-    bool isOpenReadOnly() const {
-        return _getDBI<int>(DbiOPEN_READONLY);
+    [[nodiscard]]
+    inline std::vector<TreeNode> getMembers() const {
+        return _getTreeNodeArrayNCI(NciMEMBER_NIDS, NciNUMBER_OF_MEMBERS);
     }
 
-    void setReadOnly() {
-        if (_dbid != nullptr) {
-            _setDBI(DbiREADONLY, true);
+    [[nodiscard]]
+    inline std::vector<int> getChildrenNIDs() const {
+        return _getNIDArrayNCI(NciCHILDREN_NIDS, NciNUMBER_OF_CHILDREN);
+    }
 
-            if (_mode != Mode::View) {
-                _mode = Mode::ReadOnly;
-            }
-        }
+    [[nodiscard]]
+    inline std::vector<TreeNode> getChildren() const {
+        return _getTreeNodeArrayNCI(NciCHILDREN_NIDS, NciNUMBER_OF_CHILDREN);
     }
 
-    bool isVersionsInModelEnabled() const {
-        return _getDBI<int>(DbiVERSIONS_IN_MODEL);
+    [[nodiscard]]
+    std::vector<TreeNode> getMembersAndChildren(bool sortedNIDs = true) const;
+
+    [[nodiscard]]
+    inline std::string getFullPath() const {
+        return _getStringNCI(NciFULLPATH, 1024);
     }
 
-    void setVersionsInModelEnabled(bool enabled) const {
-        _setDBI(DbiVERSIONS_IN_MODEL, enabled);
+    [[nodiscard]]
+    inline std::string getMinPath() const {
+        return _getStringNCI(NciMINPATH, 1024);
     }
 
-    bool isVersionsInPulseEnabled() const {
-        return _getDBI<int>(DbiVERSIONS_IN_PULSE);
+    [[nodiscard]]
+    inline usage_t getUsage() const {
+        return _getNCI<usage_t>(NciUSAGE);
     }
 
-    void setVersionsInPulseEnabled(bool enabled) const {
-        _setDBI(DbiVERSIONS_IN_PULSE, enabled);
+    // setUsage
+
+    [[nodiscard]]
+    inline std::string getParentTreeName() const {
+        return _getStringNCI(NciPARENT_TREE, 64);
     }
 
-    bool isAlternateCompressionEnabled() const {
-        return _getDBI<int>(DbiALTERNATE_COMPRESSION);
+    [[nodiscard]]
+    inline uint32_t getRecordLength() const {
+        return _getNCI<uint32_t>(NciRLENGTH);
     }
 
-    void setAlternateCompressionEnabled(bool enabled) const {
-        _setDBI(DbiALTERNATE_COMPRESSION, enabled);
+    [[nodiscard]]
+    inline uint32_t getNumberOfElements() const {
+        return _getNCI<uint32_t>(NciNUMBER_OF_ELTS);
     }
 
-    inline void setDefaultNode(const std::string& path) const {
-        setDefaultNode(getNode(path));
+    [[nodiscard]]
+    inline bool hasDataInNCI() const {
+        return _getNCI<bool>(NciDATA_IN_NCI);
     }
 
-    void setDefaultNode(const TreeNode& node) const;
+    [[nodiscard]]
+    inline bool hasErrorOnPut() const {
+        return _getNCI<bool>(NciERROR_ON_PUT);
+    }
 
-    TreeNode getDefaultNode() const;
+    [[nodiscard]]
+    inline uint64_t getRFA() const {
+        return _getNCI<uint64_t>(NciRFA);
+    }
 
-    template <typename ResultType = Data, typename ...ArgTypes>
-    ResultType compileData(const std::string& expression, const ArgTypes&... args) const;
+    [[nodiscard]]
+    inline uint32_t getIOStatus() const {
+        return _getNCI<uint32_t>(NciIO_STATUS);
+    }
 
-    template <typename ResultType = Data, typename ...ArgTypes>
-    ResultType executeData(const std::string& expression, const ArgTypes&... args) const;
+    [[nodiscard]]
+    inline uint32_t getIOSTV() const {
+        return _getNCI<uint32_t>(NciIO_STV);
+    }
 
-private:
+    [[nodiscard]]
+    inline std::string getDTypeString() const {
+        return _getStringNCI(NciDTYPE_STR, 64);
+    }
 
-    void * _dbid = nullptr;
+    [[nodiscard]]
+    inline std::string getUsageString() const {
+        return _getStringNCI(NciUSAGE_STR, 64);
+    }
 
-    std::string _path;
+    [[nodiscard]]
+    inline std::string getClassString() const {
+        return _getStringNCI(NciCLASS_STR, 64);
+    }
 
-    std::string _treename;
+    [[nodiscard]]
+    inline uint32_t getVersion() const {
+        return _getNCI<uint32_t>(NciVERSION);
+    }
 
-    int _shot;
+    [[nodiscard]]
+    inline uint8_t getCompressionMethod() const {
+        return _getNCI<uint8_t>(NciCOMPRESSION_METHOD);
+    }
 
-    Mode _mode = Mode::Normal;
+    // setCompressionMethod?
 
-    template <typename ResultType>
-    ResultType _getDBI(int16_t code) const;
+    [[nodiscard]]
+    inline std::string getCompressionMethodString() const {
+        return _getStringNCI(NciCOMPRESSION_METHOD_STR, 64);
+    }
 
-    std::string _getStringDBI(int16_t code, int16_t size) const;
+    // setCompressionMethodString?
 
-    void _setDBI(int16_t code, int value) const;
+    template <typename ValueType>
+    void setExtendedAttribute(const std::string& name, const ValueType& value) const;
 
-};
+    template <typename ResultType = Data>
+    ResultType getExtendedAttribute(const std::string& name);
 
-std::string to_string(const Tree * tree);
+    void addTag(const std::string& tag);
 
-inline std::string to_string(const Tree& tree) {
-    return to_string(&tree);
-}
+    virtual std::vector<std::string> getTags() const;
 
-template <typename T>
-struct is_std_vector : std::false_type { };
+    [[nodiscard]]
+    Data getRecord() const;
 
-template <typename T, typename A>
-struct is_std_vector<std::vector<T, A>> : std::true_type { };
+    void putRecord(const Data& data) const;
 
-template <typename T>
-struct is_valid_ctype : std::false_type { };
+    template <typename DataType = Data>
+    [[nodiscard]]
+    DataType getData() const;
 
-// TODO: Rename? DataWrapper DataView
-class DataView
-{
-public:
+    template <typename DataType = Data, typename UnitsType = Data>
+    [[nodiscard]]
+    std::tuple<DataType, UnitsType> getDataWithUnits() const;
 
-    DataView() = delete;
+    template <typename DataType>
+    inline void setData(const DataType& value) const {
+        putRecord(Data::FromScalar(value));
+    }
 
-    DataView(const DataView&) = default;
-    DataView& operator=(const DataView&) = default;
+    template <typename DataType, typename UnitsType>
+    inline void setDataWithUnits(const DataType& value, const UnitsType& units) const {
+        putRecord(WithUnits(Data::FromScalar(value), Data::FromScalar(units)));
+    }
 
-    inline mdsdsc_t * getDescriptor() const {
-        if (_dsc.dtype == DTYPE_MISSING && _dsc.class_ == CLASS_MISSING) {
-            return nullptr;
+    // TODO: Fix to work with pointers
+
+#ifdef __cpp_lib_span
+
+    template <typename DataType>
+    void setArrayData(const std::span<const DataType> values, const std::vector<uint32_t>& dims = {}) const {
+        if (dims.empty()) {
+            return setArrayData(values.data(), { static_cast<uint32_t>(values.size()) });
         }
+        return setArrayData(values.data(), dims);
+    }
 
-        return (mdsdsc_t *)&_dsc;
+    template <typename DataType, typename UnitsType>
+    void setArrayDataWithUnits(const std::span<const DataType> values, UnitsType units, const std::vector<uint32_t>& dims = {}) const {
+        if (dims.empty()) {
+            return setArrayDataWithUnits(values.data(), units, { static_cast<uint32_t>(values.size()) });
+        }
+        return setArrayDataWithUnits(values.data(), units, dims);
     }
 
-    inline Tree * getTree() const {
-        return _tree;
+#endif
+
+    template <typename DataType>
+    inline void setArrayData(std::vector<DataType>& values, const std::vector<uint32_t>& dims = {}) const {
+        if (dims.empty()) {
+            return putRecord(Data::FromArray(values, { static_cast<uint32_t>(values.size()) }));
+        }
+        return putRecord(Data::FromArray(values, dims));
     }
 
-    inline DataView(std::nullptr_t)
-        : _dsc(array_coeff{
-            .length = 0,
-            .dtype = DTYPE_MISSING,
-            .class_ = CLASS_MISSING,
-            .pointer = nullptr,
-        })
-    { }
+    template <typename DataType, typename UnitsType>
+    inline void setArrayDataWithUnits(const std::vector<DataType>& values, UnitsType units, const std::vector<uint32_t>& dims = {}) const {
+        if (dims.empty()) {
+            return setArrayDataWithUnits(values.data(), units, { static_cast<uint32_t>(values.size()) });
+        }
+        return setArrayDataWithUnits(values.data(), units, dims);
+    }
 
-    // If the argument is already a MDSplus Data type, we only want to store a reference
-    // to it, not take ownership, so we store a CLASS_S descriptor instead of a CLASS_XD.
-    template <typename DataType,
-        typename std::enable_if<std::is_base_of<Data, DataType>::value, bool>::type = true>
-    inline DataView(const DataType& value)
-        : _dsc(array_coeff{
-            .length = 0,
-            .dtype = DTYPE_DSC,
-            .class_ = CLASS_S,
-            .pointer = const_cast<char *>(reinterpret_cast<const char *>(value.getDescriptor())),
-        })
-        , _tree(value.getTree())
-    { }
+    template <typename DataType>
+    inline void setArrayData(const DataType * values, const std::vector<uint32_t>& dims) const {
+        putRecord(Data::FromArray(values, dims));
+    }
 
-    template <typename CType,
-        typename std::enable_if<is_valid_ctype<CType>::value, bool>::type = true>
-    inline DataView(const std::vector<CType>& values)
-        : _dsc(array_coeff{
-            .length = sizeof(CType),
-            .dtype = _getDTypeForCType<CType>(),
-            .class_ = CLASS_A,
-            .pointer = const_cast<char *>(reinterpret_cast<const char *>(values.data())),
-            .scale = 0,
-            .digits = 0,
-            .aflags = aflags_t{
-                .binscale = false,
-                .redim = true,
-                .column = true,
-                .coeff = true,
-                .bounds = false,
-            },
-            .dimct = 1,
-            .arsize = arsize_t(values.size() * sizeof(CType)),
-            .a0 = const_cast<char *>(reinterpret_cast<const char *>(values.data())),
-            .m = { static_cast<uint32_t>(values.size()), 0, 0, 0, 0, 0, 0, 0 },
-        })
-    { }
+    template <typename DataType, typename UnitsType>
+    inline void setArrayDataWithUnits(const DataType * values, UnitsType units, const std::vector<uint32_t>& dims) const {
+        putRecord(WithUnits(Data::FromArray(values, dims), Data::FromScalar(units)));
+    }
 
-    #ifdef __cpp_lib_span
+    template <typename ValueType>
+    void putRow(int segmentLength, const ValueType& value, int64_t timestamp);
 
-        template <typename CType,
-            typename std::enable_if<is_valid_ctype<CType>::value, bool>::type = true>
-        inline DataView(std::span<const CType> values)
-            : _dsc(array_coeff{
-                .length = sizeof(CType),
-                .dtype = _getDTypeForCType<CType>(),
-                .class_ = CLASS_A,
-                .pointer = const_cast<char *>(reinterpret_cast<const char *>(values.data())),
-                .scale = 0,
-                .digits = 0,
-                .aflags = aflags_t{
+    template <typename ValueArrayType>
+    void putSegment(const ValueArrayType& values, int index = -1);
+
+    template <typename ValueArrayType>
+    inline void putTimestampedSegment(std::vector<int64_t> timestamps, const ValueArrayType& values) {
+        putTimestampedSegment(timestamps.data(), values);
+    }
+
+    template <typename ValueArrayType>
+    void putTimestampedSegment(int64_t * timestamps, const ValueArrayType& values);
+
+    template <
+        typename StartIndexType,
+        typename EndIndexType,
+        typename DimensionType,
+        typename ValueArrayType
+    >
+    void beginSegment(
+        const StartIndexType& startIndex,
+        const EndIndexType& endIndex,
+        const DimensionType& dimension,
+        const ValueArrayType& initialValues,
+        int index = -1
+    ) const;
+
+    template <typename ValueArrayType>
+    void beginTimestampedSegment(const ValueArrayType& initialValues, int index = -1) const;
+
+    template <
+        typename ValueType,
+        typename StartIndexType,
+        typename EndIndexType,
+        typename DimensionType
+    >
+    void allocateSegment(
+        const StartIndexType& startIndex,
+        const EndIndexType& endIndex,
+        const DimensionType& dimension,
+        uint32_t rows,
+        const std::vector<uint32_t>& rowDims = {},
+        int index = -1
+    ) const;
+
+    template <typename ValueType>
+    void allocateTimestampedSegment(uint32_t rows, const std::vector<uint32_t>& rowDims = {}, int index = -1) const;
+
+    template <
+        typename StartIndexType,
+        typename EndIndexType,
+        typename DimensionType
+    >
+    void updateSegment(
+        const StartIndexType& startIndex,
+        const EndIndexType& endIndex,
+        const DimensionType& dimension,
+        int index = -1
+    ) const;
+
+    template <
+        typename StartIndexType,
+        typename EndIndexType,
+        typename DimensionType,
+        typename ValueArrayType
+    >
+    void makeSegment(
+        const StartIndexType& startIndex,
+        const EndIndexType& endIndex,
+        const DimensionType& dimension,
+        const ValueArrayType& values,
+        int index = -1,
+        int rowsFilled = -1
+    ) const;
+
+    template <
+        typename StartIndexType,
+        typename EndIndexType,
+        typename DimensionType,
+        typename ValueArrayType
+    >
+    void makeSegmentResampled(
+        const StartIndexType& startIndex,
+        const EndIndexType& endIndex,
+        const DimensionType& dimension,
+        const ValueArrayType& values,
+        const TreeNode& resampleNode,
+        int resampleFactor,
+        int index = -1,
+        int rowsFilled = -1
+    ) const;
+
+    template <
+        typename StartIndexType,
+        typename EndIndexType,
+        typename DimensionType,
+        typename ValueArrayType
+    >
+    void makeSegmentMinMax(
+        const StartIndexType& startIndex,
+        const EndIndexType& endIndex,
+        const DimensionType& dimension,
+        const ValueArrayType& values,
+        const TreeNode& resampleNode,
+        int resampleFactor,
+        int index = -1,
+        int rowsFilled = -1
+    ) const;
+
+    template <typename ValueType>
+    void makeSegmentDecimated(
+        double start,
+        double delta,
+        const ValueType * values,
+        uint32_t count,
+        uint32_t factor,
+        const TreeNode& minNode,
+        const TreeNode& maxNode,
+        const TreeNode& meanNode = {}
+    ) const;
+
+    template <typename ValueType>
+    inline void makeSegmentDecimated(
+        double start,
+        double delta,
+        const std::vector<ValueType>& values,
+        uint32_t factor,
+        const TreeNode& minNode,
+        const TreeNode& maxNode,
+        const TreeNode& meanNode = {}
+    ) const
+    {
+        makeSegmentDecimated(start, delta, values.data(), uint32_t(values.size()), factor, minNode, maxNode, meanNode);
+    }
+
+    // template <typename TimestampArrayType, typename ValueArrayType>
+    // inline void makeTimestampedSegment(
+    //     const TimestampArrayType& timestamps,
+    //     const ValueArrayType& values,
+    //     int index = -1,
+    //     int rowsFilled = -1
+    // ) const;
+
+    // template <typename ValueArrayType>
+    // inline void makeTimestampedSegment(
+    //     const Int64Array& timestamps,
+    //     const ValueArrayType& values,
+    //     int index = -1,
+    //     int rowsFilled = -1
+    // ) const;
+
+    template <typename ValueArrayType>
+    inline void makeTimestampedSegment(
+        std::vector<int64_t> timestamps,
+        const ValueArrayType& values,
+        int index = -1,
+        int rowsFilled = -1
+    ) const
+    {
+        makeTimestampedSegment(timestamps.data(), values, index, rowsFilled);
+    }
+
+    template <typename ValueArrayType>
+    void makeTimestampedSegment(
+        int64_t * timestamps,
+        const ValueArrayType& values,
+        int index = -1,
+        int rowsFilled = -1
+    ) const;
+
+    [[nodiscard]]
+    int getNumSegments() const;
+
+    template <typename ValueArrayType = Data, typename DimensionType = Data>
+    [[nodiscard]]
+    std::tuple<ValueArrayType, DimensionType> getSegment(int index) const;
+
+    template <typename StartType = Data, typename EndType = StartType>
+    [[nodiscard]]
+    std::tuple<StartType, EndType> getSegmentLimits(int index) const;
+
+    [[nodiscard]]
+    SegmentInfo getSegmentInfo(int index = -1) const;
+
+    template <typename ValueArrayType>
+    [[nodiscard]]
+    std::tuple<std::vector<typename ValueArrayType::__ctype>, std::vector<double>> readWindow(double start, double end) const;
+
+    template <typename ValueType>
+    void setSegmentScale(const ValueType& value);
+
+    template <typename ResultType = Data>
+    ResultType getSegmentScale();
+
+    // TODO: Move
+    #ifdef __cpp_lib_optional
+
+        [[nodiscard]]
+        std::optional<TreeNode> tryGetNode(const std::string& path) const
+        {
+            int nid = 0;
+
+            int status = _TreeFindNodeRelative(getDBID(), path.data(), _nid, &nid);
+            if (status == TreeNNF) {
+                return std::nullopt;
+            }
+            else if (IS_NOT_OK(status)) {
+                throwException(status);
+            }
+
+            return TreeNode(_tree, nid);
+        }
+
+        [[nodiscard]]
+        inline std::optional<TreeNode> tryGetParent() const
+        {
+            int nid = getParentNID();
+            if (nid == 0) {
+                return std::nullopt;
+            }
+            return TreeNode(_tree, nid);
+        }
+
+        [[nodiscard]]
+        inline std::optional<TreeNode> tryGetBrother() const
+        {
+            int nid = getBrotherNID();
+            if (nid == 0) {
+                return std::nullopt;
+            }
+            return TreeNode(_tree, nid);
+        }
+
+        [[nodiscard]]
+        inline std::optional<TreeNode> tryGetMember() const
+        {
+            int nid = getMemberID();
+            if (nid == 0) {
+                return std::nullopt;
+            }
+            return TreeNode(_tree, nid);
+        }
+
+        [[nodiscard]]
+        inline std::optional<TreeNode> tryGetChild() const
+        {
+            int nid = getChildNID();
+            if (nid == 0) {
+                return std::nullopt;
+            }
+            return TreeNode(_tree, nid);
+        }
+
+        [[nodiscard]]
+        std::optional<Data> tryGetData() const
+        {
+            TraceScope span(TraceEvent::Read);
+            if (span) {
+                span.setName(getFullPath());
+            }
+
+            mdsdsc_xd_t xd = MDSDSC_XD_INITIALIZER;
+            int status = _TreeGetRecord(getDBID(), _nid, &xd);
+            span.setStatus(status);
+            span.addBytes(xd.l_length);
+            if (status == TreeNODATA) {
+                return std::nullopt;
+            }
+            else if (IS_NOT_OK(status)) {
+                throwException(status);
+            }
+
+            return Data(std::move(xd));
+        }
+
+    #endif
+
+protected:
+
+    Tree * _tree = nullptr;
+
+    int _nid = -1;
+
+    template <typename ResultType>
+    ResultType _getNCI(nci_t code) const;
+
+    // Returns at least count zeros, used to allocate segments without building a new array every time
+    template <typename ValueType>
+    static const ValueType * _getZeros(size_t count);
+
+    // Returns the range [first, last) of segments overlapping start and end
+    std::pair<int, int> _findSegments(double start, double end) const;
+
+    // Marks the segment indexes used by readWindow() as out of date, reindex also drops this node's
+    // index for writes that add segments or can change the limits of any segment
+    void _onSegmentsWritten(bool reindex = false) const;
+
+    std::string _getStringNCI(nci_t code, int16_t size) const;
+
+    std::vector<int> _getNIDArrayNCI(nci_t code, nci_t codeForNumberOf) const;
+
+    std::vector<TreeNode> _getTreeNodeArrayNCI(nci_t code, nci_t codeForNumberOf) const;
+
+}; // class TreeNode
+
+std::string to_string(const TreeNode * node);
+
+inline std::string to_string(const TreeNode& node) {
+    return to_string(&node);
+}
+
+enum class Mode
+{
+    Normal,
+    ReadOnly,
+    Edit,
+    New,
+
+    // TODO: Rename
+    View,
+};
+
+std::string to_string(const Mode& mode);
+Mode from_string(const std::string& mode); // TODO: Rename?
+
+// TODO: TreeView class
+
+class Tree : public TreeNode
+{
+    // For the segment index used by TreeNode::readWindow()
+    friend class TreeNode;
+
+public:
+
+    // TODO: Rename public? global? ~~current~~?
+    static Tree GetActive() {
+        return Tree(TreeDbid());
+    }
+    inline void setActive() {
+        TreeSwitchDbid(getDBID());
+    }
+
+    static std::vector<int> getShotDB(
+        const std::string& treename,
+        const std::string& path = "",
+        int lower = INT_MIN,
+        int higher = INT_MAX
+    );
+
+    static void clearShotDBCache();
+
+    Tree() = default;
+
+    inline Tree(const std::string& treename, int shot, Mode mode = Mode::Normal, const std::string& path = {})
+        : _path(path)
+    {
+        open(treename, shot, mode);
+    }
+
+    inline Tree(void * dbid)
+        : _mode(Mode::View)
+        , _dbid(dbid)
+    {
+        // TODO: Review
+
+        char name[64];
+        int retNameLength;
+        DBI_ITM itmList[] = {
+            { sizeof(name), DbiNAME, name, &retNameLength, },
+            { sizeof(_shot), DbiSHOTID, &_shot, nullptr, },
+            { 0, DbiEND_OF_LIST, nullptr, nullptr, },
+        };
+
+        _treename = std::string(name, retNameLength);
+
+        int status = TreeGetDbi(itmList);
+        if (IS_NOT_OK(status)) {
+            throwException(status);
+        }
+    }
+
+    // Disallow copy constructor and assignment operator
+    Tree(const Tree&) = delete;
+    Tree& operator=(const Tree&) = delete;
+
+    inline Tree(Tree&& other)
+    {
+        // TODO: Improve
+        std::swap(_path, other._path);
+        std::swap(_treename, other._treename);
+        std::swap(_shot, other._shot);
+        std::swap(_mode, other._mode);
+        std::swap(_dbid, other._dbid);
+        std::swap(_segmentIndexes, other._segmentIndexes);
+    }
+
+    inline Tree& operator=(Tree&& other)
+    {
+        // TODO: Improve
+        std::swap(_path, other._path);
+        std::swap(_treename, other._treename);
+        std::swap(_shot, other._shot);
+        std::swap(_mode, other._mode);
+        std::swap(_dbid, other._dbid);
+        std::swap(_segmentIndexes, other._segmentIndexes);
+        return *this;
+    }
+
+    inline ~Tree()
+    {
+        if (_mode != Mode::View) {
+            TreeFreeDbid(_dbid);
+            _dbid = nullptr;
+        }
+    }
+
+    [[nodiscard]]
+    inline void * getDBID() const {
+        return _dbid;
+    }
+
+    [[nodiscard]]
+    inline void ** getContext() const {
+        return const_cast<void **>(&_dbid);
+    }
+
+    [[nodiscard]]
+    inline std::string getTreeName() const {
+        // Return _treename?
+        return _getStringDBI(DbiNAME, 64);
+    }
+
+    [[nodiscard]]
+    inline int getShot() const {
+        // Return _shot?
+        return _getDBI<int>(DbiSHOTID);
+    }
+
+    [[nodiscard]]
+    inline Mode getMode() const {
+        return _mode;
+    }
+
+    [[nodiscard]]
+    inline std::string getTreePath() const {
+        return _path;
+    }
+
+    // Takes effect on the next call to open()
+    inline void setTreePath(const std::string& path) {
+        _path = path;
+    }
+
+    inline int64_t getDatafileSize() {
+        return _TreeGetDatafileSize(getDBID());
+    }
+
+    std::string getFileName(const std::string& subtree = {});
+
+    void open(const std::string& treename, int shot, Mode mode = Mode::Normal);
+
+    void open(const std::string& treename, int shot, Mode mode, const std::string& path);
+
+    inline void reopen() {
+        open(getTreeName(), getShot(), getMode());
+    }
+
+    void close();
+
+    void write();
+
+    void createPulse(int shot) const;
+
+    // std::vector<TreeNode> findNodeWild(const std::string& wildcard) const;
+
+    std::vector<std::string> findTagWild(const std::string& wildcard) const;
+
+    inline std::vector<std::string> getTags() const override {
+        return findTagWild("*");
+    }
+
+    bool isOpen() const {
+        return (_dbid != nullptr);
+    }
+
+    bool isOpenForEdit() const {
+        return _getDBI<int>(DbiOPEN_FOR_EDIT);
+    }
+
+    bool isModified() const {
+        return _getDBI<int>(DbiMODIFIED);
+    }
+
+    bool isOpenReadOnly() const {
+        return _getDBI<int>(DbiOPEN_READONLY);
+    }
+
+    void setReadOnly() {
+        if (_dbid != nullptr) {
+            _setDBI(DbiREADONLY, true);
+
+            if (_mode != Mode::View) {
+                _mode = Mode::ReadOnly;
+            }
+        }
+    }
+
+    bool isVersionsInModelEnabled() const {
+        return _getDBI<int>(DbiVERSIONS_IN_MODEL);
+    }
+
+    void setVersionsInModelEnabled(bool enabled) const {
+        _setDBI(DbiVERSIONS_IN_MODEL, enabled);
+    }
+
+    bool isVersionsInPulseEnabled() const {
+        return _getDBI<int>(DbiVERSIONS_IN_PULSE);
+    }
+
+    void setVersionsInPulseEnabled(bool enabled) const {
+        _setDBI(DbiVERSIONS_IN_PULSE, enabled);
+    }
+
+    bool isAlternateCompressionEnabled() const {
+        return _getDBI<int>(DbiALTERNATE_COMPRESSION);
+    }
+
+    void setAlternateCompressionEnabled(bool enabled) const {
+        _setDBI(DbiALTERNATE_COMPRESSION, enabled);
+    }
+
+    inline void setDefaultNode(const std::string& path) const {
+        setDefaultNode(getNode(path));
+    }
+
+    void setDefaultNode(const TreeNode& node) const;
+
+    TreeNode getDefaultNode() const;
+
+    template <typename ResultType = Data, typename ...ArgTypes>
+    ResultType compileData(const std::string& expression, const ArgTypes&... args) const;
+
+    template <typename ResultType = Data, typename ...ArgTypes>
+    ResultType executeData(const std::string& expression, const ArgTypes&... args) const;
+
+private:
+
+    struct _ShotDBDirectory
+    {
+        std::filesystem::file_time_type LastWriteTime = {};
+
+        // Set when the directory was scanned too soon after it was modified to trust its time
+        bool Stale = true;
+
+        // Shot numbers for each lowercase tree name, sorted
+        std::unordered_map<std::string, std::vector<int>> Shots = {};
+    };
+
+    // The start and end of every segment of a node, as doubles
+    struct _SegmentIndex
+    {
+        std::vector<double> Starts = {};
+
+        std::vector<double> Ends = {};
+
+        bool Loaded = false;
+
+        // The value of _getSegmentWriteCount() when the index was last refreshed
+        uint64_t WriteCount = 0;
+    };
+
+    static std::shared_mutex& _getOpenMutex();
+
+    static std::mutex& _getShotDBMutex();
+
+    // Incremented by every segment or record written by any Tree in this process, see TreeNode::readWindow()
+    static std::atomic<uint64_t>& _getSegmentWriteCount();
+
+    static std::unordered_map<std::string, _ShotDBDirectory>& _getShotDBCache();
+
+    static std::vector<std::filesystem::path> _getShotDBDirectories(const std::string& treename, const std::string& path);
+
+    static void _expandShotDBDirectory(const std::string& pattern, std::vector<std::filesystem::path>& directories);
+
+    static void _scanShotDBDirectory(const std::filesystem::path& directory, _ShotDBDirectory& entry);
+
+    void * _dbid = nullptr;
+
+    std::string _path;
+
+    std::string _treename;
+
+    int _shot;
+
+    Mode _mode = Mode::Normal;
+
+    mutable std::mutex _segmentIndexMutex;
+
+    // Indexed by NID, see TreeNode::readWindow()
+    mutable std::unordered_map<int, _SegmentIndex> _segmentIndexes;
+
+    int _open();
+
+    template <typename ResultType>
+    ResultType _getDBI(int16_t code) const;
+
+    std::string _getStringDBI(int16_t code, int16_t size) const;
+
+    void _setDBI(int16_t code, int value) const;
+
+};
+
+std::string to_string(const Tree * tree);
+
+inline std::string to_string(const Tree& tree) {
+    return to_string(&tree);
+}
+
+template <typename T>
+struct is_std_vector : std::false_type { };
+
+template <typename T, typename A>
+struct is_std_vector<std::vector<T, A>> : std::true_type { };
+
+template <typename T>
+struct is_valid_ctype : std::false_type { };
+
+// TODO: Rename? DataWrapper DataView
+class DataView
+{
+public:
+
+    DataView() = delete;
+
+    DataView(const DataView&) = default;
+    DataView& operator=(const DataView&) = default;
+
+    inline mdsdsc_t * getDescriptor() const {
+        if (_dsc.dtype == DTYPE_MISSING && _dsc.class_ == CLASS_MISSING) {
+            return nullptr;
+        }
+
+        return (mdsdsc_t *)&_dsc;
+    }
+
+    inline Tree * getTree() const {
+        return _tree;
+    }
+
+    inline DataView(std::nullptr_t)
+        : _dsc(array_coeff{
+            .length = 0,
+            .dtype = DTYPE_MISSING,
+            .class_ = CLASS_MISSING,
+            .pointer = nullptr,
+        })
+    { }
+
+    // If the argument is already a MDSplus Data type, we only want to store a reference
+    // to it, not take ownership, so we store a CLASS_S descriptor instead of a CLASS_XD.
+    template <typename DataType,
+        typename std::enable_if<std::is_base_of<Data, DataType>::value, bool>::type = true>
+    inline DataView(const DataType& value)
+        : _dsc(array_coeff{
+            .length = 0,
+            .dtype = DTYPE_DSC,
+            .class_ = CLASS_S,
+            .pointer = const_cast<char *>(reinterpret_cast<const char *>(value.getDescriptor())),
+        })
+        , _tree(value.getTree())
+    { }
+
+    // Same as for Data, a reference to the descriptor it refers to
+    inline DataView(const DataRef& value)
+        : _dsc(array_coeff{
+            .length = 0,
+            .dtype = DTYPE_DSC,
+            .class_ = CLASS_S,
+            .pointer = reinterpret_cast<char *>(value.getDescriptor()),
+        })
+        , _tree(value.getTree())
+    { }
+
+    template <typename CType,
+        typename std::enable_if<is_valid_ctype<CType>::value, bool>::type = true>
+    inline DataView(const std::vector<CType>& values)
+        : _dsc(array_coeff{
+            .length = sizeof(CType),
+            .dtype = _getDTypeForCType<CType>(),
+            .class_ = CLASS_A,
+            .pointer = const_cast<char *>(reinterpret_cast<const char *>(values.data())),
+            .scale = 0,
+            .digits = 0,
+            .aflags = aflags_t{
+                .binscale = false,
+                .redim = true,
+                .column = true,
+                .coeff = true,
+                .bounds = false,
+            },
+            .dimct = 1,
+            .arsize = arsize_t(values.size() * sizeof(CType)),
+            .a0 = const_cast<char *>(reinterpret_cast<const char *>(values.data())),
+            .m = { static_cast<uint32_t>(values.size()), 0, 0, 0, 0, 0, 0, 0 },
+        })
+    { }
+
+    // Refers to count values without copying them, e.g. one channel of a larger block
+    template <typename CType,
+        typename std::enable_if<is_valid_ctype<CType>::value, bool>::type = true>
+    inline DataView(const CType * values, uint32_t count)
+        : _dsc(array_coeff{
+            .length = sizeof(CType),
+            .dtype = _getDTypeForCType<CType>(),
+            .class_ = CLASS_A,
+            .pointer = const_cast<char *>(reinterpret_cast<const char *>(values)),
+            .scale = 0,
+            .digits = 0,
+            .aflags = aflags_t{
+                .binscale = false,
+                .redim = true,
+                .column = true,
+                .coeff = true,
+                .bounds = false,
+            },
+            .dimct = 1,
+            .arsize = arsize_t(count * sizeof(CType)),
+            .a0 = const_cast<char *>(reinterpret_cast<const char *>(values)),
+            .m = { count, 0, 0, 0, 0, 0, 0, 0 },
+        })
+    { }
+
+    template <typename CType,
+        typename std::enable_if<is_valid_ctype<CType>::value, bool>::type = true>
+    inline DataView(const CType * values, const std::vector<uint32_t>& dims)
+    {
+        _setArray(values, dims.data(), dims.size());
+    }
+
+    #ifdef __cpp_lib_span
+
+        template <typename CType,
+            typename std::enable_if<is_valid_ctype<CType>::value, bool>::type = true>
+        inline DataView(std::span<const CType> values, const std::vector<uint32_t>& dims)
+        {
+            _checkCount(values.size(), dims);
+            _setArray(values.data(), dims.data(), dims.size());
+        }
+
+        template <typename CType,
+            typename std::enable_if<is_valid_ctype<CType>::value, bool>::type = true>
+        inline DataView(std::span<const CType> values)
+            : _dsc(array_coeff{
+                .length = sizeof(CType),
+                .dtype = _getDTypeForCType<CType>(),
+                .class_ = CLASS_A,
+                .pointer = const_cast<char *>(reinterpret_cast<const char *>(values.data())),
+                .scale = 0,
+                .digits = 0,
+                .aflags = aflags_t{
                     .binscale = false,
                     .redim = true,
                     .column = true,
@@ -4647,1411 +6340,3051 @@ public:
             })
         { }
 
-    #endif
+    #endif
+
+    #ifdef __cpp_lib_mdspan
+
+        template <typename ElementType, typename Extents, typename Layout, typename Accessor,
+            typename std::enable_if<is_valid_ctype<std::remove_const_t<ElementType>>::value, bool>::type = true>
+        inline DataView(std::mdspan<ElementType, Extents, Layout, Accessor> values)
+        {
+            static_assert(
+                std::is_same_v<Layout, std::layout_right> || std::is_same_v<Layout, std::layout_left>,
+                "Only contiguous mdspan layouts can be passed without copying"
+            );
+            static_assert(
+                std::is_same_v<Accessor, std::default_accessor<ElementType>>,
+                "Only mdspans over plain memory can be passed without copying"
+            );
+            static_assert(Extents::rank() > 0 && Extents::rank() <= MAX_DIMS);
+
+            uint32_t dims[MAX_DIMS] = {};
+            for (size_t i = 0; i < Extents::rank(); ++i) {
+                if constexpr (std::is_same_v<Layout, std::layout_right>) {
+                    dims[i] = uint32_t(values.extent(Extents::rank() - 1 - i));
+                }
+                else {
+                    dims[i] = uint32_t(values.extent(i));
+                }
+            }
+
+            _setArray(
+                static_cast<const std::remove_const_t<ElementType> *>(values.data_handle()),
+                dims,
+                Extents::rank()
+            );
+        }
+
+    #endif // __cpp_lib_mdspan
+
+    template <typename CType,
+        typename std::enable_if<is_valid_ctype<CType>::value, bool>::type = true>
+    inline DataView(const CType& value)
+        : _dsc(array_coeff{
+            .length = sizeof(CType),
+            .dtype = _getDTypeForCType<CType>(),
+            .class_ = CLASS_S,
+            .pointer = const_cast<char *>(reinterpret_cast<const char *>(&value)),
+        })
+    { }
+
+    // TODO: Improve?
+    #ifdef __cpp_lib_string_view
+
+        inline DataView(std::string_view value)
+            : _dsc(array_coeff{
+                .length = length_t(value.size()),
+                .dtype = DTYPE_T,
+                .class_ = CLASS_S,
+                .pointer = const_cast<char *>(value.data()),
+            })
+        { }
+
+    #else
+
+        inline DataView(const char * value)
+            : _dsc(array_coeff{
+                .length = length_t(strlen(value)),
+                .dtype = DTYPE_T,
+                .class_ = CLASS_S,
+                .pointer = const_cast<char *>(value),
+            })
+        { }
+
+        inline DataView(const std::string& value)
+            : _dsc(array_coeff{
+                .length = length_t(value.size()),
+                .dtype = DTYPE_T,
+                .class_ = CLASS_S,
+                .pointer = const_cast<char *>(value.data()),
+            })
+        { }
+
+    #endif // __cpp_lib_string_view
+
+    inline DataView(const TreeNode& node)
+        : _dsc(array_coeff{
+            .length = sizeof(node._nid),
+            .dtype = DTYPE_NID,
+            .class_ = CLASS_S,
+            .pointer = const_cast<char *>(reinterpret_cast<const char *>(&node._nid)),
+        })
+        , _tree(node._tree)
+    { }
+
+private:
+
+    array_coeff _dsc = MDSDSC_XD_INITIALIZER;
+
+    Tree * _tree = nullptr;
+
+    template <typename CType>
+    inline void _setArray(const CType * values, const uint32_t * dims, size_t dimCount)
+    {
+        if (dimCount == 0 || dimCount > MAX_DIMS) {
+            throwException(TreeFAILURE);
+        }
+
+        uint32_t count = 1;
+        for (size_t i = 0; i < dimCount; ++i) {
+            count *= dims[i];
+        }
+
+        _dsc = array_coeff{
+            .length = sizeof(CType),
+            .dtype = _getDTypeForCType<CType>(),
+            .class_ = CLASS_A,
+            .pointer = const_cast<char *>(reinterpret_cast<const char *>(values)),
+            .scale = 0,
+            .digits = 0,
+            .aflags = aflags_t{
+                .binscale = false,
+                .redim = true,
+                .column = true,
+                .coeff = true,
+                .bounds = false,
+            },
+            .dimct = dimct_t(dimCount),
+            .arsize = arsize_t(count * sizeof(CType)),
+            .a0 = const_cast<char *>(reinterpret_cast<const char *>(values)),
+            .m = { 0, 0, 0, 0, 0, 0, 0, 0 },
+        };
+
+        for (size_t i = 0; i < dimCount; ++i) {
+            _dsc.m[i] = dims[i];
+        }
+    }
+
+    static inline void _checkCount(size_t count, const std::vector<uint32_t>& dims)
+    {
+        size_t expected = 1;
+        for (uint32_t dim : dims) {
+            expected *= dim;
+        }
+
+        if (count != expected) {
+            throwException(TreeFAILURE);
+        }
+    }
+
+};
+
+class String : public Data
+{
+public:
+
+    static constexpr Class __class = Class::S;
+    static constexpr DType __dtype = DType::T;
+
+    String() = default;
+
+    String(mdsdsc_xd_t && xd, Tree * tree = nullptr)
+        : Data(std::move(xd), tree)
+    { }
+
+    #ifdef __cpp_lib_string_view
+
+        inline String(std::string_view value) {
+            setValue(value);
+        }
+
+    #else
+
+        inline String(const std::string& value) {
+            setValue(value);
+        }
+
+    #endif // __cpp_lib_string_view
+
+    inline String(const char *value, length_t length) {
+        setValue(value, length);
+    }
+
+    String(String&&) = default;
+    String& operator=(String&&) = default;
+
+    [[nodiscard]]
+    inline String clone() const {
+        return _clone<String>();
+    }
+
+    [[nodiscard]]
+    inline String * cloneNew() const {
+        return _cloneNew<String>();
+    }
+
+    inline std::string getValue() const {
+        return getString();
+    }
+
+    inline std::string getString() const {
+        mdsdsc_t * dsc = getDescriptor();
+        return std::string(dsc->pointer, dsc->length);
+    }
+
+    #ifdef __cpp_lib_string_view
+
+        // Warning: this will not be null-terminated
+        inline std::string_view getStringView() const {
+            mdsdsc_t * dsc = getDescriptor();
+            return std::string_view(dsc->pointer, dsc->length);
+        }
+
+    #endif // __cpp_lib_string_view
+
+    #ifdef __cpp_lib_string_view
+
+        void setValue(std::string_view value) {
+            setValue(value.data(), value.size());
+        }
+
+    #else
+
+        void setValue(const std::string& value) {
+            setValue(value.data(), value.size());
+        }
+
+    #endif // __cpp_lib_string_view
+
+    void setValue(const char * value, length_t length);
+
+}; // class String
+
+// TODO: Decide if to_string(String) should be different
+inline std::string to_string(const String * data) {
+    return data->getString();
+}
+
+inline std::string to_string(const String& data) {
+    return data.getString();
+}
+
+template <>
+inline String Data::releaseAndConvert()
+{
+    mdsdsc_xd_t xd = release();
+    mdsdsc_t * dsc = xd.pointer;
+
+    if (dsc->class_ == CLASS_S && dsc->dtype == DTYPE_T) {
+        return String(std::move(xd), getTree());
+    }
+
+    // TODO: Call DATA()?
+
+    mdsdsc_xd_t xdDeco = MDSDSC_XD_INITIALIZER;
+    int status = _intrinsic(OPC_DECOMPILE, 1, &dsc, &xdDeco);
+    if (IS_NOT_OK(status)) {
+        throwException(status);
+    }
+
+    MdsFree1Dx(&xd, nullptr);
+    return String(std::move(xdDeco), getTree());
+}
+
+template <>
+inline std::string Data::getData() const {
+    return getData<String>().getString();
+}
+
+template <>
+inline Data Data::FromScalar(const char * value) {
+    return String(value);
+}
+
+#ifdef __cpp_lib_string_view
+
+    template <>
+    inline Data Data::FromScalar(std::string_view value) {
+        return String(value);
+    }
+
+#else
+
+    template <>
+    inline Data Data::FromScalar(const std::string& value) {
+        return String(value);
+    }
+
+#endif // __cpp_lib_string_view
+
+class StringArray : public Data
+{
+public:
+
+    static constexpr Class __class = Class::A;
+    static constexpr DType __dtype = DType::T;
+
+    StringArray() = default;
+
+    inline StringArray(mdsdsc_xd_t && xd, Tree * tree = nullptr)
+        : Data(std::move(xd), tree)
+    { }
+
+    #ifdef __cpp_lib_span
+
+        inline StringArray(std::span<const std::string> values, const std::vector<uint32_t>& dims = {}) {
+            setValues(values, dims);
+        }
+
+    #else
+
+        inline StringArray(const std::vector<std::string>& values, const std::vector<uint32_t>& dims = {}) {
+            setValues(values, dims);
+        }
+
+    #endif // __cpp_lib_span
+
+    inline StringArray(std::initializer_list<std::string> values, const std::vector<uint32_t>& dims = {}) {
+        std::vector<std::string> tmp(values);
+        setValues(tmp, dims);
+    }
+
+    #ifdef __cpp_lib_string_view
+
+        inline StringArray(std::initializer_list<std::string_view> values, const std::vector<uint32_t>& dims = {}) {
+            std::vector<std::string_view> tmp(values);
+            setValues(tmp, dims);
+        }
+
+    #endif // __cpp_lib_string_view
+
+    StringArray(StringArray&&) = default;
+    StringArray& operator=(StringArray&&) = default;
+
+    [[nodiscard]]
+    inline mdsdsc_a_t * getArrayDescriptor() const {
+        return reinterpret_cast<mdsdsc_a_t *>(_xd.pointer);
+    }
+
+    [[nodiscard]]
+    inline StringArray clone() const {
+        return _clone<StringArray>();
+    }
+
+    [[nodiscard]]
+    inline StringArray * cloneNew() const {
+        return _cloneNew<StringArray>();
+    }
+
+    [[nodiscard]]
+    std::vector<std::string> getValues() const;
+
+    [[nodiscard]]
+    std::string getValueAt(size_t index) const;
+
+    #ifdef __cpp_lib_string_view
+
+        [[nodiscard]]
+        std::string_view getStringViewAt(size_t index, bool trim = true) const;
+
+        [[nodiscard]]
+        std::vector<std::string_view> getStringViews(bool trim = true) const;
+
+    #endif // __cpp_lib_string_view
+
+    [[nodiscard]]
+    size_t getSize() const;
+
+    inline void setValues(
+        const std::vector<std::string>& values,
+        const std::vector<uint32_t>& dims = {}
+    ) {
+        _setValues(values.data(), values.size(), dims);
+    }
+
+    #ifdef __cpp_lib_string_view
+
+        inline void setValues(
+            const std::vector<std::string_view>& values,
+            const std::vector<uint32_t>& dims = {}
+        ) {
+            _setValues(values.data(), values.size(), dims);
+        }
+
+    #endif // __cpp_lib_string_view
+
+    #ifdef __cpp_lib_span
+
+        inline void setValues(
+            std::span<const std::string> values,
+            const std::vector<uint32_t>& dims = {}
+        ) {
+            _setValues(values.data(), values.size(), dims);
+        }
+
+    #endif
+
+    // STL Compatability
+
+    [[nodiscard]]
+    inline size_t size() const {
+        return getSize();
+    }
+
+    [[nodiscard]]
+    inline size_t empty() const {
+        return getSize() == 0;
+    }
+
+    [[nodiscard]]
+    inline std::string at(size_t index) const {
+        return getValueAt(index);
+    }
+
+    struct Iterator
+    {
+    public:
+
+        Iterator(size_t index, const StringArray * array)
+            : _index(index)
+            , _array(array)
+        { }
+
+        inline std::string operator*() const {
+            return _array->getValueAt(_index);
+        }
+
+        inline Iterator& operator++() {
+            _index++;
+            return *this;
+        }
+
+        inline Iterator operator++(int) {
+            Iterator tmp = *this;
+            ++(*this);
+            return tmp;
+        }
+
+        inline friend bool operator==(const Iterator& a, const Iterator& b) {
+            return (a._index == b._index && a._array == b._array);
+        };
+
+        inline friend bool operator!=(const Iterator& a, const Iterator& b) {
+            return (a._index != b._index || a._array != b._array);
+        };
+
+    private:
+
+        size_t _index;
+
+        const StringArray * _array;
+
+    };
+
+    inline Iterator begin() const {
+        return Iterator(0, this);
+    }
+
+    inline Iterator end() const {
+        return Iterator(getSize(), this);
+    }
+
+protected:
+
+    // Pads every value to the longest and writes them straight into a newly allocated XD
+    template <typename StringType>
+    void _setValues(
+        const StringType * values,
+        size_t count,
+        const std::vector<uint32_t>& dims
+    );
+
+}; // class StringArray
+
+template <>
+inline StringArray Data::releaseAndConvert()
+{
+    mdsdsc_xd_t xd = release();
+    mdsdsc_t * dsc = xd.pointer;
+
+    if (dsc->class_ == CLASS_A && dsc->dtype == DTYPE_T) {
+        return StringArray(std::move(xd), getTree());
+    }
+    else if (dsc->class_ == CLASS_S && dsc->dtype == DTYPE_T) {
+        #ifdef __cpp_lib_string_view
+            return StringArray({ std::string_view(dsc->pointer, dsc->length) });
+        #else
+            return StringArray({ std::string(dsc->pointer, dsc->length) });
+        #endif
+    }
+
+    MdsFree1Dx(&xd, nullptr);
+    throw TdiInvalidDataType();
+}
+
+class Scalar : public Data
+{
+public:
+
+    static constexpr Class __class = Class::S;
+
+    Scalar() = default;
+
+    Scalar(mdsdsc_xd_t && xd, Tree * tree = nullptr)
+        : Data(std::move(xd), tree)
+    { }
+
+protected:
+
+    template <typename CType>
+    Scalar(DType dtype, CType value) {
+        _setValue<CType>(dtype, value);
+    }
+
+    template <typename CType>
+    inline void _setValue(DType dtype, CType value)
+    {
+        static_assert(sizeof(CType) <= InlineSize, "Every scalar type is stored inline");
+        _setInline(dtype_t(dtype), &value, sizeof(CType));
+    }
+
+    template <typename CType>
+    inline CType _getValue() const {
+        mdsdsc_t * dsc = getDescriptor();
+        if (dsc && dsc->pointer) {
+            return *(CType *)dsc->pointer;
+        }
+
+        // TODO: throw something?
+        return {};
+    }
+
+};
+
+class Int8 : public Scalar
+{
+public:
+
+    typedef int8_t __ctype;
+    static constexpr DType __dtype = DType::B;
+
+    Int8() = default;
+
+    Int8(Int8&&) = default;
+    Int8& operator=(Int8&&) = default;
+
+    inline Int8(mdsdsc_xd_t && xd, Tree * tree = nullptr)
+        : Scalar(std::move(xd), tree)
+    { }
+
+    /** Construct a Scalar from a value **/
+    inline Int8(__ctype value)
+        : Scalar(__dtype, value)
+    { }
+
+    inline const char * getClassName() const override {
+        return "Int8";
+    }
+
+    [[nodiscard]]
+    inline Int8 clone() const {
+        return _clone<Int8>();
+    }
+
+    [[nodiscard]]
+    inline Int8 * cloneNew() const {
+        return _cloneNew<Int8>();
+    }
+
+    [[nodiscard]]
+    inline __ctype getValue() const {
+        return _getValue<__ctype>();
+    }
+
+    inline void setValue(__ctype value) {
+        _setValue<__ctype>(__dtype, value);
+    }
+
+}; // class Int8
+
+template <>
+struct is_valid_ctype<Int8::__ctype> : std::true_type { };
+
+template <>
+inline Int8 Data::releaseAndConvert() {
+    return _convertToScalar<Int8>();
+}
+
+template <>
+inline Int8::__ctype Data::getData() const {
+    return getData<Int8>().getValue();
+}
+
+template <>
+inline Data Data::FromScalar(Int8::__ctype value) {
+    return Int8(value);
+}
+
+class UInt8 : public Scalar
+{
+public:
+
+    typedef uint8_t __ctype;
+    static constexpr DType __dtype = DType::BU;
+
+    UInt8() = default;
+
+    UInt8(UInt8&&) = default;
+    UInt8& operator=(UInt8&&) = default;
+
+    inline UInt8(mdsdsc_xd_t && xd, Tree * tree = nullptr)
+        : Scalar(std::move(xd), tree)
+    { }
+
+    /** Construct a Scalar from a value **/
+    inline UInt8(__ctype value)
+        : Scalar(__dtype, value)
+    { }
+
+    inline const char * getClassName() const override {
+        return "UInt8";
+    }
+
+    [[nodiscard]]
+    inline UInt8 clone() const {
+        return _clone<UInt8>();
+    }
+
+    [[nodiscard]]
+    inline UInt8 * cloneNew() const {
+        return _cloneNew<UInt8>();
+    }
+
+    [[nodiscard]]
+    inline __ctype getValue() const {
+        return _getValue<__ctype>();
+    }
+
+    inline void setValue(__ctype value) {
+        _setValue<__ctype>(__dtype, value);
+    }
+
+}; // class UInt8
+
+template <>
+struct is_valid_ctype<UInt8::__ctype> : std::true_type { };
+
+template <>
+inline UInt8 Data::releaseAndConvert() {
+    return _convertToScalar<UInt8>();
+}
+
+template <>
+inline UInt8::__ctype Data::getData() const {
+    return getData<UInt8>().getValue();
+}
+
+template <>
+inline Data Data::FromScalar(UInt8::__ctype value) {
+    return UInt8(value);
+}
+
+class Int16 : public Scalar
+{
+public:
+
+    typedef int16_t __ctype;
+    static constexpr DType __dtype = DType::W;
+
+    Int16() = default;
+
+    Int16(Int16&&) = default;
+    Int16& operator=(Int16&&) = default;
+
+    inline Int16(mdsdsc_xd_t && xd, Tree * tree = nullptr)
+        : Scalar(std::move(xd), tree)
+    { }
+
+    /** Construct a Scalar from a value **/
+    inline Int16(__ctype value)
+        : Scalar(__dtype, value)
+    { }
+
+    inline const char * getClassName() const override {
+        return "Int16";
+    }
+
+    [[nodiscard]]
+    inline Int16 clone() const {
+        return _clone<Int16>();
+    }
+
+    [[nodiscard]]
+    inline Int16 * cloneNew() const {
+        return _cloneNew<Int16>();
+    }
+
+    [[nodiscard]]
+    inline __ctype getValue() const {
+        return _getValue<__ctype>();
+    }
+
+    inline void setValue(__ctype value) {
+        _setValue<__ctype>(__dtype, value);
+    }
+
+}; // class Int16
+
+template <>
+struct is_valid_ctype<Int16::__ctype> : std::true_type { };
+
+template <>
+inline Int16 Data::releaseAndConvert() {
+    return _convertToScalar<Int16>();
+}
+
+template <>
+inline Int16::__ctype Data::getData() const {
+    return getData<Int16>().getValue();
+}
+
+template <>
+inline Data Data::FromScalar(Int16::__ctype value) {
+    return Int16(value);
+}
+
+class UInt16 : public Scalar
+{
+public:
+
+    typedef uint16_t __ctype;
+    static constexpr DType __dtype = DType::WU;
+
+    UInt16() = default;
+
+    UInt16(UInt16&&) = default;
+    UInt16& operator=(UInt16&&) = default;
+
+    inline UInt16(mdsdsc_xd_t && xd, Tree * tree = nullptr)
+        : Scalar(std::move(xd), tree)
+    { }
+
+    /** Construct a Scalar from a value **/
+    inline UInt16(__ctype value)
+        : Scalar(__dtype, value)
+    { }
+
+    inline const char * getClassName() const override {
+        return "UInt16";
+    }
+
+    [[nodiscard]]
+    inline UInt16 clone() const {
+        return _clone<UInt16>();
+    }
+
+    [[nodiscard]]
+    inline UInt16 * cloneNew() const {
+        return _cloneNew<UInt16>();
+    }
+
+    [[nodiscard]]
+    inline __ctype getValue() const {
+        return _getValue<__ctype>();
+    }
+
+    inline void setValue(__ctype value) {
+        _setValue<__ctype>(__dtype, value);
+    }
+
+}; // class UInt16
+
+template <>
+struct is_valid_ctype<UInt16::__ctype> : std::true_type { };
+
+template <>
+inline UInt16 Data::releaseAndConvert() {
+    return _convertToScalar<UInt16>();
+}
+
+template <>
+inline UInt16::__ctype Data::getData() const {
+    return getData<UInt16>().getValue();
+}
+
+template <>
+inline Data Data::FromScalar(UInt16::__ctype value) {
+    return UInt16(value);
+}
+
+class Int32 : public Scalar
+{
+public:
+
+    typedef int32_t __ctype;
+    static constexpr DType __dtype = DType::L;
+
+    Int32() = default;
+
+    Int32(Int32&&) = default;
+    Int32& operator=(Int32&&) = default;
+
+    inline Int32(mdsdsc_xd_t && xd, Tree * tree = nullptr)
+        : Scalar(std::move(xd), tree)
+    { }
+
+    /** Construct a Scalar from a value **/
+    inline Int32(__ctype value)
+        : Scalar(__dtype, value)
+    { }
+
+    inline const char * getClassName() const override {
+        return "Int32";
+    }
+
+    [[nodiscard]]
+    inline Int32 clone() const {
+        return _clone<Int32>();
+    }
+
+    [[nodiscard]]
+    inline Int32 * cloneNew() const {
+        return _cloneNew<Int32>();
+    }
+
+    [[nodiscard]]
+    inline __ctype getValue() const {
+        return _getValue<__ctype>();
+    }
+
+    inline void setValue(__ctype value) {
+        _setValue<__ctype>(__dtype, value);
+    }
+
+}; // class Int32
+
+template <>
+struct is_valid_ctype<Int32::__ctype> : std::true_type { };
+
+template <>
+inline Int32 Data::releaseAndConvert() {
+    return _convertToScalar<Int32>();
+}
+
+template <>
+inline Int32::__ctype Data::getData() const {
+    return getData<Int32>().getValue();
+}
+
+template <>
+inline Data Data::FromScalar(Int32::__ctype value) {
+    return Int32(value);
+}
+
+class UInt32 : public Scalar
+{
+public:
+
+    typedef uint32_t __ctype;
+    static constexpr DType __dtype = DType::LU;
+
+    UInt32() = default;
+
+    UInt32(UInt32&&) = default;
+    UInt32& operator=(UInt32&&) = default;
+
+    inline UInt32(mdsdsc_xd_t && xd, Tree * tree = nullptr)
+        : Scalar(std::move(xd), tree)
+    { }
+
+    /** Construct a Scalar from a value **/
+    inline UInt32(__ctype value)
+        : Scalar(__dtype, value)
+    { }
+
+    inline const char * getClassName() const override {
+        return "UInt32";
+    }
+
+    [[nodiscard]]
+    inline UInt32 clone() const {
+        return _clone<UInt32>();
+    }
+
+    [[nodiscard]]
+    inline UInt32 * cloneNew() const {
+        return _cloneNew<UInt32>();
+    }
+
+    [[nodiscard]]
+    inline __ctype getValue() const {
+        return _getValue<__ctype>();
+    }
+
+    inline void setValue(__ctype value) {
+        _setValue<__ctype>(__dtype, value);
+    }
+
+}; // class UInt32
+
+template <>
+struct is_valid_ctype<UInt32::__ctype> : std::true_type { };
+
+template <>
+inline UInt32 Data::releaseAndConvert() {
+    return _convertToScalar<UInt32>();
+}
+
+template <>
+inline UInt32::__ctype Data::getData() const {
+    return getData<UInt32>().getValue();
+}
+
+template <>
+inline Data Data::FromScalar(UInt32::__ctype value) {
+    return UInt32(value);
+}
+
+class Int64 : public Scalar
+{
+public:
+
+    typedef int64_t __ctype;
+    static constexpr DType __dtype = DType::Q;
+
+    Int64() = default;
+
+    Int64(Int64&&) = default;
+    Int64& operator=(Int64&&) = default;
+
+    inline Int64(mdsdsc_xd_t && xd, Tree * tree = nullptr)
+        : Scalar(std::move(xd), tree)
+    { }
+
+    /** Construct a Scalar from a value **/
+    inline Int64(__ctype value)
+        : Scalar(__dtype, value)
+    { }
+
+    inline const char * getClassName() const override {
+        return "Int64";
+    }
+
+    [[nodiscard]]
+    inline Int64 clone() const {
+        return _clone<Int64>();
+    }
+
+    [[nodiscard]]
+    inline Int64 * cloneNew() const {
+        return _cloneNew<Int64>();
+    }
+
+    [[nodiscard]]
+    inline __ctype getValue() const {
+        return _getValue<__ctype>();
+    }
+
+    inline void setValue(__ctype value) {
+        _setValue<__ctype>(__dtype, value);
+    }
+
+}; // class Int32
+
+template <>
+struct is_valid_ctype<Int64::__ctype> : std::true_type { };
+
+template <>
+inline Int64 Data::releaseAndConvert() {
+    return _convertToScalar<Int64>();
+}
+
+template <>
+inline Int64::__ctype Data::getData() const {
+    return getData<Int64>().getValue();
+}
+
+template <>
+inline Data Data::FromScalar(Int64::__ctype value) {
+    return Int64(value);
+}
+
+class UInt64 : public Scalar
+{
+public:
+
+    typedef uint64_t __ctype;
+    static constexpr DType __dtype = DType::QU;
+
+    UInt64() = default;
+
+    UInt64(UInt64&&) = default;
+    UInt64& operator=(UInt64&&) = default;
+
+    inline UInt64(mdsdsc_xd_t && xd, Tree * tree = nullptr)
+        : Scalar(std::move(xd), tree)
+    { }
+
+    /** Construct a Scalar from a value **/
+    inline UInt64(__ctype value)
+        : Scalar(__dtype, value)
+    { }
+
+    inline const char * getClassName() const override {
+        return "UInt64";
+    }
+
+    [[nodiscard]]
+    inline UInt64 clone() const {
+        return _clone<UInt64>();
+    }
+
+    [[nodiscard]]
+    inline UInt64 * cloneNew() const {
+        return _cloneNew<UInt64>();
+    }
+
+    [[nodiscard]]
+    inline __ctype getValue() const {
+        return _getValue<__ctype>();
+    }
+
+    inline void setValue(__ctype value) {
+        _setValue<__ctype>(__dtype, value);
+    }
+
+}; // class UInt64
+
+template <>
+struct is_valid_ctype<UInt64::__ctype> : std::true_type { };
+
+template <>
+inline UInt64 Data::releaseAndConvert() {
+    return _convertToScalar<UInt64>();
+}
+
+template <>
+inline UInt64::__ctype Data::getData() const {
+    return getData<UInt64>().getValue();
+}
+
+template <>
+inline Data Data::FromScalar(UInt64::__ctype value) {
+    return UInt64(value);
+}
+
+// TODO: Int128 / UInt128 ?
+
+class Float32 : public Scalar
+{
+public:
+
+    typedef float __ctype;
+    static constexpr DType __dtype = DType::FS;
+
+    Float32() = default;
+
+    Float32(Float32&&) = default;
+    Float32& operator=(Float32&&) = default;
+
+    inline Float32(mdsdsc_xd_t && xd, Tree * tree = nullptr)
+        : Scalar(std::move(xd), tree)
+    { }
+
+    /** Construct a Scalar from a value **/
+    inline Float32(__ctype value)
+        : Scalar(__dtype, value)
+    { }
+
+    inline const char * getClassName() const override {
+        return "Float32";
+    }
+
+    [[nodiscard]]
+    inline Float32 clone() const {
+        return _clone<Float32>();
+    }
+
+    [[nodiscard]]
+    inline Float32 * cloneNew() const {
+        return _cloneNew<Float32>();
+    }
+
+    [[nodiscard]]
+    inline __ctype getValue() const {
+        return _getValue<__ctype>();
+    }
+
+    inline void setValue(__ctype value) {
+        _setValue<__ctype>(__dtype, value);
+    }
+
+}; // class Float32
+
+template <>
+struct is_valid_ctype<Float32::__ctype> : std::true_type { };
+
+template <>
+inline Float32 Data::releaseAndConvert() {
+    return _convertToScalar<Float32>();
+}
+
+template <>
+inline Float32::__ctype Data::getData() const {
+    return getData<Float32>().getValue();
+}
+
+template <>
+inline Data Data::FromScalar(Float32::__ctype value) {
+    return Float32(value);
+}
+
+class Float64 : public Scalar
+{
+public:
+
+    typedef double __ctype;
+    static constexpr DType __dtype = DType::FT;
+
+    Float64() = default;
+
+    Float64(Float64&&) = default;
+    Float64& operator=(Float64&&) = default;
+
+    inline Float64(mdsdsc_xd_t && xd, Tree * tree = nullptr)
+        : Scalar(std::move(xd), tree)
+    { }
+
+    /** Construct a Scalar from a value **/
+    inline Float64(__ctype value)
+        : Scalar(__dtype, value)
+    { }
+
+    inline const char * getClassName() const override {
+        return "Float64";
+    }
+
+    [[nodiscard]]
+    inline Float64 clone() const {
+        return _clone<Float64>();
+    }
+
+    [[nodiscard]]
+    inline Float64 * cloneNew() const {
+        return _cloneNew<Float64>();
+    }
+
+    [[nodiscard]]
+    inline __ctype getValue() const {
+        return _getValue<__ctype>();
+    }
+
+    inline void setValue(__ctype value) {
+        _setValue<__ctype>(__dtype, value);
+    }
+
+}; // class Float64
+
+template <>
+struct is_valid_ctype<Float64::__ctype> : std::true_type { };
+
+template <>
+inline Float64 Data::releaseAndConvert() {
+    return _convertToScalar<Float64>();
+}
+
+template <>
+inline Float64::__ctype Data::getData() const {
+    return getData<Float64>().getValue();
+}
+
+template <>
+inline Data Data::FromScalar(Float64::__ctype value) {
+    return Float64(value);
+}
+
+class Complex32 : public Scalar
+{
+public:
+
+    typedef std::complex<float> __ctype;
+    static constexpr DType __dtype = DType::FSC;
+
+    Complex32() = default;
+
+    Complex32(Complex32&&) = default;
+    Complex32& operator=(Complex32&&) = default;
+
+    inline Complex32(mdsdsc_xd_t && xd, Tree * tree = nullptr)
+        : Scalar(std::move(xd), tree)
+    { }
+
+    /** Construct a Scalar from a value **/
+    inline Complex32(__ctype value)
+        : Scalar(__dtype, value)
+    { }
+
+    inline const char * getClassName() const override {
+        return "Complex32";
+    }
+
+    [[nodiscard]]
+    inline Complex32 clone() const {
+        return _clone<Complex32>();
+    }
+
+    [[nodiscard]]
+    inline Complex32 * cloneNew() const {
+        return _cloneNew<Complex32>();
+    }
+
+    [[nodiscard]]
+    inline __ctype getValue() const {
+        return _getValue<__ctype>();
+    }
+
+    inline void setValue(__ctype value) {
+        _setValue<__ctype>(__dtype, value);
+    }
+
+}; // class Complex32
+
+template <>
+struct is_valid_ctype<Complex32::__ctype> : std::true_type { };
+
+template <>
+inline Complex32 Data::releaseAndConvert() {
+    return _convertToScalar<Complex32>();
+}
+
+template <>
+inline Complex32::__ctype Data::getData() const {
+    return getData<Complex32>().getValue();
+}
+
+template <>
+inline Data Data::FromScalar(Complex32::__ctype value) {
+    return Complex32(value);
+}
+
+class Complex64 : public Scalar
+{
+public:
+
+    typedef std::complex<double> __ctype;
+    static constexpr DType __dtype = DType::FTC;
+
+    Complex64() = default;
+
+    Complex64(Complex64&&) = default;
+    Complex64& operator=(Complex64&&) = default;
+
+    inline Complex64(mdsdsc_xd_t && xd, Tree * tree = nullptr)
+        : Scalar(std::move(xd), tree)
+    { }
+
+    /** Construct a Scalar from a value **/
+    inline Complex64(__ctype value)
+        : Scalar(__dtype, value)
+    { }
+
+    inline const char * getClassName() const override {
+        return "Complex64";
+    }
+
+    [[nodiscard]]
+    inline Complex64 clone() const {
+        return _clone<Complex64>();
+    }
+
+    [[nodiscard]]
+    inline Complex64 * cloneNew() const {
+        return _cloneNew<Complex64>();
+    }
+
+    [[nodiscard]]
+    inline __ctype getValue() const {
+        return _getValue<__ctype>();
+    }
+
+    inline void setValue(__ctype value) {
+        _setValue<__ctype>(__dtype, value);
+    }
+
+}; // class Complex64
+
+template <>
+struct is_valid_ctype<Complex64::__ctype> : std::true_type { };
+
+template <>
+inline Complex64 Data::releaseAndConvert() {
+    return _convertToScalar<Complex64>();
+}
+
+template <>
+inline Complex64::__ctype Data::getData() const {
+    return getData<Complex64>().getValue();
+}
+
+template <>
+inline Data Data::FromScalar(Complex64::__ctype value) {
+    return Complex64(value);
+}
+
+class Array : public Data
+{
+public:
+
+    static constexpr Class __class = Class::A;
+
+    Array() = default;
+
+    Array(mdsdsc_xd_t && xd, Tree * tree = nullptr)
+        : Data(std::move(xd), tree)
+    { }
+
+    [[nodiscard]]
+    inline mdsdsc_a_t * getArrayDescriptor() const {
+        return reinterpret_cast<mdsdsc_a_t *>(_xd.pointer);
+    }
+
+    [[nodiscard]]
+    std::vector<uint32_t> getDimensions() const;
+
+    [[nodiscard]]
+    inline size_t getSize() const {
+        mdsdsc_a_t * dsc = getArrayDescriptor();
+        if (dsc) {
+            return dsc->arsize / dsc->length;
+        }
+        return 0;
+    }
+
+    // STL Compatability
+
+    inline size_t size() const {
+        return getSize();
+    }
+
+    inline bool empty() const {
+        return (getSize() == 0);
+    }
+
+protected:
+
+    template <typename CType>
+    inline Array(DType dtype, std::initializer_list<CType> values, const std::vector<uint32_t>& dims = {}) {
+        std::vector<CType> tmp(values);
+        _setValues(dtype, tmp, dims);
+    }
+
+    #ifdef __cpp_lib_span
+
+        template <typename CType>
+        inline Array(DType dtype, std::span<const CType> values, const std::vector<uint32_t>& dims = {}) {
+            _setValues<CType>(dtype, values, dims);
+        }
+
+        template <typename CType>
+        inline Array(DType dtype, const std::vector<CType>& values, const std::vector<uint32_t>& dims = {}) {
+            _setValues<CType>(dtype, std::span(values), dims);
+        }
+
+        template <typename CType>
+        inline void _setValues(DType dtype, std::span<const CType> values, const std::vector<uint32_t>& dims = {}) {
+            if (dims.empty()) {
+                _setValues(dtype, values.data(), values.size());
+            }
+            else {
+                _checkDimensions(values.size(), dims);
+                _setValues(dtype, values.data(), dims.data(), dims.size());
+            }
+        }
+
+        template <typename CType>
+        std::span<CType> _getSpan() const;
+
+    #else
+
+        template <typename CType>
+        inline Array(DType dtype, const std::vector<CType>& values, const std::vector<uint32_t>& dims = {}) {
+            _setValues<CType>(dtype, values, dims);
+        }
+
+        template <typename CType>
+        inline void _setValues(DType dtype, const std::vector<CType>& values, const std::vector<uint32_t>& dims = {}) {
+            if (dims.empty()) {
+                _setValues(dtype, values.data(), values.size());
+            }
+            else {
+                _checkDimensions(values.size(), dims);
+                _setValues(dtype, values.data(), dims.data(), dims.size());
+            }
+        }
+
+    #endif
+
+    // The dimensions must describe exactly count values, or _setValues() would read past the end
+    static inline void _checkDimensions(size_t count, const std::vector<uint32_t>& dims) {
+        size_t expected = 1;
+        for (uint32_t dim : dims) {
+            expected *= dim;
+        }
+
+        if (count != expected) {
+            throwException(TreeFAILURE);
+        }
+    }
+
+    template <typename CType>
+    inline void _setValues(DType dtype, const CType * values, uint32_t count) {
+        _setValues(dtype, values, &count, 1);
+    }
+
+    template <typename CType>
+    void _setValues(DType dtype, const CType * values, const uint32_t * dims, dimct_t dimCount);
+
+    template <typename CType>
+    std::vector<CType> _getValues() const;
+
+    template <typename CType>
+    const CType& _getValueAt(size_t index) const;
+
+    // STL Compatability
+
+    template <typename CType>
+    inline const CType& _at(size_t index) const {
+        return _getValueAt<CType>(index);
+    }
+
+    template <typename CType>
+    const CType& _front() const;
+
+    template <typename CType>
+    const CType& _back() const;
+
+    template <typename CType>
+    CType * _begin() const;
+
+    template <typename CType>
+    CType * _end() const;
+
+}; // class Array
+
+#ifdef __cpp_lib_span
+
+#else
+
+#endif // __cpp_lib_span
 
-    template <typename CType,
-        typename std::enable_if<is_valid_ctype<CType>::value, bool>::type = true>
-    inline DataView(const CType& value)
-        : _dsc(array_coeff{
-            .length = sizeof(CType),
-            .dtype = _getDTypeForCType<CType>(),
-            .class_ = CLASS_S,
-            .pointer = const_cast<char *>(reinterpret_cast<const char *>(&value)),
-        })
+class Int8Array : public Array
+{
+public:
+
+    typedef int8_t __ctype;
+    static constexpr DType __dtype = DType::B;
+
+    Int8Array() = default;
+
+    Int8Array(Int8Array &&) = default;
+    Int8Array &operator=(Int8Array &&) = default;
+
+    inline Int8Array(mdsdsc_xd_t &&xd, Tree *tree = nullptr)
+        : Array(std::move(xd), tree)
     { }
 
-    // TODO: Improve?
-    #ifdef __cpp_lib_string_view
+    inline Int8Array(
+        std::initializer_list<__ctype> values,
+        const std::vector<uint32_t> &dims = {}
+    )
+        : Array(__dtype, std::vector<__ctype>(values.begin(), values.end()), dims)
+    { }
 
-        inline DataView(std::string_view value)
-            : _dsc(array_coeff{
-                .length = length_t(value.size()),
-                .dtype = DTYPE_T,
-                .class_ = CLASS_S,
-                .pointer = const_cast<char *>(value.data()),
-            })
-        { }
+    inline const char * getClassName() const override {
+        return "Int8Array";
+    }
 
-    #else
+    [[nodiscard]]
+    inline Int8Array clone() const {
+        return _clone<Int8Array>();
+    }
 
-        inline DataView(const char * value)
-            : _dsc(array_coeff{
-                .length = length_t(strlen(value)),
-                .dtype = DTYPE_T,
-                .class_ = CLASS_S,
-                .pointer = const_cast<char *>(value),
-            })
-        { }
+    [[nodiscard]]
+    inline Int8Array * cloneNew() const {
+        return _cloneNew<Int8Array>();
+    }
 
-        inline DataView(const std::string& value)
-            : _dsc(array_coeff{
-                .length = length_t(value.size()),
-                .dtype = DTYPE_T,
-                .class_ = CLASS_S,
-                .pointer = const_cast<char *>(value.data()),
-            })
-        { }
+    [[nodiscard]]
+    inline std::vector<__ctype> getValues() const {
+        return _getValues<__ctype>();
+    }
 
-    #endif // __cpp_lib_string_view
+    [[nodiscard]]
+    inline const __ctype &getValueAt(size_t index) const {
+        return _getValueAt<__ctype>(index);
+    }
 
-    inline DataView(const TreeNode& node)
-        : _dsc(array_coeff{
-            .length = sizeof(node._nid),
-            .dtype = DTYPE_NID,
-            .class_ = CLASS_S,
-            .pointer = const_cast<char *>(reinterpret_cast<const char *>(&node._nid)),
-        })
-        , _tree(node._tree)
-    { }
+    [[nodiscard]]
+    inline const __ctype &operator[](size_t index) const {
+        return _getValueAt<__ctype>(index);
+    }
 
-private:
+    [[nodiscard]]
+    inline const __ctype& at(size_t index) const {
+        return _at<__ctype>(index);
+    }
 
-    array_coeff _dsc = MDSDSC_XD_INITIALIZER;
+    inline void setValues(const __ctype *values, uint32_t count) {
+        _setValues(__dtype, values, count);
+    }
 
-    Tree * _tree = nullptr;
+    void setValues(
+        const __ctype *values,
+        const uint32_t *dims,
+        dimct_t dimCount
+    ) {
+        _setValues(__dtype, values, dims, dimCount);
+    }
 
-    template <typename CType>
-    inline dtype_t _getDTypeForCType()
-    {
-        std::type_index id = typeid(CType);
-        if (id == typeid(int8_t)) {
-            return DTYPE_B;
-        }
-        else if (id == typeid(int16_t)) {
-            return DTYPE_W;
-        }
-        else if (id == typeid(int32_t)) {
-            return DTYPE_L;
-        }
-        else if (id == typeid(int64_t)) {
-            return DTYPE_Q;
-        }
-        else if (id == typeid(uint8_t)) {
-            return DTYPE_BU;
-        }
-        else if (id == typeid(uint16_t)) {
-            return DTYPE_WU;
-        }
-        else if (id == typeid(uint32_t)) {
-            return DTYPE_LU;
-        }
-        else if (id == typeid(uint64_t)) {
-            return DTYPE_QU;
-        }
-        else if (id == typeid(float)) {
-            return DTYPE_FS;
+    [[nodiscard]]
+    inline const __ctype& front() const {
+        return _front<__ctype>();
+    }
+
+    [[nodiscard]]
+    inline const __ctype& back() const {
+        return _back<__ctype>();
+    }
+
+    [[nodiscard]]
+    inline __ctype * begin() const {
+        return _begin<__ctype>();
+    }
+
+    [[nodiscard]]
+    inline __ctype * end() const {
+        return _end<__ctype>();
+    }
+
+    #ifdef __cpp_lib_span
+
+        inline Int8Array(
+            std::span<const __ctype> values,
+            const std::vector<uint32_t>& dims = {}
+        )
+            : Array(__dtype, values, dims)
+        { }
+
+        inline void setValues(
+            std::span<const __ctype> values,
+            const std::vector<uint32_t>& dims = {}
+        ) {
+            _setValues<__ctype>(__dtype, values, dims);
         }
-        else if (id == typeid(double)) {
-            return DTYPE_FT;
+
+        inline Int8Array(
+            const std::vector<__ctype> &values,
+            const std::vector<uint32_t> &dims = {}
+        )
+            : Array(__dtype, std::span(values), dims)
+        { }
+
+        inline void setValues(
+            const std::vector<__ctype> &values,
+            const std::vector<uint32_t> &dims = {}
+        ) {
+            _setValues<__ctype>(__dtype, std::span(values), dims);
         }
-        else if (id == typeid(std::complex<float>)) {
-            return DTYPE_FSC;
+
+        inline std::span<__ctype> getSpan() const {
+            return _getSpan<__ctype>();
         }
-        else if (id == typeid(std::complex<double>)) {
-            return DTYPE_FTC;
+
+    #else
+
+        inline Int8Array(
+            const std::vector<__ctype> &values,
+            const std::vector<uint32_t> &dims = {}
+        )
+            : Array(__dtype, values, dims)
+        { }
+
+        inline void setValues(
+            const std::vector<__ctype> &values,
+            const std::vector<uint32_t> &dims = {}
+        ) {
+            _setValues(__dtype, values, dims);
         }
 
-        return DTYPE_MISSING;
-    };
+    #endif
 
-};
+    template <typename ResultType = Data>
+    [[nodiscard]]
+    ResultType deserialize();
 
-class String : public Data
+}; // class Int8Array
+
+class UInt8Array : public Array
 {
 public:
 
-    static constexpr Class __class = Class::S;
-    static constexpr DType __dtype = DType::T;
+    typedef uint8_t __ctype;
+    static constexpr DType __dtype = DType::BU;
 
-    String() = default;
+    UInt8Array() = default;
 
-    String(mdsdsc_xd_t && xd, Tree * tree = nullptr)
-        : Data(std::move(xd), tree)
+    UInt8Array(UInt8Array &&) = default;
+    UInt8Array &operator=(UInt8Array &&) = default;
+
+    inline UInt8Array(mdsdsc_xd_t &&xd, Tree *tree = nullptr)
+        : Array(std::move(xd), tree)
     { }
 
-    #ifdef __cpp_lib_string_view
+    inline UInt8Array(
+        std::initializer_list<__ctype> values,
+        const std::vector<uint32_t> &dims = {}
+    )
+        : Array(__dtype, std::vector<__ctype>(values.begin(), values.end()), dims)
+    { }
 
-        inline String(std::string_view value) {
-            setValue(value);
-        }
+    inline const char * getClassName() const override {
+        return "UInt8Array";
+    }
 
-    #else
+    [[nodiscard]]
+    inline UInt8Array clone() const {
+        return _clone<UInt8Array>();
+    }
 
-        inline String(const std::string& value) {
-            setValue(value);
-        }
+    [[nodiscard]]
+    inline UInt8Array * cloneNew() const {
+        return _cloneNew<UInt8Array>();
+    }
 
-    #endif // __cpp_lib_string_view
+    [[nodiscard]]
+    inline std::vector<__ctype> getValues() const {
+        return _getValues<__ctype>();
+    }
 
-    inline String(const char *value, length_t length) {
-        setValue(value, length);
+    [[nodiscard]]
+    inline const __ctype &getValueAt(size_t index) const {
+        return _getValueAt<__ctype>(index);
+    }
+
+    [[nodiscard]]
+    inline const __ctype &operator[](size_t index) const {
+        return _getValueAt<__ctype>(index);
+    }
+
+    [[nodiscard]]
+    inline const __ctype& at(size_t index) const {
+        return _at<__ctype>(index);
+    }
+
+    inline void setValues(const __ctype *values, uint32_t count) {
+        _setValues(__dtype, values, count);
     }
 
-    String(String&&) = default;
-    String& operator=(String&&) = default;
+    void setValues(
+        const __ctype *values,
+        const uint32_t *dims,
+        dimct_t dimCount
+    ) {
+        _setValues(__dtype, values, dims, dimCount);
+    }
 
     [[nodiscard]]
-    inline String clone() const {
-        return _clone<String>();
+    inline const __ctype& front() const {
+        return _front<__ctype>();
     }
 
     [[nodiscard]]
-    inline String * cloneNew() const {
-        return _cloneNew<String>();
+    inline const __ctype& back() const {
+        return _back<__ctype>();
     }
 
-    inline std::string getValue() const {
-        return getString();
+    [[nodiscard]]
+    inline __ctype * begin() const {
+        return _begin<__ctype>();
     }
 
-    inline std::string getString() const {
-        mdsdsc_t * dsc = getDescriptor();
-        return std::string(dsc->pointer, dsc->length);
+    [[nodiscard]]
+    inline __ctype * end() const {
+        return _end<__ctype>();
     }
 
-    #ifdef __cpp_lib_string_view
+    #ifdef __cpp_lib_span
 
-        // Warning: this will not be null-terminated
-        inline std::string_view getStringView() const {
-            mdsdsc_t * dsc = getDescriptor();
-            return std::string_view(dsc->pointer, dsc->length);
+        inline UInt8Array(
+            std::span<const __ctype> values,
+            const std::vector<uint32_t>& dims = {}
+        )
+            : Array(__dtype, values, dims)
+        { }
+
+        inline void setValues(
+            std::span<const __ctype> values,
+            const std::vector<uint32_t>& dims = {}
+        ) {
+            _setValues<__ctype>(__dtype, values, dims);
         }
 
-    #endif // __cpp_lib_string_view
+        inline UInt8Array(
+            const std::vector<__ctype> &values,
+            const std::vector<uint32_t> &dims = {}
+        )
+            : Array(__dtype, std::span(values), dims)
+        { }
 
-    #ifdef __cpp_lib_string_view
+        inline void setValues(
+            const std::vector<__ctype> &values,
+            const std::vector<uint32_t> &dims = {}
+        ) {
+            _setValues<__ctype>(__dtype, std::span(values), dims);
+        }
 
-        void setValue(std::string_view value) {
-            setValue(value.data(), value.size());
+        inline std::span<__ctype> getSpan() const {
+            return _getSpan<__ctype>();
         }
 
     #else
 
-        void setValue(const std::string& value) {
-            setValue(value.data(), value.size());
+        inline UInt8Array(
+            const std::vector<__ctype> &values,
+            const std::vector<uint32_t> &dims = {}
+        )
+            : Array(__dtype, values, dims)
+        { }
+
+        inline void setValues(
+            const std::vector<__ctype> &values,
+            const std::vector<uint32_t> &dims = {}
+        ) {
+            _setValues(__dtype, values, dims);
         }
 
-    #endif // __cpp_lib_string_view
+    #endif
 
-    void setValue(const char * value, length_t length);
+    template <typename ResultType = Data>
+    [[nodiscard]]
+    ResultType deserialize();
 
-}; // class String
+}; // class Int8Array
 
-// TODO: Decide if to_string(String) should be different
-inline std::string to_string(const String * data) {
-    return data->getString();
-}
+class Int16Array : public Array
+{
+public:
 
-inline std::string to_string(const String& data) {
-    return data.getString();
-}
+    typedef int16_t __ctype;
+    static constexpr DType __dtype = DType::W;
 
-template <>
-inline String Data::releaseAndConvert()
-{
-    mdsdsc_xd_t xd = release();
-    mdsdsc_t * dsc = xd.pointer;
+    Int16Array() = default;
 
-    if (dsc->class_ == CLASS_S && dsc->dtype == DTYPE_T) {
-        return String(std::move(xd), getTree());
-    }
+    Int16Array(Int16Array &&) = default;
+    Int16Array &operator=(Int16Array &&) = default;
 
-    // TODO: Call DATA()?
+    inline Int16Array(mdsdsc_xd_t &&xd, Tree *tree = nullptr)
+        : Array(std::move(xd), tree)
+    { }
 
-    mdsdsc_xd_t xdDeco = MDSDSC_XD_INITIALIZER;
-    int status = _intrinsic(OPC_DECOMPILE, 1, &dsc, &xdDeco);
-    if (IS_NOT_OK(status)) {
-        throwException(status);
+    inline Int16Array(
+        std::initializer_list<__ctype> values,
+        const std::vector<uint32_t> &dims = {}
+    )
+        : Array(__dtype, std::vector<__ctype>(values.begin(), values.end()), dims)
+    { }
+
+    inline const char * getClassName() const override {
+        return "Int16Array";
     }
 
-    MdsFree1Dx(&xd, nullptr);
-    return String(std::move(xdDeco), getTree());
-}
+    [[nodiscard]]
+    inline Int16Array clone() const {
+        return _clone<Int16Array>();
+    }
 
-template <>
-inline std::string Data::getData() const {
-    return getData<String>().getString();
-}
+    [[nodiscard]]
+    inline Int16Array * cloneNew() const {
+        return _cloneNew<Int16Array>();
+    }
 
-template <>
-inline Data Data::FromScalar(const char * value) {
-    return String(value);
-}
+    [[nodiscard]]
+    inline std::vector<__ctype> getValues() const {
+        return _getValues<__ctype>();
+    }
 
-#ifdef __cpp_lib_string_view
+    [[nodiscard]]
+    inline const __ctype &getValueAt(size_t index) const {
+        return _getValueAt<__ctype>(index);
+    }
 
-    template <>
-    inline Data Data::FromScalar(std::string_view value) {
-        return String(value);
+    [[nodiscard]]
+    inline const __ctype &operator[](size_t index) const {
+        return _getValueAt<__ctype>(index);
     }
 
-#else
+    [[nodiscard]]
+    inline const __ctype& at(size_t index) const {
+        return _at<__ctype>(index);
+    }
 
-    template <>
-    inline Data Data::FromScalar(const std::string& value) {
-        return String(value);
+    inline void setValues(const __ctype *values, uint32_t count) {
+        _setValues(__dtype, values, count);
     }
 
-#endif // __cpp_lib_string_view
+    void setValues(
+        const __ctype *values,
+        const uint32_t *dims,
+        dimct_t dimCount
+    ) {
+        _setValues(__dtype, values, dims, dimCount);
+    }
 
-class StringArray : public Data
-{
-public:
+    [[nodiscard]]
+    inline const __ctype& front() const {
+        return _front<__ctype>();
+    }
 
-    static constexpr Class __class = Class::A;
-    static constexpr DType __dtype = DType::T;
+    [[nodiscard]]
+    inline const __ctype& back() const {
+        return _back<__ctype>();
+    }
 
-    StringArray() = default;
+    [[nodiscard]]
+    inline __ctype * begin() const {
+        return _begin<__ctype>();
+    }
 
-    inline StringArray(mdsdsc_xd_t && xd, Tree * tree = nullptr)
-        : Data(std::move(xd), tree)
-    { }
+    [[nodiscard]]
+    inline __ctype * end() const {
+        return _end<__ctype>();
+    }
 
     #ifdef __cpp_lib_span
 
-        inline StringArray(std::span<const std::string> values, const std::vector<uint32_t>& dims = {}) {
-            setValues(values, dims);
+        inline Int16Array(
+            std::span<const __ctype> values,
+            const std::vector<uint32_t>& dims = {}
+        )
+            : Array(__dtype, values, dims)
+        { }
+
+        inline void setValues(
+            std::span<const __ctype> values,
+            const std::vector<uint32_t>& dims = {}
+        ) {
+            _setValues<__ctype>(__dtype, values, dims);
+        }
+
+        inline Int16Array(
+            const std::vector<__ctype> &values,
+            const std::vector<uint32_t> &dims = {}
+        )
+            : Array(__dtype, std::span(values), dims)
+        { }
+
+        inline void setValues(
+            const std::vector<__ctype> &values,
+            const std::vector<uint32_t> &dims = {}
+        ) {
+            _setValues<__ctype>(__dtype, std::span(values), dims);
+        }
+
+        inline std::span<__ctype> getSpan() const {
+            return _getSpan<__ctype>();
         }
 
     #else
 
-        inline StringArray(const std::vector<std::string>& values, const std::vector<uint32_t>& dims = {}) {
-            setValues(values, dims);
+        inline Int16Array(
+            const std::vector<__ctype> &values,
+            const std::vector<uint32_t> &dims = {}
+        )
+            : Array(__dtype, values, dims)
+        { }
+
+        inline void setValues(
+            const std::vector<__ctype> &values,
+            const std::vector<uint32_t> &dims = {}
+        ) {
+            _setValues(__dtype, values, dims);
         }
 
-    #endif // __cpp_lib_span
+    #endif
+
+}; // class Int16Array
+
+class UInt16Array : public Array
+{
+public:
+
+    typedef uint16_t __ctype;
+    static constexpr DType __dtype = DType::WU;
 
-    inline StringArray(std::initializer_list<std::string> values, const std::vector<uint32_t>& dims = {}) {
-        std::vector<std::string> tmp(values);
-        setValues(tmp, dims);
-    }
+    UInt16Array() = default;
 
-    #ifdef __cpp_lib_string_view
+    UInt16Array(UInt16Array &&) = default;
+    UInt16Array &operator=(UInt16Array &&) = default;
 
-        inline StringArray(std::initializer_list<std::string_view> values, const std::vector<uint32_t>& dims = {}) {
-            std::vector<std::string_view> tmp(values);
-            setValues(tmp, dims);
-        }
+    inline UInt16Array(mdsdsc_xd_t &&xd, Tree *tree = nullptr)
+        : Array(std::move(xd), tree)
+    { }
 
-    #endif // __cpp_lib_string_view
+    inline UInt16Array(
+        std::initializer_list<__ctype> values,
+        const std::vector<uint32_t> &dims = {}
+    )
+        : Array(__dtype, std::vector<__ctype>(values.begin(), values.end()), dims)
+    { }
 
-    StringArray(StringArray&&) = default;
-    StringArray& operator=(StringArray&&) = default;
+    inline const char * getClassName() const override {
+        return "UInt16Array";
+    }
 
     [[nodiscard]]
-    inline mdsdsc_a_t * getArrayDescriptor() const {
-        return reinterpret_cast<mdsdsc_a_t *>(_xd.pointer);
+    inline UInt16Array clone() const {
+        return _clone<UInt16Array>();
     }
 
     [[nodiscard]]
-    inline StringArray clone() const {
-        return _clone<StringArray>();
+    inline UInt16Array * cloneNew() const {
+        return _cloneNew<UInt16Array>();
     }
 
     [[nodiscard]]
-    inline StringArray * cloneNew() const {
-        return _cloneNew<StringArray>();
+    inline std::vector<__ctype> getValues() const {
+        return _getValues<__ctype>();
     }
 
     [[nodiscard]]
-    std::vector<std::string> getValues() const;
+    inline const __ctype &getValueAt(size_t index) const {
+        return _getValueAt<__ctype>(index);
+    }
 
     [[nodiscard]]
-    std::string getValueAt(size_t index) const;
+    inline const __ctype &operator[](size_t index) const {
+        return _getValueAt<__ctype>(index);
+    }
 
     [[nodiscard]]
-    size_t getSize() const;
-
-    void setValues(
-        const std::vector<std::string>& values,
-        const std::vector<uint32_t>& dims = {}
-    );
-
-    #ifdef __cpp_lib_string_view
-
-        void setValues(
-            const std::vector<std::string_view>& values,
-            const std::vector<uint32_t>& dims = {}
-        );
-
-    #endif // __cpp_lib_string_view
-
-    #ifdef __cpp_lib_span
+    inline const __ctype& at(size_t index) const {
+        return _at<__ctype>(index);
+    }
 
-        inline void setValues(
-            std::span<const std::string> values,
-            const std::vector<uint32_t>& dims = {}
-        ) {
-            setValues(values, dims);
-        }
+    inline void setValues(const __ctype *values, uint32_t count) {
+        _setValues(__dtype, values, count);
+    }
 
-    #endif
+    void setValues(
+        const __ctype *values,
+        const uint32_t *dims,
+        dimct_t dimCount
+    ) {
+        _setValues(__dtype, values, dims, dimCount);
+    }
 
-    // STL Compatability
+    [[nodiscard]]
+    inline const __ctype& front() const {
+        return _front<__ctype>();
+    }
 
     [[nodiscard]]
-    inline size_t size() const {
-        return getSize();
+    inline const __ctype& back() const {
+        return _back<__ctype>();
     }
 
     [[nodiscard]]
-    inline size_t empty() const {
-        return getSize() == 0;
+    inline __ctype * begin() const {
+        return _begin<__ctype>();
     }
 
     [[nodiscard]]
-    inline std::string at(size_t index) const {
-        return getValueAt(index);
+    inline __ctype * end() const {
+        return _end<__ctype>();
     }
 
-    struct Iterator
-    {
-    public:
+    #ifdef __cpp_lib_span
 
-        Iterator(size_t index, const StringArray * array)
-            : _index(index)
-            , _array(array)
+        inline UInt16Array(
+            std::span<const __ctype> values,
+            const std::vector<uint32_t>& dims = {}
+        )
+            : Array(__dtype, values, dims)
         { }
 
-        inline std::string operator*() const {
-            return _array->getValueAt(_index);
+        inline void setValues(
+            std::span<const __ctype> values,
+            const std::vector<uint32_t>& dims = {}
+        ) {
+            _setValues<__ctype>(__dtype, values, dims);
         }
 
-        inline Iterator& operator++() {
-            _index++;
-            return *this;
-        }
+        inline UInt16Array(
+            const std::vector<__ctype> &values,
+            const std::vector<uint32_t> &dims = {}
+        )
+            : Array(__dtype, std::span(values), dims)
+        { }
 
-        inline Iterator operator++(int) {
-            Iterator tmp = *this;
-            ++(*this);
-            return tmp;
+        inline void setValues(
+            const std::vector<__ctype> &values,
+            const std::vector<uint32_t> &dims = {}
+        ) {
+            _setValues<__ctype>(__dtype, std::span(values), dims);
         }
 
-        inline friend bool operator==(const Iterator& a, const Iterator& b) {
-            return (a._index == b._index && a._array == b._array);
-        };
-
-        inline friend bool operator!=(const Iterator& a, const Iterator& b) {
-            return (a._index != b._index || a._array != b._array);
-        };
-
-    private:
-
-        size_t _index;
-
-        const StringArray * _array;
-
-    };
-
-    inline Iterator begin() const {
-        return Iterator(0, this);
-    }
-
-    inline Iterator end() const {
-        return Iterator(getSize(), this);
-    }
-
-protected:
+        inline std::span<__ctype> getSpan() const {
+            return _getSpan<__ctype>();
+        }
 
-    void _setValues(
-        const std::string& buffer,
-        length_t length,
-        const std::vector<uint32_t>& dims
-    );
+    #else
 
-}; // class StringArray
+        inline UInt16Array(
+            const std::vector<__ctype> &values,
+            const std::vector<uint32_t> &dims = {}
+        )
+            : Array(__dtype, values, dims)
+        { }
 
-template <>
-inline StringArray Data::releaseAndConvert()
-{
-    mdsdsc_xd_t xd = release();
-    mdsdsc_t * dsc = xd.pointer;
+        inline void setValues(
+            const std::vector<__ctype> &values,
+            const std::vector<uint32_t> &dims = {}
+        ) {
+            _setValues(__dtype, values, dims);
+        }
 
-    if (dsc->class_ == CLASS_A && dsc->dtype == DTYPE_T) {
-        return StringArray(std::move(xd), getTree());
-    }
-    else if (dsc->class_ == CLASS_S && dsc->dtype == DTYPE_T) {
-        #ifdef __cpp_lib_string_view
-            return StringArray({ std::string_view(dsc->pointer, dsc->length) });
-        #else
-            return StringArray({ std::string(dsc->pointer, dsc->length) });
-        #endif
-    }
+    #endif
 
-    MdsFree1Dx(&xd, nullptr);
-    throw TdiInvalidDataType();
-}
+}; // class UInt16Array
 
-class Scalar : public Data
+class Int32Array : public Array
 {
 public:
 
-    static constexpr Class __class = Class::S;
-
-    Scalar() = default;
-
-    Scalar(mdsdsc_xd_t && xd, Tree * tree = nullptr)
-        : Data(std::move(xd), tree)
-    { }
-
-protected:
-
-    template <typename CType>
-    Scalar(DType dtype, CType value) {
-        _setValue<CType>(dtype, value);
-    }
-
-    template <typename CType>
-    inline void _setValue(DType dtype, CType value)
-    {
-        int status;
+    typedef int32_t __ctype;
+    static constexpr DType __dtype = DType::L;
 
-        mdsdsc_s_t dsc = {
-            .length = sizeof(CType),
-            .dtype = dtype_t(dtype),
-            .class_ = class_t(__class),
-            .pointer = (char *)&value,
-        };
+    Int32Array() = default;
 
-        status = MdsCopyDxXd((mdsdsc_t *)&dsc, &_xd);
-        if (IS_NOT_OK(status)) {
-            throwException(status);
-        }
-    }
+    Int32Array(Int32Array &&) = default;
+    Int32Array &operator=(Int32Array &&) = default;
 
-    template <typename CType>
-    inline CType _getValue() const {
-        mdsdsc_t * dsc = getDescriptor();
-        if (dsc && dsc->pointer) {
-            return *(CType *)dsc->pointer;
-        }
+    inline Int32Array(mdsdsc_xd_t &&xd, Tree *tree = nullptr)
+        : Array(std::move(xd), tree)
+    { }
 
-        // TODO: throw something?
-        return {};
+    inline Int32Array(
+        std::initializer_list<__ctype> values,
+        const std::vector<uint32_t> &dims = {}
+    )
+        : Array(__dtype, std::vector<__ctype>(values.begin(), values.end()), dims)
+    { }
+
+    inline const char * getClassName() const override {
+        return "Int32Array";
     }
 
-};
+    [[nodiscard]]
+    inline Int32Array clone() const {
+        return _clone<Int32Array>();
+    }
 
-class Int8 : public Scalar
-{
-public:
+    [[nodiscard]]
+    inline Int32Array * cloneNew() const {
+        return _cloneNew<Int32Array>();
+    }
 
-    typedef int8_t __ctype;
-    static constexpr DType __dtype = DType::B;
+    [[nodiscard]]
+    inline std::vector<__ctype> getValues() const {
+        return _getValues<__ctype>();
+    }
 
-    Int8() = default;
+    [[nodiscard]]
+    inline const __ctype &getValueAt(size_t index) const {
+        return _getValueAt<__ctype>(index);
+    }
 
-    Int8(Int8&&) = default;
-    Int8& operator=(Int8&&) = default;
+    [[nodiscard]]
+    inline const __ctype &operator[](size_t index) const {
+        return _getValueAt<__ctype>(index);
+    }
 
-    inline Int8(mdsdsc_xd_t && xd, Tree * tree = nullptr)
-        : Scalar(std::move(xd), tree)
-    { }
+    [[nodiscard]]
+    inline const __ctype& at(size_t index) const {
+        return _at<__ctype>(index);
+    }
 
-    /** Construct a Scalar from a value **/
-    inline Int8(__ctype value)
-        : Scalar(__dtype, value)
-    { }
+    inline void setValues(const __ctype *values, uint32_t count) {
+        _setValues(__dtype, values, count);
+    }
 
-    inline const char * getClassName() const override {
-        return "Int8";
+    void setValues(
+        const __ctype *values,
+        const uint32_t *dims,
+        dimct_t dimCount
+    ) {
+        _setValues(__dtype, values, dims, dimCount);
     }
 
     [[nodiscard]]
-    inline Int8 clone() const {
-        return _clone<Int8>();
+    inline const __ctype& front() const {
+        return _front<__ctype>();
     }
 
     [[nodiscard]]
-    inline Int8 * cloneNew() const {
-        return _cloneNew<Int8>();
+    inline const __ctype& back() const {
+        return _back<__ctype>();
     }
 
     [[nodiscard]]
-    inline __ctype getValue() const {
-        return _getValue<__ctype>();
+    inline __ctype * begin() const {
+        return _begin<__ctype>();
     }
 
-    inline void setValue(__ctype value) {
-        _setValue<__ctype>(__dtype, value);
+    [[nodiscard]]
+    inline __ctype * end() const {
+        return _end<__ctype>();
     }
 
-}; // class Int8
+    #ifdef __cpp_lib_span
 
-template <>
-struct is_valid_ctype<Int8::__ctype> : std::true_type { };
+        inline Int32Array(
+            std::span<const __ctype> values,
+            const std::vector<uint32_t>& dims = {}
+        )
+            : Array(__dtype, values, dims)
+        { }
 
-template <>
-inline Int8 Data::releaseAndConvert() {
-    return _convertToScalar<Int8>();
-}
+        inline void setValues(
+            std::span<const __ctype> values,
+            const std::vector<uint32_t>& dims = {}
+        ) {
+            _setValues<__ctype>(__dtype, values, dims);
+        }
 
-template <>
-inline Int8::__ctype Data::getData() const {
-    return getData<Int8>().getValue();
-}
+        inline Int32Array(
+            const std::vector<__ctype> &values,
+            const std::vector<uint32_t> &dims = {}
+        )
+            : Array(__dtype, std::span(values), dims)
+        { }
 
-template <>
-inline Data Data::FromScalar(Int8::__ctype value) {
-    return Int8(value);
-}
+        inline void setValues(
+            const std::vector<__ctype> &values,
+            const std::vector<uint32_t> &dims = {}
+        ) {
+            _setValues<__ctype>(__dtype, std::span(values), dims);
+        }
 
-class UInt8 : public Scalar
+        inline std::span<__ctype> getSpan() const {
+            return _getSpan<__ctype>();
+        }
+
+    #else
+
+        inline Int32Array(
+            const std::vector<__ctype> &values,
+            const std::vector<uint32_t> &dims = {}
+        )
+            : Array(__dtype, values, dims)
+        { }
+
+        inline void setValues(
+            const std::vector<__ctype> &values,
+            const std::vector<uint32_t> &dims = {}
+        ) {
+            _setValues(__dtype, values, dims);
+        }
+
+    #endif
+
+}; // class Int32Array
+
+class UInt32Array : public Array
 {
 public:
 
-    typedef uint8_t __ctype;
-    static constexpr DType __dtype = DType::BU;
+    typedef uint32_t __ctype;
+    static constexpr DType __dtype = DType::LU;
 
-    UInt8() = default;
+    UInt32Array() = default;
 
-    UInt8(UInt8&&) = default;
-    UInt8& operator=(UInt8&&) = default;
+    UInt32Array(UInt32Array &&) = default;
+    UInt32Array &operator=(UInt32Array &&) = default;
 
-    inline UInt8(mdsdsc_xd_t && xd, Tree * tree = nullptr)
-        : Scalar(std::move(xd), tree)
+    inline UInt32Array(mdsdsc_xd_t &&xd, Tree *tree = nullptr)
+        : Array(std::move(xd), tree)
     { }
 
-    /** Construct a Scalar from a value **/
-    inline UInt8(__ctype value)
-        : Scalar(__dtype, value)
+    inline UInt32Array(
+        std::initializer_list<__ctype> values,
+        const std::vector<uint32_t> &dims = {}
+    )
+        : Array(__dtype, std::vector<__ctype>(values.begin(), values.end()), dims)
     { }
 
     inline const char * getClassName() const override {
-        return "UInt8";
+        return "UInt32Array";
     }
 
     [[nodiscard]]
-    inline UInt8 clone() const {
-        return _clone<UInt8>();
+    inline UInt32Array clone() const {
+        return _clone<UInt32Array>();
     }
 
     [[nodiscard]]
-    inline UInt8 * cloneNew() const {
-        return _cloneNew<UInt8>();
+    inline UInt32Array * cloneNew() const {
+        return _cloneNew<UInt32Array>();
     }
 
     [[nodiscard]]
-    inline __ctype getValue() const {
-        return _getValue<__ctype>();
+    inline std::vector<__ctype> getValues() const {
+        return _getValues<__ctype>();
     }
 
-    inline void setValue(__ctype value) {
-        _setValue<__ctype>(__dtype, value);
+    [[nodiscard]]
+    inline const __ctype &getValueAt(size_t index) const {
+        return _getValueAt<__ctype>(index);
     }
 
-}; // class UInt8
-
-template <>
-struct is_valid_ctype<UInt8::__ctype> : std::true_type { };
-
-template <>
-inline UInt8 Data::releaseAndConvert() {
-    return _convertToScalar<UInt8>();
-}
-
-template <>
-inline UInt8::__ctype Data::getData() const {
-    return getData<UInt8>().getValue();
-}
-
-template <>
-inline Data Data::FromScalar(UInt8::__ctype value) {
-    return UInt8(value);
-}
-
-class Int16 : public Scalar
-{
-public:
+    [[nodiscard]]
+    inline const __ctype &operator[](size_t index) const {
+        return _getValueAt<__ctype>(index);
+    }
 
-    typedef int16_t __ctype;
-    static constexpr DType __dtype = DType::W;
+    [[nodiscard]]
+    inline const __ctype& at(size_t index) const {
+        return _at<__ctype>(index);
+    }
 
-    Int16() = default;
+    inline void setValues(const __ctype *values, uint32_t count) {
+        _setValues(__dtype, values, count);
+    }
 
-    Int16(Int16&&) = default;
-    Int16& operator=(Int16&&) = default;
+    void setValues(
+        const __ctype *values,
+        const uint32_t *dims,
+        dimct_t dimCount
+    ) {
+        _setValues(__dtype, values, dims, dimCount);
+    }
 
-    inline Int16(mdsdsc_xd_t && xd, Tree * tree = nullptr)
-        : Scalar(std::move(xd), tree)
-    { }
+    [[nodiscard]]
+    inline const __ctype& front() const {
+        return _front<__ctype>();
+    }
 
-    /** Construct a Scalar from a value **/
-    inline Int16(__ctype value)
-        : Scalar(__dtype, value)
-    { }
+    [[nodiscard]]
+    inline const __ctype& back() const {
+        return _back<__ctype>();
+    }
 
-    inline const char * getClassName() const override {
-        return "Int16";
+    [[nodiscard]]
+    inline __ctype * begin() const {
+        return _begin<__ctype>();
     }
 
     [[nodiscard]]
-    inline Int16 clone() const {
-        return _clone<Int16>();
+    inline __ctype * end() const {
+        return _end<__ctype>();
     }
 
-    [[nodiscard]]
-    inline Int16 * cloneNew() const {
-        return _cloneNew<Int16>();
-    }
+    #ifdef __cpp_lib_span
+
+        inline UInt32Array(
+            std::span<const __ctype> values,
+            const std::vector<uint32_t>& dims = {}
+        )
+            : Array(__dtype, values, dims)
+        { }
+
+        inline void setValues(
+            std::span<const __ctype> values,
+            const std::vector<uint32_t>& dims = {}
+        ) {
+            _setValues<__ctype>(__dtype, values, dims);
+        }
 
-    [[nodiscard]]
-    inline __ctype getValue() const {
-        return _getValue<__ctype>();
-    }
+        inline UInt32Array(
+            const std::vector<__ctype> &values,
+            const std::vector<uint32_t> &dims = {}
+        )
+            : Array(__dtype, std::span(values), dims)
+        { }
 
-    inline void setValue(__ctype value) {
-        _setValue<__ctype>(__dtype, value);
-    }
+        inline void setValues(
+            const std::vector<__ctype> &values,
+            const std::vector<uint32_t> &dims = {}
+        ) {
+            _setValues<__ctype>(__dtype, std::span(values), dims);
+        }
 
-}; // class Int16
+        inline std::span<__ctype> getSpan() const {
+            return _getSpan<__ctype>();
+        }
 
-template <>
-struct is_valid_ctype<Int16::__ctype> : std::true_type { };
+    #else
 
-template <>
-inline Int16 Data::releaseAndConvert() {
-    return _convertToScalar<Int16>();
-}
+        inline UInt32Array(
+            const std::vector<__ctype> &values,
+            const std::vector<uint32_t> &dims = {}
+        )
+            : Array(__dtype, values, dims)
+        { }
 
-template <>
-inline Int16::__ctype Data::getData() const {
-    return getData<Int16>().getValue();
-}
+        inline void setValues(
+            const std::vector<__ctype> &values,
+            const std::vector<uint32_t> &dims = {}
+        ) {
+            _setValues(__dtype, values, dims);
+        }
 
-template <>
-inline Data Data::FromScalar(Int16::__ctype value) {
-    return Int16(value);
-}
+    #endif
 
-class UInt16 : public Scalar
+}; // class UInt32Array
+
+class Int64Array : public Array
 {
 public:
 
-    typedef uint16_t __ctype;
-    static constexpr DType __dtype = DType::WU;
+    typedef int64_t __ctype;
+    static constexpr DType __dtype = DType::Q;
 
-    UInt16() = default;
+    Int64Array() = default;
 
-    UInt16(UInt16&&) = default;
-    UInt16& operator=(UInt16&&) = default;
+    Int64Array(Int64Array &&) = default;
+    Int64Array &operator=(Int64Array &&) = default;
 
-    inline UInt16(mdsdsc_xd_t && xd, Tree * tree = nullptr)
-        : Scalar(std::move(xd), tree)
+    inline Int64Array(mdsdsc_xd_t &&xd, Tree *tree = nullptr)
+        : Array(std::move(xd), tree)
     { }
 
-    /** Construct a Scalar from a value **/
-    inline UInt16(__ctype value)
-        : Scalar(__dtype, value)
+    inline Int64Array(
+        std::initializer_list<__ctype> values,
+        const std::vector<uint32_t> &dims = {}
+    )
+        : Array(__dtype, std::vector<__ctype>(values.begin(), values.end()), dims)
     { }
 
     inline const char * getClassName() const override {
-        return "UInt16";
+        return "Int64Array";
     }
 
     [[nodiscard]]
-    inline UInt16 clone() const {
-        return _clone<UInt16>();
+    inline Int64Array clone() const {
+        return _clone<Int64Array>();
     }
 
     [[nodiscard]]
-    inline UInt16 * cloneNew() const {
-        return _cloneNew<UInt16>();
+    inline Int64Array * cloneNew() const {
+        return _cloneNew<Int64Array>();
     }
 
     [[nodiscard]]
-    inline __ctype getValue() const {
-        return _getValue<__ctype>();
+    inline std::vector<__ctype> getValues() const {
+        return _getValues<__ctype>();
     }
 
-    inline void setValue(__ctype value) {
-        _setValue<__ctype>(__dtype, value);
+    [[nodiscard]]
+    inline const __ctype &getValueAt(size_t index) const {
+        return _getValueAt<__ctype>(index);
     }
 
-}; // class UInt16
-
-template <>
-struct is_valid_ctype<UInt16::__ctype> : std::true_type { };
-
-template <>
-inline UInt16 Data::releaseAndConvert() {
-    return _convertToScalar<UInt16>();
-}
-
-template <>
-inline UInt16::__ctype Data::getData() const {
-    return getData<UInt16>().getValue();
-}
-
-template <>
-inline Data Data::FromScalar(UInt16::__ctype value) {
-    return UInt16(value);
-}
-
-class Int32 : public Scalar
-{
-public:
-
-    typedef int32_t __ctype;
-    static constexpr DType __dtype = DType::L;
-
-    Int32() = default;
-
-    Int32(Int32&&) = default;
-    Int32& operator=(Int32&&) = default;
+    [[nodiscard]]
+    inline const __ctype &operator[](size_t index) const {
+        return _getValueAt<__ctype>(index);
+    }
 
-    inline Int32(mdsdsc_xd_t && xd, Tree * tree = nullptr)
-        : Scalar(std::move(xd), tree)
-    { }
+    [[nodiscard]]
+    inline const __ctype& at(size_t index) const {
+        return _at<__ctype>(index);
+    }
 
-    /** Construct a Scalar from a value **/
-    inline Int32(__ctype value)
-        : Scalar(__dtype, value)
-    { }
+    inline void setValues(const __ctype *values, uint32_t count) {
+        _setValues(__dtype, values, count);
+    }
 
-    inline const char * getClassName() const override {
-        return "Int32";
+    void setValues(
+        const __ctype *values,
+        const uint32_t *dims,
+        dimct_t dimCount
+    ) {
+        _setValues(__dtype, values, dims, dimCount);
     }
 
     [[nodiscard]]
-    inline Int32 clone() const {
-        return _clone<Int32>();
+    inline const __ctype& front() const {
+        return _front<__ctype>();
     }
 
     [[nodiscard]]
-    inline Int32 * cloneNew() const {
-        return _cloneNew<Int32>();
+    inline const __ctype& back() const {
+        return _back<__ctype>();
     }
 
     [[nodiscard]]
-    inline __ctype getValue() const {
-        return _getValue<__ctype>();
+    inline __ctype * begin() const {
+        return _begin<__ctype>();
     }
 
-    inline void setValue(__ctype value) {
-        _setValue<__ctype>(__dtype, value);
+    [[nodiscard]]
+    inline __ctype * end() const {
+        return _end<__ctype>();
     }
 
-}; // class Int32
+    #ifdef __cpp_lib_span
 
-template <>
-struct is_valid_ctype<Int32::__ctype> : std::true_type { };
+        inline Int64Array(
+            std::span<const __ctype> values,
+            const std::vector<uint32_t>& dims = {}
+        )
+            : Array(__dtype, values, dims)
+        { }
 
-template <>
-inline Int32 Data::releaseAndConvert() {
-    return _convertToScalar<Int32>();
-}
+        inline void setValues(
+            std::span<const __ctype> values,
+            const std::vector<uint32_t>& dims = {}
+        ) {
+            _setValues<__ctype>(__dtype, values, dims);
+        }
 
-template <>
-inline Int32::__ctype Data::getData() const {
-    return getData<Int32>().getValue();
-}
+        inline Int64Array(
+            const std::vector<__ctype> &values,
+            const std::vector<uint32_t> &dims = {}
+        )
+            : Array(__dtype, std::span(values), dims)
+        { }
 
-template <>
-inline Data Data::FromScalar(Int32::__ctype value) {
-    return Int32(value);
-}
+        inline void setValues(
+            const std::vector<__ctype> &values,
+            const std::vector<uint32_t> &dims = {}
+        ) {
+            _setValues<__ctype>(__dtype, std::span(values), dims);
+        }
 
-class UInt32 : public Scalar
+        inline std::span<__ctype> getSpan() const {
+            return _getSpan<__ctype>();
+        }
+
+    #else
+
+        inline Int64Array(
+            const std::vector<__ctype> &values,
+            const std::vector<uint32_t> &dims = {}
+        )
+            : Array(__dtype, values, dims)
+        { }
+
+        inline void setValues(
+            const std::vector<__ctype> &values,
+            const std::vector<uint32_t> &dims = {}
+        ) {
+            _setValues(__dtype, values, dims);
+        }
+
+    #endif
+
+}; // class Int64Array
+
+class UInt64Array : public Array
 {
 public:
 
-    typedef uint32_t __ctype;
-    static constexpr DType __dtype = DType::LU;
-
-    UInt32() = default;
+    typedef uint64_t __ctype;
+    static constexpr DType __dtype = DType::QU;
 
-    UInt32(UInt32&&) = default;
-    UInt32& operator=(UInt32&&) = default;
+    UInt64Array() = default;
 
-    inline UInt32(mdsdsc_xd_t && xd, Tree * tree = nullptr)
-        : Scalar(std::move(xd), tree)
+    UInt64Array(UInt64Array &&) = default;
+    UInt64Array &operator=(UInt64Array &&) = default;
+
+    inline UInt64Array(mdsdsc_xd_t &&xd, Tree *tree = nullptr)
+        : Array(std::move(xd), tree)
     { }
 
-    /** Construct a Scalar from a value **/
-    inline UInt32(__ctype value)
-        : Scalar(__dtype, value)
+    inline UInt64Array(
+        std::initializer_list<__ctype> values,
+        const std::vector<uint32_t> &dims = {}
+    )
+        : Array(__dtype, std::vector<__ctype>(values.begin(), values.end()), dims)
     { }
 
     inline const char * getClassName() const override {
-        return "UInt32";
+        return "UInt64Array";
     }
 
     [[nodiscard]]
-    inline UInt32 clone() const {
-        return _clone<UInt32>();
+    inline UInt64Array clone() const {
+        return _clone<UInt64Array>();
     }
 
     [[nodiscard]]
-    inline UInt32 * cloneNew() const {
-        return _cloneNew<UInt32>();
+    inline UInt64Array * cloneNew() const {
+        return _cloneNew<UInt64Array>();
     }
 
     [[nodiscard]]
-    inline __ctype getValue() const {
-        return _getValue<__ctype>();
+    inline std::vector<__ctype> getValues() const {
+        return _getValues<__ctype>();
     }
 
-    inline void setValue(__ctype value) {
-        _setValue<__ctype>(__dtype, value);
+    [[nodiscard]]
+    inline const __ctype &getValueAt(size_t index) const {
+        return _getValueAt<__ctype>(index);
     }
 
-}; // class UInt32
-
-template <>
-struct is_valid_ctype<UInt32::__ctype> : std::true_type { };
-
-template <>
-inline UInt32 Data::releaseAndConvert() {
-    return _convertToScalar<UInt32>();
-}
-
-template <>
-inline UInt32::__ctype Data::getData() const {
-    return getData<UInt32>().getValue();
-}
-
-template <>
-inline Data Data::FromScalar(UInt32::__ctype value) {
-    return UInt32(value);
-}
-
-class Int64 : public Scalar
-{
-public:
-
-    typedef int64_t __ctype;
-    static constexpr DType __dtype = DType::Q;
-
-    Int64() = default;
-
-    Int64(Int64&&) = default;
-    Int64& operator=(Int64&&) = default;
+    [[nodiscard]]
+    inline const __ctype &operator[](size_t index) const {
+        return _getValueAt<__ctype>(index);
+    }
 
-    inline Int64(mdsdsc_xd_t && xd, Tree * tree = nullptr)
-        : Scalar(std::move(xd), tree)
-    { }
+    [[nodiscard]]
+    inline const __ctype& at(size_t index) const {
+        return _at<__ctype>(index);
+    }
 
-    /** Construct a Scalar from a value **/
-    inline Int64(__ctype value)
-        : Scalar(__dtype, value)
-    { }
+    inline void setValues(const __ctype *values, uint32_t count) {
+        _setValues(__dtype, values, count);
+    }
 
-    inline const char * getClassName() const override {
-        return "Int64";
+    void setValues(
+        const __ctype *values,
+        const uint32_t *dims,
+        dimct_t dimCount
+    ) {
+        _setValues(__dtype, values, dims, dimCount);
     }
 
     [[nodiscard]]
-    inline Int64 clone() const {
-        return _clone<Int64>();
+    inline const __ctype& front() const {
+        return _front<__ctype>();
     }
 
     [[nodiscard]]
-    inline Int64 * cloneNew() const {
-        return _cloneNew<Int64>();
+    inline const __ctype& back() const {
+        return _back<__ctype>();
     }
 
     [[nodiscard]]
-    inline __ctype getValue() const {
-        return _getValue<__ctype>();
+    inline __ctype * begin() const {
+        return _begin<__ctype>();
     }
 
-    inline void setValue(__ctype value) {
-        _setValue<__ctype>(__dtype, value);
+    [[nodiscard]]
+    inline __ctype * end() const {
+        return _end<__ctype>();
     }
 
-}; // class Int32
+    #ifdef __cpp_lib_span
 
-template <>
-struct is_valid_ctype<Int64::__ctype> : std::true_type { };
+        inline UInt64Array(
+            std::span<const __ctype> values,
+            const std::vector<uint32_t>& dims = {}
+        )
+            : Array(__dtype, values, dims)
+        { }
 
-template <>
-inline Int64 Data::releaseAndConvert() {
-    return _convertToScalar<Int64>();
-}
+        inline void setValues(
+            std::span<const __ctype> values,
+            const std::vector<uint32_t>& dims = {}
+        ) {
+            _setValues<__ctype>(__dtype, values, dims);
+        }
 
-template <>
-inline Int64::__ctype Data::getData() const {
-    return getData<Int64>().getValue();
-}
+        inline UInt64Array(
+            const std::vector<__ctype> &values,
+            const std::vector<uint32_t> &dims = {}
+        )
+            : Array(__dtype, std::span(values), dims)
+        { }
 
-template <>
-inline Data Data::FromScalar(Int64::__ctype value) {
-    return Int64(value);
-}
+        inline void setValues(
+            const std::vector<__ctype> &values,
+            const std::vector<uint32_t> &dims = {}
+        ) {
+            _setValues<__ctype>(__dtype, std::span(values), dims);
+        }
 
-class UInt64 : public Scalar
+        inline std::span<__ctype> getSpan() const {
+            return _getSpan<__ctype>();
+        }
+
+    #else
+
+        inline UInt64Array(
+            const std::vector<__ctype> &values,
+            const std::vector<uint32_t> &dims = {}
+        )
+            : Array(__dtype, values, dims)
+        { }
+
+        inline void setValues(
+            const std::vector<__ctype> &values,
+            const std::vector<uint32_t> &dims = {}
+        ) {
+            _setValues(__dtype, values, dims);
+        }
+
+    #endif
+
+}; // class UInt64Array
+
+class Float32Array : public Array
 {
 public:
 
-    typedef uint64_t __ctype;
-    static constexpr DType __dtype = DType::QU;
+    typedef float __ctype;
+    static constexpr DType __dtype = DType::FS;
 
-    UInt64() = default;
+    Float32Array() = default;
 
-    UInt64(UInt64&&) = default;
-    UInt64& operator=(UInt64&&) = default;
+    Float32Array(Float32Array &&) = default;
+    Float32Array &operator=(Float32Array &&) = default;
 
-    inline UInt64(mdsdsc_xd_t && xd, Tree * tree = nullptr)
-        : Scalar(std::move(xd), tree)
+    inline Float32Array(mdsdsc_xd_t &&xd, Tree *tree = nullptr)
+        : Array(std::move(xd), tree)
     { }
 
-    /** Construct a Scalar from a value **/
-    inline UInt64(__ctype value)
-        : Scalar(__dtype, value)
+    inline Float32Array(
+        std::initializer_list<__ctype> values,
+        const std::vector<uint32_t> &dims = {}
+    )
+        : Array(__dtype, std::vector<__ctype>(values.begin(), values.end()), dims)
     { }
 
     inline const char * getClassName() const override {
-        return "UInt64";
+        return "Float32Array";
     }
 
     [[nodiscard]]
-    inline UInt64 clone() const {
-        return _clone<UInt64>();
+    inline Float32Array clone() const {
+        return _clone<Float32Array>();
     }
 
     [[nodiscard]]
-    inline UInt64 * cloneNew() const {
-        return _cloneNew<UInt64>();
+    inline Float32Array * cloneNew() const {
+        return _cloneNew<Float32Array>();
     }
 
     [[nodiscard]]
-    inline __ctype getValue() const {
-        return _getValue<__ctype>();
+    inline std::vector<__ctype> getValues() const {
+        return _getValues<__ctype>();
     }
 
-    inline void setValue(__ctype value) {
-        _setValue<__ctype>(__dtype, value);
+    [[nodiscard]]
+    inline const __ctype &getValueAt(size_t index) const {
+        return _getValueAt<__ctype>(index);
     }
 
-}; // class UInt64
-
-template <>
-struct is_valid_ctype<UInt64::__ctype> : std::true_type { };
-
-template <>
-inline UInt64 Data::releaseAndConvert() {
-    return _convertToScalar<UInt64>();
-}
-
-template <>
-inline UInt64::__ctype Data::getData() const {
-    return getData<UInt64>().getValue();
-}
-
-template <>
-inline Data Data::FromScalar(UInt64::__ctype value) {
-    return UInt64(value);
-}
-
-// TODO: Int128 / UInt128 ?
-
-class Float32 : public Scalar
-{
-public:
-
-    typedef float __ctype;
-    static constexpr DType __dtype = DType::FS;
-
-    Float32() = default;
-
-    Float32(Float32&&) = default;
-    Float32& operator=(Float32&&) = default;
-
-    inline Float32(mdsdsc_xd_t && xd, Tree * tree = nullptr)
-        : Scalar(std::move(xd), tree)
-    { }
+    [[nodiscard]]
+    inline const __ctype &operator[](size_t index) const {
+        return _getValueAt<__ctype>(index);
+    }
 
-    /** Construct a Scalar from a value **/
-    inline Float32(__ctype value)
-        : Scalar(__dtype, value)
-    { }
+    [[nodiscard]]
+    inline const __ctype& at(size_t index) const {
+        return _at<__ctype>(index);
+    }
 
-    inline const char * getClassName() const override {
-        return "Float32";
+    inline void setValues(const __ctype *values, uint32_t count) {
+        _setValues(__dtype, values, count);
+    }
+
+    void setValues(
+        const __ctype *values,
+        const uint32_t *dims,
+        dimct_t dimCount
+    ) {
+        _setValues(__dtype, values, dims, dimCount);
     }
 
     [[nodiscard]]
-    inline Float32 clone() const {
-        return _clone<Float32>();
+    inline const __ctype& front() const {
+        return _front<__ctype>();
     }
 
     [[nodiscard]]
-    inline Float32 * cloneNew() const {
-        return _cloneNew<Float32>();
+    inline const __ctype& back() const {
+        return _back<__ctype>();
     }
 
     [[nodiscard]]
-    inline __ctype getValue() const {
-        return _getValue<__ctype>();
+    inline __ctype * begin() const {
+        return _begin<__ctype>();
     }
 
-    inline void setValue(__ctype value) {
-        _setValue<__ctype>(__dtype, value);
+    [[nodiscard]]
+    inline __ctype * end() const {
+        return _end<__ctype>();
     }
 
-}; // class Float32
+    #ifdef __cpp_lib_span
 
-template <>
-struct is_valid_ctype<Float32::__ctype> : std::true_type { };
+        inline Float32Array(
+            std::span<const __ctype> values,
+            const std::vector<uint32_t>& dims = {}
+        )
+            : Array(__dtype, values, dims)
+        { }
 
-template <>
-inline Float32 Data::releaseAndConvert() {
-    return _convertToScalar<Float32>();
-}
+        inline void setValues(
+            std::span<const __ctype> values,
+            const std::vector<uint32_t>& dims = {}
+        ) {
+            _setValues<__ctype>(__dtype, values, dims);
+        }
 
-template <>
-inline Float32::__ctype Data::getData() const {
-    return getData<Float32>().getValue();
-}
+        inline Float32Array(
+            const std::vector<__ctype> &values,
+            const std::vector<uint32_t> &dims = {}
+        )
+            : Array(__dtype, std::span(values), dims)
+        { }
 
-template <>
-inline Data Data::FromScalar(Float32::__ctype value) {
-    return Float32(value);
-}
+        inline void setValues(
+            const std::vector<__ctype> &values,
+            const std::vector<uint32_t> &dims = {}
+        ) {
+            _setValues<__ctype>(__dtype, std::span(values), dims);
+        }
 
-class Float64 : public Scalar
+        inline std::span<__ctype> getSpan() const {
+            return _getSpan<__ctype>();
+        }
+
+    #else
+
+        inline Float32Array(
+            const std::vector<__ctype> &values,
+            const std::vector<uint32_t> &dims = {}
+        )
+            : Array(__dtype, values, dims)
+        { }
+
+        inline void setValues(
+            const std::vector<__ctype> &values,
+            const std::vector<uint32_t> &dims = {}
+        ) {
+            _setValues(__dtype, values, dims);
+        }
+
+    #endif
+
+}; // class Float32Array
+
+class Float64Array : public Array
 {
 public:
 
     typedef double __ctype;
     static constexpr DType __dtype = DType::FT;
 
-    Float64() = default;
+    Float64Array() = default;
 
-    Float64(Float64&&) = default;
-    Float64& operator=(Float64&&) = default;
+    Float64Array(Float64Array &&) = default;
+    Float64Array &operator=(Float64Array &&) = default;
 
-    inline Float64(mdsdsc_xd_t && xd, Tree * tree = nullptr)
-        : Scalar(std::move(xd), tree)
+    inline Float64Array(mdsdsc_xd_t &&xd, Tree *tree = nullptr)
+        : Array(std::move(xd), tree)
     { }
 
-    /** Construct a Scalar from a value **/
-    inline Float64(__ctype value)
-        : Scalar(__dtype, value)
+    inline Float64Array(
+        std::initializer_list<__ctype> values,
+        const std::vector<uint32_t> &dims = {}
+    )
+        : Array(__dtype, std::vector<__ctype>(values.begin(), values.end()), dims)
     { }
 
     inline const char * getClassName() const override {
-        return "Float64";
+        return "Float64Array";
     }
 
     [[nodiscard]]
-    inline Float64 clone() const {
-        return _clone<Float64>();
+    inline Float64Array clone() const {
+        return _clone<Float64Array>();
     }
 
     [[nodiscard]]
-    inline Float64 * cloneNew() const {
-        return _cloneNew<Float64>();
+    inline Float64Array * cloneNew() const {
+        return _cloneNew<Float64Array>();
     }
 
     [[nodiscard]]
-    inline __ctype getValue() const {
-        return _getValue<__ctype>();
+    inline std::vector<__ctype> getValues() const {
+        return _getValues<__ctype>();
     }
 
-    inline void setValue(__ctype value) {
-        _setValue<__ctype>(__dtype, value);
+    [[nodiscard]]
+    inline const __ctype &getValueAt(size_t index) const {
+        return _getValueAt<__ctype>(index);
     }
 
-}; // class Float64
-
-template <>
-struct is_valid_ctype<Float64::__ctype> : std::true_type { };
-
-template <>
-inline Float64 Data::releaseAndConvert() {
-    return _convertToScalar<Float64>();
-}
-
-template <>
-inline Float64::__ctype Data::getData() const {
-    return getData<Float64>().getValue();
-}
-
-template <>
-inline Data Data::FromScalar(Float64::__ctype value) {
-    return Float64(value);
-}
-
-class Complex32 : public Scalar
-{
-public:
-
-    typedef std::complex<float> __ctype;
-    static constexpr DType __dtype = DType::FSC;
-
-    Complex32() = default;
-
-    Complex32(Complex32&&) = default;
-    Complex32& operator=(Complex32&&) = default;
+    [[nodiscard]]
+    inline const __ctype &operator[](size_t index) const {
+        return _getValueAt<__ctype>(index);
+    }
 
-    inline Complex32(mdsdsc_xd_t && xd, Tree * tree = nullptr)
-        : Scalar(std::move(xd), tree)
-    { }
+    [[nodiscard]]
+    inline const __ctype& at(size_t index) const {
+        return _at<__ctype>(index);
+    }
 
-    /** Construct a Scalar from a value **/
-    inline Complex32(__ctype value)
-        : Scalar(__dtype, value)
-    { }
+    inline void setValues(const __ctype *values, uint32_t count) {
+        _setValues(__dtype, values, count);
+    }
 
-    inline const char * getClassName() const override {
-        return "Complex32";
+    void setValues(
+        const __ctype *values,
+        const uint32_t *dims,
+        dimct_t dimCount
+    ) {
+        _setValues(__dtype, values, dims, dimCount);
     }
 
     [[nodiscard]]
-    inline Complex32 clone() const {
-        return _clone<Complex32>();
+    inline const __ctype& front() const {
+        return _front<__ctype>();
     }
 
     [[nodiscard]]
-    inline Complex32 * cloneNew() const {
-        return _cloneNew<Complex32>();
+    inline const __ctype& back() const {
+        return _back<__ctype>();
     }
 
     [[nodiscard]]
-    inline __ctype getValue() const {
-        return _getValue<__ctype>();
+    inline __ctype * begin() const {
+        return _begin<__ctype>();
     }
 
-    inline void setValue(__ctype value) {
-        _setValue<__ctype>(__dtype, value);
+    [[nodiscard]]
+    inline __ctype * end() const {
+        return _end<__ctype>();
     }
 
-}; // class Complex32
+    #ifdef __cpp_lib_span
 
-template <>
-struct is_valid_ctype<Complex32::__ctype> : std::true_type { };
+        inline Float64Array(
+            std::span<const __ctype> values,
+            const std::vector<uint32_t>& dims = {}
+        )
+            : Array(__dtype, values, dims)
+        { }
+
+        inline void setValues(
+            std::span<const __ctype> values,
+            const std::vector<uint32_t>& dims = {}
+        ) {
+            _setValues<__ctype>(__dtype, values, dims);
+        }
+
+        inline Float64Array(
+            const std::vector<__ctype> &values,
+            const std::vector<uint32_t> &dims = {}
+        )
+            : Array(__dtype, std::span(values), dims)
+        { }
+
+        inline void setValues(
+            const std::vector<__ctype> &values,
+            const std::vector<uint32_t> &dims = {}
+        ) {
+            _setValues<__ctype>(__dtype, std::span(values), dims);
+        }
+
+        inline std::span<__ctype> getSpan() const {
+            return _getSpan<__ctype>();
+        }
+
+    #else
+
+        inline Float64Array(
+            const std::vector<__ctype> &values,
+            const std::vector<uint32_t> &dims = {}
+        )
+            : Array(__dtype, values, dims)
+        { }
 
-template <>
-inline Complex32 Data::releaseAndConvert() {
-    return _convertToScalar<Complex32>();
-}
+        inline void setValues(
+            const std::vector<__ctype> &values,
+            const std::vector<uint32_t> &dims = {}
+        ) {
+            _setValues(__dtype, values, dims);
+        }
 
-template <>
-inline Complex32::__ctype Data::getData() const {
-    return getData<Complex32>().getValue();
-}
+    #endif
 
-template <>
-inline Data Data::FromScalar(Complex32::__ctype value) {
-    return Complex32(value);
-}
+}; // class Float64Array
 
-class Complex64 : public Scalar
+class Complex32Array : public Array
 {
 public:
 
-    typedef std::complex<double> __ctype;
-    static constexpr DType __dtype = DType::FTC;
+    typedef std::complex<float> __ctype;
+    static constexpr DType __dtype = DType::FSC;
 
-    Complex64() = default;
+    Complex32Array() = default;
 
-    Complex64(Complex64&&) = default;
-    Complex64& operator=(Complex64&&) = default;
+    Complex32Array(Complex32Array &&) = default;
+    Complex32Array &operator=(Complex32Array &&) = default;
 
-    inline Complex64(mdsdsc_xd_t && xd, Tree * tree = nullptr)
-        : Scalar(std::move(xd), tree)
+    inline Complex32Array(mdsdsc_xd_t &&xd, Tree *tree = nullptr)
+        : Array(std::move(xd), tree)
     { }
 
-    /** Construct a Scalar from a value **/
-    inline Complex64(__ctype value)
-        : Scalar(__dtype, value)
+    inline Complex32Array(
+        std::initializer_list<__ctype> values,
+        const std::vector<uint32_t> &dims = {}
+    )
+        : Array(__dtype, std::vector<__ctype>(values.begin(), values.end()), dims)
     { }
 
     inline const char * getClassName() const override {
-        return "Complex64";
+        return "Complex32Array";
     }
 
     [[nodiscard]]
-    inline Complex64 clone() const {
-        return _clone<Complex64>();
+    inline Complex32Array clone() const {
+        return _clone<Complex32Array>();
     }
 
     [[nodiscard]]
-    inline Complex64 * cloneNew() const {
-        return _cloneNew<Complex64>();
+    inline Complex32Array * cloneNew() const {
+        return _cloneNew<Complex32Array>();
     }
 
     [[nodiscard]]
-    inline __ctype getValue() const {
-        return _getValue<__ctype>();
+    inline std::vector<__ctype> getValues() const {
+        return _getValues<__ctype>();
     }
 
-    inline void setValue(__ctype value) {
-        _setValue<__ctype>(__dtype, value);
+    [[nodiscard]]
+    inline const __ctype &getValueAt(size_t index) const {
+        return _getValueAt<__ctype>(index);
     }
 
-}; // class Complex64
-
-template <>
-struct is_valid_ctype<Complex64::__ctype> : std::true_type { };
-
-template <>
-inline Complex64 Data::releaseAndConvert() {
-    return _convertToScalar<Complex64>();
-}
-
-template <>
-inline Complex64::__ctype Data::getData() const {
-    return getData<Complex64>().getValue();
-}
-
-template <>
-inline Data Data::FromScalar(Complex64::__ctype value) {
-    return Complex64(value);
-}
-
-class Array : public Data
-{
-public:
-
-    static constexpr Class __class = Class::A;
-
-    Array() = default;
-
-    Array(mdsdsc_xd_t && xd, Tree * tree = nullptr)
-        : Data(std::move(xd), tree)
-    { }
-
     [[nodiscard]]
-    inline mdsdsc_a_t * getArrayDescriptor() const {
-        return reinterpret_cast<mdsdsc_a_t *>(_xd.pointer);
+    inline const __ctype &operator[](size_t index) const {
+        return _getValueAt<__ctype>(index);
     }
 
     [[nodiscard]]
-    std::vector<uint32_t> getDimensions() const;
+    inline const __ctype& at(size_t index) const {
+        return _at<__ctype>(index);
+    }
 
-    [[nodiscard]]
-    inline size_t getSize() const {
-        mdsdsc_a_t * dsc = getArrayDescriptor();
-        if (dsc) {
-            return dsc->arsize / dsc->length;
-        }
-        return 0;
+    inline void setValues(const __ctype *values, uint32_t count) {
+        _setValues(__dtype, values, count);
     }
 
-    // STL Compatability
+    void setValues(
+        const __ctype *values,
+        const uint32_t *dims,
+        dimct_t dimCount
+    ) {
+        _setValues(__dtype, values, dims, dimCount);
+    }
 
-    inline size_t size() const {
-        return getSize();
+    [[nodiscard]]
+    inline const __ctype& front() const {
+        return _front<__ctype>();
     }
 
-    inline bool empty() const {
-        return (getSize() == 0);
+    [[nodiscard]]
+    inline const __ctype& back() const {
+        return _back<__ctype>();
     }
 
-protected:
+    [[nodiscard]]
+    inline __ctype * begin() const {
+        return _begin<__ctype>();
+    }
 
-    template <typename CType>
-    inline Array(DType dtype, std::initializer_list<CType> values, const std::vector<uint32_t>& dims = {}) {
-        std::vector<CType> tmp(values);
-        _setValues(dtype, tmp, dims);
+    [[nodiscard]]
+    inline __ctype * end() const {
+        return _end<__ctype>();
     }
 
     #ifdef __cpp_lib_span
 
-        template <typename CType>
-        inline Array(DType dtype, std::span<const CType> values, const std::vector<uint32_t>& dims = {}) {
-            _setValues<CType>(dtype, values, dims);
-        }
+        inline Complex32Array(
+            std::span<const __ctype> values,
+            const std::vector<uint32_t>& dims = {}
+        )
+            : Array(__dtype, values, dims)
+        { }
 
-        template <typename CType>
-        inline Array(DType dtype, const std::vector<CType>& values, const std::vector<uint32_t>& dims = {}) {
-            _setValues<CType>(dtype, std::span(values), dims);
+        inline void setValues(
+            std::span<const __ctype> values,
+            const std::vector<uint32_t>& dims = {}
+        ) {
+            _setValues<__ctype>(__dtype, values, dims);
         }
 
-        template <typename CType>
-        inline void _setValues(DType dtype, std::span<const CType> values, const std::vector<uint32_t>& dims = {}) {
-            if (dims.empty()) {
-                _setValues(dtype, values.data(), values.size());
-            }
-            else {
-                _setValues(dtype, values.data(), dims.data(), dims.size());
-            }
+        inline Complex32Array(
+            const std::vector<__ctype> &values,
+            const std::vector<uint32_t> &dims = {}
+        )
+            : Array(__dtype, std::span(values), dims)
+        { }
+
+        inline void setValues(
+            const std::vector<__ctype> &values,
+            const std::vector<uint32_t> &dims = {}
+        ) {
+            _setValues<__ctype>(__dtype, std::span(values), dims);
         }
 
-        template <typename CType>
-        std::span<CType> _getSpan() const;
+        inline std::span<__ctype> getSpan() const {
+            return _getSpan<__ctype>();
+        }
 
     #else
 
-        template <typename CType>
-        inline Array(DType dtype, const std::vector<CType>& values, const std::vector<uint32_t>& dims = {}) {
-            _setValues<CType>(dtype, values, dims);
-        }
+        inline Complex32Array(
+            const std::vector<__ctype> &values,
+            const std::vector<uint32_t> &dims = {}
+        )
+            : Array(__dtype, values, dims)
+        { }
 
-        template <typename CType>
-        inline void _setValues(DType dtype, const std::vector<CType>& values, const std::vector<uint32_t>& dims = {}) {
-            if (dims.empty()) {
-                _setValues(dtype, values.data(), values.size());
-            }
-            else {
-                _setValues(dtype, values.data(), dims.data(), dims.size());
-            }
+        inline void setValues(
+            const std::vector<__ctype> &values,
+            const std::vector<uint32_t> &dims = {}
+        ) {
+            _setValues(__dtype, values, dims);
         }
 
     #endif
 
-    template <typename CType>
-    inline void _setValues(DType dtype, const CType * values, uint32_t count) {
-        _setValues(dtype, values, &count, 1);
-    }
-
-    template <typename CType>
-    void _setValues(DType dtype, const CType * values, const uint32_t * dims, dimct_t dimCount);
-
-    template <typename CType>
-    std::vector<CType> _getValues() const;
-
-    template <typename CType>
-    const CType& _getValueAt(size_t index) const;
-
-    // STL Compatability
-
-    template <typename CType>
-    inline const CType& _at(size_t index) const {
-        return _getValueAt<CType>(index);
-    }
-
-    template <typename CType>
-    const CType& _front() const;
-
-    template <typename CType>
-    const CType& _back() const;
-
-    template <typename CType>
-    CType * _begin() const;
-
-    template <typename CType>
-    CType * _end() const;
-
-}; // class Array
-
-#ifdef __cpp_lib_span
-
-#else
-
-#endif // __cpp_lib_span
+}; // class Complex32Array
 
-class Int8Array : public Array
+class Complex64Array : public Array
 {
 public:
 
-    typedef int8_t __ctype;
-    static constexpr DType __dtype = DType::B;
-
-    Int8Array() = default;
+    typedef std::complex<double> __ctype;
+    static constexpr DType __dtype = DType::FTC;
 
-    Int8Array(Int8Array &&) = default;
-    Int8Array &operator=(Int8Array &&) = default;
+    Complex64Array() = default;
 
-    inline Int8Array(mdsdsc_xd_t &&xd, Tree *tree = nullptr)
+    Complex64Array(Complex64Array &&) = default;
+    Complex64Array &operator=(Complex64Array &&) = default;
+
+    inline Complex64Array(mdsdsc_xd_t &&xd, Tree *tree = nullptr)
         : Array(std::move(xd), tree)
     { }
 
-    inline Int8Array(
+    inline Complex64Array(
         std::initializer_list<__ctype> values,
         const std::vector<uint32_t> &dims = {}
     )
@@ -6059,17 +9392,17 @@ public:
     { }
 
     inline const char * getClassName() const override {
-        return "Int8Array";
+        return "Complex64Array";
     }
 
     [[nodiscard]]
-    inline Int8Array clone() const {
-        return _clone<Int8Array>();
+    inline Complex64Array clone() const {
+        return _clone<Complex64Array>();
     }
 
     [[nodiscard]]
-    inline Int8Array * cloneNew() const {
-        return _cloneNew<Int8Array>();
+    inline Complex64Array * cloneNew() const {
+        return _cloneNew<Complex64Array>();
     }
 
     [[nodiscard]]
@@ -6126,7 +9459,7 @@ public:
 
     #ifdef __cpp_lib_span
 
-        inline Int8Array(
+        inline Complex64Array(
             std::span<const __ctype> values,
             const std::vector<uint32_t>& dims = {}
         )
@@ -6140,7 +9473,7 @@ public:
             _setValues<__ctype>(__dtype, values, dims);
         }
 
-        inline Int8Array(
+        inline Complex64Array(
             const std::vector<__ctype> &values,
             const std::vector<uint32_t> &dims = {}
         )
@@ -6160,7 +9493,7 @@ public:
 
     #else
 
-        inline Int8Array(
+        inline Complex64Array(
             const std::vector<__ctype> &values,
             const std::vector<uint32_t> &dims = {}
         )
@@ -6176,3843 +9509,4773 @@ public:
 
     #endif
 
-    template <typename ResultType = Data>
-    [[nodiscard]]
-    ResultType deserialize();
+}; // class Complex64Array
 
-}; // class Int8Array
+#ifdef __cpp_lib_span
 
-class UInt8Array : public Array
+    #define MDSPLUS_ARRAY_CUSTOMIZATION_SPAN(ArrayType)    \
+        template <>                                        \
+        inline Data Data::FromArray(                       \
+            std::span<const ArrayType::__ctype> values,    \
+            const std::vector<uint32_t>& dims /*= {}*/     \
+        ) {                                                \
+            return ArrayType(values, dims);                \
+        }                                                  \
+                                                           \
+        template <>                                        \
+        inline Data Data::FromArray(                       \
+            const std::vector<ArrayType::__ctype>& values, \
+            const std::vector<uint32_t>& dims /*= {}*/     \
+        ) {                                                \
+            return ArrayType(std::span(values), dims);     \
+        }
+
+#else
+
+    #define MDSPLUS_ARRAY_CUSTOMIZATION_SPAN(ArrayType)    \
+                                                           \
+        template <>                                        \
+        inline Data Data::FromArray(                       \
+            const std::vector<ArrayType::__ctype>& values, \
+            const std::vector<uint32_t>& dims /*= {}*/     \
+        ) {                                                \
+            return ArrayType(values, dims);                \
+        }
+
+#endif
+
+#define MDSPLUS_ARRAY_CUSTOMIZATION(ArrayType)                     \
+                                                                   \
+    template <>                                                    \
+    inline ArrayType Data::releaseAndConvert() {                   \
+        return _convertToArray<ArrayType>();                       \
+    }                                                              \
+                                                                   \
+    template <>                                                    \
+    inline std::vector<ArrayType::__ctype> Data::getData() const { \
+        return getData<ArrayType>().getValues();                   \
+    }                                                              \
+                                                                   \
+    MDSPLUS_ARRAY_CUSTOMIZATION_SPAN(ArrayType)
+
+MDSPLUS_ARRAY_CUSTOMIZATION(Int8Array)
+MDSPLUS_ARRAY_CUSTOMIZATION(Int16Array)
+MDSPLUS_ARRAY_CUSTOMIZATION(Int32Array)
+MDSPLUS_ARRAY_CUSTOMIZATION(Int64Array)
+MDSPLUS_ARRAY_CUSTOMIZATION(UInt8Array)
+MDSPLUS_ARRAY_CUSTOMIZATION(UInt16Array)
+MDSPLUS_ARRAY_CUSTOMIZATION(UInt32Array)
+MDSPLUS_ARRAY_CUSTOMIZATION(UInt64Array)
+MDSPLUS_ARRAY_CUSTOMIZATION(Float32Array)
+MDSPLUS_ARRAY_CUSTOMIZATION(Float64Array)
+MDSPLUS_ARRAY_CUSTOMIZATION(Complex32Array)
+MDSPLUS_ARRAY_CUSTOMIZATION(Complex64Array)
+
+class APD : public Array
 {
 public:
 
-    typedef uint8_t __ctype;
-    static constexpr DType __dtype = DType::BU;
-
-    UInt8Array() = default;
+    static constexpr Class __class = Class::APD;
 
-    UInt8Array(UInt8Array &&) = default;
-    UInt8Array &operator=(UInt8Array &&) = default;
+    APD() = default;
 
-    inline UInt8Array(mdsdsc_xd_t &&xd, Tree *tree = nullptr)
-        : Array(std::move(xd), tree)
+    inline APD(mdsdsc_xd_t && dsc, Tree * tree = nullptr)
+        : Array(std::move(dsc), tree)
     { }
 
-    inline UInt8Array(
-        std::initializer_list<__ctype> values,
-        const std::vector<uint32_t> &dims = {}
-    )
-        : Array(__dtype, std::vector<__ctype>(values.begin(), values.end()), dims)
-    { }
+    APD(APD&&) = default;
+    APD& operator=(APD&&) = default;
 
-    inline const char * getClassName() const override {
-        return "UInt8Array";
+    template <typename ...ArgTypes>
+    inline APD(DType dtype, const ArgTypes& ...args) {
+        _append(dtype, args...);
     }
 
-    [[nodiscard]]
-    inline UInt8Array clone() const {
-        return _clone<UInt8Array>();
-    }
+protected:
 
-    [[nodiscard]]
-    inline UInt8Array * cloneNew() const {
-        return _cloneNew<UInt8Array>();
-    }
+    template <typename APDType>
+    friend class APDBuilder;
 
-    [[nodiscard]]
-    inline std::vector<__ctype> getValues() const {
-        return _getValues<__ctype>();
+    inline mdsdsc_t ** _getDescriptorArray() const {
+        return reinterpret_cast<mdsdsc_t **>(getPointer());
     }
 
-    [[nodiscard]]
-    inline const __ctype &getValueAt(size_t index) const {
-        return _getValueAt<__ctype>(index);
-    }
+    template <typename ...ArgTypes>
+    inline void _append(DType dtype, const ArgTypes& ...args)
+    {
+        std::vector<DataView> argList = { DataView(args)... };
 
-    [[nodiscard]]
-    inline const __ctype &operator[](size_t index) const {
-        return _getValueAt<__ctype>(index);
-    }
+        // DataView refers to a Data argument with a DTYPE_DSC, which shouldn't end up in the APD
+        std::vector<mdsdsc_t *> dscList;
+        for (size_t i = 0; i < argList.size(); ++i) {
+            dscList.push_back(_unwrapDescriptor(argList[i].getDescriptor()));
+        }
 
-    [[nodiscard]]
-    inline const __ctype& at(size_t index) const {
-        return _at<__ctype>(index);
+        _append(dtype, dscList);
     }
 
-    inline void setValues(const __ctype *values, uint32_t count) {
-        _setValues(__dtype, values, count);
+    inline void _append(DType dtype, std::vector<mdsdsc_t *> values)
+    {
+        std::vector<mdsdsc_t *> dscList = _getValues<mdsdsc_t *>();
+        dscList.reserve(dscList.size() + values.size());
+        dscList.insert(dscList.end(), values.begin(), values.end());
+
+        DESCRIPTOR_APD(dsc, dtype_t(dtype), dscList.data(), 0);
+
+        // TODO: Replace the 0 above with dscList.size() once a cast to arsize_t is added
+        dsc.arsize = arsize_t(dscList.size() * sizeof(mdsdsc_t *));
+
+        // dscList refers to the old values, which are only freed once they have been copied
+        _copyFrom((mdsdsc_t *)&dsc);
     }
 
-    void setValues(
-        const __ctype *values,
-        const uint32_t *dims,
-        dimct_t dimCount
-    ) {
-        _setValues(__dtype, values, dims, dimCount);
+}; // class APD
+
+class List : public APD
+{
+public:
+
+    static constexpr DType __dtype = DType::List;
+
+    inline List(mdsdsc_xd_t && dsc, Tree * tree = nullptr)
+        : APD(std::move(dsc), tree)
+    { }
+
+    template <typename ...ArgTypes>
+    inline List(const ArgTypes& ...args)
+        : APD(__dtype, args...)
+    { }
+
+    template <typename DataType>
+    inline List(const std::vector<DataType>& values)
+    {
+        std::vector<mdsdsc_t *> dscList;
+        for (size_t i = 0; i < values.size(); ++i) {
+            dscList.push_back(values[i].getDescriptor());
+        }
+
+        _append(__dtype, dscList);
     }
 
-    [[nodiscard]]
-    inline const __ctype& front() const {
-        return _front<__ctype>();
+    inline const char * getClassName() const override {
+        return "List";
     }
 
-    [[nodiscard]]
-    inline const __ctype& back() const {
-        return _back<__ctype>();
+    template <typename ...ArgTypes>
+    inline void append(ArgTypes ...args) {
+        _append(__dtype, args...);
     }
 
-    [[nodiscard]]
-    inline __ctype * begin() const {
-        return _begin<__ctype>();
+    inline std::vector<Data> getValues() const
+    {
+        int status;
+
+        #ifdef __cpp_lib_span
+            std::span<mdsdsc_t *> dscList = _getSpan<mdsdsc_t *>();
+        #else
+            std::vector<mdsdsc_t *> dscList = _getValues<mdsdsc_t *>();
+        #endif
+
+        std::vector<Data> values;
+        for (mdsdsc_t * dsc : dscList) {
+            mdsdsc_xd_t out = MDSDSC_XD_INITIALIZER;
+            status = MdsCopyDxXd(dsc, &out);
+            if (IS_NOT_OK(status)) {
+                throwException(status);
+            }
+
+            values.emplace_back(Data(std::move(out), getTree()));
+        }
+
+        return std::move(values);
     }
 
     [[nodiscard]]
-    inline __ctype * end() const {
-        return _end<__ctype>();
+    inline DataRef operator[](size_t index) const {
+        return DataRef(_getDescriptorArray()[index], getTree());
     }
 
-    #ifdef __cpp_lib_span
+    // STL Compatibility
 
-        inline UInt8Array(
-            std::span<const __ctype> values,
-            const std::vector<uint32_t>& dims = {}
-        )
-            : Array(__dtype, values, dims)
+    struct Iterator
+    {
+    public:
+
+        using iterator_category = std::forward_iterator_tag;
+        using difference_type = std::ptrdiff_t;
+        using value_type = DataRef;
+        using pointer = mdsdsc_t *;
+        using reference = DataRef;
+
+        Iterator(size_t index, const List * list)
+            : _index(index)
+            , _list(list)
         { }
 
-        inline void setValues(
-            std::span<const __ctype> values,
-            const std::vector<uint32_t>& dims = {}
-        ) {
-            _setValues<__ctype>(__dtype, values, dims);
+        inline DataRef operator*() const {
+            return (*_list)[_index];
         }
 
-        inline UInt8Array(
-            const std::vector<__ctype> &values,
-            const std::vector<uint32_t> &dims = {}
-        )
-            : Array(__dtype, std::span(values), dims)
-        { }
+        inline mdsdsc_t * operator->() const {
+            return _list->_getDescriptorArray()[_index];
+        }
 
-        inline void setValues(
-            const std::vector<__ctype> &values,
-            const std::vector<uint32_t> &dims = {}
-        ) {
-            _setValues<__ctype>(__dtype, std::span(values), dims);
+        inline Iterator& operator++() {
+            _index++;
+            return *this;
         }
 
-        inline std::span<__ctype> getSpan() const {
-            return _getSpan<__ctype>();
+        inline Iterator operator++(int) {
+            Iterator tmp = *this;
+            ++(*this);
+            return tmp;
         }
 
-    #else
+        inline friend bool operator==(const Iterator& a, const Iterator& b) {
+            return (a._index == b._index && a._list == b._list);
+        };
 
-        inline UInt8Array(
-            const std::vector<__ctype> &values,
-            const std::vector<uint32_t> &dims = {}
-        )
-            : Array(__dtype, values, dims)
-        { }
+        inline friend bool operator!=(const Iterator& a, const Iterator& b) {
+            return (a._index != b._index || a._list != b._list);
+        };
 
-        inline void setValues(
-            const std::vector<__ctype> &values,
-            const std::vector<uint32_t> &dims = {}
-        ) {
-            _setValues(__dtype, values, dims);
-        }
+    private:
 
-    #endif
+        size_t _index;
 
-    template <typename ResultType = Data>
-    [[nodiscard]]
-    ResultType deserialize();
+        const List * _list;
 
-}; // class Int8Array
+    };
 
-class Int16Array : public Array
-{
-public:
+    inline Iterator begin() const {
+        return Iterator(0, this);
+    }
 
-    typedef int16_t __ctype;
-    static constexpr DType __dtype = DType::W;
+    inline Iterator end() const {
+        return Iterator(getSize(), this);
+    }
 
-    Int16Array() = default;
+}; // class List
 
-    Int16Array(Int16Array &&) = default;
-    Int16Array &operator=(Int16Array &&) = default;
+class Dictionary : public APD
+{
+public:
 
-    inline Int16Array(mdsdsc_xd_t &&xd, Tree *tree = nullptr)
-        : Array(std::move(xd), tree)
-    { }
+    static constexpr DType __dtype = DType::Dictionary;
 
-    inline Int16Array(
-        std::initializer_list<__ctype> values,
-        const std::vector<uint32_t> &dims = {}
-    )
-        : Array(__dtype, std::vector<__ctype>(values.begin(), values.end()), dims)
+    inline Dictionary(mdsdsc_xd_t && dsc, Tree * tree = nullptr)
+        : APD(std::move(dsc), tree)
     { }
 
-    inline const char * getClassName() const override {
-        return "Int16Array";
+    template <typename KeyType, typename ValueType,
+        typename std::enable_if<is_valid_ctype<KeyType>::value, bool>::type = true,
+        typename std::enable_if<is_valid_ctype<ValueType>::value, bool>::type = true>
+    inline Dictionary(const std::map<KeyType, ValueType>& map)
+    {
+        std::vector<Data> values;
+        for (const auto& it : map) {
+            values.emplace_back(Data::FromScalar(it->first));
+            values.emplace_back(Data::FromScalar(it->second));
+        }
     }
 
-    [[nodiscard]]
-    inline Int16Array clone() const {
-        return _clone<Int16Array>();
-    }
+    inline Dictionary(const std::vector<Data>& keys, const std::vector<Data>& values)
+    {
+        assert(keys.size() == values.size());
 
-    [[nodiscard]]
-    inline Int16Array * cloneNew() const {
-        return _cloneNew<Int16Array>();
-    }
+        std::vector<mdsdsc_t *> dscList = _getValues<mdsdsc_t *>();
+        for (size_t i = 0; i < keys.size(); ++i) {
+            dscList.push_back(_unwrapDescriptor(keys[i].getDescriptor()));
+            dscList.push_back(_unwrapDescriptor(values[i].getDescriptor()));
+        }
 
-    [[nodiscard]]
-    inline std::vector<__ctype> getValues() const {
-        return _getValues<__ctype>();
-    }
+        DESCRIPTOR_APD(dsc, dtype_t(__dtype), dscList.data(), 0);
 
-    [[nodiscard]]
-    inline const __ctype &getValueAt(size_t index) const {
-        return _getValueAt<__ctype>(index);
+        // TODO: Replace the 0 above with dscList.size() once a cast to arsize_t is added
+        dsc.arsize = arsize_t(dscList.size() * sizeof(mdsdsc_t *));
+
+        _copyFrom((mdsdsc_t *)&dsc);
     }
 
-    [[nodiscard]]
-    inline const __ctype &operator[](size_t index) const {
-        return _getValueAt<__ctype>(index);
+    template <typename ...ArgTypes,
+        typename std::enable_if<(sizeof...(ArgTypes) % 2) == 0, bool>::type = true>
+    inline Dictionary(const ArgTypes& ...args)
+        : APD(__dtype, args...)
+    { }
+
+    // The index refers to the APD, which moves with it
+    inline Dictionary(Dictionary&& other)
+        : APD(std::move(other))
+        , _index(other._index.exchange(nullptr))
+    { }
+
+    inline Dictionary& operator=(Dictionary&& other)
+    {
+        if (this != &other) {
+            // Frees our index through _onValueReplaced()
+            APD::operator=(std::move(other));
+            _index = other._index.exchange(nullptr);
+        }
+        return *this;
     }
 
-    [[nodiscard]]
-    inline const __ctype& at(size_t index) const {
-        return _at<__ctype>(index);
+    inline ~Dictionary() {
+        delete _index.load();
     }
 
-    inline void setValues(const __ctype *values, uint32_t count) {
-        _setValues(__dtype, values, count);
+    inline const char * getClassName() const override {
+        return "Dictionary";
     }
 
-    void setValues(
-        const __ctype *values,
-        const uint32_t *dims,
-        dimct_t dimCount
-    ) {
-        _setValues(__dtype, values, dims, dimCount);
+    template <typename KeyType, typename ValueType>
+    void append(KeyType key, ValueType value) {
+        _append(__dtype, key, value);
     }
 
     [[nodiscard]]
-    inline const __ctype& front() const {
-        return _front<__ctype>();
+    inline DataRef find(std::string_view key) const {
+        const _Index& index = _getIndex();
+        auto it = index.Strings.find(key);
+        return (it == index.Strings.end() ? DataRef() : _getValueRef(it->second));
     }
 
+    template <typename KeyType,
+        typename std::enable_if<std::is_integral<KeyType>::value, bool>::type = true>
     [[nodiscard]]
-    inline const __ctype& back() const {
-        return _back<__ctype>();
+    inline DataRef find(KeyType key) const {
+        const _Index& index = _getIndex();
+        auto it = index.Integers.find(int64_t(key));
+        return (it == index.Integers.end() ? DataRef() : _getValueRef(it->second));
     }
 
+    template <typename KeyType>
     [[nodiscard]]
-    inline __ctype * begin() const {
-        return _begin<__ctype>();
+    inline bool contains(const KeyType& key) const {
+        return bool(find(key));
     }
 
+    template <typename KeyType>
     [[nodiscard]]
-    inline __ctype * end() const {
-        return _end<__ctype>();
+    inline DataRef operator[](const KeyType& key) const {
+        DataRef value = find(key);
+        if (!value) {
+            throwException(TdiBAD_INDEX);
+        }
+        return value;
     }
 
-    #ifdef __cpp_lib_span
+    inline std::tuple<std::vector<Data>, std::vector<Data>> getKeysAndValues() const {
+        int status;
 
-        inline Int16Array(
-            std::span<const __ctype> values,
-            const std::vector<uint32_t>& dims = {}
-        )
-            : Array(__dtype, values, dims)
-        { }
+        #ifdef __cpp_lib_span
+            std::span<mdsdsc_t *> dscList = _getSpan<mdsdsc_t *>();
+        #else
+            std::vector<mdsdsc_t *> dscList = _getValues<mdsdsc_t *>();
+        #endif
 
-        inline void setValues(
-            std::span<const __ctype> values,
-            const std::vector<uint32_t>& dims = {}
-        ) {
-            _setValues<__ctype>(__dtype, values, dims);
-        }
+        assert((dscList.size() % 2) == 0);
 
-        inline Int16Array(
-            const std::vector<__ctype> &values,
-            const std::vector<uint32_t> &dims = {}
-        )
-            : Array(__dtype, std::span(values), dims)
-        { }
+        std::vector<Data> keys;
+        std::vector<Data> values;
+        for (size_t i = 0; i < dscList.size(); i += 2) {
+            mdsdsc_xd_t outKey = MDSDSC_XD_INITIALIZER;
+            mdsdsc_xd_t outValue = MDSDSC_XD_INITIALIZER;
 
-        inline void setValues(
-            const std::vector<__ctype> &values,
-            const std::vector<uint32_t> &dims = {}
-        ) {
-            _setValues<__ctype>(__dtype, std::span(values), dims);
+            status = MdsCopyDxXd(dscList[i], &outKey);
+            if (IS_NOT_OK(status)) {
+                throwException(status);
+            }
+
+            status = MdsCopyDxXd(dscList[i + 1], &outValue);
+            if (IS_NOT_OK(status)) {
+                throwException(status);
+            }
+
+            keys.emplace_back(std::move(outKey), getTree());
+            values.emplace_back(std::move(outValue), getTree());
         }
 
-        inline std::span<__ctype> getSpan() const {
-            return _getSpan<__ctype>();
+        return { std::move(keys), std::move(values) };
+    }
+
+    template <typename KeyType = Data, typename ValueType = Data,
+        typename std::enable_if<std::is_base_of<Data, KeyType>::value, bool>::type = true,
+        typename std::enable_if<std::is_base_of<Data, ValueType>::value, bool>::type = true>
+    inline std::unordered_map<KeyType, ValueType> getUnorderedMap() const {
+        int status;
+
+        #ifdef __cpp_lib_span
+            std::span<mdsdsc_t *> dscList = _getSpan<mdsdsc_t *>();
+        #else
+            std::vector<mdsdsc_t *> dscList = _getValues<mdsdsc_t *>();
+        #endif
+
+        assert((dscList.size() % 2) == 0);
+
+        std::unordered_map<KeyType, ValueType> values;
+        for (size_t i = 0; i < dscList.size(); i += 2) {
+            mdsdsc_xd_t outKey = MDSDSC_XD_INITIALIZER;
+            mdsdsc_xd_t outValue = MDSDSC_XD_INITIALIZER;
+
+            status = MdsCopyDxXd(dscList[i], &outKey);
+            if (IS_NOT_OK(status)) {
+                throwException(status);
+            }
+
+            status = MdsCopyDxXd(dscList[i + 1], &outValue);
+            if (IS_NOT_OK(status)) {
+                throwException(status);
+            }
+
+            values.emplace(
+                Data(std::move(outKey), getTree()).releaseAndConvert<KeyType>(),
+                Data(std::move(outValue), getTree()).releaseAndConvert<ValueType>()
+            );
         }
 
-    #else
+        return std::move(values);
+    }
 
-        inline Int16Array(
-            const std::vector<__ctype> &values,
-            const std::vector<uint32_t> &dims = {}
-        )
-            : Array(__dtype, values, dims)
+    // STL Compatibility
+
+    struct Iterator
+    {
+    public:
+
+        using iterator_category = std::forward_iterator_tag;
+        using difference_type = std::ptrdiff_t;
+        using value_type = std::pair<DataRef, DataRef>;
+        using pointer = void;
+        using reference = std::pair<DataRef, DataRef>;
+
+        Iterator(size_t index, const Dictionary * dictionary)
+            : _index(index)
+            , _dictionary(dictionary)
         { }
 
-        inline void setValues(
-            const std::vector<__ctype> &values,
-            const std::vector<uint32_t> &dims = {}
-        ) {
-            _setValues(__dtype, values, dims);
+        inline std::pair<DataRef, DataRef> operator*() const {
+            return {
+                _dictionary->_getValueRef(_index),
+                _dictionary->_getValueRef(_index + 1),
+            };
         }
 
-    #endif
+        inline Iterator& operator++() {
+            _index += 2;
+            return *this;
+        }
 
-}; // class Int16Array
+        inline Iterator operator++(int) {
+            Iterator tmp = *this;
+            ++(*this);
+            return tmp;
+        }
 
-class UInt16Array : public Array
-{
-public:
+        inline friend bool operator==(const Iterator& a, const Iterator& b) {
+            return (a._index == b._index && a._dictionary == b._dictionary);
+        };
 
-    typedef uint16_t __ctype;
-    static constexpr DType __dtype = DType::WU;
+        inline friend bool operator!=(const Iterator& a, const Iterator& b) {
+            return (a._index != b._index || a._dictionary != b._dictionary);
+        };
 
-    UInt16Array() = default;
+    private:
 
-    UInt16Array(UInt16Array &&) = default;
-    UInt16Array &operator=(UInt16Array &&) = default;
+        size_t _index;
 
-    inline UInt16Array(mdsdsc_xd_t &&xd, Tree *tree = nullptr)
-        : Array(std::move(xd), tree)
-    { }
+        const Dictionary * _dictionary;
 
-    inline UInt16Array(
-        std::initializer_list<__ctype> values,
-        const std::vector<uint32_t> &dims = {}
-    )
-        : Array(__dtype, std::vector<__ctype>(values.begin(), values.end()), dims)
-    { }
+    };
 
-    inline const char * getClassName() const override {
-        return "UInt16Array";
+    inline Iterator begin() const {
+        return Iterator(0, this);
     }
 
-    [[nodiscard]]
-    inline UInt16Array clone() const {
-        return _clone<UInt16Array>();
+    inline Iterator end() const {
+        // An odd trailing key without a value is skipped
+        return Iterator(getSize() - (getSize() % 2), this);
     }
 
-    [[nodiscard]]
-    inline UInt16Array * cloneNew() const {
-        return _cloneNew<UInt16Array>();
-    }
+protected:
 
-    [[nodiscard]]
-    inline std::vector<__ctype> getValues() const {
-        return _getValues<__ctype>();
+    // Also called by ScopedArena, so it can't allocate or throw
+    inline void _onValueReplaced() noexcept override {
+        delete _index.exchange(nullptr, std::memory_order_acq_rel);
     }
 
-    [[nodiscard]]
-    inline const __ctype &getValueAt(size_t index) const {
-        return _getValueAt<__ctype>(index);
-    }
+private:
 
-    [[nodiscard]]
-    inline const __ctype &operator[](size_t index) const {
-        return _getValueAt<__ctype>(index);
+    // Position of the value for each key, keys are views into the APD
+    struct _Index
+    {
+        std::unordered_map<std::string_view, size_t> Strings = {};
+
+        std::unordered_map<int64_t, size_t> Integers = {};
+    };
+
+    // Only allocated by the first find(), so a Dictionary that is never searched doesn't pay for it
+    mutable std::atomic<_Index *> _index = nullptr;
+
+    inline DataRef _getValueRef(size_t position) const {
+        return DataRef(_getDescriptorArray()[position], getTree());
     }
 
-    [[nodiscard]]
-    inline const __ctype& at(size_t index) const {
-        return _at<__ctype>(index);
+    inline const _Index& _getIndex() const
+    {
+        _Index * index = _index.load(std::memory_order_acquire);
+        if (index) {
+            return *index;
+        }
+
+        auto built = std::make_unique<_Index>();
+        _buildIndex(*built);
+
+        // If another thread published its index first, use that one and discard ours
+        if (_index.compare_exchange_strong(index, built.get(), std::memory_order_acq_rel)) {
+            return *built.release();
+        }
+        return *index;
     }
 
-    inline void setValues(const __ctype *values, uint32_t count) {
-        _setValues(__dtype, values, count);
+    inline void _buildIndex(_Index& index) const
+    {
+        mdsdsc_t ** dscList = _getDescriptorArray();
+        size_t size = (dscList ? getSize() : 0);
+
+        // emplace() keeps the first of any duplicate keys, same as a linear search
+        for (size_t i = 0; i + 1 < size; i += 2) {
+            mdsdsc_t * key = dscList[i];
+            if (!key || (key->class_ != CLASS_S && key->class_ != CLASS_D)) {
+                continue;
+            }
+
+            switch (key->dtype) {
+            case DTYPE_T:
+                index.Strings.emplace(std::string_view(key->pointer, key->length), i + 1);
+                break;
+            case DTYPE_B:
+                index.Integers.emplace(*reinterpret_cast<int8_t *>(key->pointer), i + 1);
+                break;
+            case DTYPE_BU:
+                index.Integers.emplace(*reinterpret_cast<uint8_t *>(key->pointer), i + 1);
+                break;
+            case DTYPE_W:
+                index.Integers.emplace(*reinterpret_cast<int16_t *>(key->pointer), i + 1);
+                break;
+            case DTYPE_WU:
+                index.Integers.emplace(*reinterpret_cast<uint16_t *>(key->pointer), i + 1);
+                break;
+            case DTYPE_L:
+                index.Integers.emplace(*reinterpret_cast<int32_t *>(key->pointer), i + 1);
+                break;
+            case DTYPE_LU:
+                index.Integers.emplace(*reinterpret_cast<uint32_t *>(key->pointer), i + 1);
+                break;
+            case DTYPE_Q:
+            case DTYPE_QU:
+                index.Integers.emplace(*reinterpret_cast<int64_t *>(key->pointer), i + 1);
+                break;
+            default: ;
+            }
+        }
     }
 
-    void setValues(
-        const __ctype *values,
-        const uint32_t *dims,
-        dimct_t dimCount
-    ) {
-        _setValues(__dtype, values, dims, dimCount);
+}; // class Dictionary
+
+template <typename APDType>
+class APDBuilder
+{
+public:
+
+    APDBuilder() = default;
+
+    inline explicit APDBuilder(size_t capacity) {
+        _values.reserve(capacity);
     }
 
     [[nodiscard]]
-    inline const __ctype& front() const {
-        return _front<__ctype>();
+    inline size_t getSize() const {
+        return _values.size();
     }
 
-    [[nodiscard]]
-    inline const __ctype& back() const {
-        return _back<__ctype>();
+    inline void reserve(size_t capacity) {
+        _values.reserve(capacity);
     }
 
-    [[nodiscard]]
-    inline __ctype * begin() const {
-        return _begin<__ctype>();
+    inline void clear() {
+        _values.clear();
     }
 
     [[nodiscard]]
-    inline __ctype * end() const {
-        return _end<__ctype>();
-    }
+    inline APDType build() const &
+    {
+        std::vector<mdsdsc_t *> dscList(_values.size());
+        for (size_t i = 0; i < _values.size(); ++i) {
+            dscList[i] = _values[i].getDescriptor();
+        }
 
-    #ifdef __cpp_lib_span
+        mdsdsc_a_t dsc = _getDescriptor(dscList);
 
-        inline UInt16Array(
-            std::span<const __ctype> values,
-            const std::vector<uint32_t>& dims = {}
-        )
-            : Array(__dtype, values, dims)
-        { }
+        APDType result;
+        static_cast<APD&>(result)._copyFrom((mdsdsc_t *)&dsc);
+        return result;
+    }
 
-        inline void setValues(
-            std::span<const __ctype> values,
-            const std::vector<uint32_t>& dims = {}
-        ) {
-            _setValues<__ctype>(__dtype, values, dims);
+    [[nodiscard]]
+    inline APDType build() &&
+    {
+        // Left out of the copy, and filled in once they have been adopted
+        std::vector<mdsdsc_t *> dscList(_values.size());
+        for (size_t i = 0; i < _values.size(); ++i) {
+            dscList[i] = (APD::_canAdopt(_values[i]) ? nullptr : _values[i].getDescriptor());
         }
 
-        inline UInt16Array(
-            const std::vector<__ctype> &values,
-            const std::vector<uint32_t> &dims = {}
-        )
-            : Array(__dtype, std::span(values), dims)
-        { }
+        mdsdsc_a_t dsc = _getDescriptor(dscList);
 
-        inline void setValues(
-            const std::vector<__ctype> &values,
-            const std::vector<uint32_t> &dims = {}
-        ) {
-            _setValues<__ctype>(__dtype, std::span(values), dims);
-        }
+        APDType result;
+        APD& apd = result;
+        apd._copyFrom((mdsdsc_t *)&dsc);
 
-        inline std::span<__ctype> getSpan() const {
-            return _getSpan<__ctype>();
+        mdsdsc_t ** out = apd._getDescriptorArray();
+        for (size_t i = 0; i < _values.size(); ++i) {
+            if (APD::_canAdopt(_values[i])) {
+                out[i] = apd._adopt(std::move(_values[i]));
+            }
         }
 
-    #else
+        _values.clear();
+        return result;
+    }
 
-        inline UInt16Array(
-            const std::vector<__ctype> &values,
-            const std::vector<uint32_t> &dims = {}
-        )
-            : Array(__dtype, values, dims)
-        { }
+protected:
 
-        inline void setValues(
-            const std::vector<__ctype> &values,
-            const std::vector<uint32_t> &dims = {}
-        ) {
-            _setValues(__dtype, values, dims);
+    std::vector<Data> _values;
+
+    static inline mdsdsc_a_t _getDescriptor(std::vector<mdsdsc_t *>& dscList) {
+        return mdsdsc_a_t{
+            .length = sizeof(mdsdsc_t *),
+            .dtype = dtype_t(APDType::__dtype),
+            .class_ = CLASS_APD,
+            .pointer = reinterpret_cast<char *>(dscList.data()),
+            .scale = 0,
+            .digits = 0,
+            .aflags = aflags_t{
+                .binscale = false,
+                .redim = true,
+                .column = true,
+                .coeff = false,
+                .bounds = false,
+            },
+            .dimct = 1,
+            .arsize = arsize_t(dscList.size() * sizeof(mdsdsc_t *)),
+        };
+    }
+
+    template <typename ValueType>
+    inline void _append(ValueType&& value)
+    {
+        using BaseType = std::remove_cv_t<std::remove_reference_t<ValueType>>;
+
+        // Data given up by the caller is moved in without being copied
+        if constexpr (std::is_base_of_v<Data, BaseType> && !std::is_lvalue_reference_v<ValueType>) {
+            _values.emplace_back(std::move(value));
         }
+        else {
+            DataView argValue(value);
 
-    #endif
+            mdsdsc_xd_t xd = MDSDSC_XD_INITIALIZER;
+            int status = MdsCopyDxXd(_unwrapDescriptor(argValue.getDescriptor()), &xd);
+            if (IS_NOT_OK(status)) {
+                throwException(status);
+            }
 
-}; // class UInt16Array
+            _values.emplace_back(std::move(xd), argValue.getTree());
+        }
+    }
 
-class Int32Array : public Array
+}; // class APDBuilder
+
+class ListBuilder : public APDBuilder<List>
 {
 public:
 
-    typedef int32_t __ctype;
-    static constexpr DType __dtype = DType::L;
+    using APDBuilder<List>::APDBuilder;
 
-    Int32Array() = default;
+    template <typename ValueType>
+    inline void append(ValueType&& value) {
+        _append(std::forward<ValueType>(value));
+    }
 
-    Int32Array(Int32Array &&) = default;
-    Int32Array &operator=(Int32Array &&) = default;
+}; // class ListBuilder
 
-    inline Int32Array(mdsdsc_xd_t &&xd, Tree *tree = nullptr)
-        : Array(std::move(xd), tree)
-    { }
+class DictionaryBuilder : public APDBuilder<Dictionary>
+{
+public:
 
-    inline Int32Array(
-        std::initializer_list<__ctype> values,
-        const std::vector<uint32_t> &dims = {}
-    )
-        : Array(__dtype, std::vector<__ctype>(values.begin(), values.end()), dims)
-    { }
+    using APDBuilder<Dictionary>::APDBuilder;
 
-    inline const char * getClassName() const override {
-        return "Int32Array";
+    template <typename KeyType, typename ValueType>
+    inline void append(KeyType&& key, ValueType&& value) {
+        _append(std::forward<KeyType>(key));
+        _append(std::forward<ValueType>(value));
     }
 
-    [[nodiscard]]
-    inline Int32Array clone() const {
-        return _clone<Int32Array>();
-    }
+}; // class DictionaryBuilder
 
-    [[nodiscard]]
-    inline Int32Array * cloneNew() const {
-        return _cloneNew<Int32Array>();
-    }
+// TODO: Tuple
 
-    [[nodiscard]]
-    inline std::vector<__ctype> getValues() const {
-        return _getValues<__ctype>();
-    }
+class Record : public Data
+{
+public:
 
-    [[nodiscard]]
-    inline const __ctype &getValueAt(size_t index) const {
-        return _getValueAt<__ctype>(index);
-    }
+    static constexpr Class __class = Class::R;
 
-    [[nodiscard]]
-    inline const __ctype &operator[](size_t index) const {
-        return _getValueAt<__ctype>(index);
-    }
+    Record() = default;
 
-    [[nodiscard]]
-    inline const __ctype& at(size_t index) const {
-        return _at<__ctype>(index);
-    }
+    inline Record(mdsdsc_xd_t && dsc, Tree * tree = nullptr)
+        : Data(std::move(dsc), tree)
+    { }
 
-    inline void setValues(const __ctype *values, uint32_t count) {
-        _setValues(__dtype, values, count);
-    }
+    Record(Record&&) = default;
+    Record& operator=(Record&&) = default;
 
-    void setValues(
-        const __ctype *values,
-        const uint32_t *dims,
-        dimct_t dimCount
-    ) {
-        _setValues(__dtype, values, dims, dimCount);
-    }
+    virtual ~Record() = default;
 
     [[nodiscard]]
-    inline const __ctype& front() const {
-        return _front<__ctype>();
+    inline mdsdsc_r_t * getRecordDescriptor() const {
+        return reinterpret_cast<mdsdsc_r_t *>(_xd.pointer);
+    }
+
+    inline size_t getNumDescriptors() const {
+        mdsdsc_r_t * dsc = getRecordDescriptor();
+        return (dsc ? dsc->ndesc : 0);
     }
 
-    [[nodiscard]]
-    inline const __ctype& back() const {
-        return _back<__ctype>();
+    inline bool hasDescriptorAt(size_t index) const {
+        mdsdsc_r_t * dsc = getRecordDescriptor();
+        return (dsc && index < dsc->ndesc && dsc->dscptrs[index] != nullptr);
     }
 
-    [[nodiscard]]
-    inline __ctype * begin() const {
-        return _begin<__ctype>();
-    }
+    template <typename ResultType = Data>
+    inline ResultType getDescriptorAt(size_t index) const {
+        mdsdsc_r_t * dsc = getRecordDescriptor();
 
-    [[nodiscard]]
-    inline __ctype * end() const {
-        return _end<__ctype>();
+        if (dsc && index < dsc->ndesc) {
+            mdsdsc_xd_t xd = MDSDSC_XD_INITIALIZER;
+            int status = MdsCopyDxXd(dsc->dscptrs[index], &xd);
+            if (IS_NOT_OK(status)) {
+                throwException(status);
+            }
+
+            mdsdsc_t * newDsc = xd.pointer;
+            if (Class(newDsc->class_) == ResultType::__class && DType(newDsc->dtype) == ResultType::__dtype) {
+                return ResultType(std::move(xd), getTree());
+            }
+
+            return Data(std::move(xd), getTree()).releaseAndConvert<ResultType>();
+        }
+
+        return ResultType();
     }
 
-    #ifdef __cpp_lib_span
+protected:
 
-        inline Int32Array(
-            std::span<const __ctype> values,
-            const std::vector<uint32_t>& dims = {}
-        )
-            : Array(__dtype, values, dims)
-        { }
+    template <typename ...ArgTypes>
+    void _build(mdsdsc_r_t * dsc, ArgTypes&& ...args)
+    {
+        // The extra element keeps the array from being empty
+        Data * adoptable[] = { _getAdoptable<ArgTypes>(args)..., nullptr };
 
-        inline void setValues(
-            std::span<const __ctype> values,
-            const std::vector<uint32_t>& dims = {}
-        ) {
-            _setValues<__ctype>(__dtype, values, dims);
+        // Left out of the copy, and filled in once they have been adopted
+        for (size_t i = 0; i < sizeof...(args); ++i) {
+            if (adoptable[i]) {
+                dsc->dscptrs[i] = nullptr;
+            }
         }
 
-        inline Int32Array(
-            const std::vector<__ctype> &values,
-            const std::vector<uint32_t> &dims = {}
-        )
-            : Array(__dtype, std::span(values), dims)
-        { }
+        _copyFrom((mdsdsc_t *)dsc);
 
-        inline void setValues(
-            const std::vector<__ctype> &values,
-            const std::vector<uint32_t> &dims = {}
-        ) {
-            _setValues<__ctype>(__dtype, std::span(values), dims);
+        mdsdsc_r_t * out = getRecordDescriptor();
+        for (size_t i = 0; i < sizeof...(args); ++i) {
+            if (adoptable[i]) {
+                out->dscptrs[i] = _adopt(std::move(*adoptable[i]));
+            }
         }
+    }
 
-        inline std::span<__ctype> getSpan() const {
-            return _getSpan<__ctype>();
+    template <typename ArgType>
+    static inline Data * _getAdoptable(ArgType& arg)
+    {
+        using BaseType = std::remove_reference_t<ArgType>;
+
+        // Only arguments passed as rvalues, e.g. with std::move(), can be taken
+        if constexpr (std::is_base_of_v<Data, BaseType> &&
+                      !std::is_const_v<BaseType> &&
+                      !std::is_lvalue_reference_v<ArgType>) {
+            if (_canAdopt(arg)) {
+                return &arg;
+            }
         }
 
-    #else
+        return nullptr;
+    }
 
-        inline Int32Array(
-            const std::vector<__ctype> &values,
-            const std::vector<uint32_t> &dims = {}
-        )
-            : Array(__dtype, values, dims)
-        { }
+    void _setTree(Tree * tree)
+    {
+        // Don't overwrite our tree with nullptr
+        if (!tree) {
+            return;
+        }
 
-        inline void setValues(
-            const std::vector<__ctype> &values,
-            const std::vector<uint32_t> &dims = {}
-        ) {
-            _setValues(__dtype, values, dims);
+        // We can't reference two trees at once
+        if (getTree() && tree != getTree()) {
+            // TODO: Throw custom exception?
+            throw TdiArgumentMismatch();
         }
 
-    #endif
+        setTree(tree);
+    }
 
-}; // class Int32Array
+}; // class Record
 
-class UInt32Array : public Array
+#define MDSPLUS_RECORD_BOOTSTRAP(RecordType, DataType)           \
+                                                                 \
+    static constexpr DType __dtype = DataType;                   \
+                                                                 \
+    RecordType() = default;                                      \
+                                                                 \
+    inline RecordType(mdsdsc_xd_t && dsc, Tree * tree = nullptr) \
+        : Record(std::move(dsc), tree)                           \
+    { }                                                          \
+                                                                 \
+    RecordType(RecordType &&) = default;                         \
+    RecordType &operator=(RecordType &&) = default;              \
+                                                                 \
+    inline const char * getClassName() const override {          \
+        return #RecordType;                                      \
+    }                                                            \
+                                                                 \
+    [[nodiscard]]                                                \
+    inline RecordType clone() const {                            \
+        return _clone<RecordType>();                             \
+    }                                                            \
+                                                                 \
+    [[nodiscard]]                                                \
+    inline RecordType * cloneNew() const {                       \
+        return _cloneNew<RecordType>();                          \
+    }
+
+#define MDSPLUS_RECORD_CUSTOMIZATION(RecordType)                 \
+    template <>                                                  \
+    inline RecordType Data::releaseAndConvert()                  \
+    {                                                            \
+        mdsdsc_xd_t xd = release();                              \
+        mdsdsc_t * dsc = xd.pointer;                             \
+                                                                 \
+        if (dsc->class_ == class_t(RecordType::__class) &&       \
+            dsc->dtype == dtype_t(RecordType::__dtype)) {        \
+            return RecordType(std::move(xd), getTree());         \
+        }                                                        \
+                                                                 \
+        MdsFree1Dx(&xd, nullptr);                                \
+        throw TdiInvalidDataType();                              \
+    }
+
+class Param : public Record
 {
 public:
 
-    typedef uint32_t __ctype;
-    static constexpr DType __dtype = DType::LU;
-
-    UInt32Array() = default;
+    MDSPLUS_RECORD_BOOTSTRAP(Param, DType::Param)
 
-    UInt32Array(UInt32Array &&) = default;
-    UInt32Array &operator=(UInt32Array &&) = default;
+    template <
+        typename ValueType,
+        typename HelpType,
+        typename ValidationType
+    >
+    Param(
+        ValueType&& value,
+        HelpType&& help,
+        ValidationType&& validation
+    ) {
+        DataView argValue(value);
+        DataView argHelp(help);
+        DataView argValidation(validation);
 
-    inline UInt32Array(mdsdsc_xd_t &&xd, Tree *tree = nullptr)
-        : Array(std::move(xd), tree)
-    { }
+        _setTree(argValue.getTree());
+        _setTree(argHelp.getTree());
+        _setTree(argValidation.getTree());
 
-    inline UInt32Array(
-        std::initializer_list<__ctype> values,
-        const std::vector<uint32_t> &dims = {}
-    )
-        : Array(__dtype, std::vector<__ctype>(values.begin(), values.end()), dims)
-    { }
+        DESCRIPTOR_PARAM(dsc,
+            argValue.getDescriptor(),
+            argHelp.getDescriptor(),
+            argValidation.getDescriptor()
+        );
 
-    inline const char * getClassName() const override {
-        return "UInt32Array";
+        _build((mdsdsc_r_t *)&dsc,
+            std::forward<ValueType>(value),
+            std::forward<HelpType>(help),
+            std::forward<ValidationType>(validation)
+        );
     }
 
+    template <typename ValueType = Data>
     [[nodiscard]]
-    inline UInt32Array clone() const {
-        return _clone<UInt32Array>();
+    inline ValueType getValue() const {
+        return getDescriptorAt<ValueType>(0);
     }
 
+    template <typename HelpType = Data>
     [[nodiscard]]
-    inline UInt32Array * cloneNew() const {
-        return _cloneNew<UInt32Array>();
+    inline HelpType getHelp() const {
+        return getDescriptorAt<HelpType>(1);
     }
 
+    template <typename ValidationType = Data>
     [[nodiscard]]
-    inline std::vector<__ctype> getValues() const {
-        return _getValues<__ctype>();
+    inline ValidationType getValidation() const {
+        return getDescriptorAt<ValidationType>(2);
     }
 
-    [[nodiscard]]
-    inline const __ctype &getValueAt(size_t index) const {
-        return _getValueAt<__ctype>(index);
-    }
+}; // class Param
 
-    [[nodiscard]]
-    inline const __ctype &operator[](size_t index) const {
-        return _getValueAt<__ctype>(index);
-    }
+MDSPLUS_RECORD_CUSTOMIZATION(Param)
 
-    [[nodiscard]]
-    inline const __ctype& at(size_t index) const {
-        return _at<__ctype>(index);
-    }
+class Signal : public Record
+{
+public:
 
-    inline void setValues(const __ctype *values, uint32_t count) {
-        _setValues(__dtype, values, count);
+    MDSPLUS_RECORD_BOOTSTRAP(Signal, DType::Signal)
+
+    template <
+        typename ValueType,
+        typename RawType,
+        typename DimensionType
+    >
+    Signal(
+        ValueType&& value,
+        RawType&& raw,
+        DimensionType&& dimension = {}
+    ) {
+        DataView argValue(value);
+        DataView argRaw(raw);
+        DataView argDimension(dimension);
+
+        _setTree(argValue.getTree());
+        _setTree(argRaw.getTree());
+        _setTree(argDimension.getTree());
+
+        DESCRIPTOR_SIGNAL_1(dsc,
+            argValue.getDescriptor(),
+            argRaw.getDescriptor(),
+            argDimension.getDescriptor()
+        );
+
+        _build((mdsdsc_r_t *)&dsc,
+            std::forward<ValueType>(value),
+            std::forward<RawType>(raw),
+            std::forward<DimensionType>(dimension)
+        );
     }
 
-    void setValues(
-        const __ctype *values,
-        const uint32_t *dims,
-        dimct_t dimCount
-    ) {
-        _setValues(__dtype, values, dims, dimCount);
+    template <
+        typename ValueType,
+        typename RawType,
+        typename ...DimensionTypes
+    >
+    Signal(
+        ValueType&& value,
+        RawType&& raw,
+        DimensionTypes&& ...dimensions
+    ) {
+        DataView argValue(value);
+        DataView argRaw(raw);
+        std::vector<DataView> argDimensions = { DataView(dimensions)... };
+
+        _setTree(argValue.getTree());
+        _setTree(argRaw.getTree());
+
+        DESCRIPTOR_SIGNAL(dsc,
+            sizeof...(dimensions),
+            argValue.getDescriptor(),
+            argRaw.getDescriptor()
+        );
+
+        for (size_t i = 0; i < argDimensions.size(); ++i) {
+            dsc.dimensions[i] = argDimensions[i].getDescriptor();
+            _setTree(argDimensions[i].getTree());
+        }
+
+        _build((mdsdsc_r_t *)&dsc,
+            std::forward<ValueType>(value),
+            std::forward<RawType>(raw),
+            std::forward<DimensionTypes>(dimensions)...
+        );
     }
 
+    template <typename ValueType = Data>
     [[nodiscard]]
-    inline const __ctype& front() const {
-        return _front<__ctype>();
+    inline ValueType getValue() const {
+        return getDescriptorAt<ValueType>(0);
     }
 
+    template <typename RawType = Data>
     [[nodiscard]]
-    inline const __ctype& back() const {
-        return _back<__ctype>();
+    inline RawType getRaw() const {
+        return getDescriptorAt<RawType>(1);
     }
 
+    template <typename DimensionType = Data>
     [[nodiscard]]
-    inline __ctype * begin() const {
-        return _begin<__ctype>();
+    inline DimensionType getDimensionAt(size_t index = 0) const {
+        return getDescriptorAt<DimensionType>(2 + index);
     }
 
+    template <typename DimensionType = Data>
     [[nodiscard]]
-    inline __ctype * end() const {
-        return _end<__ctype>();
+    inline std::vector<DimensionType> getDimensions() const {
+        std::vector<DimensionType> dims;
+        size_t count = getNumDescriptors() - 2;
+        for (size_t i = 0; i < count; ++i) {
+            dims.push_back(getDimensionAt(i));
+        }
+        return dims;
     }
 
-    #ifdef __cpp_lib_span
+}; // class Signal
 
-        inline UInt32Array(
-            std::span<const __ctype> values,
-            const std::vector<uint32_t>& dims = {}
-        )
-            : Array(__dtype, values, dims)
-        { }
+MDSPLUS_RECORD_CUSTOMIZATION(Signal)
 
-        inline void setValues(
-            std::span<const __ctype> values,
-            const std::vector<uint32_t>& dims = {}
-        ) {
-            _setValues<__ctype>(__dtype, values, dims);
-        }
+class Dimension : public Record
+{
+public:
 
-        inline UInt32Array(
-            const std::vector<__ctype> &values,
-            const std::vector<uint32_t> &dims = {}
-        )
-            : Array(__dtype, std::span(values), dims)
-        { }
+    MDSPLUS_RECORD_BOOTSTRAP(Dimension, DType::Dimension)
 
-        inline void setValues(
-            const std::vector<__ctype> &values,
-            const std::vector<uint32_t> &dims = {}
-        ) {
-            _setValues<__ctype>(__dtype, std::span(values), dims);
-        }
+    template <typename WindowType, typename AxisType>
+    Dimension(WindowType&& window, AxisType&& axis)
+    {
+        DataView tmpWindow(window);
+        DataView tmpAxis(axis);
 
-        inline std::span<__ctype> getSpan() const {
-            return _getSpan<__ctype>();
-        }
+        _setTree(tmpWindow.getTree());
+        _setTree(tmpAxis.getTree());
 
-    #else
+        DESCRIPTOR_DIMENSION(dsc,
+            tmpWindow.getDescriptor(),
+            tmpAxis.getDescriptor()
+        );
 
-        inline UInt32Array(
-            const std::vector<__ctype> &values,
-            const std::vector<uint32_t> &dims = {}
-        )
-            : Array(__dtype, values, dims)
-        { }
+        _build((mdsdsc_r_t *)&dsc,
+            std::forward<WindowType>(window),
+            std::forward<AxisType>(axis)
+        );
+    }
 
-        inline void setValues(
-            const std::vector<__ctype> &values,
-            const std::vector<uint32_t> &dims = {}
-        ) {
-            _setValues(__dtype, values, dims);
-        }
+    template <typename WindowType = Data>
+    [[nodiscard]]
+    inline WindowType getWindow() const {
+        return getDescriptorAt<WindowType>(0);
+    }
 
-    #endif
+    template <typename AxisType = Data>
+    [[nodiscard]]
+    inline AxisType getAxis() const {
+        return getDescriptorAt<AxisType>(1);
+    }
 
-}; // class UInt32Array
+}; // class Dimension
 
-class Int64Array : public Array
+MDSPLUS_RECORD_CUSTOMIZATION(Dimension)
+
+class Window : public Record
 {
 public:
 
-    typedef int64_t __ctype;
-    static constexpr DType __dtype = DType::Q;
-
-    Int64Array() = default;
+    MDSPLUS_RECORD_BOOTSTRAP(Window, DType::Window)
 
-    Int64Array(Int64Array &&) = default;
-    Int64Array &operator=(Int64Array &&) = default;
+    template <
+        typename StartIndexType,
+        typename EndIndexType,
+        typename ValueType
+    >
+    Window(
+        StartIndexType&& startIndex,
+        EndIndexType&& endIndex,
+        ValueType&& valueAtIndex0
+    ) {
+        DataView argStartIndex(startIndex);
+        DataView argEndIndex(endIndex);
+        DataView argValueAtIndex0(valueAtIndex0);
 
-    inline Int64Array(mdsdsc_xd_t &&xd, Tree *tree = nullptr)
-        : Array(std::move(xd), tree)
-    { }
+        _setTree(argStartIndex.getTree());
+        _setTree(argEndIndex.getTree());
+        _setTree(argValueAtIndex0.getTree());
 
-    inline Int64Array(
-        std::initializer_list<__ctype> values,
-        const std::vector<uint32_t> &dims = {}
-    )
-        : Array(__dtype, std::vector<__ctype>(values.begin(), values.end()), dims)
-    { }
+        DESCRIPTOR_WINDOW(dsc,
+            argStartIndex.getDescriptor(),
+            argEndIndex.getDescriptor(),
+            argValueAtIndex0.getDescriptor()
+        );
 
-    inline const char * getClassName() const override {
-        return "Int64Array";
+        _build((mdsdsc_r_t *)&dsc,
+            std::forward<StartIndexType>(startIndex),
+            std::forward<EndIndexType>(endIndex),
+            std::forward<ValueType>(valueAtIndex0)
+        );
     }
 
+    template <typename StartIndexType = Data>
     [[nodiscard]]
-    inline Int64Array clone() const {
-        return _clone<Int64Array>();
+    inline StartIndexType getStartIndex() const {
+        return getDescriptorAt<StartIndexType>(0);
     }
 
+    template <typename EndIndexType = Data>
     [[nodiscard]]
-    inline Int64Array * cloneNew() const {
-        return _cloneNew<Int64Array>();
+    inline EndIndexType getEndIndex() const {
+        return getDescriptorAt<EndIndexType>(1);
     }
 
+    template <typename ValueType = Data>
     [[nodiscard]]
-    inline std::vector<__ctype> getValues() const {
-        return _getValues<__ctype>();
+    inline ValueType getValueAtIndex0() const {
+        return getDescriptorAt<ValueType>(2);
     }
 
-    [[nodiscard]]
-    inline const __ctype &getValueAt(size_t index) const {
-        return _getValueAt<__ctype>(index);
-    }
+}; // class Window
 
-    [[nodiscard]]
-    inline const __ctype &operator[](size_t index) const {
-        return _getValueAt<__ctype>(index);
+MDSPLUS_RECORD_CUSTOMIZATION(Window)
+
+class Function : public Record
+{
+public:
+
+    MDSPLUS_RECORD_BOOTSTRAP(Function, DType::Function)
+
+    Function(opcode_t opcode)
+    {
+        DESCRIPTOR_FUNCTION_0(dsc, &opcode);
+        _copyFrom((mdsdsc_t *)&dsc);
     }
 
-    [[nodiscard]]
-    inline const __ctype& at(size_t index) const {
-        return _at<__ctype>(index);
+    template <typename ...ArgTypes>
+    Function(opcode_t opcode, ArgTypes&& ...args)
+    {
+        // TODO: #define MAX_ARGS 255 ?
+        static_assert(sizeof...(args) <= 255, "Function's are limited to 254 arguments");
+
+        std::vector<DataView> argList = { DataView(args)... };
+
+        DESCRIPTOR_FUNCTION(dsc, &opcode, sizeof...(args));
+
+        for (size_t i = 0; i < argList.size(); ++i) {
+            dsc.arguments[i] = argList[i].getDescriptor();
+            _setTree(argList[i].getTree());
+        }
+
+        _build((mdsdsc_r_t *)&dsc,
+            std::forward<ArgTypes>(args)...
+        );
     }
 
-    inline void setValues(const __ctype *values, uint32_t count) {
-        _setValues(__dtype, values, count);
+    Data call() const;
+
+    template <typename ResultType = Data>
+    inline ResultType getData() const {
+        return call().releaseAndConvert<ResultType>();
     }
 
-    void setValues(
-        const __ctype *values,
-        const uint32_t *dims,
-        dimct_t dimCount
+}; // class Function
+
+MDSPLUS_RECORD_CUSTOMIZATION(Function)
+
+// TODO: Conglom?
+
+class Range : public Record
+{
+public:
+
+    MDSPLUS_RECORD_BOOTSTRAP(Range, DType::Range)
+
+    template <
+        typename BeginType = Data,
+        typename EndingType = Data,
+        typename DeltaType = Data
+    >
+    Range(
+        BeginType&& begin,
+        EndingType&& ending,
+        DeltaType&& delta
     ) {
-        _setValues(__dtype, values, dims, dimCount);
-    }
+        DataView argBegin(begin);
+        DataView argEnding(ending);
+        DataView argDelta(delta);
 
-    [[nodiscard]]
-    inline const __ctype& front() const {
-        return _front<__ctype>();
+        _setTree(argBegin.getTree());
+        _setTree(argEnding.getTree());
+        _setTree(argDelta.getTree());
+
+        DESCRIPTOR_RANGE(dsc,
+            argBegin.getDescriptor(),
+            argEnding.getDescriptor(),
+            argDelta.getDescriptor()
+        );
+
+        _build((mdsdsc_r_t *)&dsc,
+            std::forward<BeginType>(begin),
+            std::forward<EndingType>(ending),
+            std::forward<DeltaType>(delta)
+        );
     }
 
+    template <typename BeginType = Data>
     [[nodiscard]]
-    inline const __ctype& back() const {
-        return _back<__ctype>();
+    inline BeginType getBegin() const {
+        return getDescriptorAt<BeginType>(0);
     }
 
+    template <typename EndingType = Data>
     [[nodiscard]]
-    inline __ctype * begin() const {
-        return _begin<__ctype>();
+    inline EndingType getEnding() const {
+        return getDescriptorAt<EndingType>(1);
     }
 
+    template <typename DeltaType = Data>
     [[nodiscard]]
-    inline __ctype * end() const {
-        return _end<__ctype>();
+    inline DeltaType getDelta() const {
+        return getDescriptorAt<DeltaType>(2);
     }
 
-    #ifdef __cpp_lib_span
+    // TODO: isFinite() ?
+    // TODO: begin/end/size
 
-        inline Int64Array(
-            std::span<const __ctype> values,
-            const std::vector<uint32_t>& dims = {}
-        )
-            : Array(__dtype, values, dims)
-        { }
+}; // class Range
 
-        inline void setValues(
-            std::span<const __ctype> values,
-            const std::vector<uint32_t>& dims = {}
-        ) {
-            _setValues<__ctype>(__dtype, values, dims);
-        }
+MDSPLUS_RECORD_CUSTOMIZATION(Range)
 
-        inline Int64Array(
-            const std::vector<__ctype> &values,
-            const std::vector<uint32_t> &dims = {}
-        )
-            : Array(__dtype, std::span(values), dims)
-        { }
+// TODO: Action
+// TODO: Dispatch
+// TODO: Routine?
+// TODO: Method?
+// TODO: Event?
 
-        inline void setValues(
-            const std::vector<__ctype> &values,
-            const std::vector<uint32_t> &dims = {}
-        ) {
-            _setValues<__ctype>(__dtype, std::span(values), dims);
-        }
+class WithUnits : public Record
+{
+public:
 
-        inline std::span<__ctype> getSpan() const {
-            return _getSpan<__ctype>();
-        }
+    MDSPLUS_RECORD_BOOTSTRAP(WithUnits, DType::WithUnits)
 
-    #else
+    template <typename ValueType, typename UnitsType>
+    WithUnits(ValueType&& value, UnitsType&& units)
+    {
+        DataView argValue(value);
+        DataView argUnits(units);
 
-        inline Int64Array(
-            const std::vector<__ctype> &values,
-            const std::vector<uint32_t> &dims = {}
-        )
-            : Array(__dtype, values, dims)
-        { }
+        _setTree(argValue.getTree());
+        _setTree(argUnits.getTree());
 
-        inline void setValues(
-            const std::vector<__ctype> &values,
-            const std::vector<uint32_t> &dims = {}
-        ) {
-            _setValues(__dtype, values, dims);
-        }
+        DESCRIPTOR_WITH_UNITS(dsc,
+            argValue.getDescriptor(),
+            argUnits.getDescriptor()
+        );
 
-    #endif
+        _build((mdsdsc_r_t *)&dsc,
+            std::forward<ValueType>(value),
+            std::forward<UnitsType>(units)
+        );
+    }
 
-}; // class Int64Array
+    template <typename ValueType = Data>
+    [[nodiscard]]
+    inline ValueType getValue() const {
+        return getDescriptorAt<ValueType>(0);
+    }
 
-class UInt64Array : public Array
+    template <typename UnitsType = Data>
+    [[nodiscard]]
+    inline UnitsType getUnits() const {
+        return getDescriptorAt<UnitsType>(1);
+    }
+
+}; // class WithUnits
+
+MDSPLUS_RECORD_CUSTOMIZATION(WithUnits)
+
+// TODO: Call?
+
+class WithError : public Record
 {
 public:
 
-    typedef uint64_t __ctype;
-    static constexpr DType __dtype = DType::QU;
-
-    UInt64Array() = default;
+    MDSPLUS_RECORD_BOOTSTRAP(WithError, DType::WithError)
 
-    UInt64Array(UInt64Array &&) = default;
-    UInt64Array &operator=(UInt64Array &&) = default;
+    template <typename ValueType, typename ErrorType>
+    WithError(ValueType&& value, ErrorType&& error)
+    {
+        DataView argValue(value);
+        DataView argError(error);
 
-    inline UInt64Array(mdsdsc_xd_t &&xd, Tree *tree = nullptr)
-        : Array(std::move(xd), tree)
-    { }
+        _setTree(argValue.getTree());
+        _setTree(argError.getTree());
 
-    inline UInt64Array(
-        std::initializer_list<__ctype> values,
-        const std::vector<uint32_t> &dims = {}
-    )
-        : Array(__dtype, std::vector<__ctype>(values.begin(), values.end()), dims)
-    { }
+        DESCRIPTOR_WITH_ERROR(dsc,
+            argValue.getDescriptor(),
+            argError.getDescriptor()
+        );
 
-    inline const char * getClassName() const override {
-        return "UInt64Array";
+        _build((mdsdsc_r_t *)&dsc,
+            std::forward<ValueType>(value),
+            std::forward<ErrorType>(error)
+        );
     }
 
+    template <typename ValueType = Data>
     [[nodiscard]]
-    inline UInt64Array clone() const {
-        return _clone<UInt64Array>();
+    inline ValueType getValue() const {
+        return getDescriptorAt<ValueType>(0);
     }
 
+    template <typename ErrorType = Data>
     [[nodiscard]]
-    inline UInt64Array * cloneNew() const {
-        return _cloneNew<UInt64Array>();
+    inline ErrorType getError() const {
+        return getDescriptorAt<ErrorType>(1);
     }
 
-    [[nodiscard]]
-    inline std::vector<__ctype> getValues() const {
-        return _getValues<__ctype>();
-    }
+}; // class WithError
 
-    [[nodiscard]]
-    inline const __ctype &getValueAt(size_t index) const {
-        return _getValueAt<__ctype>(index);
-    }
+MDSPLUS_RECORD_CUSTOMIZATION(WithError)
 
-    [[nodiscard]]
-    inline const __ctype &operator[](size_t index) const {
-        return _getValueAt<__ctype>(index);
-    }
+// TODO: Opaque?
 
-    [[nodiscard]]
-    inline const __ctype& at(size_t index) const {
-        return _at<__ctype>(index);
-    }
+class GetMany;
+class PutMany;
 
-    inline void setValues(const __ctype *values, uint32_t count) {
-        _setValues(__dtype, values, count);
-    }
+class Connection
+{
+public:
 
-    void setValues(
-        const __ctype *values,
-        const uint32_t *dims,
-        dimct_t dimCount
-    ) {
-        _setValues(__dtype, values, dims, dimCount);
-    }
+    static constexpr int InvalidConnectionID = -1;
 
-    [[nodiscard]]
-    inline const __ctype& front() const {
-        return _front<__ctype>();
+    inline Connection(const std::string& hostspec) {
+        connect(hostspec);
     }
 
-    [[nodiscard]]
-    inline const __ctype& back() const {
-        return _back<__ctype>();
+    inline virtual ~Connection() {
+        disconnect();
     }
 
-    [[nodiscard]]
-    inline __ctype * begin() const {
-        return _begin<__ctype>();
+    void connect(const std::string& hostspec);
+
+    void disconnect();
+
+    inline void reconnect() {
+        disconnect();
+        connect(_hostspec);
     }
 
-    [[nodiscard]]
-    inline __ctype * end() const {
-        return _end<__ctype>();
+    template <typename ResultType = Data, typename ...ArgTypes>
+    ResultType get(const std::string& expression, const ArgTypes& ...args) const
+    {
+        if (_local) {
+            return Data::Execute<ResultType>(expression, args...);
+        }
+        else {
+            std::vector<DataView> argList({ DataView(args)... });
+            return _get(expression, std::move(argList)).releaseAndConvert<ResultType>();
+        }
     }
 
-    #ifdef __cpp_lib_span
+    template <typename ResultType = Data, typename ...ArgTypes>
+    ResultType getObject(const std::string& expression, ArgTypes ...args) const
+    {
+        Int8Array serializedData = get<Int8Array>("SerializeOut(`(" + expression + ";))", args...);
+        return serializedData.deserialize<ResultType>();
+    }
 
-        inline UInt64Array(
-            std::span<const __ctype> values,
-            const std::vector<uint32_t>& dims = {}
-        )
-            : Array(__dtype, values, dims)
-        { }
+    inline void openTree(const std::string& tree, int shot) const {
+        int status = get<Int32>("TreeOpen($,$)", tree, shot).getValue();
+        if (IS_NOT_OK(status)) {
+            throwException(status);
+        }
+    }
 
-        inline void setValues(
-            std::span<const __ctype> values,
-            const std::vector<uint32_t>& dims = {}
-        ) {
-            _setValues<__ctype>(__dtype, values, dims);
+    inline void closeTree(const std::string& tree, int shot) const {
+        int status = get<Int32>("TreeClose($,$)", tree, shot).getValue();
+        if (IS_NOT_OK(status)) {
+            throwException(status);
         }
+    }
 
-        inline UInt64Array(
-            const std::vector<__ctype> &values,
-            const std::vector<uint32_t> &dims = {}
-        )
-            : Array(__dtype, std::span(values), dims)
-        { }
+    inline int closeAllTrees() const {
+        return get<Int32>("_i=0;WHILE(IAND(TreeClose(),1)) _i++;_i").getValue();
+    }
 
-        inline void setValues(
-            const std::vector<__ctype> &values,
-            const std::vector<uint32_t> &dims = {}
-        ) {
-            _setValues<__ctype>(__dtype, std::span(values), dims);
-        }
+    inline void setDefault(const std::string& path) {
+        get("TreeSetDefault($)", path);
+    }
 
-        inline std::span<__ctype> getSpan() const {
-            return _getSpan<__ctype>();
+    template <typename ...Args>
+    inline void put(const std::string& node, const std::string& expression, const Args& ...args) const
+    {
+        std::string putExpression = "TreePut($,$";
+        for (size_t i = 0; i < sizeof...(args) - 2; ++i) {
+            putExpression += ",$";
         }
+        putExpression += ")";
 
-    #else
+        get(putExpression, node, expression, args...);
+    }
 
-        inline UInt64Array(
-            const std::vector<__ctype> &values,
-            const std::vector<uint32_t> &dims = {}
-        )
-            : Array(__dtype, values, dims)
-        { }
+    GetMany getMany() const;
 
-        inline void setValues(
-            const std::vector<__ctype> &values,
-            const std::vector<uint32_t> &dims = {}
-        ) {
-            _setValues(__dtype, values, dims);
-        }
+    // putMany
 
-    #endif
+private:
 
-}; // class UInt64Array
+    Data _get(const std::string& expression, std::vector<DataView>&& xdArgs) const;
 
-class Float32Array : public Array
-{
-public:
+    int _id = InvalidConnectionID;
 
-    typedef float __ctype;
-    static constexpr DType __dtype = DType::FS;
+    std::string _hostspec;
 
-    Float32Array() = default;
+    bool _local = false;
 
-    Float32Array(Float32Array &&) = default;
-    Float32Array &operator=(Float32Array &&) = default;
+}; // class Connection
 
-    inline Float32Array(mdsdsc_xd_t &&xd, Tree *tree = nullptr)
-        : Array(std::move(xd), tree)
-    { }
+class GetMany
+{
+public:
 
-    inline Float32Array(
-        std::initializer_list<__ctype> values,
-        const std::vector<uint32_t> &dims = {}
-    )
-        : Array(__dtype, std::vector<__ctype>(values.begin(), values.end()), dims)
+    GetMany(const Connection * conn)
+        : _conn(conn)
     { }
 
-    inline const char * getClassName() const override {
-        return "Float32Array";
+    template <typename ...ArgTypes>
+    void append(const std::string& name, const std::string& expression, const ArgTypes& ...args)
+    {
+        // _queries.emplace_back(std::unordered_map<std::string, Data>{
+        //     { "name", String(name) },
+        //     { "exp", String(expression), },
+        //     { "args", List(args...) },
+        // });
+        _queries.emplace_back(Dictionary(
+            "name", name,
+            "exp", expression,
+            "args", List(args...)
+        ));
     }
 
-    [[nodiscard]]
-    inline Float32Array clone() const {
-        return _clone<Float32Array>();
-    }
+    const Dictionary& execute()
+    {
+        Data result = _conn->get("GetManyExecute($)", List(_queries).serialize());
 
-    [[nodiscard]]
-    inline Float32Array * cloneNew() const {
-        return _cloneNew<Float32Array>();
-    }
+        if (result.getClass() == Class::S) {
+            if (result.getDType() == DType::T) {
+                // TODO: Read error
+                throw MDSplusException();
+            }
+            else if (result.getDType() == DType::L) {
+                int status = result.releaseAndConvert<Int32>().getValue();
+                throwException(status);
+            }
+        }
 
-    [[nodiscard]]
-    inline std::vector<__ctype> getValues() const {
-        return _getValues<__ctype>();
+        _result = result.releaseAndConvert<UInt8Array>().deserialize<Dictionary>();
+        return _result;
     }
 
-    [[nodiscard]]
-    inline const __ctype &getValueAt(size_t index) const {
-        return _getValueAt<__ctype>(index);
-    }
+private:
 
-    [[nodiscard]]
-    inline const __ctype &operator[](size_t index) const {
-        return _getValueAt<__ctype>(index);
-    }
+    const Connection * _conn;
 
-    [[nodiscard]]
-    inline const __ctype& at(size_t index) const {
-        return _at<__ctype>(index);
-    }
+    // std::vector<std::unordered_map<std::string, Data>> _queries;
 
-    inline void setValues(const __ctype *values, uint32_t count) {
-        _setValues(__dtype, values, count);
-    }
+    std::vector<Dictionary> _queries;
 
-    void setValues(
-        const __ctype *values,
-        const uint32_t *dims,
-        dimct_t dimCount
-    ) {
-        _setValues(__dtype, values, dims, dimCount);
-    }
+    Dictionary _result;
 
-    [[nodiscard]]
-    inline const __ctype& front() const {
-        return _front<__ctype>();
-    }
+}; // class GetMany
 
-    [[nodiscard]]
-    inline const __ctype& back() const {
-        return _back<__ctype>();
-    }
+inline GetMany Connection::getMany() const {
+    return GetMany(this);
+}
 
-    [[nodiscard]]
-    inline __ctype * begin() const {
-        return _begin<__ctype>();
-    }
+struct DevicePart
+{
+    std::string Path;
+    mdsplus::Usage Usage = mdsplus::Usage::Any;
+    Data * Value = {};
+    std::string ValueExpression = {};
+    TreeNodeFlags Flags = {};
+    std::map<std::string, Data *> XNCI = {};
+    std::function<void(TreeNode& node)> Callback;
+};
 
-    [[nodiscard]]
-    inline __ctype * end() const {
-        return _end<__ctype>();
-    }
+class Device : public TreeNode
+{
+public:
 
-    #ifdef __cpp_lib_span
+    Device(Tree * tree, int nid)
+        : TreeNode(tree, nid)
+    { }
 
-        inline Float32Array(
-            std::span<const __ctype> values,
-            const std::vector<uint32_t>& dims = {}
-        )
-            : Array(__dtype, values, dims)
-        { }
+    template <typename DeviceClass,
+        std::enable_if_t<std::is_base_of<Device, DeviceClass>::value, bool> = true>
+    static DeviceClass Add(Tree * tree, const std::string& name)
+    {
+        int nid = 0;
+        DESCRIPTOR_FROM_CSTRING(dscLibrary, DeviceClass::__library_name);
+        DESCRIPTOR_FROM_CSTRING(dscModel, DeviceClass::__class_name);
+        static DESCRIPTOR_CONGLOM(dscConglom, &dscLibrary, &dscModel, 0, 0);
 
-        inline void setValues(
-            std::span<const __ctype> values,
-            const std::vector<uint32_t>& dims = {}
-        ) {
-            _setValues<__ctype>(__dtype, values, dims);
-        }
+        std::vector<mdsplus::DevicePart> parts = DeviceClass::GetParts();
 
-        inline Float32Array(
-            const std::vector<__ctype> &values,
-            const std::vector<uint32_t> &dims = {}
-        )
-            : Array(__dtype, std::span(values), dims)
-        { }
+        _TreeStartConglomerate(tree->getDBID(), parts.size() + 1);
+        _TreeAddNode(tree->getDBID(), name.c_str(), &nid, TreeUSAGE_DEVICE);
+        _TreePutRecord(tree->getDBID(), nid, (mdsdsc_t *)&dscConglom, 0);
 
-        inline void setValues(
-            const std::vector<__ctype> &values,
-            const std::vector<uint32_t> &dims = {}
-        ) {
-            _setValues<__ctype>(__dtype, std::span(values), dims);
-        }
+        DeviceClass device(tree, nid);
+        device.addParts(std::move(parts));
 
-        inline std::span<__ctype> getSpan() const {
-            return _getSpan<__ctype>();
-        }
+        _TreeEndConglomerate(tree->getDBID());
 
-    #else
+        return device;
+    }
 
-        inline Float32Array(
-            const std::vector<__ctype> &values,
-            const std::vector<uint32_t> &dims = {}
-        )
-            : Array(__dtype, values, dims)
-        { }
+    static std::vector<DevicePart> GetParts() {
+        return {};
+    }
 
-        inline void setValues(
-            const std::vector<__ctype> &values,
-            const std::vector<uint32_t> &dims = {}
-        ) {
-            _setValues(__dtype, values, dims);
-        }
+    void addParts(std::vector<DevicePart>&& parts) const;
 
-    #endif
+};
 
-}; // class Float32Array
+// TODO: Error handling
 
-class Float64Array : public Array
+#define MDSPLUS_DEVICE_BOOTSTRAP(LibraryName, DeviceClass, DeviceClassLower) \
+    static inline const char * __library_name = #LibraryName;                \
+    static inline const char * __class_name = #DeviceClass;                  \
+    static inline const char * __class_name_lower = #DeviceClassLower;       \
+                                                                             \
+    DeviceClass(Tree * tree, int nid)                                        \
+        : Device(tree, nid)                                                  \
+    { }                                                                      \
+    virtual ~DeviceClass() = default;                                        \
+
+#define MDSPLUS_DEVICE(DeviceClassLower, DeviceClass)               \
+    extern "C" int DeviceClassLower##__add(                         \
+        mdsdsc_t * dscName,                                         \
+        mdsdsc_t * dscDummy,                                        \
+        int * nidOut)                                               \
+    {                                                               \
+        (void)dscDummy;                                             \
+        Tree tree = mdsplus::Tree::GetActive();                     \
+        std::string name(dscName->pointer, dscName->length);        \
+        const auto& device = Device::Add<DeviceClass>(&tree, name); \
+        if (nidOut) {                                               \
+            *nidOut = device.getNID();                              \
+        }                                                           \
+        return TreeSUCCESS;                                         \
+    }
+
+#define MDSPLUS_DEVICE_METHOD(DeviceClassLower, DeviceClass, MethodName) \
+    extern "C" int DeviceClassLower##__##MethodName(mdsdsc_t * nid)      \
+    {                                                                    \
+        mdsplus::Tree tree = mdsplus::Tree::GetActive();                 \
+        DeviceClass device(&tree, *(int *)nid->pointer);                 \
+        try {                                                            \
+            device.MethodName();                                         \
+        } catch (mdsplus::MDSplusException& e) {                         \
+            return e.getStatus();                                        \
+        }                                                                \
+        return TreeSUCCESS;                                              \
+    }
+
+template <typename DataType = Data>
+struct ShotData
 {
-public:
+    int Shot = 0;
 
-    typedef double __ctype;
-    static constexpr DType __dtype = DType::FT;
+    int Status = MDSplusSUCCESS;
 
-    Float64Array() = default;
+    std::vector<DataType> Values = {};
 
-    Float64Array(Float64Array &&) = default;
-    Float64Array &operator=(Float64Array &&) = default;
+    std::vector<int> ValueStatus = {};
 
-    inline Float64Array(mdsdsc_xd_t &&xd, Tree *tree = nullptr)
-        : Array(std::move(xd), tree)
-    { }
+    inline bool isOK() const {
+        return IS_OK(Status);
+    }
 
-    inline Float64Array(
-        std::initializer_list<__ctype> values,
-        const std::vector<uint32_t> &dims = {}
+}; // struct ShotData
+
+class ShotScanner
+{
+public:
+
+    inline ShotScanner(
+        const std::string& treename,
+        const std::vector<std::string>& paths,
+        const std::string& path = {}
     )
-        : Array(__dtype, std::vector<__ctype>(values.begin(), values.end()), dims)
+        : _treename(treename)
+        , _path(path)
+        , _paths(paths)
     { }
 
-    inline const char * getClassName() const override {
-        return "Float64Array";
-    }
-
     [[nodiscard]]
-    inline Float64Array clone() const {
-        return _clone<Float64Array>();
+    inline std::string getTreeName() const {
+        return _treename;
     }
 
     [[nodiscard]]
-    inline Float64Array * cloneNew() const {
-        return _cloneNew<Float64Array>();
+    inline const std::vector<std::string>& getNodePaths() const {
+        return _paths;
     }
 
     [[nodiscard]]
-    inline std::vector<__ctype> getValues() const {
-        return _getValues<__ctype>();
+    inline const std::vector<int>& getShots() const {
+        return _shots;
     }
 
-    [[nodiscard]]
-    inline const __ctype &getValueAt(size_t index) const {
-        return _getValueAt<__ctype>(index);
+    inline void setShots(const std::vector<int>& shots) {
+        _shots = shots;
     }
 
-    [[nodiscard]]
-    inline const __ctype &operator[](size_t index) const {
-        return _getValueAt<__ctype>(index);
+    inline void setShotRange(int lower = INT_MIN, int higher = INT_MAX) {
+        _shots = Tree::getShotDB(_treename, _path, lower, higher);
     }
 
     [[nodiscard]]
-    inline const __ctype& at(size_t index) const {
-        return _at<__ctype>(index);
+    inline size_t getThreadCount() const {
+        return _threadCount;
     }
 
-    inline void setValues(const __ctype *values, uint32_t count) {
-        _setValues(__dtype, values, count);
+    inline void setThreadCount(size_t threadCount) {
+        _threadCount = threadCount;
     }
 
-    void setValues(
-        const __ctype *values,
-        const uint32_t *dims,
-        dimct_t dimCount
-    ) {
-        _setValues(__dtype, values, dims, dimCount);
-    }
+    template <typename DataType = Data, typename CallbackType>
+    void scan(CallbackType callback) const;
 
+    template <typename DataType = Data>
     [[nodiscard]]
-    inline const __ctype& front() const {
-        return _front<__ctype>();
-    }
+    std::vector<ShotData<DataType>> read() const;
 
-    [[nodiscard]]
-    inline const __ctype& back() const {
-        return _back<__ctype>();
-    }
+private:
 
-    [[nodiscard]]
-    inline __ctype * begin() const {
-        return _begin<__ctype>();
-    }
+    std::string _treename;
 
-    [[nodiscard]]
-    inline __ctype * end() const {
-        return _end<__ctype>();
-    }
+    std::string _path;
 
-    #ifdef __cpp_lib_span
+    std::vector<std::string> _paths;
 
-        inline Float64Array(
-            std::span<const __ctype> values,
-            const std::vector<uint32_t>& dims = {}
-        )
-            : Array(__dtype, values, dims)
-        { }
+    std::vector<int> _shots;
 
-        inline void setValues(
-            std::span<const __ctype> values,
-            const std::vector<uint32_t>& dims = {}
-        ) {
-            _setValues<__ctype>(__dtype, values, dims);
-        }
+    size_t _threadCount = 1;
 
-        inline Float64Array(
-            const std::vector<__ctype> &values,
-            const std::vector<uint32_t> &dims = {}
-        )
-            : Array(__dtype, std::span(values), dims)
-        { }
+    struct _ResolvedNIDs
+    {
+        std::vector<int> NIDs;
 
-        inline void setValues(
-            const std::vector<__ctype> &values,
-            const std::vector<uint32_t> &dims = {}
-        ) {
-            _setValues<__ctype>(__dtype, std::span(values), dims);
-        }
+        std::vector<int> Status;
 
-        inline std::span<__ctype> getSpan() const {
-            return _getSpan<__ctype>();
-        }
+        std::vector<size_t> Probes;
 
-    #else
+    }; // struct _ResolvedNIDs
 
-        inline Float64Array(
-            const std::vector<__ctype> &values,
-            const std::vector<uint32_t> &dims = {}
-        )
-            : Array(__dtype, values, dims)
-        { }
+    struct _ModelCache
+    {
+        std::mutex Mutex;
 
-        inline void setValues(
-            const std::vector<__ctype> &values,
-            const std::vector<uint32_t> &dims = {}
-        ) {
-            _setValues(__dtype, values, dims);
-        }
+        std::vector<std::shared_ptr<const _ResolvedNIDs>> Models;
 
-    #endif
+    }; // struct _ModelCache
 
-}; // class Float64Array
+    template <typename DataType, typename CallbackType>
+    void _scan(CallbackType callback) const;
 
-class Complex32Array : public Array
+    std::shared_ptr<const _ResolvedNIDs> _getNIDs(
+        const Tree& tree,
+        const std::shared_ptr<const _ResolvedNIDs>& current,
+        _ModelCache& cache
+    ) const;
+
+    std::shared_ptr<const _ResolvedNIDs> _resolveNIDs(const Tree& tree) const;
+
+    bool _matchesModel(const Tree& tree, const _ResolvedNIDs& resolved) const;
+
+    template <typename DataType>
+    void _readValues(Tree& tree, const _ResolvedNIDs& resolved, ShotData<DataType>& result) const;
+
+}; // class ShotScanner
+
+class TreeCache
 {
 public:
 
-    typedef std::complex<float> __ctype;
-    static constexpr DType __dtype = DType::FSC;
-
-    Complex32Array() = default;
+    using Handle = std::shared_ptr<const Tree>;
 
-    Complex32Array(Complex32Array &&) = default;
-    Complex32Array &operator=(Complex32Array &&) = default;
+    static TreeCache& GetGlobal() {
+        static TreeCache cache;
+        return cache;
+    }
 
-    inline Complex32Array(mdsdsc_xd_t &&xd, Tree *tree = nullptr)
-        : Array(std::move(xd), tree)
+    inline explicit TreeCache(size_t maxOpen = 16)
+        : _maxOpen(maxOpen)
     { }
 
-    inline Complex32Array(
-        std::initializer_list<__ctype> values,
-        const std::vector<uint32_t> &dims = {}
-    )
-        : Array(__dtype, std::vector<__ctype>(values.begin(), values.end()), dims)
-    { }
+    // Handles refer to Trees owned by the cache
+    TreeCache(const TreeCache&) = delete;
+    TreeCache& operator=(const TreeCache&) = delete;
 
-    inline const char * getClassName() const override {
-        return "Complex32Array";
-    }
+    Handle open(const std::string& treename, int shot, const std::string& path = {});
 
-    [[nodiscard]]
-    inline Complex32Array clone() const {
-        return _clone<Complex32Array>();
-    }
+    void erase(const std::string& treename, int shot, const std::string& path = {});
 
-    [[nodiscard]]
-    inline Complex32Array * cloneNew() const {
-        return _cloneNew<Complex32Array>();
-    }
+    void clear();
 
     [[nodiscard]]
-    inline std::vector<__ctype> getValues() const {
-        return _getValues<__ctype>();
-    }
+    size_t getMaxOpen() const;
+
+    void setMaxOpen(size_t maxOpen);
 
     [[nodiscard]]
-    inline const __ctype &getValueAt(size_t index) const {
-        return _getValueAt<__ctype>(index);
-    }
+    size_t getOpenCount() const;
 
     [[nodiscard]]
-    inline const __ctype &operator[](size_t index) const {
-        return _getValueAt<__ctype>(index);
-    }
+    size_t getHitCount() const;
 
     [[nodiscard]]
-    inline const __ctype& at(size_t index) const {
-        return _at<__ctype>(index);
-    }
+    size_t getMissCount() const;
 
-    inline void setValues(const __ctype *values, uint32_t count) {
-        _setValues(__dtype, values, count);
-    }
+private:
 
-    void setValues(
-        const __ctype *values,
-        const uint32_t *dims,
-        dimct_t dimCount
-    ) {
-        _setValues(__dtype, values, dims, dimCount);
-    }
+    // Lowercase tree name, shot, path
+    using _Key = std::tuple<std::string, int, std::string>;
 
-    [[nodiscard]]
-    inline const __ctype& front() const {
-        return _front<__ctype>();
-    }
+    struct _Entry
+    {
+        // Ready once the Tree has finished opening
+        std::shared_future<Handle> Future;
 
-    [[nodiscard]]
-    inline const __ctype& back() const {
-        return _back<__ctype>();
+        // Position in _recent
+        std::list<_Key>::iterator Recent;
+    };
+
+    mutable std::mutex _mutex;
+
+    size_t _maxOpen;
+
+    size_t _hitCount = 0;
+
+    size_t _missCount = 0;
+
+    // Most recently used first
+    std::list<_Key> _recent;
+
+    std::map<_Key, _Entry> _entries;
+
+    static _Key _makeKey(const std::string& treename, int shot, const std::string& path);
+
+    // Must be called with _mutex locked
+    void _evict();
+
+}; // class TreeCache
+
+enum class CompressionMethod
+{
+
+    Default = -1,
+
+    Standard = 0,
+
+    Gzip = 1,
+};
+
+inline std::string to_string(const CompressionMethod& method)
+{
+    switch (method) {
+    case CompressionMethod::Default: return "CompressionMethod::Default";
+    case CompressionMethod::Standard: return "CompressionMethod::Standard";
+    case CompressionMethod::Gzip: return "CompressionMethod::Gzip";
     }
 
+    return "?";
+}
+
+struct CompressionStats
+{
+    size_t Segments = 0;
+
+    uint64_t InputBytes = 0;
+
+    uint64_t OutputBytes = 0;
+
+    std::chrono::nanoseconds Duration = {};
+
     [[nodiscard]]
-    inline __ctype * begin() const {
-        return _begin<__ctype>();
+    inline double getRatio() const {
+        return (OutputBytes > 0 ? double(InputBytes) / double(OutputBytes) : 0.0);
     }
 
     [[nodiscard]]
-    inline __ctype * end() const {
-        return _end<__ctype>();
+    inline double getThroughput() const {
+        double seconds = std::chrono::duration<double>(Duration).count();
+        return (seconds > 0.0 ? double(InputBytes) / seconds : 0.0);
     }
 
-    #ifdef __cpp_lib_span
-
-        inline Complex32Array(
-            std::span<const __ctype> values,
-            const std::vector<uint32_t>& dims = {}
-        )
-            : Array(__dtype, values, dims)
-        { }
-
-        inline void setValues(
-            std::span<const __ctype> values,
-            const std::vector<uint32_t>& dims = {}
-        ) {
-            _setValues<__ctype>(__dtype, values, dims);
-        }
+}; // struct CompressionStats
 
-        inline Complex32Array(
-            const std::vector<__ctype> &values,
-            const std::vector<uint32_t> &dims = {}
-        )
-            : Array(__dtype, std::span(values), dims)
-        { }
+inline Data compress(const DataView& values, CompressionMethod method = CompressionMethod::Standard)
+{
+    mdsdsc_t * dscValues = _unwrapDescriptor(values.getDescriptor());
 
-        inline void setValues(
-            const std::vector<__ctype> &values,
-            const std::vector<uint32_t> &dims = {}
-        ) {
-            _setValues<__ctype>(__dtype, std::span(values), dims);
-        }
+    // The shared library and routine for each method, same as the table in treeshr
+    std::string_view image;
+    std::string_view routine;
+    if (method == CompressionMethod::Gzip) {
+        image = "MdsShr";
+        routine = "gzip";
+    }
 
-        inline std::span<__ctype> getSpan() const {
-            return _getSpan<__ctype>();
-        }
+    mdsdsc_t dscImage = {
+        .length = length_t(image.size()),
+        .dtype = DTYPE_T,
+        .class_ = CLASS_S,
+        .pointer = const_cast<char *>(image.data()),
+    };
 
-    #else
+    mdsdsc_t dscRoutine = {
+        .length = length_t(routine.size()),
+        .dtype = DTYPE_T,
+        .class_ = CLASS_S,
+        .pointer = const_cast<char *>(routine.data()),
+    };
 
-        inline Complex32Array(
-            const std::vector<__ctype> &values,
-            const std::vector<uint32_t> &dims = {}
-        )
-            : Array(__dtype, values, dims)
-        { }
+    mdsdsc_xd_t xd = MDSDSC_XD_INITIALIZER;
+    int status = MdsCompress(
+        (image.empty() ? nullptr : &dscImage),
+        (routine.empty() ? nullptr : &dscRoutine),
+        dscValues,
+        &xd
+    );
+    if (IS_NOT_OK(status)) {
+        throwException(status);
+    }
 
-        inline void setValues(
-            const std::vector<__ctype> &values,
-            const std::vector<uint32_t> &dims = {}
-        ) {
-            _setValues(__dtype, values, dims);
-        }
+    return Data(std::move(xd), values.getTree());
+}
 
-    #endif
+enum class OverflowPolicy
+{
 
-}; // class Complex32Array
+    Block,
 
-class Complex64Array : public Array
+    Drop,
+};
+
+template <typename ValueType>
+class SegmentWriter
 {
 public:
 
-    typedef std::complex<double> __ctype;
-    static constexpr DType __dtype = DType::FTC;
+    SegmentWriter(
+        const TreeNode& node,
+        uint32_t segmentLength,
+        size_t bufferSegments = 4,
+        const std::vector<uint32_t>& rowDims = {}
+    );
 
-    Complex64Array() = default;
+    SegmentWriter(
+        const TreeNode& node,
+        double start,
+        double delta,
+        uint32_t segmentLength,
+        size_t bufferSegments = 4,
+        const std::vector<uint32_t>& rowDims = {}
+    );
 
-    Complex64Array(Complex64Array &&) = default;
-    Complex64Array &operator=(Complex64Array &&) = default;
+    // The background thread refers to this object
+    SegmentWriter(const SegmentWriter&) = delete;
+    SegmentWriter& operator=(const SegmentWriter&) = delete;
 
-    inline Complex64Array(mdsdsc_xd_t &&xd, Tree *tree = nullptr)
-        : Array(std::move(xd), tree)
-    { }
+    ~SegmentWriter();
 
-    inline Complex64Array(
-        std::initializer_list<__ctype> values,
-        const std::vector<uint32_t> &dims = {}
-    )
-        : Array(__dtype, std::vector<__ctype>(values.begin(), values.end()), dims)
-    { }
+    bool putRow(const ValueType * row, int64_t timestamp = 0);
 
-    inline const char * getClassName() const override {
-        return "Complex64Array";
+    inline bool putRow(const ValueType& value, int64_t timestamp = 0) {
+        if (_rowSize != 1) {
+            throwException(TreeFAILURE);
+        }
+        return putRow(&value, timestamp);
     }
 
-    [[nodiscard]]
-    inline Complex64Array clone() const {
-        return _clone<Complex64Array>();
+    inline bool putRow(const std::vector<ValueType>& row, int64_t timestamp = 0) {
+        if (row.size() != _rowSize) {
+            throwException(TreeFAILURE);
+        }
+        return putRow(row.data(), timestamp);
     }
 
-    [[nodiscard]]
-    inline Complex64Array * cloneNew() const {
-        return _cloneNew<Complex64Array>();
-    }
+    void flush();
 
     [[nodiscard]]
-    inline std::vector<__ctype> getValues() const {
-        return _getValues<__ctype>();
+    inline OverflowPolicy getOverflowPolicy() const {
+        return _overflowPolicy;
     }
 
-    [[nodiscard]]
-    inline const __ctype &getValueAt(size_t index) const {
-        return _getValueAt<__ctype>(index);
+    inline void setOverflowPolicy(OverflowPolicy policy) {
+        _overflowPolicy = policy;
     }
 
     [[nodiscard]]
-    inline const __ctype &operator[](size_t index) const {
-        return _getValueAt<__ctype>(index);
+    inline size_t getRowSize() const {
+        return _rowSize;
     }
 
     [[nodiscard]]
-    inline const __ctype& at(size_t index) const {
-        return _at<__ctype>(index);
-    }
-
-    inline void setValues(const __ctype *values, uint32_t count) {
-        _setValues(__dtype, values, count);
-    }
-
-    void setValues(
-        const __ctype *values,
-        const uint32_t *dims,
-        dimct_t dimCount
-    ) {
-        _setValues(__dtype, values, dims, dimCount);
+    inline uint32_t getSegmentLength() const {
+        return _segmentLength;
     }
 
     [[nodiscard]]
-    inline const __ctype& front() const {
-        return _front<__ctype>();
+    inline size_t getSegmentCount() const {
+        return _segmentCount;
     }
 
     [[nodiscard]]
-    inline const __ctype& back() const {
-        return _back<__ctype>();
+    inline size_t getBackpressureCount() const {
+        return _backpressureCount;
     }
 
     [[nodiscard]]
-    inline __ctype * begin() const {
-        return _begin<__ctype>();
+    inline size_t getDroppedRowCount() const {
+        return _droppedRowCount;
     }
 
     [[nodiscard]]
-    inline __ctype * end() const {
-        return _end<__ctype>();
-    }
+    size_t getPendingSegmentCount() const;
 
-    #ifdef __cpp_lib_span
+private:
 
-        inline Complex64Array(
-            std::span<const __ctype> values,
-            const std::vector<uint32_t>& dims = {}
-        )
-            : Array(__dtype, values, dims)
-        { }
+    struct _Slot
+    {
+        std::vector<ValueType> Values = {};
 
-        inline void setValues(
-            std::span<const __ctype> values,
-            const std::vector<uint32_t>& dims = {}
-        ) {
-            _setValues<__ctype>(__dtype, values, dims);
-        }
+        std::vector<int64_t> Timestamps = {};
 
-        inline Complex64Array(
-            const std::vector<__ctype> &values,
-            const std::vector<uint32_t> &dims = {}
-        )
-            : Array(__dtype, std::span(values), dims)
-        { }
+        // Set when the slot is submitted
+        uint32_t Rows = 0;
 
-        inline void setValues(
-            const std::vector<__ctype> &values,
-            const std::vector<uint32_t> &dims = {}
-        ) {
-            _setValues<__ctype>(__dtype, std::span(values), dims);
-        }
+        // Index of the first row in the whole signal, used to compute times for Range dimensions
+        uint64_t FirstRow = 0;
+    };
 
-        inline std::span<__ctype> getSpan() const {
-            return _getSpan<__ctype>();
-        }
+    TreeNode _node;
 
-    #else
+    bool _timestamped;
 
-        inline Complex64Array(
-            const std::vector<__ctype> &values,
-            const std::vector<uint32_t> &dims = {}
-        )
-            : Array(__dtype, values, dims)
-        { }
+    double _start = 0.0;
 
-        inline void setValues(
-            const std::vector<__ctype> &values,
-            const std::vector<uint32_t> &dims = {}
-        ) {
-            _setValues(__dtype, values, dims);
-        }
+    double _delta = 0.0;
 
-    #endif
+    uint32_t _segmentLength;
 
-}; // class Complex64Array
+    std::vector<uint32_t> _rowDims;
 
-#ifdef __cpp_lib_span
+    size_t _rowSize = 1;
 
-    #define MDSPLUS_ARRAY_CUSTOMIZATION_SPAN(ArrayType)    \
-        template <>                                        \
-        inline Data Data::FromArray(                       \
-            std::span<const ArrayType::__ctype> values,    \
-            const std::vector<uint32_t>& dims /*= {}*/     \
-        ) {                                                \
-            return ArrayType(values, dims);                \
-        }                                                  \
-                                                           \
-        template <>                                        \
-        inline Data Data::FromArray(                       \
-            const std::vector<ArrayType::__ctype>& values, \
-            const std::vector<uint32_t>& dims /*= {}*/     \
-        ) {                                                \
-            return ArrayType(std::span(values), dims);     \
-        }
+    OverflowPolicy _overflowPolicy = OverflowPolicy::Block;
 
-#else
+    std::vector<_Slot> _slots;
 
-    #define MDSPLUS_ARRAY_CUSTOMIZATION_SPAN(ArrayType)    \
-                                                           \
-        template <>                                        \
-        inline Data Data::FromArray(                       \
-            const std::vector<ArrayType::__ctype>& values, \
-            const std::vector<uint32_t>& dims /*= {}*/     \
-        ) {                                                \
-            return ArrayType(values, dims);                \
-        }
+    // Only used by the thread calling putRow()
+    size_t _writeSlot = 0;
+    uint32_t _rows = 0;
+    uint64_t _nextRow = 0;
 
-#endif
+    // Guarded by _mutex
+    size_t _flushSlot = 0;
+    size_t _pending = 0;
+    bool _stop = false;
+    std::exception_ptr _error;
 
-#define MDSPLUS_ARRAY_CUSTOMIZATION(ArrayType)                     \
-                                                                   \
-    template <>                                                    \
-    inline ArrayType Data::releaseAndConvert() {                   \
-        return _convertToArray<ArrayType>();                       \
-    }                                                              \
-                                                                   \
-    template <>                                                    \
-    inline std::vector<ArrayType::__ctype> Data::getData() const { \
-        return getData<ArrayType>().getValues();                   \
-    }                                                              \
-                                                                   \
-    MDSPLUS_ARRAY_CUSTOMIZATION_SPAN(ArrayType)
+    mutable std::mutex _mutex;
 
-MDSPLUS_ARRAY_CUSTOMIZATION(Int8Array)
-MDSPLUS_ARRAY_CUSTOMIZATION(Int16Array)
-MDSPLUS_ARRAY_CUSTOMIZATION(Int32Array)
-MDSPLUS_ARRAY_CUSTOMIZATION(Int64Array)
-MDSPLUS_ARRAY_CUSTOMIZATION(UInt8Array)
-MDSPLUS_ARRAY_CUSTOMIZATION(UInt16Array)
-MDSPLUS_ARRAY_CUSTOMIZATION(UInt32Array)
-MDSPLUS_ARRAY_CUSTOMIZATION(UInt64Array)
-MDSPLUS_ARRAY_CUSTOMIZATION(Float32Array)
-MDSPLUS_ARRAY_CUSTOMIZATION(Float64Array)
-MDSPLUS_ARRAY_CUSTOMIZATION(Complex32Array)
-MDSPLUS_ARRAY_CUSTOMIZATION(Complex64Array)
+    // Signalled when a segment is ready to be written, or when one has been written
+    std::condition_variable _ready;
+    std::condition_variable _written;
 
-class APD : public Array
+    std::atomic<size_t> _segmentCount = 0;
+
+    std::atomic<size_t> _backpressureCount = 0;
+
+    std::atomic<size_t> _droppedRowCount = 0;
+
+    std::thread _thread;
+
+    void _initialize(size_t bufferSegments);
+
+    // Hand the current slot to the background thread
+    void _submit();
+
+    void _run();
+
+    void _write(const _Slot& slot);
+
+    void _rethrow();
+
+}; // class SegmentWriter
+
+template <typename ValueArrayType = Data, typename DimensionType = Data>
+struct SegmentData
+{
+    int Index = -1;
+
+    ValueArrayType Values = {};
+
+    DimensionType Dimension = {};
+
+}; // struct SegmentData
+
+template <typename ValueArrayType = Data, typename DimensionType = Data>
+class SegmentReader
 {
 public:
 
-    static constexpr Class __class = Class::APD;
+    SegmentReader(const TreeNode& node, size_t prefetch = 2, int first = 0, int last = -1);
 
-    APD() = default;
+    // The background thread refers to this object
+    SegmentReader(const SegmentReader&) = delete;
+    SegmentReader& operator=(const SegmentReader&) = delete;
 
-    inline APD(mdsdsc_xd_t && dsc, Tree * tree = nullptr)
-        : Array(std::move(dsc), tree)
-    { }
+    ~SegmentReader();
 
-    APD(APD&&) = default;
-    APD& operator=(APD&&) = default;
+    bool next(SegmentData<ValueArrayType, DimensionType>& segment);
 
-    template <typename ...ArgTypes>
-    inline APD(DType dtype, const ArgTypes& ...args) {
-        _append(dtype, args...);
+    [[nodiscard]]
+    inline int getFirst() const {
+        return _first;
     }
 
-protected:
+    [[nodiscard]]
+    inline int getLast() const {
+        return _last;
+    }
 
-    inline mdsdsc_t ** _getDescriptorArray() const {
-        return reinterpret_cast<mdsdsc_t **>(getPointer());
+    [[nodiscard]]
+    inline size_t getPrefetch() const {
+        return _prefetch;
     }
 
-    template <typename ...ArgTypes>
-    inline void _append(DType dtype, const ArgTypes& ...args)
-    {
-        std::vector<DataView> argList = { DataView(args)... };
+    [[nodiscard]]
+    size_t getStallCount() const;
 
-        std::vector<mdsdsc_t *> dscList;
-        for (size_t i = 0; i < argList.size(); ++i) {
-            dscList.push_back(argList[i].getDescriptor());
-        }
+private:
 
-        _append(dtype, dscList);
-    }
+    TreeNode _node;
 
-    inline void _append(DType dtype, std::vector<mdsdsc_t *> values)
-    {
-        std::vector<mdsdsc_t *> dscList = _getValues<mdsdsc_t *>();
-        dscList.reserve(dscList.size() + values.size());
-        dscList.insert(dscList.end(), values.begin(), values.end());
+    size_t _prefetch;
 
-        DESCRIPTOR_APD(dsc, dtype_t(dtype), dscList.data(), 0);
+    int _first;
 
-        // TODO: Replace the 0 above with dscList.size() once a cast to arsize_t is added
-        dsc.arsize = arsize_t(dscList.size() * sizeof(mdsdsc_t *));
+    int _last;
 
-        mdsdsc_xd_t tmpXD = std::move(_xd);
+    // The index of the next segment returned by next()
+    int _next;
 
-        int status = MdsCopyDxXd((mdsdsc_t *)&dsc, &_xd);
-        if (IS_NOT_OK(status)) {
-            throwException(status);
-        }
+    std::unique_ptr<Tree> _tree;
 
-        MdsFree1Dx(&tmpXD, nullptr);
-    }
+    // Guarded by _mutex
+    std::deque<SegmentData<ValueArrayType, DimensionType>> _ready;
+    std::exception_ptr _error;
+    bool _stop = false;
+    size_t _stallCount = 0;
 
-}; // class APD
+    mutable std::mutex _mutex;
 
-class List : public APD
-{
-public:
+    // Signalled when a segment has been read, or when there is room to read another
+    std::condition_variable _read;
+    std::condition_variable _taken;
 
-    static constexpr DType __dtype = DType::List;
+    std::thread _thread;
 
-    inline List(mdsdsc_xd_t && dsc, Tree * tree = nullptr)
-        : APD(std::move(dsc), tree)
-    { }
+    void _run();
 
-    template <typename ...ArgTypes>
-    inline List(const ArgTypes& ...args)
-        : APD(__dtype, args...)
-    { }
+}; // class SegmentReader
 
-    template <typename DataType>
-    inline List(const std::vector<DataType>& values)
-    {
-        std::vector<mdsdsc_t *> dscList;
-        for (size_t i = 0; i < values.size(); ++i) {
-            dscList.push_back(values[i].getDescriptor());
-        }
+template <typename ValueArrayType = Float64Array>
+class SignalView
+{
+public:
 
-        _append(__dtype, dscList);
-    }
+    using ValueType = typename ValueArrayType::__ctype;
 
-    inline const char * getClassName() const override {
-        return "List";
-    }
+    explicit SignalView(const Signal& signal);
 
-    template <typename ...ArgTypes>
-    inline void append(ArgTypes ...args) {
-        _append(__dtype, args...);
+    [[nodiscard]]
+    inline size_t size() const {
+        return _values.getSize();
     }
 
-    inline std::vector<Data> getValues() const
-    {
-        int status;
+    [[nodiscard]]
+    inline const ValueArrayType& getValues() const {
+        return _values;
+    }
 
-        #ifdef __cpp_lib_span
-            std::span<mdsdsc_t *> dscList = _getSpan<mdsdsc_t *>();
-        #else
-            std::vector<mdsdsc_t *> dscList = _getValues<mdsdsc_t *>();
-        #endif
+    [[nodiscard]]
+    inline const ValueType * data() const {
+        return _values.begin();
+    }
 
-        std::vector<Data> values;
-        for (mdsdsc_t * dsc : dscList) {
-            mdsdsc_xd_t out = MDSDSC_XD_INITIALIZER;
-            status = MdsCopyDxXd(dsc, &out);
-            if (IS_NOT_OK(status)) {
-                throwException(status);
-            }
+    #ifdef __cpp_lib_span
 
-            values.emplace_back(Data(std::move(out), getTree()));
+        [[nodiscard]]
+        inline std::span<const ValueType> getSpan() const {
+            return std::span<const ValueType>(_values.begin(), size());
         }
 
-        return std::move(values);
+    #endif // __cpp_lib_span
+
+    [[nodiscard]]
+    inline const Timebase& getTimebase() const {
+        return _timebase;
     }
 
-    // STL Compatibility
+    [[nodiscard]]
+    inline ValueType operator[](size_t index) const {
+        return data()[index];
+    }
 
-    struct Iterator
-    {
-    public:
+    [[nodiscard]]
+    inline double getTime(size_t index) const {
+        return _timebase.getTime(index);
+    }
 
-        Iterator(size_t index, const List * list)
-            : _index(index)
-            , _list(list)
-        { }
+    [[nodiscard]]
+    inline size_t getIndex(double time) const {
+        return std::min(_timebase.getIndex(time), (size() == 0 ? 0 : size() - 1));
+    }
 
-        inline Data operator*() const
-        {
-            mdsdsc_xd_t out = MDSDSC_XD_INITIALIZER;
-            mdsdsc_a_t * dsc = _list->getArrayDescriptor();
+    [[nodiscard]]
+    inline ValueType getValueAt(double time) const {
+        if (size() == 0) {
+            throw TdiBadIndex();
+        }
+        return data()[getIndex(time)];
+    }
 
-            mdsdsc_t * tmp = _list->_getDescriptorArray()[_index];
-            int status = MdsCopyDxXd(tmp, &out);
-            if (IS_NOT_OK(status)) {
-                throwException(status);
-            }
+private:
 
-            return Data(std::move(out), _list->getTree());
-        }
+    ValueArrayType _values;
 
-        inline mdsdsc_t * operator->() const {
-            return _list->_getDescriptorArray()[_index];
-        }
+    Timebase _timebase;
 
-        inline Iterator& operator++() {
-            _index++;
-            return *this;
-        }
+}; // class SignalView
 
-        inline Iterator operator++(int) {
-            Iterator tmp = *this;
-            ++(*this);
-            return tmp;
-        }
+class MultiChannelWriter
+{
+public:
 
-        inline friend bool operator==(const Iterator& a, const Iterator& b) {
-            return (a._index == b._index && a._list == b._list);
-        };
+    inline MultiChannelWriter(const std::vector<TreeNode>& channels)
+        : _channels(channels)
+        , _compressionMethods(channels.size(), CompressionMethod::Default)
+    { }
 
-        inline friend bool operator!=(const Iterator& a, const Iterator& b) {
-            return (a._index != b._index || a._list != b._list);
-        };
+    [[nodiscard]]
+    inline const std::vector<TreeNode>& getChannels() const {
+        return _channels;
+    }
 
-    private:
+    [[nodiscard]]
+    inline size_t getThreadCount() const {
+        return _threadCount;
+    }
 
-        size_t _index;
+    inline void setThreadCount(size_t threadCount) {
+        _threadCount = std::max<size_t>(threadCount, 1);
+    }
 
-        const List * _list;
+    [[nodiscard]]
+    inline bool isCompressionEnabled() const {
+        return _compressionEnabled;
+    }
 
-    };
+    inline void setCompressionEnabled(bool enabled) {
+        _compressionEnabled = enabled;
+    }
 
-    inline Iterator begin() const {
-        return Iterator(0, this);
+    [[nodiscard]]
+    inline CompressionMethod getCompressionMethod(size_t channel) const {
+        return _compressionMethods.at(channel);
     }
 
-    inline Iterator end() const {
-        return Iterator(getSize(), this);
+    inline void setCompressionMethod(size_t channel, CompressionMethod method) {
+        _compressionMethods.at(channel) = method;
     }
 
-}; // class List
+    inline void setCompressionMethod(CompressionMethod method) {
+        std::fill(_compressionMethods.begin(), _compressionMethods.end(), method);
+    }
 
-class Dictionary : public APD
-{
-public:
+    [[nodiscard]]
+    inline const CompressionStats& getCompressionStats() const {
+        return _compressionStats;
+    }
 
-    static constexpr DType __dtype = DType::Dictionary;
+    inline void resetCompressionStats() {
+        _compressionStats = {};
+    }
 
-    inline Dictionary(mdsdsc_xd_t && dsc, Tree * tree = nullptr)
-        : APD(std::move(dsc), tree)
-    { }
+    template <
+        typename StartIndexType,
+        typename EndIndexType,
+        typename DimensionType,
+        typename ValueType
+    >
+    void makeSegment(
+        const StartIndexType& startIndex,
+        const EndIndexType& endIndex,
+        const DimensionType& dimension,
+        const ValueType * block,
+        uint32_t samples,
+        int rowsFilled = -1
+    );
 
-    template <typename KeyType, typename ValueType,
-        typename std::enable_if<is_valid_ctype<KeyType>::value, bool>::type = true,
-        typename std::enable_if<is_valid_ctype<ValueType>::value, bool>::type = true>
-    inline Dictionary(const std::map<KeyType, ValueType>& map)
-    {
-        std::vector<Data> values;
-        for (const auto& it : map) {
-            values.emplace_back(Data::FromScalar(it->first));
-            values.emplace_back(Data::FromScalar(it->second));
-        }
+    template <
+        typename StartIndexType,
+        typename EndIndexType,
+        typename DimensionType,
+        typename ValueType
+    >
+    inline void makeSegment(
+        const StartIndexType& startIndex,
+        const EndIndexType& endIndex,
+        const DimensionType& dimension,
+        const std::vector<ValueType>& block,
+        int rowsFilled = -1
+    ) {
+        makeSegment(startIndex, endIndex, dimension, block.data(), _getSamples(block.size()), rowsFilled);
     }
 
-    inline Dictionary(const std::vector<Data>& keys, const std::vector<Data>& values)
-    {
-        assert(keys.size() == values.size());
+    template <typename ValueType>
+    void makeTimestampedSegment(
+        const int64_t * timestamps,
+        const ValueType * block,
+        uint32_t samples,
+        int rowsFilled = -1
+    );
 
-        std::vector<mdsdsc_t *> dscList = _getValues<mdsdsc_t *>();
-        for (size_t i = 0; i < keys.size(); ++i) {
-            dscList.push_back(keys[i].getDescriptor());
-            dscList.push_back(values[i].getDescriptor());
+    template <typename ValueType>
+    inline void makeTimestampedSegment(
+        const std::vector<int64_t>& timestamps,
+        const std::vector<ValueType>& block,
+        int rowsFilled = -1
+    ) {
+        uint32_t samples = _getSamples(block.size());
+        if (timestamps.size() != samples) {
+            throwException(TreeFAILURE);
         }
+        makeTimestampedSegment(timestamps.data(), block.data(), samples, rowsFilled);
+    }
 
-        DESCRIPTOR_APD(dsc, dtype_t(__dtype), dscList.data(), 0);
+private:
 
-        // TODO: Replace the 0 above with dscList.size() once a cast to arsize_t is added
-        dsc.arsize = arsize_t(dscList.size() * sizeof(mdsdsc_t *));
+    std::vector<TreeNode> _channels;
 
-        int status = MdsCopyDxXd((mdsdsc_t *)&dsc, &_xd);
-        if (IS_NOT_OK(status)) {
-            throwException(status);
-        }
-    }
+    size_t _threadCount = 1;
 
-    template <typename ...ArgTypes,
-        typename std::enable_if<(sizeof...(ArgTypes) % 2) == 0, bool>::type = true>
-    inline Dictionary(const ArgTypes& ...args)
-        : APD(__dtype, args...)
-    { }
+    bool _compressionEnabled = false;
 
-    inline const char * getClassName() const override {
-        return "Dictionary";
-    }
+    std::vector<CompressionMethod> _compressionMethods;
 
-    template <typename KeyType, typename ValueType>
-    void append(KeyType key, ValueType value) {
-        _append(__dtype, key, value);
-    }
+    CompressionStats _compressionStats;
 
-    inline std::tuple<std::vector<Data>, std::vector<Data>> getKeysAndValues() const {
-        int status;
+    uint32_t _getSamples(size_t blockSize) const;
 
-        #ifdef __cpp_lib_span
-            std::span<mdsdsc_t *> dscList = _getSpan<mdsdsc_t *>();
-        #else
-            std::vector<mdsdsc_t *> dscList = _getValues<mdsdsc_t *>();
-        #endif
+    // Compress every channel's share of the block, split between _threadCount threads
+    template <typename ValueType>
+    std::vector<Data> _compressChannels(const ValueType * block, uint32_t samples);
 
-        assert((dscList.size() % 2) == 0);
+}; // class MultiChannelWriter
 
-        std::vector<Data> keys;
-        std::vector<Data> values;
-        for (size_t i = 0; i < dscList.size(); i += 2) {
-            mdsdsc_xd_t outKey = MDSDSC_XD_INITIALIZER;
-            mdsdsc_xd_t outValue = MDSDSC_XD_INITIALIZER;
+inline std::string to_string(const Class& class_)
+{
+    switch (class_) {
+        case Class::Missing: return"Class::Missing";
+        case Class::S: return"Class::S";
+        case Class::D: return"Class::D";
+        case Class::A: return"Class::A";
+        case Class::XD: return"Class::XD";
+        case Class::XS: return"Class::XS";
+        case Class::R: return"Class::R";
+        case Class::CA: return"Class::CA";
+        case Class::APD: return"Class::APD";
+    }
 
-            status = MdsCopyDxXd(dscList[i], &outKey);
-            if (IS_NOT_OK(status)) {
-                throwException(status);
-            }
+    return "?";
+}
 
-            status = MdsCopyDxXd(dscList[i + 1], &outValue);
-            if (IS_NOT_OK(status)) {
-                throwException(status);
-            }
+inline std::string to_string(const DType& dtype)
+{
+    switch (dtype) {
+        case DType::Missing: return "DType::Missing";
+        case DType::BU: return "DType::BU";
+        case DType::WU: return "DType::WU";
+        case DType::LU: return "DType::LU";
+        case DType::QU: return "DType::QU";
+        case DType::B: return "DType::B";
+        case DType::W: return "DType::W";
+        case DType::L: return "DType::L";
+        case DType::Q: return "DType::Q";
+        case DType::F: return "DType::F";
+        case DType::D: return "DType::D";
+        case DType::FC: return "DType::FC";
+        case DType::DC: return "DType::DC";
+        case DType::T: return "DType::T";
+        case DType::DSC: return "DType::DSC";
+        case DType::OU: return "DType::OU";
+        case DType::O: return "DType::O";
+        case DType::G: return "DType::G";
+        case DType::H: return "DType::H";
+        case DType::GC: return "DType::GC";
+        case DType::HC: return "DType::HC";
 
-            // keys.emplace(std::move(outKey), getTree());
-            // values.emplace(std::move(outValue), getTree());
-        }
+        case DType::Pointer: return "DType::Pointer";
+        case DType::FS: return "DType::FS";
+        case DType::FT: return "DType::FT";
+        case DType::FSC: return "DType::FSC";
+        case DType::FTC: return "DType::FTC";
+        case DType::C: return "DType::C";
 
-        return { std::move(keys), std::move(values) };
+        case DType::List: return "DType::List";
+        case DType::Tuple: return "DType::Tuple";
+        case DType::Dictionary: return "DType::Dictionary";
+
+        case DType::Ident: return "DType::Ident";
+        case DType::NID: return "DType::NID";
+        case DType::Path: return "DType::Path";
+        case DType::Param: return "DType::Param";
+        case DType::Signal: return "DType::Signal";
+        case DType::Dimension: return "DType::Dimension";
+        case DType::Window: return "DType::Window";
+        case DType::Slope: return "DType::Slope";
+        case DType::Function: return "DType::Function";
+        case DType::Conglom: return "DType::Conglom";
+        case DType::Range: return "DType::Range";
+        case DType::Action: return "DType::Action";
+        case DType::Dispatch: return "DType::Dispatch";
+        case DType::Program: return "DType::Program";
+        case DType::Routine: return "DType::Routine";
+        case DType::Procedure: return "DType::Procedure";
+        case DType::Method: return "DType::Method";
+        case DType::Dependency: return "DType::Dependency";
+        case DType::Condition: return "DType::Condition";
+        case DType::Event: return "DType::Event";
+        case DType::WithUnits: return "DType::WithUnits";
+        case DType::Call: return "DType::Call";
+        case DType::WithError: return "DType::WithError";
+        case DType::Opaque: return "DType::Opaque";
     }
 
-    template <typename KeyType = Data, typename ValueType = Data,
-        typename std::enable_if<std::is_base_of<Data, KeyType>::value, bool>::type = true,
-        typename std::enable_if<std::is_base_of<Data, ValueType>::value, bool>::type = true>
-    inline std::unordered_map<KeyType, ValueType> getUnorderedMap() const {
-        int status;
+    return "?";
+}
 
-        #ifdef __cpp_lib_span
-            std::span<mdsdsc_t *> dscList = _getSpan<mdsdsc_t *>();
-        #else
-            std::vector<mdsdsc_t *> dscList = _getValues<mdsdsc_t *>();
-        #endif
+inline std::string to_string(const Data * data)
+{
+    assert(data);
 
-        assert((dscList.size() % 2) == 0);
+    std::string str(data->getClassName());
+    str += "(";
+    str += to_string(data->getClass());
+    str += ", ";
+    str += to_string(data->getDType());
+    str += ", `";
+    str += data->decompile();
+    str += "`)";
 
-        std::unordered_map<KeyType, ValueType> values;
-        for (size_t i = 0; i < dscList.size(); i += 2) {
-            mdsdsc_xd_t outKey = MDSDSC_XD_INITIALIZER;
-            mdsdsc_xd_t outValue = MDSDSC_XD_INITIALIZER;
+    return str;
+}
 
-            status = MdsCopyDxXd(dscList[i], &outKey);
-            if (IS_NOT_OK(status)) {
-                throwException(status);
-            }
+inline std::string Data::decompile() const
+{
+    int status;
 
-            status = MdsCopyDxXd(dscList[i + 1], &outValue);
-            if (IS_NOT_OK(status)) {
-                throwException(status);
-            }
+    mdsdsc_t * dsc = getDescriptor();
+    mdsdsc_xd_t out = MDSDSC_XD_INITIALIZER;
+    status = _intrinsic(OPC_DECOMPILE, 1, &dsc, &out);
+    if (IS_NOT_OK(status)) {
+        throwException(status);
+    }
 
-            values.emplace(
-                Data(std::move(outKey), getTree()).releaseAndConvert<KeyType>(),
-                Data(std::move(outValue), getTree()).releaseAndConvert<ValueType>()
-            );
-        }
+    mdsdsc_t * deco = out.pointer;
+    assert(deco->dtype == DTYPE_T);
 
-        return std::move(values);
-    }
+    std::string decompile(deco->pointer, deco->length);
 
-}; // class Dictionary
+    status = MdsFree1Dx(&out, nullptr);
+    if (IS_NOT_OK(status)) {
+        throwException(status);
+    }
 
-// TODO: Tuple
+    return decompile;
+}
 
-class Record : public Data
+inline Data Data::serialize() const
 {
-public:
-
-    static constexpr Class __class = Class::R;
+    mdsdsc_t * dsc = getDescriptor();
+    mdsdsc_xd_t out = MDSDSC_XD_INITIALIZER;
+    int status = MdsSerializeDscOut(dsc, &out);
+    if (IS_NOT_OK(status)) {
+        throwException(status);
+    }
 
-    Record() = default;
+    return Data(std::move(out), getTree());
+}
 
-    inline Record(mdsdsc_xd_t && dsc, Tree * tree = nullptr)
-        : Data(std::move(dsc), tree)
-    { }
+template <typename UnitsType /*= Data*/>
+inline UnitsType Data::getUnits() const
+{
+    mdsdsc_xd_t out = MDSDSC_XD_INITIALIZER;
+    mdsdsc_t * dsc = getDescriptor();
+    int status = _intrinsic(OPC_UNITS_OF, 1, &dsc, &out);
+    if (IS_NOT_OK(status)) {
+        throwException(status);
+    }
 
-    Record(Record&&) = default;
-    Record& operator=(Record&&) = default;
+    return Data(std::move(out)).releaseAndConvert<UnitsType>();
+}
 
-    virtual ~Record() = default;
+template <typename DataType /*= Data*/, typename UnitsType /*= Data*/>
+std::tuple<DataType, UnitsType> Data::getDataWithUnits() const
+{
+    // We could use OPC_DATA_WITH_UNITS to upcast it to a WithUnits() type,
+    // but returning a tuple is a cleaner API
+    return { getData<DataType>(), getUnits<UnitsType>() };
+}
 
-    [[nodiscard]]
-    inline mdsdsc_r_t * getRecordDescriptor() const {
-        return reinterpret_cast<mdsdsc_r_t *>(_xd.pointer);
+template <typename ErrorType /*= Data*/>
+inline ErrorType Data::getError() const
+{
+    mdsdsc_xd_t out = MDSDSC_XD_INITIALIZER;
+    mdsdsc_t * dsc = getDescriptor();
+    int status = _intrinsic(OPC_ERROR_OF, 1, &dsc, &out);
+    if (IS_NOT_OK(status)) {
+        throwException(status);
     }
 
-    inline size_t getNumDescriptors() const {
-        mdsdsc_r_t * dsc = getRecordDescriptor();
-        return (dsc ? dsc->ndesc : 0);
-    }
+    return Data(std::move(out)).releaseAndConvert<ErrorType>();
+}
 
-    inline bool hasDescriptorAt(size_t index) const {
-        mdsdsc_r_t * dsc = getRecordDescriptor();
-        return (dsc && index < dsc->ndesc && dsc->dscptrs[index] != nullptr);
+template <typename HelpType /*= Data*/>
+inline HelpType Data::getHelp() const
+{
+    mdsdsc_xd_t out = MDSDSC_XD_INITIALIZER;
+    mdsdsc_t * dsc = getDescriptor();
+    int status = _intrinsic(OPC_HELP_OF, 1, &dsc, &out);
+    if (status == TdiINVDTYDSC) {
+        // Unlike UNITS_OF and ERROR_OF, this throws an error when there is no value
+        return HelpType();
+    }
+    else if (IS_NOT_OK(status)) {
+        throwException(status);
     }
 
-    template <typename ResultType = Data>
-    inline ResultType getDescriptorAt(size_t index) const {
-        mdsdsc_r_t * dsc = getRecordDescriptor();
+    return Data(std::move(out)).releaseAndConvert<HelpType>();
+}
 
-        if (dsc && index < dsc->ndesc) {
-            mdsdsc_xd_t xd = MDSDSC_XD_INITIALIZER;
-            int status = MdsCopyDxXd(dsc->dscptrs[index], &xd);
-            if (IS_NOT_OK(status)) {
-                throwException(status);
-            }
+template <typename ValidationType /*= Data*/>
+inline ValidationType Data::getValidation() const
+{
+    mdsdsc_xd_t out = MDSDSC_XD_INITIALIZER;
+    mdsdsc_t * dsc = getDescriptor();
+    int status = _intrinsic(OPC_ERROR_OF, 1, &dsc, &out);
+    if (status == TdiINVDTYDSC) {
+        // Unlike UNITS_OF and ERROR_OF, this throws an error when there is no value
+        return ValidationType();
+    }
+    else if (IS_NOT_OK(status)) {
+        throwException(status);
+    }
 
-            mdsdsc_t * newDsc = xd.pointer;
-            if (Class(newDsc->class_) == ResultType::__class && DType(newDsc->dtype) == ResultType::__dtype) {
-                return ResultType(std::move(xd), getTree());
-            }
+    return Data(std::move(out)).releaseAndConvert<ValidationType>();
+}
 
-            return Data(std::move(xd), getTree()).releaseAndConvert<ResultType>();
-        }
+template <typename ResultType /*= Data*/, typename ...ArgTypes>
+ResultType Data::Compile(const std::string& expression, const ArgTypes& ...args)
+{
+    DataView argExp(expression);
+    std::vector<DataView> argList = { DataView(args)... };
 
-        return ResultType();
+    std::vector<mdsdsc_t *> dscList = { argExp.getDescriptor() };
+    for (const auto& arg : argList) {
+        dscList.push_back(arg.getDescriptor());
     }
 
-protected:
-
-    void _setTree(Tree * tree)
-    {
-        // Don't overwrite our tree with nullptr
-        if (!tree) {
-            return;
-        }
-
-        // We can't reference two trees at once
-        if (getTree() && tree != getTree()) {
-            // TODO: Throw custom exception?
-            throw TdiArgumentMismatch();
-        }
+    TraceScope span(TraceEvent::TDI, expression);
 
-        setTree(tree);
+    mdsdsc_xd_t out = MDSDSC_XD_INITIALIZER;
+    int status = TdiIntrinsic(OPC_COMPILE, dscList.size(), dscList.data(), &out);
+    span.setStatus(status);
+    span.addBytes(out.l_length);
+    if (IS_NOT_OK(status)) {
+        throwException(status);
     }
 
-}; // class Record
+    return Data(std::move(out)).releaseAndConvert<ResultType>();
+}
 
-#define MDSPLUS_RECORD_BOOTSTRAP(RecordType, DataType)           \
-                                                                 \
-    static constexpr DType __dtype = DataType;                   \
-                                                                 \
-    RecordType() = default;                                      \
-                                                                 \
-    inline RecordType(mdsdsc_xd_t && dsc, Tree * tree = nullptr) \
-        : Record(std::move(dsc), tree)                           \
-    { }                                                          \
-                                                                 \
-    RecordType(RecordType &&) = default;                         \
-    RecordType &operator=(RecordType &&) = default;              \
-                                                                 \
-    inline const char * getClassName() const override {          \
-        return #RecordType;                                      \
-    }                                                            \
-                                                                 \
-    [[nodiscard]]                                                \
-    inline RecordType clone() const {                            \
-        return _clone<RecordType>();                             \
-    }                                                            \
-                                                                 \
-    [[nodiscard]]                                                \
-    inline RecordType * cloneNew() const {                       \
-        return _cloneNew<RecordType>();                          \
-    }
+template <typename ResultType /*= Data*/, typename ...ArgTypes>
+ResultType Data::Execute(const std::string& expression, const ArgTypes& ...args)
+{
+    DataView argExp(expression);
+    std::vector<DataView> argList = { DataView(args)... };
 
-#define MDSPLUS_RECORD_CUSTOMIZATION(RecordType)                 \
-    template <>                                                  \
-    inline RecordType Data::releaseAndConvert()                  \
-    {                                                            \
-        mdsdsc_xd_t xd = release();                              \
-        mdsdsc_t * dsc = xd.pointer;                             \
-                                                                 \
-        if (dsc->class_ == class_t(RecordType::__class) &&       \
-            dsc->dtype == dtype_t(RecordType::__dtype)) {        \
-            return RecordType(std::move(xd), getTree());         \
-        }                                                        \
-                                                                 \
-        MdsFree1Dx(&xd, nullptr);                                \
-        throw TdiInvalidDataType();                              \
+    std::vector<mdsdsc_t *> dscList = { argExp.getDescriptor() };
+    for (const auto& arg : argList) {
+        dscList.push_back(arg.getDescriptor());
     }
 
-class Param : public Record
+    TraceScope span(TraceEvent::TDI, expression);
+
+    mdsdsc_xd_t out = MDSDSC_XD_INITIALIZER;
+    int status = TdiIntrinsic(OPC_EXECUTE, dscList.size(), dscList.data(), &out);
+    span.setStatus(status);
+    span.addBytes(out.l_length);
+    if (IS_NOT_OK(status)) {
+        throwException(status);
+    }
+
+    return Data(std::move(out)).releaseAndConvert<ResultType>();
+}
+
+inline int Data::_intrinsic(opcode_t opcode, int narg, mdsdsc_t *list[], mdsdsc_xd_t * out) const
 {
-public:
+    int status;
 
-    MDSPLUS_RECORD_BOOTSTRAP(Param, DType::Param)
+    if (hasTree()) {
+        status = _TdiIntrinsic(getTree()->getContext(), opcode, narg, list, out);
+    }
+    else {
+        status = TdiIntrinsic(opcode, narg, list, out);
+    }
 
-    template <
-        typename ValueType,
-        typename HelpType,
-        typename ValidationType
-    >
-    Param(
-        const ValueType& value,
-        const HelpType& help,
-        const ValidationType& validation
-    ) {
-        DataView argValue(value);
-        DataView argHelp(help);
-        DataView argValidation(validation);
+    return status;
+}
 
-        _setTree(argValue.getTree());
-        _setTree(argHelp.getTree());
-        _setTree(argValidation.getTree());
+template <typename ResultType>
+inline ResultType Data::_convertToScalar()
+{
+    int status;
 
-        DESCRIPTOR_PARAM(dsc,
-            argValue.getDescriptor(),
-            argHelp.getDescriptor(),
-            argValidation.getDescriptor()
-        );
+    // Move an inline or arena value across as it is, instead of allocating an XD for it in release()
+    if ((_isInline() || _arena) &&
+        getClass() == ResultType::__class &&
+        getDType() == ResultType::__dtype) {
+        ResultType result;
+        static_cast<Data&>(result) = std::move(*this);
+        return result;
+    }
+
+    mdsdsc_xd_t xd = release();
+    mdsdsc_t * dsc = xd.pointer;
+
+    if (dsc->class_ == class_t(ResultType::__class) &&
+        dsc->dtype == dtype_t(ResultType::__dtype)) {
+        return ResultType(std::move(xd), getTree());
+    }
 
-        int status = MdsCopyDxXd((mdsdsc_t *)&dsc, &_xd);
+    // TODO: Check edge cases for when we need to call DATA()
+    if (dsc->class_ == CLASS_R) {
+        mdsdsc_xd_t dataXD = MDSDSC_XD_INITIALIZER;
+        status = _intrinsic(OPC_DATA, 1, &dsc, &dataXD);
         if (IS_NOT_OK(status)) {
             throwException(status);
         }
-    }
 
-    template <typename ValueType = Data>
-    [[nodiscard]]
-    inline ValueType getValue() const {
-        return getDescriptorAt<ValueType>(0);
-    }
+        MdsFree1Dx(&xd, nullptr);
 
-    template <typename HelpType = Data>
-    [[nodiscard]]
-    inline HelpType getHelp() const {
-        return getDescriptorAt<HelpType>(1);
-    }
+        xd = dataXD;
+        dsc = xd.pointer;
 
-    template <typename ValidationType = Data>
-    [[nodiscard]]
-    inline ValidationType getValidation() const {
-        return getDescriptorAt<ValidationType>(2);
+        if (dsc->class_ == class_t(ResultType::__class) &&
+            dsc->dtype == dtype_t(ResultType::__dtype)) {
+            return ResultType(std::move(xd), getTree());
+        }
     }
 
-}; // class Param
+    typename ResultType::__ctype value = {};
 
-MDSPLUS_RECORD_CUSTOMIZATION(Param)
+    mdsdsc_t convert = {
+        .length = sizeof(typename ResultType::__ctype),
+        .dtype = dtype_t(ResultType::__dtype),
+        .class_ = CLASS_S,
+        .pointer = (char *)&value,
+    };
 
-class Signal : public Record
+    status = TdiConvert((mdsdsc_a_t *)dsc, (mdsdsc_a_t *)&convert);
+    if (IS_NOT_OK(status)) {
+        throwException(status);
+    }
+
+    MdsFree1Dx(&xd, nullptr);
+    return ResultType(value);
+}
+
+template <typename ResultType>
+inline ResultType Data::_convertToArray()
 {
-public:
+    int status;
 
-    MDSPLUS_RECORD_BOOTSTRAP(Signal, DType::Signal)
+    // Uniform ranges and dimensions are generated natively, instead of being evaluated by DATA()
+    if constexpr (std::is_floating_point_v<typename ResultType::__ctype>) {
+        std::optional<Timebase> timebase = Timebase::FromDescriptor(getDescriptor());
+        if (timebase) {
+            using CType = typename ResultType::__ctype;
 
-    template <
-        typename ValueType,
-        typename RawType,
-        typename DimensionType
-    >
-    Signal(
-        const ValueType& value,
-        const RawType& raw,
-        const DimensionType& dimension = {}
-    ) {
-        DataView argValue(value);
-        DataView argRaw(raw);
-        DataView argDimension(dimension);
+            mdsdsc_a_t dsc = {
+                .length = sizeof(CType),
+                .dtype = dtype_t(ResultType::__dtype),
+                .class_ = CLASS_A,
+                .pointer = nullptr,
+                .scale = 0,
+                .digits = 0,
+                .aflags = aflags_t{
+                    .binscale = false,
+                    .redim = true,
+                    .column = true,
+                    .coeff = false,
+                    .bounds = false,
+                },
+                .dimct = 1,
+                .arsize = arsize_t(timebase->size() * sizeof(CType)),
+            };
 
-        _setTree(argValue.getTree());
-        _setTree(argRaw.getTree());
-        _setTree(argDimension.getTree());
+            // Allocate the array without copying anything into it, and then fill it in place
+            mdsdsc_xd_t xd = MDSDSC_XD_INITIALIZER;
+            length_t length = sizeof(CType);
+            dtype_t dtype = dsc.dtype;
+            status = MdsGet1DxA(&dsc, &length, &dtype, &xd);
+            if (IS_NOT_OK(status)) {
+                throwException(status);
+            }
 
-        DESCRIPTOR_SIGNAL_1(dsc,
-            argValue.getDescriptor(),
-            argRaw.getDescriptor(),
-            argDimension.getDescriptor()
-        );
+            timebase->getTimes(reinterpret_cast<CType *>(reinterpret_cast<mdsdsc_a_t *>(xd.pointer)->pointer));
 
-        int status = MdsCopyDxXd((mdsdsc_t *)&dsc, &_xd);
-        if (IS_NOT_OK(status)) {
-            throwException(status);
+            Tree * tree = getTree();
+            _free();
+            return ResultType(std::move(xd), tree);
         }
     }
 
-    template <
-        typename ValueType,
-        typename RawType,
-        typename ...DimensionTypes
-    >
-    Signal(
-        const ValueType& value,
-        const RawType& raw,
-        const DimensionTypes& ...dimensions
-    ) {
-        DataView argValue(value);
-        DataView argRaw(raw);
-        std::vector<DataView> argDimensions = { DataView(dimensions)... };
-
-        _setTree(argValue.getTree());
-        _setTree(argRaw.getTree());
+    // Move an arena value across as it is, instead of allocating an XD for it in release()
+    if (_arena &&
+        getClass() == ResultType::__class &&
+        getDType() == ResultType::__dtype) {
+        ResultType result;
+        static_cast<Data&>(result) = std::move(*this);
+        return result;
+    }
 
-        DESCRIPTOR_SIGNAL(dsc,
-            sizeof...(dimensions),
-            argValue.getDescriptor(),
-            argRaw.getDescriptor()
-        );
+    mdsdsc_xd_t xd = release();
+    mdsdsc_t * dsc = xd.pointer;
 
-        for (size_t i = 0; i < argDimensions.size(); ++i) {
-            dsc.dimensions[i] = argDimensions[i].getDescriptor();
-            _setTree(argDimensions[i].getTree());
-        }
+    if (dsc->class_ == class_t(ResultType::__class) &&
+        dsc->dtype == dtype_t(ResultType::__dtype)) {
+        return ResultType(std::move(xd), getTree());
+    }
 
-        int status = MdsCopyDxXd((mdsdsc_t *)&dsc, &_xd);
+    // TODO: Check edge cases for when we need to call DATA()
+    if (dsc->class_ == CLASS_R) {
+        mdsdsc_xd_t dataXD = MDSDSC_XD_INITIALIZER;
+        status = _intrinsic(OPC_DATA, 1, &dsc, &dataXD);
         if (IS_NOT_OK(status)) {
             throwException(status);
         }
-    }
-
-    template <typename ValueType = Data>
-    [[nodiscard]]
-    inline ValueType getValue() const {
-        return getDescriptorAt<ValueType>(0);
-    }
 
-    template <typename RawType = Data>
-    [[nodiscard]]
-    inline RawType getRaw() const {
-        return getDescriptorAt<RawType>(1);
-    }
+        MdsFree1Dx(&xd, nullptr);
 
-    template <typename DimensionType = Data>
-    [[nodiscard]]
-    inline DimensionType getDimensionAt(size_t index = 0) const {
-        return getDescriptorAt<DimensionType>(2 + index);
-    }
+        xd = dataXD;
+        dsc = xd.pointer;
 
-    template <typename DimensionType = Data>
-    [[nodiscard]]
-    inline std::vector<DimensionType> getDimensions() const {
-        std::vector<DimensionType> dims;
-        size_t count = getNumDescriptors() - 2;
-        for (size_t i = 0; i < count; ++i) {
-            dims.push_back(getDimensionAt(i));
+        if (dsc->class_ == class_t(ResultType::__class) &&
+            dsc->dtype == dtype_t(ResultType::__dtype)) {
+            return ResultType(std::move(xd), getTree());
         }
-        return dims;
     }
 
-}; // class Signal
-
-MDSPLUS_RECORD_CUSTOMIZATION(Signal)
-
-class Dimension : public Record
-{
-public:
-
-    MDSPLUS_RECORD_BOOTSTRAP(Dimension, DType::Dimension)
-
-    template <typename WindowType, typename AxisType>
-    Dimension(const WindowType& window, const AxisType& axis)
-    {
-        DataView tmpWindow(window);
-        DataView tmpAxis(axis);
+    array_coeff arrayOfOne = {
+        .length = dsc->length,
+        .dtype = dsc->dtype,
+        .class_ = CLASS_A,
+        .pointer = dsc->pointer,
+        .scale = 0,
+        .digits = 0,
+        .aflags = {
+            .binscale = false,
+            .redim = true,
+            .column = true,
+            .coeff = false,
+            .bounds = false,
+        },
+        .dimct = 0,
+        .arsize = dsc->length,
+    };
 
-        _setTree(tmpWindow.getTree());
-        _setTree(tmpAxis.getTree());
+    array_coeff * dscArray = &arrayOfOne;
+    if (dsc->class_ == CLASS_A) {
+        dscArray = (array_coeff *)dsc;
+    }
 
-        DESCRIPTOR_DIMENSION(dsc,
-            tmpWindow.getDescriptor(),
-            tmpAxis.getDescriptor()
-        );
+    size_t size = (dscArray->arsize / dscArray->length);
+    std::vector<typename ResultType::__ctype> values(size);
+    array_coeff convert = {
+        .length = sizeof(typename ResultType::__ctype),
+        .dtype = dtype_t(ResultType::__dtype),
+        .class_ = CLASS_A,
+        .pointer = (char *)values.data(),
+        .scale = dscArray->scale,
+        .digits = dscArray->digits,
+        .aflags = dscArray->aflags,
+        .dimct = dscArray->dimct,
+        .arsize = arsize_t(size * sizeof(typename ResultType::__ctype)),
+        .a0 = (char *)values.data(),
+        .m = { 0 },
+    };
 
-        int status = MdsCopyDxXd((mdsdsc_t *)&dsc, &_xd);
-        if (IS_NOT_OK(status)) {
-            throwException(status);
+    std::vector<uint32_t> dims(dscArray->dimct);
+    if (dscArray->aflags.coeff) {
+        for (dimct_t i = 0; i < dscArray->dimct; ++i) {
+            convert.m[i] = dscArray->m[i];
+            dims[i] = dscArray->m[i];
         }
     }
-
-    template <typename WindowType = Data>
-    [[nodiscard]]
-    inline WindowType getWindow() const {
-        return getDescriptorAt<WindowType>(0);
+    else {
+        // TODO: Improve
+        dims.clear();
     }
 
-    template <typename AxisType = Data>
-    [[nodiscard]]
-    inline AxisType getAxis() const {
-        return getDescriptorAt<AxisType>(1);
+    status = TdiConvert((mdsdsc_a_t *)dscArray, (mdsdsc_a_t *)&convert);
+    if (IS_NOT_OK(status)) {
+        throwException(status);
     }
 
-}; // class Dimension
-
-MDSPLUS_RECORD_CUSTOMIZATION(Dimension)
+    MdsFree1Dx(&xd, nullptr);
+    return ResultType(values, dims);
+}
 
-class Window : public Record
+inline ScopedArena::~ScopedArena()
 {
-public:
-
-    MDSPLUS_RECORD_BOOTSTRAP(Window, DType::Window)
-
-    template <
-        typename StartIndexType,
-        typename EndIndexType,
-        typename ValueType
-    >
-    Window(
-        const StartIndexType& startIndex,
-        const EndIndexType& endIndex,
-        const ValueType& valueAtIndex0
-    ) {
-        DataView argStartIndex(startIndex);
-        DataView argEndIndex(endIndex);
-        DataView argValueAtIndex0(valueAtIndex0);
-
-        _setTree(argStartIndex.getTree());
-        _setTree(argEndIndex.getTree());
-        _setTree(argValueAtIndex0.getTree());
-
-        DESCRIPTOR_WINDOW(dsc,
-            argStartIndex.getDescriptor(),
-            argEndIndex.getDescriptor(),
-            argValueAtIndex0.getDescriptor()
-        );
+    // Arenas must be destroyed in the reverse order they were created in
+    assert(_getActive() == this);
+    _getActive() = _previous;
 
-        int status = MdsCopyDxXd((mdsdsc_t *)&dsc, &_xd);
-        if (IS_NOT_OK(status)) {
-            throwException(status);
-        }
+    // Anything still alive escaped the scope, and is moved out before the blocks are freed
+    std::lock_guard<std::mutex> lock(_liveMutex);
+    for (Data * data = _live; data; ) {
+        Data * next = data->_arenaNext;
+        data->_arenaPrevious = nullptr;
+        data->_arenaNext = nullptr;
+        data->_promote();
+        data = next;
     }
+    _live = nullptr;
+    _liveCount = 0;
+}
 
-    template <typename StartIndexType = Data>
-    [[nodiscard]]
-    inline StartIndexType getStartIndex() const {
-        return getDescriptorAt<StartIndexType>(0);
+inline void ScopedArena::_register(Data * data)
+{
+    std::lock_guard<std::mutex> lock(_liveMutex);
+    data->_arenaPrevious = nullptr;
+    data->_arenaNext = _live;
+    if (_live) {
+        _live->_arenaPrevious = data;
     }
+    _live = data;
+    ++_liveCount;
+}
 
-    template <typename EndIndexType = Data>
-    [[nodiscard]]
-    inline EndIndexType getEndIndex() const {
-        return getDescriptorAt<EndIndexType>(1);
+inline void ScopedArena::_unregister(Data * data)
+{
+    std::lock_guard<std::mutex> lock(_liveMutex);
+    if (data->_arenaPrevious) {
+        data->_arenaPrevious->_arenaNext = data->_arenaNext;
     }
-
-    template <typename ValueType = Data>
-    [[nodiscard]]
-    inline ValueType getValueAtIndex0() const {
-        return getDescriptorAt<ValueType>(2);
+    else {
+        _live = data->_arenaNext;
     }
 
-}; // class Window
+    if (data->_arenaNext) {
+        data->_arenaNext->_arenaPrevious = data->_arenaPrevious;
+    }
 
-MDSPLUS_RECORD_CUSTOMIZATION(Window)
+    data->_arenaPrevious = nullptr;
+    data->_arenaNext = nullptr;
+    --_liveCount;
+}
 
-class Function : public Record
+inline void ScopedArena::_replace(Data * from, Data * to)
 {
-public:
+    std::lock_guard<std::mutex> lock(_liveMutex);
+    to->_arenaPrevious = from->_arenaPrevious;
+    to->_arenaNext = from->_arenaNext;
 
-    MDSPLUS_RECORD_BOOTSTRAP(Function, DType::Function)
+    if (to->_arenaPrevious) {
+        to->_arenaPrevious->_arenaNext = to;
+    }
+    else {
+        _live = to;
+    }
 
-    Function(opcode_t opcode)
-    {
-        DESCRIPTOR_FUNCTION_0(dsc, &opcode);
-        int status = MdsCopyDxXd((mdsdsc_t *)&dsc, &_xd);
-        if (IS_NOT_OK(status)) {
-            throwException(status);
-        }
+    if (to->_arenaNext) {
+        to->_arenaNext->_arenaPrevious = to;
     }
 
-    template <typename ...ArgTypes>
-    Function(opcode_t opcode, const ArgTypes& ...args)
-    {
-        // TODO: #define MAX_ARGS 255 ?
-        static_assert(sizeof...(args) <= 255, "Function's are limited to 254 arguments");
+    from->_arenaPrevious = nullptr;
+    from->_arenaNext = nullptr;
+}
 
-        std::vector<DataView> argList = { DataView(args)... };
+inline void String::setValue(const char * value, length_t length)
+{
+    if (_setInline(DTYPE_T, value, length)) {
+        return;
+    }
 
-        DESCRIPTOR_FUNCTION(dsc, &opcode, sizeof...(args));
+    mdsdsc_s_t dsc = {
+        length,
+        DTYPE_T,
+        CLASS_S,
+        (char *)value
+    };
 
-        for (size_t i = 0; i < argList.size(); ++i) {
-            dsc.arguments[i] = argList[i].getDescriptor();
-            _setTree(argList[i].getTree());
-        }
+    _copyFrom((mdsdsc_t *)&dsc);
+}
 
-        int status = MdsCopyDxXd((mdsdsc_t *)&dsc, &_xd);
-        if (IS_NOT_OK(status)) {
-            throwException(status);
+inline std::vector<std::string> StringArray::getValues() const
+{
+    mdsdsc_a_t * dsc = (mdsdsc_a_t *)getDescriptor();
+    if (dsc) {
+        std::vector<std::string> values;
+        for (size_t i = 0; i < size(); ++i) {
+            values.emplace_back(dsc->pointer + (i * dsc->length), dsc->length);
         }
+        return values;
     }
+    return {};
+}
 
-    Data call() const;
-
-    template <typename ResultType = Data>
-    inline ResultType getData() const {
-        return call().releaseAndConvert<ResultType>();
+inline std::string StringArray::getValueAt(size_t index) const
+{
+    mdsdsc_a_t * dsc = (mdsdsc_a_t *)getDescriptor();
+    if (dsc && index < size()) {
+        return std::string(dsc->pointer + (index * dsc->length), dsc->length);
     }
 
-}; // class Function
-
-MDSPLUS_RECORD_CUSTOMIZATION(Function)
-
-// TODO: Conglom?
+    throw TdiBadIndex();
+}
 
-class Range : public Record
+inline size_t StringArray::getSize() const
 {
-public:
-
-    MDSPLUS_RECORD_BOOTSTRAP(Range, DType::Range)
-
-    template <
-        typename BeginType = Data,
-        typename EndingType = Data,
-        typename DeltaType = Data
-    >
-    Range(
-        const BeginType& begin,
-        const EndingType& ending,
-        const DeltaType& delta
-    ) {
-        DataView argBegin(begin);
-        DataView argEnding(ending);
-        DataView argDelta(delta);
+    mdsdsc_a_t * dsc = (mdsdsc_a_t *)getDescriptor();
+    if (dsc) {
+        return dsc->arsize / dsc->length;
+    }
+    return 0;
+}
 
-        _setTree(argBegin.getTree());
-        _setTree(argEnding.getTree());
-        _setTree(argDelta.getTree());
+#ifdef __cpp_lib_string_view
 
-        DESCRIPTOR_RANGE(dsc,
-            argBegin.getDescriptor(),
-            argEnding.getDescriptor(),
-            argDelta.getDescriptor()
-        );
+    inline std::string_view StringArray::getStringViewAt(size_t index, bool trim /*= true*/) const
+    {
+        return ArrayRef(getDescriptor(), getTree()).getStringViewAt(index, trim);
+    }
 
-        int status = MdsCopyDxXd((mdsdsc_t *)&dsc, &_xd);
-        if (IS_NOT_OK(status)) {
-            throwException(status);
+    inline std::vector<std::string_view> StringArray::getStringViews(bool trim /*= true*/) const
+    {
+        std::vector<std::string_view> values(size());
+        for (size_t i = 0; i < values.size(); ++i) {
+            values[i] = getStringViewAt(i, trim);
         }
+        return values;
     }
 
-    template <typename BeginType = Data>
-    [[nodiscard]]
-    inline BeginType getBegin() const {
-        return getDescriptorAt<BeginType>(0);
-    }
+#endif // __cpp_lib_string_view
 
-    template <typename EndingType = Data>
-    [[nodiscard]]
-    inline EndingType getEnding() const {
-        return getDescriptorAt<EndingType>(1);
+template <typename StringType>
+inline void StringArray::_setValues(
+    const StringType * values,
+    size_t count,
+    const std::vector<uint32_t>& dims
+) {
+    std::vector<uint32_t> shape = dims;
+    if (shape.empty()) {
+        shape.push_back(uint32_t(count));
     }
 
-    template <typename DeltaType = Data>
-    [[nodiscard]]
-    inline DeltaType getDelta() const {
-        return getDescriptorAt<DeltaType>(2);
+    size_t expected = 1;
+    for (uint32_t dim : shape) {
+        expected *= dim;
     }
 
-    // TODO: isFinite() ?
-    // TODO: begin/end/size
-
-}; // class Range
-
-MDSPLUS_RECORD_CUSTOMIZATION(Range)
-
-// TODO: Action
-// TODO: Dispatch
-// TODO: Routine?
-// TODO: Method?
-// TODO: Event?
-
-class WithUnits : public Record
-{
-public:
+    if (shape.size() > MAX_DIMS || expected != count) {
+        throwException(TreeFAILURE);
+    }
 
-    MDSPLUS_RECORD_BOOTSTRAP(WithUnits, DType::WithUnits)
+    // Zero length elements would make the number of elements impossible to compute from arsize
+    size_t maxSize = 1;
+    for (size_t i = 0; i < count; ++i) {
+        maxSize = std::max(maxSize, values[i].size());
+    }
 
-    template <typename ValueType, typename UnitsType>
-    WithUnits(const ValueType& value, const UnitsType& units)
-    {
-        DataView argValue(value);
-        DataView argUnits(units);
+    // Every element is padded to the longest one, which has to fit in the descriptor's length and arsize
+    if (maxSize > std::numeric_limits<length_t>::max() || count > std::numeric_limits<arsize_t>::max() / maxSize) {
+        throwException(TreeBUFFEROVF);
+    }
 
-        _setTree(argValue.getTree());
-        _setTree(argUnits.getTree());
+    length_t length = length_t(maxSize);
 
-        DESCRIPTOR_WITH_UNITS(dsc,
-            argValue.getDescriptor(),
-            argUnits.getDescriptor()
-        );
+    array_coeff dsc = {
+        .length = length,
+        .dtype = DTYPE_T,
+        .class_ = CLASS_A,
+        .pointer = nullptr,
+        .scale = 0,
+        .digits = 0,
+        .aflags = aflags_t{
+            .binscale = false,
+            .redim = true,
+            .column = true,
+            .coeff = true,
+            .bounds = false,
+        },
+        .dimct = dimct_t(shape.size()),
+        .arsize = arsize_t(count * length),
+        .a0 = nullptr,
+        .m = { 0 },
+    };
 
-        int status = MdsCopyDxXd((mdsdsc_t *)&dsc, &_xd);
-        if (IS_NOT_OK(status)) {
-            throwException(status);
-        }
+    for (size_t i = 0; i < shape.size(); ++i) {
+        dsc.m[i] = shape[i];
     }
 
-    template <typename ValueType = Data>
-    [[nodiscard]]
-    inline ValueType getValue() const {
-        return getDescriptorAt<ValueType>(0);
+    // Allocate the array without copying anything into it, and then fill it in place
+    mdsdsc_xd_t xd = MDSDSC_XD_INITIALIZER;
+    dtype_t dtype = DTYPE_T;
+    int status = MdsGet1DxA((mdsdsc_a_t *)&dsc, &length, &dtype, &xd);
+    if (IS_NOT_OK(status)) {
+        throwException(status);
     }
 
-    template <typename UnitsType = Data>
-    [[nodiscard]]
-    inline UnitsType getUnits() const {
-        return getDescriptorAt<UnitsType>(1);
+    char * buffer = reinterpret_cast<mdsdsc_a_t *>(xd.pointer)->pointer;
+    for (size_t i = 0; i < count; ++i) {
+        size_t size = values[i].size();
+        std::memcpy(buffer, values[i].data(), size);
+        std::memset(buffer + size, ' ', length - size);
+        buffer += length;
     }
 
-}; // class WithUnits
+    _free();
+    _xd = xd;
+}
 
-MDSPLUS_RECORD_CUSTOMIZATION(WithUnits)
+// #include <mdsplusplus/Scalar.inc.hpp>
 
-// TODO: Call?
+inline std::vector<uint32_t> Array::getDimensions() const
+{
+    mdsdsc_a_t * dsc = getArrayDescriptor();
+    if (dsc) {
+        if (dsc->aflags.coeff) {
+            array_coeff * dscCoeff = reinterpret_cast<array_coeff *>(dsc);
+            return std::vector<uint32_t>(
+                (uint32_t *)dscCoeff->m,
+                (uint32_t *)(dscCoeff->m + dscCoeff->dimct)
+            );
+        }
+        else {
+            return { (dsc->arsize / dsc->length) };
+        }
+    }
 
-class WithError : public Record
+    return {};
+}
+
+template <typename CType>
+inline void Array::_setValues(DType dtype, const CType * values, const uint32_t * dims, dimct_t dimCount)
 {
-public:
+    // TODO: Overwrite existing values if the shape/type is the same
 
-    MDSPLUS_RECORD_BOOTSTRAP(WithError, DType::WithError)
+    if (dimCount == 0 || dimCount > MAX_DIMS) {
+        throwException(TreeFAILURE);
+    }
 
-    template <typename ValueType, typename ErrorType>
-    WithError(const ValueType& value, const ErrorType& error)
-    {
-        DataView argValue(value);
-        DataView argError(error);
+    uint32_t count = 1;
+    for (dimct_t i = 0; i < dimCount; ++i) {
+        count *= dims[i];
+    }
 
-        _setTree(argValue.getTree());
-        _setTree(argError.getTree());
+    array_coeff dsc = {
+        .length = sizeof(CType),
+        .dtype = dtype_t(dtype),
+        .class_ = CLASS_A,
+        .pointer = (char *)values,
+        .scale = 0,
+        .digits = 0,
+        .aflags = aflags_t{
+            .binscale = false,
+            .redim = true,
+            .column = true,
+            .coeff = false,
+            .bounds = false,
+        },
+        .dimct = dimCount,
+        .arsize = arsize_t(count * sizeof(CType)),
+        .a0 = (char *)values,
+        .m = { count, 0, 0, 0, 0, 0, 0, 0, },
+    };
 
-        DESCRIPTOR_WITH_ERROR(dsc,
-            argValue.getDescriptor(),
-            argError.getDescriptor()
-        );
+    if (dimCount > 1) {
+        dsc.aflags.coeff = true;
+        for (size_t i = 0; i < dimCount; ++i) {
+            dsc.m[i] = dims[i];
+        }
+    }
 
-        int status = MdsCopyDxXd((mdsdsc_t *)&dsc, &_xd);
-        if (IS_NOT_OK(status)) {
-            throwException(status);
+    _copyFrom((mdsdsc_t *)&dsc);
+}
+
+#ifdef __cpp_lib_span
+
+    template <typename CType>
+    inline std::span<CType> Array::_getSpan() const {
+        mdsdsc_a_t * dsc = getArrayDescriptor();
+        if (dsc) {
+            return std::span<CType>(
+                reinterpret_cast<CType *>(dsc->pointer),
+                reinterpret_cast<CType *>(dsc->pointer + dsc->arsize)
+            );
         }
+        return {};
     }
 
-    template <typename ValueType = Data>
-    [[nodiscard]]
-    inline ValueType getValue() const {
-        return getDescriptorAt<ValueType>(0);
+#endif // __cpp_lib_span
+
+template <typename CType>
+inline std::vector<CType> Array::_getValues() const {
+    mdsdsc_a_t * dsc = getArrayDescriptor();
+    if (dsc) {
+        return std::vector<CType>(
+            reinterpret_cast<CType *>(dsc->pointer),
+            reinterpret_cast<CType *>(dsc->pointer + dsc->arsize)
+        );
     }
+    return {};
+}
 
-    template <typename ErrorType = Data>
-    [[nodiscard]]
-    inline ErrorType getError() const {
-        return getDescriptorAt<ErrorType>(1);
+template <typename CType>
+inline const CType& Array::_getValueAt(size_t index) const {
+    mdsdsc_a_t * dsc = getArrayDescriptor();
+    if (dsc && index < size()) {
+        return *((CType *)dsc->pointer + index);
     }
 
-}; // class WithError
+    throw TdiBadIndex();
+}
 
-MDSPLUS_RECORD_CUSTOMIZATION(WithError)
+template <typename CType>
+inline const CType& Array::_front() const
+{
+    return _getValueAt<CType>(0);
+}
 
-// TODO: Opaque?
+template <typename CType>
+inline const CType& Array::_back() const
+{
+    return _getValueAt<CType>(size() - 1);
+}
 
-class GetMany;
-class PutMany;
+template <typename CType>
+inline CType * Array::_begin() const
+{
+    mdsdsc_a_t * dsc = (mdsdsc_a_t *)getDescriptor();
+    if (dsc) {
+        return reinterpret_cast<CType *>(dsc->pointer);
+    }
 
-class Connection
+    return nullptr;
+}
+
+template <typename CType>
+inline CType * Array::_end() const
 {
-public:
+    mdsdsc_a_t * dsc = (mdsdsc_a_t *)getDescriptor();
+    if (dsc) {
+        return reinterpret_cast<CType *>(dsc->pointer + dsc->arsize);
+    }
 
-    static constexpr int InvalidConnectionID = -1;
+    return nullptr;
+}
 
-    inline Connection(const std::string& hostspec) {
-        connect(hostspec);
+template <typename ResultType /*= Data*/>
+inline ResultType Int8Array::deserialize()
+{
+    mdsdsc_xd_t out = MDSDSC_XD_INITIALIZER;
+    int status = MdsSerializeDscIn(getDescriptor()->pointer, &out);
+    if (IS_NOT_OK(status)) {
+        throwException(status);
     }
 
-    inline virtual ~Connection() {
-        disconnect();
+    return Data(std::move(out)).releaseAndConvert<ResultType>();
+}
+
+template <typename ResultType /*= Data*/>
+inline ResultType UInt8Array::deserialize()
+{
+    mdsdsc_xd_t out = MDSDSC_XD_INITIALIZER;
+    int status = MdsSerializeDscIn(getDescriptor()->pointer, &out);
+    if (IS_NOT_OK(status)) {
+        throwException(status);
     }
 
-    void connect(const std::string& hostspec);
+    return Data(std::move(out)).releaseAndConvert<ResultType>();
+}
 
-    void disconnect();
+// #include <mdsplusplus/APD.inc.hpp>
 
-    inline void reconnect() {
-        disconnect();
-        connect(_hostspec);
-    }
+inline Data Function::call() const
+{
+    int status;
 
-    template <typename ResultType = Data, typename ...ArgTypes>
-    ResultType get(const std::string& expression, const ArgTypes& ...args) const
-    {
-        if (_local) {
-            return Data::Execute<ResultType>(expression, args...);
-        }
-        else {
-            std::vector<DataView> argList({ DataView(args)... });
-            return _get(expression, std::move(argList)).releaseAndConvert<ResultType>();
-        }
-    }
+    descriptor_function * dsc = (descriptor_function *)getDescriptor();
 
-    template <typename ResultType = Data, typename ...ArgTypes>
-    ResultType getObject(const std::string& expression, ArgTypes ...args) const
-    {
-        Int8Array serializedData = get<Int8Array>("SerializeOut(`(" + expression + ";))", args...);
-        return serializedData.deserialize<ResultType>();
+    // TODO: Tree*
+    opcode_t * opcode = (opcode_t *)dsc->pointer;
+    mdsdsc_xd_t out = MDSDSC_XD_INITIALIZER;
+    _intrinsic(*opcode, dsc->ndesc, dsc->arguments, &out);
+    if (IS_NOT_OK(status)) {
+        throwException(status);
     }
 
-    inline void openTree(const std::string& tree, int shot) const {
-        int status = get<Int32>("TreeOpen($,$)", tree, shot).getValue();
-        if (IS_NOT_OK(status)) {
-            throwException(status);
-        }
-    }
+    return Data(std::move(out));
+}
 
-    inline void closeTree(const std::string& tree, int shot) const {
-        int status = get<Int32>("TreeClose($,$)", tree, shot).getValue();
-        if (IS_NOT_OK(status)) {
-            throwException(status);
-        }
+inline std::string to_string(const Usage& usage)
+{
+    switch (usage) {
+    case Usage::Any: return "Usage::Any";
+    case Usage::Structure: return "Usage::Structure";
+    case Usage::Action: return "Usage::Action";
+    case Usage::Device: return "Usage::Device";
+    case Usage::Dispatch: return "Usage::Dispatch";
+    case Usage::Numeric: return "Usage::Numeric";
+    case Usage::Signal: return "Usage::Signal";
+    case Usage::Task: return "Usage::Task";
+    case Usage::Text: return "Usage::Text";
+    case Usage::Window: return "Usage::Window";
+    case Usage::Axis: return "Usage::Axis";
+    case Usage::Subtree: return "Usage::Subtree";
+    case Usage::CompoundData: return "Usage::CompoundData";
     }
 
-    inline int closeAllTrees() const {
-        return get<Int32>("_i=0;WHILE(IAND(TreeClose(),1)) _i++;_i").getValue();
-    }
+    return "?";
+}
 
-    inline void setDefault(const std::string& path) {
-        get("TreeSetDefault($)", path);
-    }
+inline std::string to_string(const TreeNodeFlags& flags)
+{
+    std::string str;
 
-    template <typename ...Args>
-    inline void put(const std::string& node, const std::string& expression, const Args& ...args) const
-    {
-        std::string putExpression = "TreePut($,$";
-        for (size_t i = 0; i < sizeof...(args) - 2; ++i) {
-            putExpression += ",$";
-        }
-        putExpression += ")";
+    if (flags.CompressSegments) {
+        str += "CompressSegments | ";
+    }
 
-        get(putExpression, node, expression, args...);
+    if (flags.IncludeInPulse) {
+        str += "IncludeInPulse | ";
     }
 
-    GetMany getMany() const;
+    if (flags.NidReference) {
+        str += "NidReference | ";
+    }
 
-    // putMany
+    if (flags.PathReference) {
+        str += "PathReference | ";
+    }
 
-private:
+    if (flags.NoWriteShot) {
+        str += "NoWriteShot | ";
+    }
 
-    Data _get(const std::string& expression, std::vector<DataView>&& xdArgs) const;
+    if (flags.NoWriteModel) {
+        str += "NoWriteModel | ";
+    }
 
-    int _id = InvalidConnectionID;
+    if (flags.CompressOnPut) {
+        str += "CompressOnPut | ";
+    }
 
-    std::string _hostspec;
+    if (flags.DoNotCompress) {
+        str += "DoNotCompress | ";
+    }
 
-    bool _local = false;
+    if (flags.Compressible) {
+        str += "Compressible | ";
+    }
 
-}; // class Connection
+    if (flags.WriteOnce) {
+        str += "WriteOnce | ";
+    }
 
-class GetMany
-{
-public:
+    if (flags.SetupInformation) {
+        str += "SetupInformation | ";
+    }
 
-    GetMany(const Connection * conn)
-        : _conn(conn)
-    { }
+    if (flags.Segmented) {
+        str += "Segmented | ";
+    }
 
-    template <typename ...ArgTypes>
-    void append(const std::string& name, const std::string& expression, const ArgTypes& ...args)
-    {
-        // _queries.emplace_back(std::unordered_map<std::string, Data>{
-        //     { "name", String(name) },
-        //     { "exp", String(expression), },
-        //     { "args", List(args...) },
-        // });
-        _queries.emplace_back(Dictionary(
-            "name", name,
-            "exp", expression,
-            "args", List(args...)
-        ));
+    if (flags.Versions) {
+        str += "Versions | ";
     }
 
-    const Dictionary& execute()
-    {
-        printf("%s\n", to_string(List(_queries).serialize()).c_str());
-        Data result = _conn->get("GetManyExecute($)", List(_queries).serialize());
+    if (flags.Cached) {
+        str += "Cached | ";
+    }
 
-        if (result.getClass() == Class::S) {
-            if (result.getDType() == DType::T) {
-                // TODO: Read error
-                throw MDSplusException();
-            }
-            else if (result.getDType() == DType::L) {
-                int status = result.releaseAndConvert<Int32>().getValue();
-                throwException(status);
-            }
-        }
+    if (flags.Essential) {
+        str += "Essential | ";
+    }
 
-        _result = result.releaseAndConvert<UInt8Array>().deserialize<Dictionary>();
-        return _result;
+    if (flags.ParentState) {
+        str += "ParentState | ";
     }
 
-private:
+    if (flags.State) {
+        str += "State | ";
+    }
 
-    const Connection * _conn;
+    // Strip trailing " | "
+    if (!str.empty()) {
+        str.resize(str.size() - 3);
+    }
 
-    // std::vector<std::unordered_map<std::string, Data>> _queries;
+    return str;
+}
 
-    std::vector<Dictionary> _queries;
+inline std::string to_string(const TreeNode * node)
+{
+    assert(node);
 
-    Dictionary _result;
+    std::string str = "TreeNode(";
+    str += to_string(node->getTree());
+    str += ", ";
+    str += std::to_string(node->getNID());
+    str += ")";
 
-}; // class GetMany
+    return str;
 
-inline GetMany Connection::getMany() const {
-    return GetMany(this);
+    // return std::format(
+    //     "TreeNode({}, {})",
+    //     to_string(node->getTree()),
+    //     node->getNID()
+    // );
 }
 
-struct DevicePart
-{
-    std::string Path;
-    mdsplus::Usage Usage = mdsplus::Usage::Any;
-    Data * Value = {};
-    std::string ValueExpression = {};
-    TreeNodeFlags Flags = {};
-    std::map<std::string, Data *> XNCI = {};
-    std::function<void(TreeNode& node)> Callback;
-};
-
-class Device : public TreeNode
+inline std::string to_string(const Mode& mode)
 {
-public:
+    switch (mode) {
+    case Mode::Normal: return "Mode::Normal";
+    case Mode::ReadOnly: return "Mode::ReadOnly";
+    case Mode::Edit: return "Mode::Edit";
+    case Mode::New: return "Mode::New";
 
-    Device(Tree * tree, int nid)
-        : TreeNode(tree, nid)
-    { }
+    case Mode::View: return "Mode::View";
+    }
 
-    template <typename DeviceClass,
-        std::enable_if_t<std::is_base_of<Device, DeviceClass>::value, bool> = true>
-    static DeviceClass Add(Tree * tree, const std::string& name)
-    {
-        int nid = 0;
-        DESCRIPTOR_FROM_CSTRING(dscLibrary, DeviceClass::__library_name);
-        DESCRIPTOR_FROM_CSTRING(dscModel, DeviceClass::__class_name);
-        static DESCRIPTOR_CONGLOM(dscConglom, &dscLibrary, &dscModel, 0, 0);
+    return "?";
+}
 
-        std::vector<mdsplus::DevicePart> parts = DeviceClass::GetParts();
+inline std::string to_string(const Tree * tree)
+{
+    assert(tree);
 
-        _TreeStartConglomerate(tree->getDBID(), parts.size() + 1);
-        _TreeAddNode(tree->getDBID(), name.c_str(), &nid, TreeUSAGE_DEVICE);
-        _TreePutRecord(tree->getDBID(), nid, (mdsdsc_t *)&dscConglom, 0);
+    std::string str = "Tree(\"";
+    str += tree->getTreeName();
+    str += "\", ";
+    str += std::to_string(tree->getShot());
+    str += ", ";
+    str += to_string(tree->getMode());
+    str += ")";
 
-        DeviceClass device(tree, nid);
-        device.addParts(std::move(parts));
+    return str;
 
-        _TreeEndConglomerate(tree->getDBID());
+    // return std::format(
+    //     "Tree(\"{}\", {}, {})",
+    //     tree->getTreeName(),
+    //     tree->getShot(),
+    //     to_string(tree->getMode())
+    // );
+}
 
-        return device;
-    }
+[[nodiscard]]
+inline void * TreeNode::getDBID() const {
+    return getTree()->getDBID();
+}
 
-    static std::vector<DevicePart> GetParts() {
-        return {};
-    }
+[[nodiscard]]
+inline void * TreeNode::getContext() const {
+    return getTree()->getContext();
+}
 
-    void addParts(std::vector<DevicePart>&& parts) const;
+inline TreeNode TreeNode::getNode(const std::string& path) const
+{
+    int nid = 0;
 
-};
+    int status = _TreeFindNodeRelative(getDBID(), path.data(), _nid, &nid);
+    if (IS_NOT_OK(status)) {
+        throwException(status);
+    }
 
-// TODO: Error handling
+    return TreeNode(_tree, nid);
+}
 
-#define MDSPLUS_DEVICE_BOOTSTRAP(LibraryName, DeviceClass, DeviceClassLower) \
-    static inline const char * __library_name = #LibraryName;                \
-    static inline const char * __class_name = #DeviceClass;                  \
-    static inline const char * __class_name_lower = #DeviceClassLower;       \
-                                                                             \
-    DeviceClass(Tree * tree, int nid)                                        \
-        : Device(tree, nid)                                                  \
-    { }                                                                      \
-    virtual ~DeviceClass() = default;                                        \
+inline std::vector<TreeNode> TreeNode::findNodeWild(const std::string& wildcard, std::vector<Usage> validUsages /*= {}*/) const
+{
+    std::vector<TreeNode> nodes;
 
-#define MDSPLUS_DEVICE(DeviceClassLower, DeviceClass)               \
-    extern "C" int DeviceClassLower##__add(                         \
-        mdsdsc_t * dscName,                                         \
-        mdsdsc_t * dscDummy,                                        \
-        int * nidOut)                                               \
-    {                                                               \
-        (void)dscDummy;                                             \
-        mdsplus::Tree tree(TreeDbid());                             \
-        std::string name(dscName->pointer, dscName->length);        \
-        const auto& device = Device::Add<DeviceClass>(&tree, name); \
-        if (nidOut) {                                               \
-            *nidOut = device.getNID();                              \
-        }                                                           \
-        return TreeSUCCESS;                                         \
+    int usageMask = 0xFFFF;
+    if (!validUsages.empty()) {
+        usageMask = 0;
+        for (const auto& usage : validUsages) {
+            usageMask |= 1 << int(usage);
+        }
     }
 
-#define MDSPLUS_DEVICE_METHOD(DeviceClassLower, DeviceClass, MethodName) \
-    extern "C" int DeviceClassLower##__##MethodName(mdsdsc_t * nid)      \
-    {                                                                    \
-        mdsplus::Tree tree(TreeDbid());                                  \
-        DeviceClass device(&tree, *(int *)nid->pointer);                 \
-        try {                                                            \
-            device.MethodName();                                         \
-        } catch (mdsplus::MDSplusException& e) {                         \
-            return e.getStatus();                                        \
-        }                                                                \
-        return TreeSUCCESS;                                              \
-    }
+    void * findContext = nullptr;
+    while (true)
+    {
+        int outnid;
+        int status = _TreeFindNodeWildRelative(
+            getDBID(),
+            wildcard.c_str(),
+            _nid,
+            &outnid,
+            &findContext,
+            usageMask
+        );
+        if (status == TreeNMN || status == TreeNNF) {
+            break;
+        }
+        else if (IS_NOT_OK(status)) {
+            throwException(status);
+        }
 
-inline std::string to_string(const Class& class_)
-{
-    switch (class_) {
-        case Class::Missing: return"Class::Missing";
-        case Class::S: return"Class::S";
-        case Class::D: return"Class::D";
-        case Class::A: return"Class::A";
-        case Class::XD: return"Class::XD";
-        case Class::XS: return"Class::XS";
-        case Class::R: return"Class::R";
-        case Class::CA: return"Class::CA";
-        case Class::APD: return"Class::APD";
+        nodes.push_back(TreeNode(getTree(), outnid));
     }
 
-    return "?";
+    _TreeFindNodeEnd(getDBID(), &findContext);
+
+    return nodes;
 }
 
-inline std::string to_string(const DType& dtype)
+inline TreeNode TreeNode::addNode(const std::string& path, Usage usage) const
 {
-    switch (dtype) {
-        case DType::Missing: return "DType::Missing";
-        case DType::BU: return "DType::BU";
-        case DType::WU: return "DType::WU";
-        case DType::LU: return "DType::LU";
-        case DType::QU: return "DType::QU";
-        case DType::B: return "DType::B";
-        case DType::W: return "DType::W";
-        case DType::L: return "DType::L";
-        case DType::Q: return "DType::Q";
-        case DType::F: return "DType::F";
-        case DType::D: return "DType::D";
-        case DType::FC: return "DType::FC";
-        case DType::DC: return "DType::DC";
-        case DType::T: return "DType::T";
-        case DType::DSC: return "DType::DSC";
-        case DType::OU: return "DType::OU";
-        case DType::O: return "DType::O";
-        case DType::G: return "DType::G";
-        case DType::H: return "DType::H";
-        case DType::GC: return "DType::GC";
-        case DType::HC: return "DType::HC";
-
-        case DType::Pointer: return "DType::Pointer";
-        case DType::FS: return "DType::FS";
-        case DType::FT: return "DType::FT";
-        case DType::FSC: return "DType::FSC";
-        case DType::FTC: return "DType::FTC";
-        case DType::C: return "DType::C";
-
-        case DType::List: return "DType::List";
-        case DType::Tuple: return "DType::Tuple";
-        case DType::Dictionary: return "DType::Dictionary";
+    int nid = 0;
 
-        case DType::Ident: return "DType::Ident";
-        case DType::NID: return "DType::NID";
-        case DType::Path: return "DType::Path";
-        case DType::Param: return "DType::Param";
-        case DType::Signal: return "DType::Signal";
-        case DType::Dimension: return "DType::Dimension";
-        case DType::Window: return "DType::Window";
-        case DType::Slope: return "DType::Slope";
-        case DType::Function: return "DType::Function";
-        case DType::Conglom: return "DType::Conglom";
-        case DType::Range: return "DType::Range";
-        case DType::Action: return "DType::Action";
-        case DType::Dispatch: return "DType::Dispatch";
-        case DType::Program: return "DType::Program";
-        case DType::Routine: return "DType::Routine";
-        case DType::Procedure: return "DType::Procedure";
-        case DType::Method: return "DType::Method";
-        case DType::Dependency: return "DType::Dependency";
-        case DType::Condition: return "DType::Condition";
-        case DType::Event: return "DType::Event";
-        case DType::WithUnits: return "DType::WithUnits";
-        case DType::Call: return "DType::Call";
-        case DType::WithError: return "DType::WithError";
-        case DType::Opaque: return "DType::Opaque";
+    int status = _TreeAddNode(getDBID(), path.data(), &nid, static_cast<unsigned char>(usage));
+    if (IS_NOT_OK(status)) {
+        throwException(status);
     }
 
-    return "?";
+    return TreeNode(_tree, nid);
 }
 
-inline std::string to_string(const Data * data)
+inline TreeNode TreeNode::addDevice(const std::string& path, const std::string& model) const
 {
-    assert(data);
+    int nid = 0;
 
-    std::string str(data->getClassName());
-    str += "(";
-    str += to_string(data->getClass());
-    str += ", ";
-    str += to_string(data->getDType());
-    str += ", `";
-    str += data->decompile();
-    str += "`)";
+    int status = _TreeAddConglom(getDBID(), path.data(), model.data(), &nid);
+    if (IS_NOT_OK(status)) {
+        throwException(status);
+    }
 
-    return str;
+    return TreeNode(_tree, nid);
 }
 
-inline std::string Data::decompile() const
+template <typename ResultType /*= Data*/, typename ...ArgTypes>
+ResultType TreeNode::doMethod(const std::string& method, const ArgTypes&... args)
 {
-    int status;
+    std::vector<DataView> argList = { DataView(args)... };
 
-    mdsdsc_t * dsc = getDescriptor();
+    std::vector<mdsdsc_t *> dscList;
+    for (const auto& arg : argList) {
+        dscList.push_back(arg.getDescriptor());
+    }
+
+    _tree->setActive(); // HACK:
+
+    DESCRIPTOR_NID(dscNID, &_nid);
+    DESCRIPTOR_FROM_CSTRING(dscMethod, method.c_str());
     mdsdsc_xd_t out = MDSDSC_XD_INITIALIZER;
-    status = _intrinsic(OPC_DECOMPILE, 1, &dsc, &out);
+    int status = _TreeDoMethodA(
+        getDBID(),
+        &dscNID,
+        &dscMethod,
+        dscList.size(),
+        dscList.data(),
+        &out
+    );
     if (IS_NOT_OK(status)) {
         throwException(status);
     }
 
-    mdsdsc_t * deco = out.pointer;
-    assert(deco->dtype == DTYPE_T);
+    return Data(std::move(out), getTree()).releaseAndConvert<ResultType>();
+}
 
-    std::string decompile(deco->pointer, deco->length);
+inline std::string TreeNode::getNodeName() const
+{
+    std::string name = _getStringNCI(NciNODE_NAME, 64);
 
-    status = MdsFree1Dx(&out, nullptr);
+    // Trim trailing spaces
+    size_t it = name.find(' ');
+    if (it != std::string::npos) {
+        name[it] = '\0';
+    }
+
+    return name;
+}
+
+template <typename ValueType>
+inline void TreeNode::setExtendedAttribute(const std::string& name, const ValueType& value) const
+{
+    DataView argValue(value);
+    int status = _TreeSetXNci(getDBID(), _nid, name.c_str(), argValue.getDescriptor());
     if (IS_NOT_OK(status)) {
         throwException(status);
     }
-
-    return decompile;
 }
 
-inline Data Data::serialize() const
+template <typename ResultType /*= Data*/>
+ResultType TreeNode::getExtendedAttribute(const std::string& name)
 {
-    mdsdsc_t * dsc = getDescriptor();
     mdsdsc_xd_t out = MDSDSC_XD_INITIALIZER;
-    int status = MdsSerializeDscOut(dsc, &out);
+    int status = _TreeGetXNci(getDBID(), _nid, name.c_str(), &out);
     if (IS_NOT_OK(status)) {
         throwException(status);
     }
 
-    return Data(std::move(out), getTree());
+    return Data(std::move(out), getTree()).releaseAndConvert<ResultType>();
 }
 
-template <typename UnitsType /*= Data*/>
-inline UnitsType Data::getUnits() const
+inline void TreeNode::addTag(const std::string& tag)
 {
-    mdsdsc_xd_t out = MDSDSC_XD_INITIALIZER;
-    mdsdsc_t * dsc = getDescriptor();
-    int status = _intrinsic(OPC_UNITS_OF, 1, &dsc, &out);
+    int status = _TreeAddTag(getDBID(), _nid, tag.c_str());
     if (IS_NOT_OK(status)) {
         throwException(status);
     }
-
-    return Data(std::move(out)).releaseAndConvert<UnitsType>();
 }
 
-template <typename DataType /*= Data*/, typename UnitsType /*= Data*/>
-std::tuple<DataType, UnitsType> Data::getDataWithUnits() const
+inline std::vector<std::string> TreeNode::getTags() const
 {
-    // We could use OPC_DATA_WITH_UNITS to upcast it to a WithUnits() type,
-    // but returning a tuple is a cleaner API
-    return { getData<DataType>(), getUnits<UnitsType>() };
+    std::vector<std::string> tags;
+
+    int outnid = _nid;
+    void * findContext = nullptr;
+    while (true)
+    {
+        char * tag = _TreeFindNodeTags(getDBID(), _nid, &findContext);
+        if (!tag) {
+            break;
+        }
+
+        tags.push_back("\\" + std::string(tag));
+    }
+
+    TreeFindTagEnd(&findContext);
+
+    return tags;
 }
 
-template <typename ErrorType /*= Data*/>
-inline ErrorType Data::getError() const
+inline Data TreeNode::getRecord() const
 {
-    mdsdsc_xd_t out = MDSDSC_XD_INITIALIZER;
-    mdsdsc_t * dsc = getDescriptor();
-    int status = _intrinsic(OPC_ERROR_OF, 1, &dsc, &out);
+    TraceScope span(TraceEvent::Read);
+    if (span) {
+        span.setName(getFullPath());
+    }
+
+    mdsdsc_xd_t xd = MDSDSC_XD_INITIALIZER;
+    int status = _TreeGetRecord(getDBID(), _nid, &xd);
+    span.setStatus(status);
+    span.addBytes(xd.l_length);
     if (IS_NOT_OK(status)) {
         throwException(status);
     }
 
-    return Data(std::move(out)).releaseAndConvert<ErrorType>();
+    return Data(std::move(xd), getTree());
 }
 
-template <typename HelpType /*= Data*/>
-inline HelpType Data::getHelp() const
+inline void TreeNode::putRecord(const Data& data) const
 {
-    mdsdsc_xd_t out = MDSDSC_XD_INITIALIZER;
-    mdsdsc_t * dsc = getDescriptor();
-    int status = _intrinsic(OPC_HELP_OF, 1, &dsc, &out);
-    if (status == TdiINVDTYDSC) {
-        // Unlike UNITS_OF and ERROR_OF, this throws an error when there is no value
-        return HelpType();
+    TraceScope span(TraceEvent::Write);
+    if (span) {
+        span.setName(getFullPath());
+    }
+
+    mdsdsc_t * dsc = data.getDescriptor();
+    int status = _TreePutRecord(getDBID(), _nid, dsc, 0);
+    _onSegmentsWritten(true);
+    span.setStatus(status);
+    span.addBytes(Trace::GetSize(dsc));
+    if (IS_NOT_OK(status)) {
+        throwException(status);
+    }
+}
+
+inline std::vector<TreeNode> TreeNode::getMembersAndChildren(bool sortedNIDs /*= true*/) const
+{
+    int status;
+
+    uint32_t numberOfMembers = 0;
+    uint32_t numberOfChildren = 0;
+    nci_itm countItemList[] = {
+        { sizeof(numberOfMembers), NciNUMBER_OF_MEMBERS, &numberOfMembers, nullptr },
+        { sizeof(numberOfChildren), NciNUMBER_OF_CHILDREN, &numberOfChildren, nullptr },
+        { 0, NciEND_OF_LIST, nullptr, nullptr },
+    };
+
+    status = _TreeGetNci(getDBID(), _nid, countItemList);
+    if (IS_NOT_OK(status)) {
+        throwException(status);
+    }
+
+    std::vector<int> nids(numberOfMembers + numberOfChildren);
+
+    int16_t sizeInBytesMembers = sizeof(int) * numberOfMembers;
+    int16_t sizeInBytesChildren = sizeof(int) * numberOfChildren;
+    nci_itm itemList[] = {
+        { sizeInBytesMembers, NciMEMBER_NIDS, (void *)&nids[0], nullptr },
+        { sizeInBytesChildren, NciCHILDREN_NIDS, (void *)&nids[numberOfMembers], nullptr },
+        { 0, NciEND_OF_LIST, nullptr, nullptr },
+    };
+
+    status = _TreeGetNci(getDBID(), _nid, itemList);
+    if (IS_NOT_OK(status)) {
+        throwException(status);
+    }
+
+    if (sortedNIDs) {
+        std::sort(nids.begin(), nids.end());
     }
-    else if (IS_NOT_OK(status)) {
-        throwException(status);
+
+    std::vector<TreeNode> nodes;
+    nodes.reserve(nids.size());
+
+    for (const int& nid : nids) {
+        nodes.emplace_back(_tree, nid);
     }
 
-    return Data(std::move(out)).releaseAndConvert<HelpType>();
+    return nodes;
 }
 
-template <typename ValidationType /*= Data*/>
-inline ValidationType Data::getValidation() const
+template <typename ResultType>
+inline ResultType TreeNode::_getNCI(nci_t code) const
 {
-    mdsdsc_xd_t out = MDSDSC_XD_INITIALIZER;
-    mdsdsc_t * dsc = getDescriptor();
-    int status = _intrinsic(OPC_ERROR_OF, 1, &dsc, &out);
-    if (status == TdiINVDTYDSC) {
-        // Unlike UNITS_OF and ERROR_OF, this throws an error when there is no value
-        return ValidationType();
-    }
-    else if (IS_NOT_OK(status)) {
+    ResultType value = {};
+    nci_itm itm_lst[] = {
+        { sizeof(value), code, &value, nullptr },
+        { 0, NciEND_OF_LIST, nullptr, nullptr },
+    };
+
+    int status = _TreeGetNci(_tree->getDBID(), _nid, itm_lst);
+    if (IS_NOT_OK(status)) {
         throwException(status);
     }
 
-    return Data(std::move(out)).releaseAndConvert<ValidationType>();
+    return value;
 }
 
-template <typename ResultType /*= Data*/, typename ...ArgTypes>
-ResultType Data::Compile(const std::string& expression, const ArgTypes& ...args)
+inline std::string TreeNode::_getStringNCI(nci_t code, int16_t size) const
 {
-    DataView argExp(expression);
-    std::vector<DataView> argList = { DataView(args)... };
+    std::string buffer;
+    buffer.resize(size);
 
-    std::vector<mdsdsc_t *> dscList = { argExp.getDescriptor() };
-    for (const auto& arg : argList) {
-        dscList.push_back(arg.getDescriptor());
-    }
+    int retlen = 0;
+    nci_itm itemList[] = {
+        { size, code, (void *)buffer.data(), &retlen },
+        { 0, NciEND_OF_LIST, nullptr, nullptr },
+    };
 
-    mdsdsc_xd_t out = MDSDSC_XD_INITIALIZER;
-    int status = TdiIntrinsic(OPC_COMPILE, dscList.size(), dscList.data(), &out);
+    int status = _TreeGetNci(getDBID(), _nid, itemList);
     if (IS_NOT_OK(status)) {
         throwException(status);
     }
 
-    return Data(std::move(out)).releaseAndConvert<ResultType>();
+    buffer.resize(retlen);
+
+    return buffer;
 }
 
-template <typename ResultType /*= Data*/, typename ...ArgTypes>
-ResultType Data::Execute(const std::string& expression, const ArgTypes& ...args)
+inline std::vector<int> TreeNode::_getNIDArrayNCI(nci_t code, nci_t codeForNumberOf) const
 {
-    DataView argExp(expression);
-    std::vector<DataView> argList = { DataView(args)... };
+    uint32_t numberOfNodes = _getNCI<uint32_t>(codeForNumberOf);
+    std::vector<int> nids(numberOfNodes);
 
-    std::vector<mdsdsc_t *> dscList = { argExp.getDescriptor() };
-    for (const auto& arg : argList) {
-        dscList.push_back(arg.getDescriptor());
-    }
+    int16_t sizeInBytes = sizeof(int) * numberOfNodes;
+    nci_itm itemList[] = {
+        { sizeInBytes, code, (void *)nids.data(), nullptr },
+        { 0, NciEND_OF_LIST, nullptr, nullptr },
+    };
 
-    mdsdsc_xd_t out = MDSDSC_XD_INITIALIZER;
-    int status = TdiIntrinsic(OPC_EXECUTE, dscList.size(), dscList.data(), &out);
+    int status = _TreeGetNci(getDBID(), _nid, itemList);
     if (IS_NOT_OK(status)) {
         throwException(status);
     }
 
-    return Data(std::move(out)).releaseAndConvert<ResultType>();
+    return nids;
 }
 
-inline int Data::_intrinsic(opcode_t opcode, int narg, mdsdsc_t *list[], mdsdsc_xd_t * out) const
+inline std::vector<TreeNode> TreeNode::_getTreeNodeArrayNCI(nci_t code, nci_t codeForNumberOf) const
 {
-    int status;
+    const auto& nids = _getNIDArrayNCI(code, codeForNumberOf);
 
-    if (hasTree()) {
-        status = _TdiIntrinsic(getTree()->getContext(), opcode, narg, list, out);
-    }
-    else {
-        status = TdiIntrinsic(opcode, narg, list, out);
+    std::vector<TreeNode> nodes;
+    nodes.reserve(nids.size());
+
+    for (const int& nid : nids) {
+        nodes.emplace_back(_tree, nid);
     }
 
-    return status;
+    return nodes;
 }
 
-template <typename ResultType>
-inline ResultType Data::_convertToScalar()
+template <typename ValueType>
+void TreeNode::putRow(int segmentLength, const ValueType& value, int64_t timestamp)
 {
-    int status;
-
-    mdsdsc_xd_t xd = release();
-    mdsdsc_t * dsc = xd.pointer;
-
-    if (dsc->class_ == class_t(ResultType::__class) &&
-        dsc->dtype == dtype_t(ResultType::__dtype)) {
-        return ResultType(std::move(xd), getTree());
+    TraceScope span(TraceEvent::Write);
+    if (span) {
+        span.setName(getFullPath());
     }
 
-    // TODO: Check edge cases for when we need to call DATA()
-    if (dsc->class_ == CLASS_R) {
-        mdsdsc_xd_t dataXD = MDSDSC_XD_INITIALIZER;
-        status = _intrinsic(OPC_DATA, 1, &dsc, &dataXD);
-        if (IS_NOT_OK(status)) {
-            throwException(status);
-        }
-
-        MdsFree1Dx(&xd, nullptr);
+    DataView argValue(value);
 
-        xd = dataXD;
-        dsc = xd.pointer;
+    int status = _TreePutRow(
+        getDBID(),
+        getNID(),
+        segmentLength,
+        &timestamp,
+        (mdsdsc_a_t *)argValue.getDescriptor()
+    );
+    _onSegmentsWritten();
+    span.setStatus(status);
+    span.addBytes(Trace::GetSize(argValue.getDescriptor()));
+    if (IS_NOT_OK(status)) {
+        throwException(status);
+    }
+}
 
-        if (dsc->class_ == class_t(ResultType::__class) &&
-            dsc->dtype == dtype_t(ResultType::__dtype)) {
-            return ResultType(std::move(xd), getTree());
-        }
+template <typename ValueArrayType>
+void TreeNode::putSegment(const ValueArrayType& values, int index /*= -1*/)
+{
+    TraceScope span(TraceEvent::Write);
+    if (span) {
+        span.setName(getFullPath());
     }
 
-    typename ResultType::__ctype value = {};
+    DataView argValues(values);
 
-    mdsdsc_t convert = {
-        .length = sizeof(typename ResultType::__ctype),
-        .dtype = dtype_t(ResultType::__dtype),
-        .class_ = CLASS_S,
-        .pointer = (char *)&value,
-    };
+    mdsdsc_a_t * dscValues = (mdsdsc_a_t *)_unwrapDescriptor(argValues.getDescriptor());
 
-    status = TdiConvert((mdsdsc_a_t *)dsc, (mdsdsc_a_t *)&convert);
+    int status = _TreePutSegment(
+        getDBID(),
+        getNID(),
+        index,
+        dscValues
+    );
+    _onSegmentsWritten();
+    span.setStatus(status);
+    span.addBytes(Trace::GetSize((mdsdsc_t *)dscValues));
     if (IS_NOT_OK(status)) {
         throwException(status);
     }
-
-    MdsFree1Dx(&xd, nullptr);
-    return ResultType(value);
 }
 
-template <typename ResultType>
-inline ResultType Data::_convertToArray()
+template <typename ValueArrayType>
+void TreeNode::putTimestampedSegment(int64_t * timestamps, const ValueArrayType& values)
 {
-    int status;
+    TraceScope span(TraceEvent::Write);
+    if (span) {
+        span.setName(getFullPath());
+    }
 
-    mdsdsc_xd_t xd = release();
-    mdsdsc_t * dsc = xd.pointer;
+    DataView argValues(values);
 
-    if (dsc->class_ == class_t(ResultType::__class) &&
-        dsc->dtype == dtype_t(ResultType::__dtype)) {
-        return ResultType(std::move(xd), getTree());
-    }
+    mdsdsc_a_t * dscValues = (mdsdsc_a_t *)_unwrapDescriptor(argValues.getDescriptor());
 
-    // TODO: Check edge cases for when we need to call DATA()
-    if (dsc->class_ == CLASS_R) {
-        mdsdsc_xd_t dataXD = MDSDSC_XD_INITIALIZER;
-        status = _intrinsic(OPC_DATA, 1, &dsc, &dataXD);
-        if (IS_NOT_OK(status)) {
-            throwException(status);
-        }
+    int status = _TreePutTimestampedSegment(
+        getDBID(),
+        getNID(),
+        timestamps,
+        dscValues
+    );
+    _onSegmentsWritten();
+    span.setStatus(status);
+    span.addBytes(Trace::GetSize((mdsdsc_t *)dscValues));
+    if (IS_NOT_OK(status)) {
+        throwException(status);
+    }
+}
 
-        MdsFree1Dx(&xd, nullptr);
+template <typename DataType /*= Data*/>
+[[nodiscard]]
+inline DataType TreeNode::getData() const {
+    return getRecord().releaseAndConvert<DataType>();
+}
 
-        xd = dataXD;
-        dsc = xd.pointer;
+template <typename DataType /*= Data*/, typename UnitsType /*= Data*/>
+[[nodiscard]]
+inline std::tuple<DataType, UnitsType> TreeNode::getDataWithUnits() const {
+    auto data = getRecord();
+    auto units = data.getUnits<UnitsType>();
+    return { data.releaseAndConvert<DataType>(), std::move(units) };
+}
 
-        if (dsc->class_ == class_t(ResultType::__class) &&
-            dsc->dtype == dtype_t(ResultType::__dtype)) {
-            return ResultType(std::move(xd), getTree());
+// The number of rows in a segment's values, which is the last and slowest varying dimension,
+// e.g. the number of frames in an array of { width, height, frames }
+inline int _getMaxRowsFilled(mdsdsc_a_t * dsc)
+{
+    switch (dsc->class_) {
+    case CLASS_A:
+    case CLASS_CA:
+        if (dsc->aflags.coeff && dsc->dimct > 0) {
+            array_coeff * dscCoeff = (array_coeff *)dsc;
+            return dscCoeff->m[dscCoeff->dimct - 1];
         }
-    }
+        else if (dsc->length > 0) {
+            return (dsc->arsize / dsc->length);
+        }
+        return 0;
 
-    array_coeff arrayOfOne = {
-        .length = dsc->length,
-        .dtype = dsc->dtype,
-        .class_ = CLASS_A,
-        .pointer = dsc->pointer,
-        .scale = 0,
-        .digits = 0,
-        .aflags = {
-            .binscale = false,
-            .redim = true,
-            .column = true,
-            .coeff = false,
-            .bounds = false,
-        },
-        .dimct = 0,
-        .arsize = dsc->length,
-    };
+    // A single row, same as TreeNode.makeSegment() in tree.py
+    case CLASS_S:
+    case CLASS_R:
+        return 1;
 
-    array_coeff * dscArray = &arrayOfOne;
-    if (dsc->class_ == CLASS_A) {
-        dscArray = (array_coeff *)dsc;
+    default:
+        return -1;
     }
+}
 
-    size_t size = (dscArray->arsize / dscArray->length);
-    std::vector<typename ResultType::__ctype> values(size);
-    array_coeff convert = {
-        .length = sizeof(typename ResultType::__ctype),
-        .dtype = dtype_t(ResultType::__dtype),
-        .class_ = CLASS_A,
-        .pointer = (char *)values.data(),
-        .scale = dscArray->scale,
-        .digits = dscArray->digits,
-        .aflags = dscArray->aflags,
-        .dimct = dscArray->dimct,
-        .arsize = arsize_t(size * sizeof(typename ResultType::__ctype)),
-        .a0 = (char *)values.data(),
-        .m = { 0 },
-    };
-
-    std::vector<uint32_t> dims(dscArray->dimct);
-    if (dscArray->aflags.coeff) {
-        for (dimct_t i = 0; i < dscArray->dimct; ++i) {
-            convert.m[i] = dscArray->m[i];
-            dims[i] = dscArray->m[i];
-        }
-    }
-    else {
-        // TODO: Improve
-        dims.clear();
+// Default rowsFilled to every row, and reject rows that aren't in the values
+inline int _getRowsFilled(mdsdsc_a_t * dsc, int rowsFilled)
+{
+    int maxRowsFilled = _getMaxRowsFilled(dsc);
+    if (rowsFilled < 0) {
+        return maxRowsFilled;
     }
 
-    status = TdiConvert((mdsdsc_a_t *)dscArray, (mdsdsc_a_t *)&convert);
-    if (IS_NOT_OK(status)) {
-        throwException(status);
+    // A record, e.g. compressed values, has no shape to check against
+    if (dsc->class_ != CLASS_R && maxRowsFilled >= 0 && rowsFilled > maxRowsFilled) {
+        throwException(TreeBUFFEROVF);
     }
 
-    MdsFree1Dx(&xd, nullptr);
-    return ResultType(values, dims);
+    return rowsFilled;
 }
 
-inline void String::setValue(const char * value, length_t length)
+template <
+    typename StartIndexType,
+    typename EndIndexType,
+    typename DimensionType,
+    typename ValueArrayType
+>
+void TreeNode::makeSegment(
+    const StartIndexType& startIndex,
+    const EndIndexType& endIndex,
+    const DimensionType& dimension,
+    const ValueArrayType& values,
+    int index /*= -1*/,
+    int rowsFilled /*= -1*/
+) const
 {
-    mdsdsc_s_t dsc = {
-        length,
-        DTYPE_T,
-        CLASS_S,
-        (char *)value
-    };
+    TraceScope span(TraceEvent::Write);
+    if (span) {
+        span.setName(getFullPath());
+    }
+
+    DataView argStartIndex(startIndex);
+    DataView argEndIndex(endIndex);
+    DataView argDimension(dimension);
+    DataView argValues(values);
 
-    // TODO: Verify that this does free the existing XD
-    int status = MdsCopyDxXd((mdsdsc_t *)&dsc, &_xd);
+    mdsdsc_a_t * dscValues = (mdsdsc_a_t *)_unwrapDescriptor(argValues.getDescriptor());
+
+    rowsFilled = _getRowsFilled(dscValues, rowsFilled);
+
+    int status = _TreeMakeSegment(
+        getDBID(),
+        getNID(),
+        argStartIndex.getDescriptor(),
+        argEndIndex.getDescriptor(),
+        argDimension.getDescriptor(),
+        dscValues,
+        index,
+        rowsFilled
+    );
+    _onSegmentsWritten(true);
+    span.setStatus(status);
+    span.addBytes(Trace::GetSize((mdsdsc_t *)dscValues));
     if (IS_NOT_OK(status)) {
         throwException(status);
     }
 }
 
-inline std::vector<std::string> StringArray::getValues() const
+template <
+    typename StartIndexType,
+    typename EndIndexType,
+    typename DimensionType,
+    typename ValueArrayType
+>
+void TreeNode::makeSegmentResampled(
+    const StartIndexType& startIndex,
+    const EndIndexType& endIndex,
+    const DimensionType& dimension,
+    const ValueArrayType& values,
+    const TreeNode& resampleNode,
+    int resampleFactor,
+    int index /*= -1*/,
+    int rowsFilled /*= -1*/
+) const
 {
-    mdsdsc_a_t * dsc = (mdsdsc_a_t *)getDescriptor();
-    if (dsc) {
-        std::vector<std::string> values;
-        for (size_t i = 0; i < size(); ++i) {
-            values.emplace_back(dsc->pointer + (i * dsc->length), dsc->length);
-        }
-        return values;
+    TraceScope span(TraceEvent::Write);
+    if (span) {
+        span.setName(getFullPath());
     }
-    return {};
-}
 
-inline std::string StringArray::getValueAt(size_t index) const
-{
-    mdsdsc_a_t * dsc = (mdsdsc_a_t *)getDescriptor();
-    if (dsc && index < size()) {
-        return std::string(dsc->pointer + (index * dsc->length), dsc->length);
-    }
+    DataView argStartIndex(startIndex);
+    DataView argEndIndex(endIndex);
+    DataView argDimension(dimension);
+    DataView argValues(values);
 
-    throw TdiBadIndex();
-}
+    mdsdsc_a_t * dscValues = (mdsdsc_a_t *)_unwrapDescriptor(argValues.getDescriptor());
 
-inline size_t StringArray::getSize() const
-{
-    mdsdsc_a_t * dsc = (mdsdsc_a_t *)getDescriptor();
-    if (dsc) {
-        return dsc->arsize / dsc->length;
+    rowsFilled = _getRowsFilled(dscValues, rowsFilled);
+
+    int status = _TreeMakeSegmentResampled(
+        getDBID(),
+        getNID(),
+        argStartIndex.getDescriptor(),
+        argEndIndex.getDescriptor(),
+        argDimension.getDescriptor(),
+        dscValues,
+        index,
+        rowsFilled,
+        resampleNode.getNID(),
+        resampleFactor
+    );
+    _onSegmentsWritten(true);
+    span.setStatus(status);
+    span.addBytes(Trace::GetSize((mdsdsc_t *)dscValues));
+    if (IS_NOT_OK(status)) {
+        throwException(status);
     }
-    return 0;
 }
 
-inline void StringArray::setValues(
-    const std::vector<std::string>& values,
-    const std::vector<uint32_t>& dims /*= {}*/
-) {
-    length_t maxSize = 0;
-    for (const auto& value : values) {
-        if (value.size() > maxSize) {
-            maxSize = value.size();
-        }
+template <
+    typename StartIndexType,
+    typename EndIndexType,
+    typename DimensionType,
+    typename ValueArrayType
+>
+void TreeNode::makeSegmentMinMax(
+    const StartIndexType& startIndex,
+    const EndIndexType& endIndex,
+    const DimensionType& dimension,
+    const ValueArrayType& values,
+    const TreeNode& resampleNode,
+    int resampleFactor,
+    int index /*= -1*/,
+    int rowsFilled /*= -1*/
+) const
+{
+    TraceScope span(TraceEvent::Write);
+    if (span) {
+        span.setName(getFullPath());
     }
 
-    std::string buffer;
-    for (const auto& value : values) {
-        buffer += value;
-        for (length_t i = value.size(); i < maxSize; ++i) {
-            buffer.push_back(' ');
-        }
-    }
+    DataView argStartIndex(startIndex);
+    DataView argEndIndex(endIndex);
+    DataView argDimension(dimension);
+    DataView argValues(values);
 
-    if (dims.empty()) {
-        _setValues(buffer, maxSize, { length_t(values.size()) });
-    }
-    else {
-        _setValues(buffer, maxSize, dims);
+    mdsdsc_a_t * dscValues = (mdsdsc_a_t *)_unwrapDescriptor(argValues.getDescriptor());
+
+    rowsFilled = _getRowsFilled(dscValues, rowsFilled);
+
+    int status = _TreeMakeSegmentMinMax(
+        getDBID(),
+        getNID(),
+        argStartIndex.getDescriptor(),
+        argEndIndex.getDescriptor(),
+        argDimension.getDescriptor(),
+        dscValues,
+        index,
+        rowsFilled,
+        resampleNode.getNID(),
+        resampleFactor
+    );
+    _onSegmentsWritten(true);
+    span.setStatus(status);
+    span.addBytes(Trace::GetSize((mdsdsc_t *)dscValues));
+    if (IS_NOT_OK(status)) {
+        throwException(status);
     }
 }
 
-#ifdef __cpp_lib_string_view
-
-    inline void StringArray::setValues(
-        const std::vector<std::string_view>& values,
-        const std::vector<uint32_t>& dims /*= {}*/
-    ) {
-        length_t maxSize = 0;
-        for (const auto& value : values) {
-            if (value.size() > maxSize) {
-                maxSize = value.size();
-            }
-        }
+template <typename ValueType>
+void TreeNode::makeSegmentDecimated(
+    double start,
+    double delta,
+    const ValueType * values,
+    uint32_t count,
+    uint32_t factor,
+    const TreeNode& minNode,
+    const TreeNode& maxNode,
+    const TreeNode& meanNode /*= {}*/
+) const
+{
+    if (count == 0 || factor == 0) {
+        throwException(TreeFAILURE);
+    }
 
-        std::string buffer;
-        for (const auto& value : values) {
-            buffer += value;
-            for (length_t i = value.size(); i < maxSize; ++i) {
-                buffer.push_back(' ');
-            }
-        }
+    auto decimated = decimate(values, count, factor);
 
-        if (dims.empty()) {
-            _setValues(buffer, maxSize, { length_t(values.size()) });
-        }
-        else {
-            _setValues(buffer, maxSize, dims);
-        }
-    }
+    double end = start + delta * (count - 1);
+    makeSegment(start, end, Range(start, end, delta), DataView(values, count));
 
-#endif // __cpp_lib_string_view
+    double decimatedDelta = delta * factor;
+    double decimatedEnd = start + decimatedDelta * (decimated.Min.size() - 1);
+    Range decimatedDimension(start, decimatedEnd, decimatedDelta);
 
-inline void StringArray::_setValues(
-    const std::string& buffer,
-    length_t length,
-    const std::vector<uint32_t>& dims
-) {
-    array_coeff dsc = {
-        .length = length,
-        .dtype = DTYPE_T,
-        .class_ = CLASS_A,
-        .pointer = const_cast<char *>(buffer.data()),
-        .scale = 0,
-        .digits = 0,
-        .aflags = aflags_t{
-            .binscale = false,
-            .redim = true,
-            .column = true,
-            .coeff = true,
-            .bounds = false,
-        },
-        .dimct = dimct_t(dims.size()),
-        .arsize = arsize_t(buffer.size()),
-        .a0 = const_cast<char *>(buffer.data()),
-        .m = { 0 },
-    };
+    if (minNode.getNID() >= 0) {
+        minNode.makeSegment(start, decimatedEnd, decimatedDimension, decimated.Min);
+    }
 
-    for (size_t i = 0; i < dims.size(); ++i) {
-        dsc.m[i] = dims[i];
+    if (maxNode.getNID() >= 0) {
+        maxNode.makeSegment(start, decimatedEnd, decimatedDimension, decimated.Max);
     }
 
-    int status = MdsCopyDxXd((mdsdsc_t *)&dsc, &_xd);
-    if (IS_NOT_OK(status)) {
-        throwException(status);
+    if (meanNode.getNID() >= 0) {
+        meanNode.makeSegment(start, decimatedEnd, decimatedDimension, decimated.Mean);
     }
 }
 
-// #include <mdsplusplus/Scalar.inc.hpp>
-
-inline std::vector<uint32_t> Array::getDimensions() const
+template <typename ValueArrayType>
+void TreeNode::makeTimestampedSegment(
+    int64_t * timestamps,
+    const ValueArrayType& values,
+    int index /*= -1*/,
+    int rowsFilled /*= -1*/
+) const
 {
-    mdsdsc_a_t * dsc = getArrayDescriptor();
-    if (dsc) {
-        if (dsc->aflags.coeff) {
-            array_coeff * dscCoeff = reinterpret_cast<array_coeff *>(dsc);
-            return std::vector<uint32_t>(
-                (uint32_t *)dscCoeff->m,
-                (uint32_t *)(dscCoeff->m + dscCoeff->dimct)
-            );
-        }
-        else {
-            return { (dsc->arsize / dsc->length) };
-        }
+    TraceScope span(TraceEvent::Write);
+    if (span) {
+        span.setName(getFullPath());
     }
 
-    return {};
-}
+    DataView argValues(values);
 
-template <typename CType>
-inline void Array::_setValues(DType dtype, const CType * values, const uint32_t * dims, dimct_t dimCount)
-{
-    // TODO: Overwrite existing values if the shape/type is the same
+    mdsdsc_a_t * dscValues = (mdsdsc_a_t *)_unwrapDescriptor(argValues.getDescriptor());
 
-    uint32_t count = dims[0];
-    for (dimct_t i = 1; i < dimCount; ++i) {
-        count *= dims[dimCount];
-    }
+    rowsFilled = _getRowsFilled(dscValues, rowsFilled);
 
-    array_coeff dsc = {
-        .length = sizeof(CType),
-        .dtype = dtype_t(dtype),
-        .class_ = CLASS_A,
-        .pointer = (char *)values,
-        .scale = 0,
-        .digits = 0,
-        .aflags = aflags_t{
-            .binscale = false,
-            .redim = true,
-            .column = true,
-            .coeff = false,
-            .bounds = false,
-        },
-        .dimct = dimCount,
-        .arsize = arsize_t(count * sizeof(CType)),
-        .a0 = (char *)values,
-        .m = { count, 0, 0, 0, 0, 0, 0, 0, },
-    };
+    int status = _TreeMakeTimestampedSegment(
+        getDBID(),
+        getNID(),
+        timestamps,
+        dscValues,
+        index,
+        rowsFilled
+    );
+    _onSegmentsWritten(true);
+    span.setStatus(status);
+    span.addBytes(Trace::GetSize((mdsdsc_t *)dscValues));
+    if (IS_NOT_OK(status)) {
+        throwException(status);
+    }
+}
 
-    if (dims && dimCount > 0) {
-        dsc.aflags.coeff = true;
-        for (size_t i = 0; i < dimCount; ++i) {
-            dsc.m[i] = dims[i];
-        }
+template <
+    typename StartIndexType,
+    typename EndIndexType,
+    typename DimensionType,
+    typename ValueArrayType
+>
+void TreeNode::beginSegment(
+    const StartIndexType& startIndex,
+    const EndIndexType& endIndex,
+    const DimensionType& dimension,
+    const ValueArrayType& initialValues,
+    int index /*= -1*/
+) const
+{
+    TraceScope span(TraceEvent::Write);
+    if (span) {
+        span.setName(getFullPath());
     }
 
-    int status = MdsCopyDxXd((mdsdsc_t *)&dsc, &_xd);
+    DataView argStartIndex(startIndex);
+    DataView argEndIndex(endIndex);
+    DataView argDimension(dimension);
+    DataView argValues(initialValues);
+
+    mdsdsc_a_t * dscValues = (mdsdsc_a_t *)_unwrapDescriptor(argValues.getDescriptor());
+
+    int status = _TreeBeginSegment(
+        getDBID(),
+        getNID(),
+        argStartIndex.getDescriptor(),
+        argEndIndex.getDescriptor(),
+        argDimension.getDescriptor(),
+        dscValues,
+        index
+    );
+    _onSegmentsWritten(true);
+    span.setStatus(status);
+    span.addBytes(Trace::GetSize((mdsdsc_t *)dscValues));
     if (IS_NOT_OK(status)) {
         throwException(status);
     }
 }
 
-#ifdef __cpp_lib_span
-
-    template <typename CType>
-    inline std::span<CType> Array::_getSpan() const {
-        mdsdsc_a_t * dsc = getArrayDescriptor();
-        if (dsc) {
-            return std::span<CType>(
-                reinterpret_cast<CType *>(dsc->pointer),
-                reinterpret_cast<CType *>(dsc->pointer + dsc->arsize)
-            );
-        }
-        return {};
+template <typename ValueArrayType>
+void TreeNode::beginTimestampedSegment(const ValueArrayType& initialValues, int index /*= -1*/) const
+{
+    TraceScope span(TraceEvent::Write);
+    if (span) {
+        span.setName(getFullPath());
     }
 
-#endif // __cpp_lib_span
+    DataView argValues(initialValues);
 
-template <typename CType>
-inline std::vector<CType> Array::_getValues() const {
-    mdsdsc_a_t * dsc = getArrayDescriptor();
-    if (dsc) {
-        return std::vector<CType>(
-            reinterpret_cast<CType *>(dsc->pointer),
-            reinterpret_cast<CType *>(dsc->pointer + dsc->arsize)
-        );
+    mdsdsc_a_t * dscValues = (mdsdsc_a_t *)_unwrapDescriptor(argValues.getDescriptor());
+
+    int status = _TreeBeginTimestampedSegment(
+        getDBID(),
+        getNID(),
+        dscValues,
+        index
+    );
+    _onSegmentsWritten(true);
+    span.setStatus(status);
+    span.addBytes(Trace::GetSize((mdsdsc_t *)dscValues));
+    if (IS_NOT_OK(status)) {
+        throwException(status);
     }
-    return {};
 }
 
-template <typename CType>
-inline const CType& Array::_getValueAt(size_t index) const {
-    mdsdsc_a_t * dsc = getArrayDescriptor();
-    if (dsc && index < size()) {
-        return *((CType *)dsc->pointer + index);
+template <
+    typename ValueType,
+    typename StartIndexType,
+    typename EndIndexType,
+    typename DimensionType
+>
+void TreeNode::allocateSegment(
+    const StartIndexType& startIndex,
+    const EndIndexType& endIndex,
+    const DimensionType& dimension,
+    uint32_t rows,
+    const std::vector<uint32_t>& rowDims /*= {}*/,
+    int index /*= -1*/
+) const
+{
+    std::vector<uint32_t> dims = rowDims;
+    dims.push_back(rows);
+
+    size_t count = 1;
+    for (uint32_t dim : dims) {
+        count *= dim;
     }
 
-    throw TdiBadIndex();
+    const ValueType * zeros = _getZeros<ValueType>(count);
+    beginSegment(startIndex, endIndex, dimension, DataView(zeros, dims), index);
 }
 
-template <typename CType>
-inline const CType& Array::_front() const
+template <typename ValueType>
+const ValueType * TreeNode::_getZeros(size_t count)
 {
-    return _getValueAt<CType>(0);
+    // Only ever read, so it can be shared by every call on this thread and only grows
+    thread_local std::vector<ValueType> zeros;
+    if (zeros.size() < count) {
+        zeros.resize(count);
+    }
+    return zeros.data();
 }
 
-template <typename CType>
-inline const CType& Array::_back() const
+template <typename ValueType>
+void TreeNode::allocateTimestampedSegment(
+    uint32_t rows,
+    const std::vector<uint32_t>& rowDims /*= {}*/,
+    int index /*= -1*/
+) const
 {
-    return _getValueAt<CType>(size() - 1);
-}
+    std::vector<uint32_t> dims = rowDims;
+    dims.push_back(rows);
 
-template <typename CType>
-inline CType * Array::_begin() const
-{
-    mdsdsc_a_t * dsc = (mdsdsc_a_t *)getDescriptor();
-    if (dsc) {
-        return reinterpret_cast<CType *>(dsc->pointer);
+    size_t count = 1;
+    for (uint32_t dim : dims) {
+        count *= dim;
     }
 
-    return nullptr;
+    const ValueType * zeros = _getZeros<ValueType>(count);
+    beginTimestampedSegment(DataView(zeros, dims), index);
 }
 
-template <typename CType>
-inline CType * Array::_end() const
+template <
+    typename StartIndexType,
+    typename EndIndexType,
+    typename DimensionType
+>
+void TreeNode::updateSegment(
+    const StartIndexType& startIndex,
+    const EndIndexType& endIndex,
+    const DimensionType& dimension,
+    int index /*= -1*/
+) const
 {
-    mdsdsc_a_t * dsc = (mdsdsc_a_t *)getDescriptor();
-    if (dsc) {
-        return reinterpret_cast<CType *>(dsc->pointer + dsc->arsize);
+    TraceScope span(TraceEvent::Write);
+    if (span) {
+        span.setName(getFullPath());
     }
 
-    return nullptr;
+    DataView argStartIndex(startIndex);
+    DataView argEndIndex(endIndex);
+    DataView argDimension(dimension);
+
+    int status = _TreeUpdateSegment(
+        getDBID(),
+        getNID(),
+        argStartIndex.getDescriptor(),
+        argEndIndex.getDescriptor(),
+        argDimension.getDescriptor(),
+        index
+    );
+    _onSegmentsWritten(true);
+    span.setStatus(status);
+    if (IS_NOT_OK(status)) {
+        throwException(status);
+    }
 }
 
-template <typename ResultType /*= Data*/>
-inline ResultType Int8Array::deserialize()
+inline int TreeNode::getNumSegments() const
 {
-    mdsdsc_xd_t out = MDSDSC_XD_INITIALIZER;
-    int status = MdsSerializeDscIn(getDescriptor()->pointer, &out);
+    int numSegments = 0;
+    int status = _TreeGetNumSegments(getDBID(), getNID(), &numSegments);
     if (IS_NOT_OK(status)) {
         throwException(status);
     }
 
-    return Data(std::move(out)).releaseAndConvert<ResultType>();
+    return numSegments;
 }
 
-template <typename ResultType /*= Data*/>
-inline ResultType UInt8Array::deserialize()
+template <typename ValueArrayType /*= Data*/, typename DimensionType /*= Data*/>
+std::tuple<ValueArrayType, DimensionType> TreeNode::getSegment(int index) const
 {
-    mdsdsc_xd_t out = MDSDSC_XD_INITIALIZER;
-    int status = MdsSerializeDscIn(getDescriptor()->pointer, &out);
+    TraceScope span(TraceEvent::Read);
+    if (span) {
+        span.setName(getFullPath() + "[" + std::to_string(index) + "]");
+    }
+
+    mdsdsc_xd_t values = MDSDSC_XD_INITIALIZER;
+    mdsdsc_xd_t dimension = MDSDSC_XD_INITIALIZER;
+    int status = _TreeGetSegment(getDBID(), getNID(), index, &values, &dimension);
+    span.setStatus(status);
+    span.addBytes(values.l_length + dimension.l_length);
     if (IS_NOT_OK(status)) {
+        MdsFree1Dx(&values, nullptr);
+        MdsFree1Dx(&dimension, nullptr);
         throwException(status);
     }
 
-    return Data(std::move(out)).releaseAndConvert<ResultType>();
+    return {
+        Data(std::move(values), getTree()).releaseAndConvert<ValueArrayType>(),
+        Data(std::move(dimension), getTree()).releaseAndConvert<DimensionType>(),
+    };
 }
 
-// #include <mdsplusplus/APD.inc.hpp>
-
-inline Data Function::call() const
+template <typename StartType /*= Data*/, typename EndType /*= StartType*/>
+std::tuple<StartType, EndType> TreeNode::getSegmentLimits(int index) const
 {
-    int status;
+    mdsdsc_xd_t start = MDSDSC_XD_INITIALIZER;
+    mdsdsc_xd_t end = MDSDSC_XD_INITIALIZER;
+    int status = _TreeGetSegmentLimits(getDBID(), getNID(), index, &start, &end);
+    if (IS_NOT_OK(status)) {
+        MdsFree1Dx(&start, nullptr);
+        MdsFree1Dx(&end, nullptr);
+        throwException(status);
+    }
 
-    descriptor_function * dsc = (descriptor_function *)getDescriptor();
+    return {
+        Data(std::move(start), getTree()).releaseAndConvert<StartType>(),
+        Data(std::move(end), getTree()).releaseAndConvert<EndType>(),
+    };
+}
 
-    // TODO: Tree*
-    opcode_t * opcode = (opcode_t *)dsc->pointer;
-    mdsdsc_xd_t out = MDSDSC_XD_INITIALIZER;
-    _intrinsic(*opcode, dsc->ndesc, dsc->arguments, &out);
+inline SegmentInfo TreeNode::getSegmentInfo(int index /*= -1*/) const
+{
+    char dtype = 0;
+    char dimct = 0;
+    int dims[MAX_DIMS] = {};
+    int nextRow = 0;
+    int status = _TreeGetSegmentInfo(getDBID(), getNID(), index, &dtype, &dimct, dims, &nextRow);
     if (IS_NOT_OK(status)) {
         throwException(status);
     }
 
-    return Data(std::move(out));
+    SegmentInfo info;
+    info.Type = DType(static_cast<uint8_t>(dtype));
+    info.Dimensions.assign(dims, dims + dimct);
+    info.RowsFilled = nextRow;
+    return info;
 }
 
-inline std::string to_string(const Usage& usage)
+template <typename ValueArrayType>
+std::tuple<std::vector<typename ValueArrayType::__ctype>, std::vector<double>> TreeNode::readWindow(double start, double end) const
 {
-    switch (usage) {
-    case Usage::Any: return "Usage::Any";
-    case Usage::Structure: return "Usage::Structure";
-    case Usage::Action: return "Usage::Action";
-    case Usage::Device: return "Usage::Device";
-    case Usage::Dispatch: return "Usage::Dispatch";
-    case Usage::Numeric: return "Usage::Numeric";
-    case Usage::Signal: return "Usage::Signal";
-    case Usage::Task: return "Usage::Task";
-    case Usage::Text: return "Usage::Text";
-    case Usage::Window: return "Usage::Window";
-    case Usage::Axis: return "Usage::Axis";
-    case Usage::Subtree: return "Usage::Subtree";
-    case Usage::CompoundData: return "Usage::CompoundData";
+    std::vector<typename ValueArrayType::__ctype> values;
+    std::vector<double> times;
+
+    auto [first, last] = _findSegments(start, end);
+    for (int index = first; index < last; ++index) {
+        auto [segmentValues, segmentTimes] = getSegment<ValueArrayType, Float64Array>(index);
+
+        const auto& dims = segmentValues.getDimensions();
+        if (dims.empty() || dims.back() == 0) {
+            continue;
+        }
+
+        // The values of a partially filled segment can be shorter than its dimension
+        size_t rows = std::min<size_t>(dims.back(), segmentTimes.getSize());
+        size_t rowSize = segmentValues.getSize() / dims.back();
+
+        const double * timesBegin = segmentTimes.begin();
+        const double * timesEnd = timesBegin + rows;
+        const double * windowBegin = std::lower_bound(timesBegin, timesEnd, start);
+        const double * windowEnd = std::upper_bound(windowBegin, timesEnd, end);
+
+        times.insert(times.end(), windowBegin, windowEnd);
+
+        const auto * valuesBegin = segmentValues.begin();
+        values.insert(
+            values.end(),
+            valuesBegin + (windowBegin - timesBegin) * rowSize,
+            valuesBegin + (windowEnd - timesBegin) * rowSize
+        );
     }
 
-    return "?";
+    return { std::move(values), std::move(times) };
 }
 
-inline std::string to_string(const TreeNodeFlags& flags)
+inline std::pair<int, int> TreeNode::_findSegments(double start, double end) const
 {
-    std::string str;
+    // Convert a list of segment limits, or an array of them, to doubles
+    auto toDoubles = [](Data&& data) {
+        std::vector<double> limits;
+        if (data.getClass() == Class::APD) {
+            for (auto limit : data.releaseAndConvert<List>()) {
+                limits.push_back(limit.clone<Float64>().getValue());
+            }
+        }
+        else if (data.getClass() != Class::Missing) {
+            limits = data.releaseAndConvert<Float64Array>().getValues();
+        }
+        return limits;
+    };
 
-    if (flags.CompressSegments) {
-        str += "CompressSegments | ";
-    }
+    Tree * tree = getTree();
 
-    if (flags.IncludeInPulse) {
-        str += "IncludeInPulse | ";
-    }
+    // Read before refreshing, so that a segment written during the refresh is picked up next time
+    uint64_t writeCount = Tree::_getSegmentWriteCount().load(std::memory_order_acquire);
 
-    if (flags.NidReference) {
-        str += "NidReference | ";
-    }
+    std::lock_guard<std::mutex> lock(tree->_segmentIndexMutex);
+    auto& index = tree->_segmentIndexes[_nid];
 
-    if (flags.PathReference) {
-        str += "PathReference | ";
+    bool reload = !index.Loaded;
+    if (index.Loaded && index.WriteCount != writeCount) {
+        int numSegments = getNumSegments();
+        if (index.Starts.size() != size_t(numSegments)) {
+            reload = true;
+        }
+        else if (numSegments > 0) {
+            // Rows can still be added to the last segment, which moves its end
+            auto [lastStart, lastEnd] = getSegmentLimits<Float64>(numSegments - 1);
+            index.Starts.back() = lastStart.getValue();
+            index.Ends.back() = lastEnd.getValue();
+        }
     }
 
-    if (flags.NoWriteShot) {
-        str += "NoWriteShot | ";
-    }
+    if (reload) {
+        int count = 0;
+        mdsdsc_xd_t startList = MDSDSC_XD_INITIALIZER;
+        mdsdsc_xd_t endList = MDSDSC_XD_INITIALIZER;
+        int status = _TreeGetSegmentTimesXd(getDBID(), getNID(), &count, &startList, &endList);
+        if (IS_NOT_OK(status)) {
+            MdsFree1Dx(&startList, nullptr);
+            MdsFree1Dx(&endList, nullptr);
+            index = {};
+            throwException(status);
+        }
 
-    if (flags.NoWriteModel) {
-        str += "NoWriteModel | ";
+        index.Starts = toDoubles(Data(std::move(startList), tree));
+        index.Ends = toDoubles(Data(std::move(endList), tree));
+        if (index.Starts.size() != index.Ends.size()) {
+            index = {};
+            throwException(TreeFAILURE);
+        }
+
+        index.Loaded = true;
     }
 
-    if (flags.CompressOnPut) {
-        str += "CompressOnPut | ";
+    index.WriteCount = writeCount;
+
+    // Segments are written in order, so both the starts and the ends are sorted
+    int first = std::lower_bound(index.Ends.begin(), index.Ends.end(), start) - index.Ends.begin();
+    int last = std::upper_bound(index.Starts.begin(), index.Starts.end(), end) - index.Starts.begin();
+
+    return { first, std::max(first, last) };
+}
+
+inline void TreeNode::_onSegmentsWritten(bool reindex /*= false*/) const
+{
+    Tree::_getSegmentWriteCount().fetch_add(1, std::memory_order_release);
+
+    Tree * tree = getTree();
+    if (reindex && tree) {
+        std::lock_guard<std::mutex> lock(tree->_segmentIndexMutex);
+        tree->_segmentIndexes.erase(_nid);
     }
+}
 
-    if (flags.DoNotCompress) {
-        str += "DoNotCompress | ";
+template <typename ValueType>
+void TreeNode::setSegmentScale(const ValueType& value)
+{
+    DataView argValue(value);
+    int status = _TreeSetSegmentScale(getDBID(), getNID(), argValue.getDescriptor());
+    if (IS_NOT_OK(status)) {
+        throwException(status);
     }
+}
 
-    if (flags.Compressible) {
-        str += "Compressible | ";
+template <typename ResultType>
+ResultType TreeNode::getSegmentScale()
+{
+    mdsdsc_xd_t out = MDSDSC_XD_INITIALIZER;
+    int status = _TreeGetSegmentScale(getDBID(), getNID(), &out);
+    if (IS_NOT_OK(status)) {
+        throwException(status);
     }
+    return Data(std::move(out), getTree()).releaseAndConvert<ResultType>();
+}
 
-    if (flags.WriteOnce) {
-        str += "WriteOnce | ";
+inline std::vector<int> Tree::getShotDB(
+    const std::string& treename,
+    const std::string& path /*= ""*/,
+    int lower /*= INT_MIN */,
+    int higher /*= INT_MAX */
+) {
+    std::string lowerTreename(treename);
+    for (auto& c : lowerTreename) {
+        c = ::tolower(c);
     }
 
-    if (flags.SetupInformation) {
-        str += "SetupInformation | ";
+    const auto& directories = _getShotDBDirectories(lowerTreename, path);
+
+    std::vector<int> shots;
+
+    std::lock_guard<std::mutex> lock(_getShotDBMutex());
+    auto& cache = _getShotDBCache();
+
+    for (const auto& directory : directories) {
+        std::error_code ec;
+        auto lastWriteTime = std::filesystem::last_write_time(directory, ec);
+        if (ec) {
+            // Missing directories are skipped, the same as when opening a tree
+            continue;
+        }
+
+        auto& entry = cache[directory.string()];
+        if (entry.Stale || entry.LastWriteTime != lastWriteTime) {
+            entry.LastWriteTime = lastWriteTime;
+            _scanShotDBDirectory(directory, entry);
+        }
+
+        auto it = entry.Shots.find(lowerTreename);
+        if (it != entry.Shots.end()) {
+            const auto& treeShots = it->second;
+            auto first = std::lower_bound(treeShots.begin(), treeShots.end(), lower);
+            auto last = std::upper_bound(first, treeShots.end(), higher);
+            shots.insert(shots.end(), first, last);
+        }
     }
 
-    if (flags.Segmented) {
-        str += "Segmented | ";
+    // The same shot can be found in more than one directory
+    std::sort(shots.begin(), shots.end());
+    shots.erase(std::unique(shots.begin(), shots.end()), shots.end());
+
+    return shots;
+}
+
+inline void Tree::clearShotDBCache()
+{
+    std::lock_guard<std::mutex> lock(_getShotDBMutex());
+    _getShotDBCache().clear();
+}
+
+inline std::mutex& Tree::_getShotDBMutex()
+{
+    static std::mutex mutex;
+    return mutex;
+}
+
+inline std::atomic<uint64_t>& Tree::_getSegmentWriteCount()
+{
+    static std::atomic<uint64_t> count = 0;
+    return count;
+}
+
+inline std::unordered_map<std::string, Tree::_ShotDBDirectory>& Tree::_getShotDBCache()
+{
+    static std::unordered_map<std::string, _ShotDBDirectory> cache;
+    return cache;
+}
+
+inline std::vector<std::filesystem::path> Tree::_getShotDBDirectories(const std::string& treename, const std::string& path)
+{
+    std::string treePath = path;
+    if (treePath.empty()) {
+        // Don't read the environment while Tree::open() is overriding a path
+        std::shared_lock<std::shared_mutex> lock(_getOpenMutex());
+
+        std::string envName = treename + "_path";
+        const char * envPath = ::getenv(envName.c_str());
+        if (!envPath) {
+            envPath = ::getenv("default_tree_path");
+        }
+
+        if (envPath) {
+            treePath = envPath;
+        }
     }
 
-    if (flags.Versions) {
-        str += "Versions | ";
+    // e.g. /trees/~t/ -> /trees/mytree/
+    size_t pos = 0;
+    while ((pos = treePath.find("~t", pos)) != std::string::npos) {
+        treePath.replace(pos, 2, treename);
+        pos += treename.size();
     }
 
-    if (flags.Cached) {
-        str += "Cached | ";
-    }
+    std::vector<std::filesystem::path> directories;
 
-    if (flags.Essential) {
-        str += "Essential | ";
-    }
+    size_t begin = 0;
+    while (begin <= treePath.size()) {
+        size_t end = treePath.find(';', begin);
+        if (end == std::string::npos) {
+            end = treePath.size();
+        }
 
-    if (flags.ParentState) {
-        str += "ParentState | ";
-    }
+        std::string entry = treePath.substr(begin, end - begin);
+        begin = end + 1;
 
-    if (flags.State) {
-        str += "State | ";
-    }
+        // Trim whitespace
+        entry.erase(0, entry.find_first_not_of(" \t"));
+        entry.erase(entry.find_last_not_of(" \t") + 1);
 
-    // Strip trailing " | "
-    if (!str.empty()) {
-        str.resize(str.size() - 3);
+        // Remote paths, e.g. server::/trees/, cannot be searched locally
+        if (entry.empty() || entry.find("::") != std::string::npos) {
+            continue;
+        }
+
+        _expandShotDBDirectory(entry, directories);
     }
 
-    return str;
+    return directories;
 }
 
-inline std::string to_string(const TreeNode * node)
+inline void Tree::_expandShotDBDirectory(const std::string& pattern, std::vector<std::filesystem::path>& directories)
 {
-    assert(node);
+    // Directories can contain ~a through ~j, which are replaced with digits of the shot number
+    size_t tilde = pattern.find('~');
+    if (tilde == std::string::npos) {
+        directories.emplace_back(pattern);
+        return;
+    }
 
-    std::string str = "TreeNode(";
-    str += to_string(node->getTree());
-    str += ", ";
-    str += std::to_string(node->getNID());
-    str += ")";
+    // Search every subdirectory in place of the directory name containing the ~
+    size_t slash = pattern.rfind('/', tilde);
+    std::string parent = (slash == std::string::npos ? "." : pattern.substr(0, slash + 1));
 
-    return str;
+    size_t next = pattern.find('/', tilde);
+    std::string rest = (next == std::string::npos ? "" : pattern.substr(next));
 
-    // return std::format(
-    //     "TreeNode({}, {})",
-    //     to_string(node->getTree()),
-    //     node->getNID()
-    // );
+    std::error_code ec;
+    std::filesystem::directory_iterator it(parent, ec);
+    for (; !ec && it != std::filesystem::directory_iterator(); it.increment(ec)) {
+        if (it->is_directory(ec)) {
+            _expandShotDBDirectory(it->path().string() + rest, directories);
+        }
+    }
 }
 
-inline std::string to_string(const Mode& mode)
+inline void Tree::_scanShotDBDirectory(const std::filesystem::path& directory, _ShotDBDirectory& entry)
 {
-    switch (mode) {
-    case Mode::Normal: return "Mode::Normal";
-    case Mode::ReadOnly: return "Mode::ReadOnly";
-    case Mode::Edit: return "Mode::Edit";
-    case Mode::New: return "Mode::New";
+    static constexpr std::string_view extension = ".tree";
 
-    case Mode::View: return "Mode::View";
-    }
+    entry.Shots.clear();
 
-    return "?";
-}
+    // A file added within the resolution of the filesystem's timestamps would not change the
+    // modification time, so anything modified recently is scanned again on the next query
+    auto age = std::filesystem::file_time_type::clock::now() - entry.LastWriteTime;
+    entry.Stale = (age < std::chrono::seconds(2));
 
-inline std::string to_string(const Tree * tree)
-{
-    assert(tree);
+    std::error_code ec;
+    std::filesystem::directory_iterator it(directory, ec);
+    for (; !ec && it != std::filesystem::directory_iterator(); it.increment(ec)) {
+        // e.g. mytree_123.tree
+        const std::string filename = it->path().filename().string();
+        if (filename.size() <= extension.size() ||
+            filename.compare(filename.size() - extension.size(), extension.size(), extension) != 0) {
+            continue;
+        }
 
-    std::string str = "Tree(\"";
-    str += tree->getTreeName();
-    str += "\", ";
-    str += std::to_string(tree->getShot());
-    str += ", ";
-    str += to_string(tree->getMode());
-    str += ")";
+        const char * end = filename.data() + filename.size() - extension.size();
 
-    return str;
+        size_t underscore = filename.rfind('_', filename.size() - extension.size() - 1);
+        if (underscore == std::string::npos || underscore == 0) {
+            continue;
+        }
 
-    // return std::format(
-    //     "Tree(\"{}\", {}, {})",
-    //     tree->getTreeName(),
-    //     tree->getShot(),
-    //     to_string(tree->getMode())
-    // );
-}
+        const char * begin = filename.data() + underscore + 1;
+        if (begin == end || !::isdigit(*begin)) {
+            // e.g. mytree_model.tree
+            continue;
+        }
 
-[[nodiscard]]
-inline void * TreeNode::getDBID() const {
-    return getTree()->getDBID();
-}
+        int shot = 0;
+        auto result = std::from_chars(begin, end, shot);
+        if (result.ec != std::errc() || result.ptr != end) {
+            continue;
+        }
 
-[[nodiscard]]
-inline void * TreeNode::getContext() const {
-    return getTree()->getContext();
+        entry.Shots[filename.substr(0, underscore)].push_back(shot);
+    }
+
+    for (auto& it : entry.Shots) {
+        std::sort(it.second.begin(), it.second.end());
+    }
 }
 
-inline TreeNode TreeNode::getNode(const std::string& path) const
+inline std::string Tree::getFileName(const std::string& subtree /*= {}*/)
 {
-    int nid = 0;
-
-    int status = _TreeFindNodeRelative(getDBID(), path.data(), _nid, &nid);
+    mdsdsc_xd_t out = MDSDSC_XD_INITIALIZER;
+    const char * treename = (subtree.empty() ? nullptr : subtree.c_str());
+    int status = _TreeFileName(getDBID(), const_cast<char *>(treename), getShot(), &out);
     if (IS_NOT_OK(status)) {
         throwException(status);
     }
 
-    return TreeNode(_tree, nid);
+    return Data(std::move(out)).releaseAndConvert<String>().getString();
 }
 
-inline std::vector<TreeNode> TreeNode::findNodeWild(const std::string& wildcard, std::vector<Usage> validUsages /*= {}*/) const
+inline Mode from_string(const std::string& mode)
 {
-    std::vector<TreeNode> nodes;
+    if (mode == "normal" || mode == "NORMAL") {
+        return Mode::Normal;
+    }
+    else if (mode == "edit" || mode == "EDIT") {
+        return Mode::Edit;
+    }
+    else if (mode == "new" || mode == "NEW") {
+        return Mode::Edit;
+    }
 
-    int usageMask = 0xFFFF;
-    if (!validUsages.empty()) {
-        usageMask = 0;
-        for (const auto& usage : validUsages) {
-            usageMask |= 1 << int(usage);
-        }
+    return Mode::ReadOnly;
+}
+
+inline void Tree::open(const std::string& treename, int shot, Mode mode /*= Mode::Normal*/)
+{
+    int status;
+
+    if (mode == Mode::View) {
+        return;
     }
 
-    void * findContext = nullptr;
-    while (true)
+    if (_dbid != nullptr) {
+        close();
+    }
+
+    _treename = treename;
+    _shot = shot;
+    _mode = mode;
+
     {
-        int outnid;
-        int status = _TreeFindNodeWildRelative(
-            getDBID(),
-            wildcard.c_str(),
-            _nid,
-            &outnid,
-            &findContext,
-            usageMask
-        );
-        if (status == TreeNMN || status == TreeNNF) {
-            break;
-        }
-        else if (IS_NOT_OK(status)) {
-            throwException(status);
-        }
+        std::lock_guard<std::mutex> lock(_segmentIndexMutex);
+        _segmentIndexes.clear();
+    }
 
-        nodes.push_back(TreeNode(getTree(), outnid));
+    TraceScope span(TraceEvent::Open);
+    if (span) {
+        span.setName(_treename + ", " + std::to_string(_shot));
     }
 
-    _TreeFindNodeEnd(getDBID(), &findContext);
+    if (_path.empty()) {
+        std::shared_lock<std::shared_mutex> lock(_getOpenMutex());
+        status = _open();
+    }
+    else {
+        // TreeOpen only reads <tree>_path from the environment, so the override has to be set
+        // there for the duration of the open. Holding the lock exclusively ensures no other
+        // open, or getShotDB(), can see it.
+        std::unique_lock<std::shared_mutex> lock(_getOpenMutex());
 
-    return nodes;
-}
+        std::string envName(_treename);
+        for (auto& c : envName) {
+            c = ::tolower(c);
+        }
+        envName += "_path";
 
-inline TreeNode TreeNode::addNode(const std::string& path, Usage usage) const
-{
-    int nid = 0;
+        // The pointer returned by getenv() is not guaranteed to survive setenv()
+        const char * envPath = ::getenv(envName.c_str());
+        bool hasOldPath = (envPath != nullptr);
+        std::string oldPath = (hasOldPath ? envPath : "");
 
-    int status = _TreeAddNode(getDBID(), path.data(), &nid, static_cast<unsigned char>(usage));
+        ::setenv(envName.c_str(), _path.c_str(), true);
+
+        status = _open();
+
+        if (hasOldPath) {
+            ::setenv(envName.c_str(), oldPath.c_str(), true);
+        }
+        else {
+            ::unsetenv(envName.c_str());
+        }
+    }
+
+    span.setStatus(status);
     if (IS_NOT_OK(status)) {
         throwException(status);
     }
 
-    return TreeNode(_tree, nid);
+    // Initialize TreeNode parent class to \\TOP
+    _tree = this;
+    _nid = 0;
 }
 
-inline TreeNode TreeNode::addDevice(const std::string& path, const std::string& model) const
+inline void Tree::open(const std::string& treename, int shot, Mode mode, const std::string& path)
 {
-    int nid = 0;
+    _path = path;
+    open(treename, shot, mode);
+}
 
-    int status = _TreeAddConglom(getDBID(), path.data(), model.data(), &nid);
-    if (IS_NOT_OK(status)) {
-        throwException(status);
+inline int Tree::_open()
+{
+    switch (_mode) {
+    case Mode::Normal:
+        return _TreeOpen(&_dbid, _treename.c_str(), _shot, 0);
+    case Mode::ReadOnly:
+        return _TreeOpen(&_dbid, _treename.c_str(), _shot, 1);
+    case Mode::Edit:
+        return _TreeOpenEdit(&_dbid, _treename.c_str(), _shot);
+    case Mode::New:
+        return _TreeOpenNew(&_dbid, _treename.c_str(), _shot);
+    default: ;
     }
 
-    return TreeNode(_tree, nid);
+    return TreeFAILURE;
 }
 
-template <typename ResultType /*= Data*/, typename ...ArgTypes>
-ResultType TreeNode::doMethod(const std::string& method, const ArgTypes&... args)
+inline std::shared_mutex& Tree::_getOpenMutex()
 {
-    std::vector<DataView> argList = { DataView(args)... };
+    static std::shared_mutex mutex;
+    return mutex;
+}
 
-    std::vector<mdsdsc_t *> dscList;
-    for (const auto& arg : argList) {
-        dscList.push_back(arg.getDescriptor());
+inline void Tree::close()
+{
+    int status = _TreeClose(&_dbid, nullptr, 0);
+    if (IS_NOT_OK(status) && status != TreeNOT_OPEN) {
+        throwException(status);
     }
 
-    _tree->setActive(); // HACK:
-
-    DESCRIPTOR_NID(dscNID, &_nid);
-    DESCRIPTOR_FROM_CSTRING(dscMethod, method.c_str());
-    mdsdsc_xd_t out = MDSDSC_XD_INITIALIZER;
-    int status = _TreeDoMethodA(
-        getDBID(),
-        &dscNID,
-        &dscMethod,
-        dscList.size(),
-        dscList.data(),
-        &out
-    );
-    if (IS_NOT_OK(status)) {
-        throwException(status);
+    {
+        std::lock_guard<std::mutex> lock(_segmentIndexMutex);
+        _segmentIndexes.clear();
     }
 
-    return Data(std::move(out), getTree()).releaseAndConvert<ResultType>();
+    // Cleanup TreeNode
+    _tree = nullptr;
+    _nid = -1;
 }
 
-inline std::string TreeNode::getNodeName() const
+inline void Tree::write()
 {
-    std::string name = _getStringNCI(NciNODE_NAME, 64);
-
-    // Trim trailing spaces
-    size_t it = name.find(' ');
-    if (it != std::string::npos) {
-        name[it] = '\0';
+    int status = _TreeWriteTree(&_dbid, nullptr, 0);
+    if (IS_NOT_OK(status)) {
+        throwException(status);
     }
-
-    return name;
 }
 
-template <typename ValueType>
-inline void TreeNode::setExtendedAttribute(const std::string& name, const ValueType& value) const
+inline void Tree::createPulse(int shot) const
 {
-    DataView argValue(value);
-    int status = _TreeSetXNci(getDBID(), _nid, name.c_str(), argValue.getDescriptor());
+    // TODO: copy_only_this ?
+
+    int nid = getNID();
+    int status = _TreeCreatePulseFile(getDBID(), shot, 0, &nid);
     if (IS_NOT_OK(status)) {
         throwException(status);
     }
 }
 
-template <typename ResultType /*= Data*/>
-ResultType TreeNode::getExtendedAttribute(const std::string& name)
-{
-    mdsdsc_xd_t out = MDSDSC_XD_INITIALIZER;
-    int status = _TreeGetXNci(getDBID(), _nid, name.c_str(), &out);
-    if (IS_NOT_OK(status)) {
-        throwException(status);
-    }
+// inline std::vector<TreeNode> Tree::findNodeWild(const std::string& wildcard) const
+// {
+//     std::vector<TreeNode> nodes;
+
+//     int usageMask = 0xFFFF;
+
+//     void * findContext = nullptr;
+//     while (true)
+//     {
+//         int outnid;
+//         int status = _TreeFindNodeWild(
+//             getDBID(),
+//             wildcard.c_str(),
+//             &outnid,
+//             &findContext,
+//             usageMask
+//         );
+//         if (status == TreeNMN || status == TreeNNF) {
+//             break;
+//         }
+//         else if (IS_NOT_OK(status)) {
+//             throwException(status);
+//         }
+
+//         nodes.push_back(TreeNode(getTree(), outnid));
+//     }
 
-    return Data(std::move(out), getTree()).releaseAndConvert<ResultType>();
-}
+//     _TreeFindNodeEnd(getDBID(), &findContext);
 
-inline void TreeNode::addTag(const std::string& tag)
-{
-    int status = _TreeAddTag(getDBID(), _nid, tag.c_str());
-    if (IS_NOT_OK(status)) {
-        throwException(status);
-    }
-}
+//     return nodes;
+// }
 
-inline std::vector<std::string> TreeNode::getTags() const
+inline std::vector<std::string> Tree::findTagWild(const std::string& wildcard) const
 {
     std::vector<std::string> tags;
 
-    int outnid = _nid;
+    int outnid;
     void * findContext = nullptr;
     while (true)
     {
-        char * tag = _TreeFindNodeTags(getDBID(), _nid, &findContext);
+        char * tag = _TreeFindTagWild(getDBID(), const_cast<char *>(wildcard.c_str()), &outnid, &findContext);
         if (!tag) {
             break;
         }
 
-        tags.push_back("\\" + std::string(tag));
+        tags.push_back(tag);
     }
 
     TreeFindTagEnd(&findContext);
@@ -10020,82 +14283,83 @@ inline std::vector<std::string> TreeNode::getTags() const
     return tags;
 }
 
-inline Data TreeNode::getRecord() const
+inline void Tree::setDefaultNode(const TreeNode& node) const
 {
-    mdsdsc_xd_t xd = MDSDSC_XD_INITIALIZER;
-    int status = _TreeGetRecord(getDBID(), _nid, &xd);
+    int status = _TreeSetDefaultNid(getDBID(), node.getNID());
     if (IS_NOT_OK(status)) {
         throwException(status);
     }
-
-    return Data(std::move(xd), getTree());
 }
 
-inline void TreeNode::putRecord(const Data& data) const
+inline TreeNode Tree::getDefaultNode() const
 {
-    mdsdsc_t * dsc = data.getDescriptor();
-    int status = _TreePutRecord(getDBID(), _nid, dsc, 0);
+    int nid;
+    int status = _TreeGetDefaultNid(getDBID(), &nid);
     if (IS_NOT_OK(status)) {
         throwException(status);
     }
+
+    return TreeNode(getTree(), nid);
 }
 
-inline std::vector<TreeNode> TreeNode::getMembersAndChildren(bool sortedNIDs /*= true*/) const
+template <typename ResultType /*= Data*/, typename ...ArgTypes>
+ResultType Tree::compileData(const std::string& expression, const ArgTypes&... args) const
 {
-    int status;
-
-    uint32_t numberOfMembers = 0;
-    uint32_t numberOfChildren = 0;
-    nci_itm countItemList[] = {
-        { sizeof(numberOfMembers), NciNUMBER_OF_MEMBERS, &numberOfMembers, nullptr },
-        { sizeof(numberOfChildren), NciNUMBER_OF_CHILDREN, &numberOfChildren, nullptr },
-        { 0, NciEND_OF_LIST, nullptr, nullptr },
-    };
+    DataView argExp(expression);
+    std::vector<DataView> argList = { DataView(args)... };
 
-    status = _TreeGetNci(getDBID(), _nid, countItemList);
-    if (IS_NOT_OK(status)) {
-        throwException(status);
+    std::vector<mdsdsc_t *> dscList = { argExp.getDescriptor() };
+    for (const auto& arg : argList) {
+        dscList.push_back(arg.getDescriptor());
     }
 
-    std::vector<int> nids(numberOfMembers + numberOfChildren);
-
-    int16_t sizeInBytesMembers = sizeof(int) * numberOfMembers;
-    int16_t sizeInBytesChildren = sizeof(int) * numberOfChildren;
-    nci_itm itemList[] = {
-        { sizeInBytesMembers, NciMEMBER_NIDS, (void *)&nids[0], nullptr },
-        { sizeInBytesChildren, NciCHILDREN_NIDS, (void *)&nids[numberOfMembers], nullptr },
-        { 0, NciEND_OF_LIST, nullptr, nullptr },
-    };
+    TraceScope span(TraceEvent::TDI, expression);
 
-    status = _TreeGetNci(getDBID(), _nid, itemList);
+    mdsdsc_xd_t out = MDSDSC_XD_INITIALIZER;
+    int status = TdiIntrinsic(OPC_COMPILE, dscList.size(), dscList.data(), &out);
+    span.setStatus(status);
+    span.addBytes(out.l_length);
     if (IS_NOT_OK(status)) {
         throwException(status);
     }
 
-    if (sortedNIDs) {
-        std::sort(nids.begin(), nids.end());
+    return Data(std::move(out), getTree()).releaseAndConvert<ResultType>();
+}
+
+template <typename ResultType /*= Data*/, typename ...ArgTypes>
+ResultType Tree::executeData(const std::string& expression, const ArgTypes&... args) const
+{
+    DataView argExp(expression);
+    std::vector<DataView> argList = { DataView(args)... };
+
+    std::vector<mdsdsc_t *> dscList = { argExp.getDescriptor() };
+    for (const auto& arg : argList) {
+        dscList.push_back(arg.getDescriptor());
     }
 
-    std::vector<TreeNode> nodes;
-    nodes.reserve(nids.size());
+    TraceScope span(TraceEvent::TDI, expression);
 
-    for (const int& nid : nids) {
-        nodes.emplace_back(_tree, nid);
+    mdsdsc_xd_t out = MDSDSC_XD_INITIALIZER;
+    int status = _TdiIntrinsic(getContext(), OPC_EXECUTE, dscList.size(), dscList.data(), &out);
+    span.setStatus(status);
+    span.addBytes(out.l_length);
+    if (IS_NOT_OK(status)) {
+        throwException(status);
     }
 
-    return nodes;
+    return Data(std::move(out), getTree()).releaseAndConvert<ResultType>();
 }
 
 template <typename ResultType>
-inline ResultType TreeNode::_getNCI(nci_t code) const
+inline ResultType Tree::_getDBI(int16_t code) const
 {
     ResultType value = {};
-    nci_itm itm_lst[] = {
+    dbi_itm itm_lst[] = {
         { sizeof(value), code, &value, nullptr },
-        { 0, NciEND_OF_LIST, nullptr, nullptr },
+        { 0, DbiEND_OF_LIST, nullptr, nullptr },
     };
 
-    int status = _TreeGetNci(_tree->getDBID(), _nid, itm_lst);
+    int status = _TreeGetDbi(getDBID(), itm_lst);
     if (IS_NOT_OK(status)) {
         throwException(status);
     }
@@ -10103,18 +14367,18 @@ inline ResultType TreeNode::_getNCI(nci_t code) const
     return value;
 }
 
-inline std::string TreeNode::_getStringNCI(nci_t code, int16_t size) const
+inline std::string Tree::_getStringDBI(int16_t code, int16_t size) const
 {
     std::string buffer;
     buffer.resize(size);
 
     int retlen = 0;
-    nci_itm itemList[] = {
+    dbi_itm itemList[] = {
         { size, code, (void *)buffer.data(), &retlen },
-        { 0, NciEND_OF_LIST, nullptr, nullptr },
+        { 0, DbiEND_OF_LIST, nullptr, nullptr },
     };
 
-    int status = _TreeGetNci(getDBID(), _nid, itemList);
+    int status = _TreeGetDbi(getDBID(), itemList);
     if (IS_NOT_OK(status)) {
         throwException(status);
     }
@@ -10124,805 +14388,1125 @@ inline std::string TreeNode::_getStringNCI(nci_t code, int16_t size) const
     return buffer;
 }
 
-inline std::vector<int> TreeNode::_getNIDArrayNCI(nci_t code, nci_t codeForNumberOf) const
+inline void Tree::_setDBI(int16_t code, int value) const
 {
-    uint32_t numberOfNodes = _getNCI<uint32_t>(codeForNumberOf);
-    std::vector<int> nids(numberOfNodes);
-
-    int16_t sizeInBytes = sizeof(int) * numberOfNodes;
-    nci_itm itemList[] = {
-        { sizeInBytes, code, (void *)nids.data(), nullptr },
-        { 0, NciEND_OF_LIST, nullptr, nullptr },
+    int retlen = 0;
+    dbi_itm itemList[] = {
+        { sizeof(value), code, &value },
+        { 0, DbiEND_OF_LIST, nullptr, nullptr },
     };
 
-    int status = _TreeGetNci(getDBID(), _nid, itemList);
+    int status = _TreeSetDbi(getDBID(), itemList);
     if (IS_NOT_OK(status)) {
         throwException(status);
     }
+}
 
-    return nids;
+inline void Device::addParts(std::vector<DevicePart>&& parts) const
+{
+    auto defaultNode = getTree()->getDefaultNode();
+    getTree()->setDefaultNode(*this);
+
+    for (const auto& part : parts)
+    {
+        addNode(part.Path, part.Usage);
+    }
+
+    for (const auto& part : parts) {
+        auto node = getNode(part.Path);
+
+        if (!part.ValueExpression.empty()) {
+            node.putRecord(getTree()->compileData(part.ValueExpression));
+        }
+        else if (part.Value) {
+            node.putRecord(*part.Value);
+        }
+
+        node.setFlagsOn(part.Flags);
+
+        if (part.Callback) {
+            part.Callback(node);
+        }
+    }
+
+    for (auto& part : parts)
+    {
+        if (part.Value) {
+            delete part.Value;
+            part.Value = nullptr;
+        }
+
+        for (auto& it : part.XNCI) {
+            if (it.second) {
+                delete it.second;
+                it.second = nullptr;
+            }
+        }
+    }
+
+    getTree()->setDefaultNode(defaultNode);
+}
+
+inline void Connection::connect(const std::string& hostspec)
+{
+    if (hostspec == "local") {
+        _local = true;
+    }
+    else {
+        // TODO: SetCompressionLevel
+        _id = ConnectToMds(const_cast<char *>(hostspec.c_str()));
+        if (_id == InvalidConnectionID) {
+            // TODO:
+            throw MDSplusException();
+        }
+    }
+
+    _hostspec = hostspec;
+}
+
+inline void Connection::disconnect()
+{
+    _local = false;
+
+    if (_id != InvalidConnectionID) {
+        DisconnectFromMds(_id);
+        _id = InvalidConnectionID;
+    }
 }
 
-inline std::vector<TreeNode> TreeNode::_getTreeNodeArrayNCI(nci_t code, nci_t codeForNumberOf) const
-{
-    const auto& nids = _getNIDArrayNCI(code, codeForNumberOf);
+inline Data Connection::_get(const std::string& expression, std::vector<DataView>&& argList) const
+{
+    int status;
+    int argIndex = 0;
+    uint8_t numberOfArgs = argList.size() + 1;
+
+    TraceScope span(TraceEvent::Network);
+    if (span) {
+        span.setName(_hostspec + " " + expression);
+    }
+
+    status = SendArg(
+        _id,
+        argIndex,
+        DTYPE_T,
+        numberOfArgs,
+        expression.size(),
+        0,
+        nullptr,
+        const_cast<char *>(expression.data())
+    );
+    if (IS_NOT_OK(status)) {
+        span.setStatus(status);
+        throwException(status);
+    }
+
+    span.addBytes(expression.size());
+    ++argIndex;
+
+    for (auto& arg : argList) {
+        status = MDSplusERROR;
+
+        mdsdsc_t * dscArg = arg.getDescriptor();
+
+        if (dscArg->class_ == CLASS_S) {
+            mdsdsc_s_t * scalar = reinterpret_cast<mdsdsc_s_t *>(dscArg);
+            status = SendArg(
+                _id,
+                argIndex,
+                scalar->dtype,
+                numberOfArgs,
+                scalar->length,
+                0,
+                nullptr,
+                scalar->pointer
+            );
+        }
+        else if (dscArg->class_ == CLASS_A) {
+            array_coeff * array = reinterpret_cast<array_coeff *>(dscArg);
+            status = SendArg(
+                _id,
+                argIndex,
+                array->dtype,
+                numberOfArgs,
+                array->length,
+                array->dimct,
+                reinterpret_cast<int *>(array->m),
+                array->pointer
+            );
+        }
+
+        // TODO: Throw exception for unsupported types
 
-    std::vector<TreeNode> nodes;
-    nodes.reserve(nids.size());
+        if (IS_NOT_OK(status)) {
+            span.setStatus(status);
+            throwException(status);
+        }
 
-    for (const int& nid : nids) {
-        nodes.emplace_back(_tree, nid);
+        span.addBytes(Trace::GetSize(dscArg));
+        ++argIndex;
     }
 
-    return nodes;
-}
+    // Switch to temporary variables and building a descriptor :(
 
-template <typename ValueType>
-void TreeNode::putRow(int segmentLength, const ValueType& value, int64_t timestamp)
-{
-    DataView argValue(value);
+    array_coeff * response = (array_coeff *)calloc(1, sizeof(array_coeff));
+    mdsdsc_xd_t dscResponse = {
+        .length = 0,
+        .dtype = DTYPE_DSC,
+        .class_ = CLASS_XD,
+        .pointer = (mdsdsc_t *)response,
+        .l_length = sizeof(array_coeff),
+    };
 
-    int status = _TreePutRow(
-        getDBID(),
-        getNID(),
-        segmentLength,
-        &timestamp,
-        (mdsdsc_a_t *)argValue.getDescriptor()
+    // numbytes is an int, writing it into response->length would overwrite dtype and class_
+    int numberOfBytes = 0;
+    void * message = nullptr;
+    status = GetAnswerInfoTO(
+        _id,
+        reinterpret_cast<char *>(&response->dtype),
+        reinterpret_cast<short *>(&response->length),
+        reinterpret_cast<char *>(&response->dimct),
+        reinterpret_cast<int *>(response->m),
+        &numberOfBytes,
+        reinterpret_cast<void **>(&response->pointer),
+        &message,
+        -1
     );
+    span.setStatus(status);
+    span.addBytes(numberOfBytes);
     if (IS_NOT_OK(status)) {
+        if (response->dtype == DTYPE_T && response->pointer) {
+            // The server's error text, only kept when tracing
+            span.setMessage(std::string_view(response->pointer, numberOfBytes));
+        }
+
         throwException(status);
     }
-}
 
-template <typename ValueArrayType>
-void TreeNode::putSegment(const ValueArrayType& values, int index /*= -1*/)
-{
-    DataView argValues(values);
-
-    int status = _TreePutSegment(
-        getDBID(),
-        getNID(),
-        index,
-        (mdsdsc_a_t *)argValues.getDescriptor()
-    );
-    if (IS_NOT_OK(status)) {
-        throwException(status);
+    if (response->dimct == 0) {
+        response->class_ = CLASS_S;
     }
-}
+    else {
+        response->class_ = CLASS_A;
 
-template <typename ValueArrayType>
-void TreeNode::putTimestampedSegment(int64_t * timestamps, const ValueArrayType& values)
-{
-    DataView argValues(values);
+        // Calculate arsize
+        arsize_t size = 1;
+        for (int i = 0; i < response->dimct; ++i) {
+            size *= response->m[i];
+        }
+        response->arsize = size * response->length;
+    }
 
-    int status = _TreePutTimestampedSegment(
-        getDBID(),
-        getNID(),
-        timestamps,
-        (mdsdsc_a_t *)argValues.getDescriptor()
-    );
-    if (IS_NOT_OK(status)) {
-        throwException(status);
+    switch (response->dtype) {
+    case DTYPE_F:
+        response->dtype = DTYPE_FLOAT;
+        break;
+    case DTYPE_D:
+        response->dtype = DTYPE_DOUBLE;
+        break;
+    case DTYPE_FC:
+        response->dtype = DTYPE_FLOAT_COMPLEX;
+        break;
+    case DTYPE_DC:
+        response->dtype = DTYPE_DOUBLE_COMPLEX;
+        break;
+    default: ;
     }
-}
 
-template <typename DataType /*= Data*/>
-[[nodiscard]]
-inline DataType TreeNode::getData() const {
-    return getRecord().releaseAndConvert<DataType>();
+    return Data(std::move(dscResponse));
 }
 
-template <typename DataType /*= Data*/, typename UnitsType /*= Data*/>
-[[nodiscard]]
-inline std::tuple<DataType, UnitsType> TreeNode::getDataWithUnits() const {
-    auto data = getRecord();
-    auto units = data.getUnits<UnitsType>();
-    return { data.releaseAndConvert<DataType>(), std::move(units) };
+template <typename DataType /*= Data*/, typename CallbackType>
+inline void ShotScanner::scan(CallbackType callback) const
+{
+    _scan<DataType>([&](size_t index, ShotData<DataType>&& result) {
+        (void)index;
+        callback(std::move(result));
+    });
 }
 
-inline int _getMaxRowsFilled(mdsdsc_a_t * dsc)
+template <typename DataType /*= Data*/>
+inline std::vector<ShotData<DataType>> ShotScanner::read() const
 {
-    // TODO: Investigate, taken from TreeNode:makeSegment() in tree.py
-    if (dsc->class_ == CLASS_R) {
-        return 1;
-    }
-    else if (dsc->class_ == CLASS_A) {
-        // TODO: Verify
-        if (dsc->aflags.coeff) {
-            array_coeff * dscCoeff = (array_coeff *)dsc;
-            return dscCoeff->m[dscCoeff->dimct - 1];
-        }
-        else {
-            return (dsc->arsize / dsc->length);
-        }
-    }
+    // Each worker writes to its own slot, so no locking is needed
+    std::vector<ShotData<DataType>> results(_shots.size());
+    _scan<DataType>([&](size_t index, ShotData<DataType>&& result) {
+        results[index] = std::move(result);
+    });
 
-    return -1;
+    return results;
 }
 
-template <
-    typename StartIndexType,
-    typename EndIndexType,
-    typename DimensionType,
-    typename ValueArrayType
->
-void TreeNode::makeSegment(
-    const StartIndexType& startIndex,
-    const EndIndexType& endIndex,
-    const DimensionType& dimension,
-    const ValueArrayType& values,
-    int index /*= -1*/,
-    int rowsFilled /*= -1*/
-) const
+template <typename DataType, typename CallbackType>
+inline void ShotScanner::_scan(CallbackType callback) const
 {
-    DataView argStartIndex(startIndex);
-    DataView argEndIndex(endIndex);
-    DataView argDimension(dimension);
-    DataView argValues(values);
-
-    mdsdsc_a_t * dscValues = (mdsdsc_a_t *)argValues.getDescriptor();
-
-    // Hack?
-    if (dscValues->dtype == DTYPE_DSC) {
-        dscValues = (mdsdsc_a_t *)dscValues->pointer;
+    if (_shots.empty()) {
+        return;
     }
 
-    if (rowsFilled < 0) {
-        rowsFilled = _getMaxRowsFilled(dscValues);
+    size_t threadCount = _threadCount;
+    if (threadCount == 0) {
+        threadCount = std::max<size_t>(std::thread::hardware_concurrency(), 1);
     }
+    threadCount = std::min(threadCount, _shots.size());
 
-    int status = _TreeMakeSegment(
-        getDBID(),
-        getNID(),
-        argStartIndex.getDescriptor(),
-        argEndIndex.getDescriptor(),
-        argDimension.getDescriptor(),
-        dscValues,
-        index,
-        rowsFilled
-    );
-    if (IS_NOT_OK(status)) {
-        throwException(status);
-    }
-}
+    // NIDs are shared by every worker, and resolved by whichever opens a shot of a new model first
+    _ModelCache cache;
 
-template <
-    typename StartIndexType,
-    typename EndIndexType,
-    typename DimensionType,
-    typename ValueArrayType
->
-void TreeNode::makeSegmentResampled(
-    const StartIndexType& startIndex,
-    const EndIndexType& endIndex,
-    const DimensionType& dimension,
-    const ValueArrayType& values,
-    const TreeNode& resampleNode,
-    int resampleFactor,
-    int index /*= -1*/,
-    int rowsFilled /*= -1*/
-) const
-{
-    DataView argStartIndex(startIndex);
-    DataView argEndIndex(endIndex);
-    DataView argDimension(dimension);
-    DataView argValues(values);
+    std::atomic<size_t> nextIndex = 0;
+    std::atomic<bool> stop = false;
 
-    mdsdsc_a_t * dscValues = (mdsdsc_a_t *)argValues.getDescriptor();
-    if (rowsFilled < 0) {
-        rowsFilled = _getMaxRowsFilled(dscValues);
-    }
+    std::mutex errorMutex;
+    std::exception_ptr error;
 
-    int status = _TreeMakeSegmentResampled(
-        getDBID(),
-        getNID(),
-        argStartIndex.getDescriptor(),
-        argEndIndex.getDescriptor(),
-        argDimension.getDescriptor(),
-        dscValues,
-        index,
-        rowsFilled,
-        resampleNode.getNID(),
-        resampleFactor
-    );
-    if (IS_NOT_OK(status)) {
-        throwException(status);
-    }
-}
+    auto worker = [&]() {
+        try {
+            // Reopening the same Tree reuses its DBID instead of allocating a new one per shot
+            Tree tree;
+            tree.setTreePath(_path);
 
-// template <
-//     typename StartIndexType,
-//     typename EndIndexType,
-//     typename DimensionType,
-//     typename ValueArrayType
-// >
-// void TreeNode::makeSegmentMinMax(
-//     const StartIndexType& startIndex,
-//     const EndIndexType& endIndex,
-//     const DimensionType& dimension,
-//     const ValueArrayType& values,
-//     const TreeNode& resampleNode,
-//     int resampleFactor,
-//     int index /*= -1*/,
-//     int rowsFilled /*= -1*/
-// ) const
-// {
-//     Argument argStartIndex(startIndex);
-//     Argument argEndIndex(endIndex);
-//     Argument argDimension(dimension);
-//     Argument argValues(values);
-
-//     mdsdsc_a_t * dscValues = (mdsdsc_a_t *)argValues.getDescriptor();
-//     if (rowsFilled < 0) {
-//         rowsFilled = _getMaxRowsFilled(dscValues);
-//     }
+            // Consecutive shots usually come from the same model, so check the last one first
+            std::shared_ptr<const _ResolvedNIDs> resolved;
 
-//     int status = _TreeMakeSegmentMinMax(
-//         getDBID(),
-//         getNID(),
-//         argStartIndex.getDescriptor(),
-//         argEndIndex.getDescriptor(),
-//         argDimension.getDescriptor(),
-//         dscValues,
-//         index,
-//         rowsFilled,
-//         resampleNode.getNID(),
-//         resampleFactor
-//     );
-//     if (IS_NOT_OK(status)) {
-//         throwException(status);
-//     }
-// }
+            while (!stop) {
+                size_t index = nextIndex++;
+                if (index >= _shots.size()) {
+                    break;
+                }
 
-template <typename ValueArrayType>
-void TreeNode::makeTimestampedSegment(
-    int64_t * timestamps,
-    const ValueArrayType& values,
-    int index /*= -1*/,
-    int rowsFilled /*= -1*/
-) const
-{
-    DataView argValues(values);
+                ShotData<DataType> result;
+                result.Shot = _shots[index];
 
-    mdsdsc_a_t * dscValues = (mdsdsc_a_t *)argValues.getDescriptor();
-    if (rowsFilled < 0) {
-        rowsFilled = _getMaxRowsFilled(dscValues);
-    }
+                try {
+                    tree.open(_treename, result.Shot, Mode::ReadOnly);
+                }
+                catch (const MDSplusException& e) {
+                    result.Status = e.getStatus();
+                }
 
-    int status = _TreeMakeTimestampedSegment(
-        getDBID(),
-        getNID(),
-        timestamps,
-        dscValues,
-        index,
-        rowsFilled
-    );
-    if (IS_NOT_OK(status)) {
-        throwException(status);
-    }
-}
+                if (result.isOK()) {
+                    resolved = _getNIDs(tree, resolved, cache);
+                    _readValues(tree, *resolved, result);
+                }
 
-template <typename ValueType>
-void TreeNode::setSegmentScale(const ValueType& value)
-{
-    DataView argValue(value);
-    int status = _TreeSetSegmentScale(getDBID(), getNID(), argValue.getDescriptor());
-    if (IS_NOT_OK(status)) {
-        throwException(status);
+                callback(index, std::move(result));
+            }
+        }
+        catch (...) {
+            std::lock_guard<std::mutex> lock(errorMutex);
+            if (!error) {
+                error = std::current_exception();
+            }
+            stop = true;
+        }
+    };
+
+    if (threadCount == 1) {
+        worker();
     }
-}
+    else {
+        std::vector<std::thread> threads;
+        threads.reserve(threadCount);
+        for (size_t i = 0; i < threadCount; ++i) {
+            threads.emplace_back(worker);
+        }
 
-template <typename ResultType>
-ResultType TreeNode::getSegmentScale()
-{
-    mdsdsc_xd_t out = MDSDSC_XD_INITIALIZER;
-    int status = _TreeGetSegmentScale(getDBID(), getNID(), &out);
-    if (IS_NOT_OK(status)) {
-        throwException(status);
+        for (auto& thread : threads) {
+            thread.join();
+        }
     }
-    return Data(std::move(out), getTree()).releaseAndConvert<ResultType>();
-}
 
-inline std::vector<int> Tree::getShotDB(
-    const std::string& treename,
-    const std::string& path /*= ""*/,
-    int lower /*= INT_MIN */,
-    int higher /*= INT_MAX */
-) {
-    // TODO:
-    return {};
+    if (error) {
+        std::rethrow_exception(error);
+    }
 }
 
-inline std::string Tree::getFileName(const std::string& subtree /*= {}*/)
+inline std::shared_ptr<const ShotScanner::_ResolvedNIDs> ShotScanner::_getNIDs(
+    const Tree& tree,
+    const std::shared_ptr<const _ResolvedNIDs>& current,
+    _ModelCache& cache
+) const
 {
-    // Even with the DBID we may want to ask about subtrees, so we still pass _treename
-    mdsdsc_xd_t out = MDSDSC_XD_INITIALIZER;
-    const char * treename = (subtree.empty() ? nullptr : subtree.c_str());
-    int status = _TreeFileName(getDBID(), const_cast<char *>(treename), getShot(), &out);
-    if (IS_NOT_OK(status)) {
-        throwException(status);
+    if (current && _matchesModel(tree, *current)) {
+        return current;
     }
 
-    return Data(std::move(out)).releaseAndConvert<String>().getString();
+    {
+        std::lock_guard<std::mutex> lock(cache.Mutex);
+        for (const auto& model : cache.Models) {
+            if (model != current && _matchesModel(tree, *model)) {
+                return model;
+            }
+        }
+    }
+
+    // Resolve outside of the lock, two workers racing on the same new model only costs a duplicate entry
+    auto resolved = _resolveNIDs(tree);
+
+    std::lock_guard<std::mutex> lock(cache.Mutex);
+    cache.Models.push_back(resolved);
+    return resolved;
 }
 
-inline Mode from_string(const std::string& mode)
+inline std::shared_ptr<const ShotScanner::_ResolvedNIDs> ShotScanner::_resolveNIDs(const Tree& tree) const
 {
-    if (mode == "normal" || mode == "NORMAL") {
-        return Mode::Normal;
+    auto resolved = std::make_shared<_ResolvedNIDs>();
+    resolved->NIDs.resize(_paths.size(), -1);
+    resolved->Status.resize(_paths.size(), TreeNNF);
+
+    for (size_t i = 0; i < _paths.size(); ++i) {
+        try {
+            resolved->NIDs[i] = tree.getNode(_paths[i]).getNID();
+            resolved->Status[i] = MDSplusSUCCESS;
+        }
+        catch (const MDSplusException& e) {
+            resolved->Status[i] = e.getStatus();
+        }
     }
-    else if (mode == "edit" || mode == "EDIT") {
-        return Mode::Edit;
+
+    // Probe the first and last paths that resolved, since nodes added to a model shift the NIDs
+    // of everything after them, and the first path that didn't, in case it was added
+    auto isOK = [&](size_t i) { return IS_OK(resolved->Status[i]); };
+    for (size_t i = 0; i < _paths.size(); ++i) {
+        if (isOK(i)) {
+            resolved->Probes.push_back(i);
+            break;
+        }
     }
-    else if (mode == "new" || mode == "NEW") {
-        return Mode::Edit;
+
+    for (size_t i = _paths.size(); i > 0; --i) {
+        if (isOK(i - 1)) {
+            if (resolved->Probes.empty() || resolved->Probes.front() != i - 1) {
+                resolved->Probes.push_back(i - 1);
+            }
+            break;
+        }
     }
 
-    return Mode::ReadOnly;
+    for (size_t i = 0; i < _paths.size(); ++i) {
+        if (!isOK(i)) {
+            resolved->Probes.push_back(i);
+            break;
+        }
+    }
+
+    return resolved;
 }
 
-inline void Tree::open(const std::string& treename, int shot, Mode mode /*= Mode::Normal*/)
+inline bool ShotScanner::_matchesModel(const Tree& tree, const _ResolvedNIDs& resolved) const
 {
-    int status;
+    for (size_t i : resolved.Probes) {
+        int nid = -1;
+        int status = MDSplusSUCCESS;
+        try {
+            nid = tree.getNode(_paths[i]).getNID();
+        }
+        catch (const MDSplusException& e) {
+            status = e.getStatus();
+        }
 
-    if (mode == Mode::View) {
-        return;
+        if (status != resolved.Status[i] || (IS_OK(status) && nid != resolved.NIDs[i])) {
+            return false;
+        }
     }
 
-    if (_dbid != nullptr) {
-        close();
-    }
+    return true;
+}
 
-    _treename = treename;
-    _shot = shot;
-    _mode = mode;
+template <typename DataType>
+inline void ShotScanner::_readValues(Tree& tree, const _ResolvedNIDs& resolved, ShotData<DataType>& result) const
+{
+    result.Values.reserve(resolved.NIDs.size());
+    result.ValueStatus.reserve(resolved.NIDs.size());
 
-    std::string env_name;
-    const char * old_path = nullptr;
-    if (!_path.empty()) {
-        std::string lower(_treename);
-        for (auto& c : lower) {
-            c = ::tolower(c);
+    for (size_t i = 0; i < resolved.NIDs.size(); ++i) {
+        if (IS_NOT_OK(resolved.Status[i])) {
+            result.Values.emplace_back();
+            result.ValueStatus.push_back(resolved.Status[i]);
+            continue;
         }
 
-        std::string env_name = lower + "_path";
+        try {
+            DataType value = TreeNode(&tree, resolved.NIDs[i]).getData<DataType>();
 
-        old_path = ::getenv(env_name.c_str());
-        ::setenv(env_name.c_str(), _path.c_str(), true);
+            // The worker's Tree is reopened for the next shot, so don't keep a reference to it
+            value.setTree(nullptr);
+
+            result.Values.push_back(std::move(value));
+            result.ValueStatus.push_back(MDSplusSUCCESS);
+        }
+        catch (const MDSplusException& e) {
+            result.Values.emplace_back();
+            result.ValueStatus.push_back(e.getStatus());
+        }
     }
+}
 
-    printf("%d\n", _shot);
+inline TreeCache::Handle TreeCache::open(const std::string& treename, int shot, const std::string& path /*= {}*/)
+{
+    if (shot == 0) {
+        return std::make_shared<const Tree>(treename, shot, Mode::ReadOnly, path);
+    }
 
-    switch (_mode) {
-    case Mode::Normal:
-        status = _TreeOpen(&_dbid, _treename.c_str(), _shot, 0);
-        break;
-    case Mode::ReadOnly:
-        status = _TreeOpen(&_dbid, _treename.c_str(), _shot, 1);
-        break;
-    case Mode::Edit:
-        status = _TreeOpenEdit(&_dbid, _treename.c_str(), _shot);
-        break;
-    case Mode::New:
-        status = _TreeOpenNew(&_dbid, _treename.c_str(), _shot);
-        break;
-    default: ;
+    _Key key = _makeKey(treename, shot, path);
+
+    std::promise<Handle> promise;
+
+    std::unique_lock<std::mutex> lock(_mutex);
+
+    auto it = _entries.find(key);
+    if (it != _entries.end()) {
+        ++_hitCount;
+        _recent.splice(_recent.begin(), _recent, it->second.Recent);
+        auto future = it->second.Future;
+
+        // Wait outside of the lock, in case another thread is still opening it
+        lock.unlock();
+        return future.get();
     }
 
-    if (!_path.empty()) {
-        if (old_path) {
-            ::setenv(env_name.c_str(), old_path, true);
-        }
-        else {
-            ::unsetenv(env_name.c_str());
-        }
+    ++_missCount;
+    _recent.push_front(key);
+    _entries.emplace(key, _Entry{ promise.get_future().share(), _recent.begin() });
+
+    lock.unlock();
+
+    Handle tree;
+    try {
+        tree = std::make_shared<const Tree>(treename, shot, Mode::ReadOnly, path);
     }
+    catch (...) {
+        lock.lock();
+        it = _entries.find(key);
+        if (it != _entries.end()) {
+            _recent.erase(it->second.Recent);
+            _entries.erase(it);
+        }
+        lock.unlock();
 
-    if (IS_NOT_OK(status)) {
-        throwException(status);
+        // Anyone waiting on this open gets the same exception
+        promise.set_exception(std::current_exception());
+        throw;
     }
 
-    // Initialize TreeNode parent class to \\TOP
-    _tree = this;
-    _nid = 0;
+    promise.set_value(tree);
+
+    lock.lock();
+    _evict();
+
+    return tree;
 }
 
-inline void Tree::close()
+inline void TreeCache::erase(const std::string& treename, int shot, const std::string& path /*= {}*/)
 {
-    int status = _TreeClose(&_dbid, nullptr, 0);
-    if (IS_NOT_OK(status) && status != TreeNOT_OPEN) {
-        throwException(status);
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    auto it = _entries.find(_makeKey(treename, shot, path));
+    if (it != _entries.end()) {
+        _recent.erase(it->second.Recent);
+        _entries.erase(it);
     }
+}
 
-    // Cleanup TreeNode
-    _tree = nullptr;
-    _nid = -1;
+inline void TreeCache::clear()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _recent.clear();
+    _entries.clear();
 }
 
-inline void Tree::write()
+inline size_t TreeCache::getMaxOpen() const
 {
-    int status = _TreeWriteTree(&_dbid, nullptr, 0);
-    if (IS_NOT_OK(status)) {
-        throwException(status);
-    }
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _maxOpen;
 }
 
-inline void Tree::createPulse(int shot) const
+inline void TreeCache::setMaxOpen(size_t maxOpen)
 {
-    // TODO: copy_only_this ?
+    std::lock_guard<std::mutex> lock(_mutex);
+    _maxOpen = maxOpen;
+    _evict();
+}
 
-    int nid = getNID();
-    int status = _TreeCreatePulseFile(getDBID(), shot, 0, &nid);
-    if (IS_NOT_OK(status)) {
-        throwException(status);
-    }
+inline size_t TreeCache::getOpenCount() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _entries.size();
 }
 
-// inline std::vector<TreeNode> Tree::findNodeWild(const std::string& wildcard) const
-// {
-//     std::vector<TreeNode> nodes;
+inline size_t TreeCache::getHitCount() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _hitCount;
+}
 
-//     int usageMask = 0xFFFF;
+inline size_t TreeCache::getMissCount() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _missCount;
+}
 
-//     void * findContext = nullptr;
-//     while (true)
-//     {
-//         int outnid;
-//         int status = _TreeFindNodeWild(
-//             getDBID(),
-//             wildcard.c_str(),
-//             &outnid,
-//             &findContext,
-//             usageMask
-//         );
-//         if (status == TreeNMN || status == TreeNNF) {
-//             break;
-//         }
-//         else if (IS_NOT_OK(status)) {
-//             throwException(status);
-//         }
+inline TreeCache::_Key TreeCache::_makeKey(const std::string& treename, int shot, const std::string& path)
+{
+    // Tree names are case insensitive
+    std::string lowerTreename(treename);
+    for (auto& c : lowerTreename) {
+        c = ::tolower(c);
+    }
 
-//         nodes.push_back(TreeNode(getTree(), outnid));
-//     }
+    return _Key(std::move(lowerTreename), shot, path);
+}
 
-//     _TreeFindNodeEnd(getDBID(), &findContext);
+inline void TreeCache::_evict()
+{
+    auto isReady = [](const _Entry& entry) {
+        return (entry.Future.wait_for(std::chrono::seconds(0)) == std::future_status::ready);
+    };
 
-//     return nodes;
-// }
+    while (_entries.size() > _maxOpen) {
+        // Prefer the least recently used shot that nothing is using, so it is actually closed
+        auto victim = _entries.end();
+        auto fallback = _entries.end();
 
-inline std::vector<std::string> Tree::findTagWild(const std::string& wildcard) const
-{
-    std::vector<std::string> tags;
+        for (auto recent = _recent.rbegin(); recent != _recent.rend(); ++recent) {
+            auto it = _entries.find(*recent);
+            if (!isReady(it->second)) {
+                // Still being opened
+                continue;
+            }
 
-    int outnid;
-    void * findContext = nullptr;
-    while (true)
-    {
-        char * tag = _TreeFindTagWild(getDBID(), const_cast<char *>(wildcard.c_str()), &outnid, &findContext);
-        if (!tag) {
+            if (fallback == _entries.end()) {
+                fallback = it;
+            }
+
+            if (it->second.Future.get().use_count() == 1) {
+                victim = it;
+                break;
+            }
+        }
+
+        if (victim == _entries.end()) {
+            victim = fallback;
+        }
+
+        if (victim == _entries.end()) {
             break;
         }
 
-        tags.push_back(tag);
+        _recent.erase(victim->second.Recent);
+        _entries.erase(victim);
     }
+}
 
-    TreeFindTagEnd(&findContext);
+template <typename ValueType>
+inline SegmentWriter<ValueType>::SegmentWriter(
+    const TreeNode& node,
+    uint32_t segmentLength,
+    size_t bufferSegments /*= 4*/,
+    const std::vector<uint32_t>& rowDims /*= {}*/
+)
+    : _node(node)
+    , _timestamped(true)
+    , _segmentLength(segmentLength)
+    , _rowDims(rowDims)
+{
+    _initialize(bufferSegments);
+}
 
-    return tags;
+template <typename ValueType>
+inline SegmentWriter<ValueType>::SegmentWriter(
+    const TreeNode& node,
+    double start,
+    double delta,
+    uint32_t segmentLength,
+    size_t bufferSegments /*= 4*/,
+    const std::vector<uint32_t>& rowDims /*= {}*/
+)
+    : _node(node)
+    , _timestamped(false)
+    , _start(start)
+    , _delta(delta)
+    , _segmentLength(segmentLength)
+    , _rowDims(rowDims)
+{
+    _initialize(bufferSegments);
 }
 
-inline void Tree::setDefaultNode(const TreeNode& node) const
+template <typename ValueType>
+inline SegmentWriter<ValueType>::~SegmentWriter()
 {
-    int status = _TreeSetDefaultNid(getDBID(), node.getNID());
-    if (IS_NOT_OK(status)) {
-        throwException(status);
+    try {
+        if (_rows > 0) {
+            std::unique_lock<std::mutex> lock(_mutex);
+
+            // There is always room for the current slot, it was reserved by putRow()
+            _submit();
+        }
+    }
+    catch (...) { }
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stop = true;
+    }
+    _ready.notify_one();
+
+    if (_thread.joinable()) {
+        _thread.join();
     }
 }
 
-inline TreeNode Tree::getDefaultNode() const
+template <typename ValueType>
+inline void SegmentWriter<ValueType>::_initialize(size_t bufferSegments)
 {
-    int nid;
-    int status = _TreeGetDefaultNid(getDBID(), &nid);
-    if (IS_NOT_OK(status)) {
-        throwException(status);
+    if (_segmentLength == 0) {
+        throwException(TreeFAILURE);
     }
 
-    return TreeNode(getTree(), nid);
+    for (uint32_t dim : _rowDims) {
+        _rowSize *= dim;
+    }
+
+    // One slot is filled by putRow() while the others are written
+    _slots.resize(std::max<size_t>(bufferSegments, 2));
+    for (auto& slot : _slots) {
+        slot.Values.resize(_rowSize * _segmentLength);
+        if (_timestamped) {
+            slot.Timestamps.resize(_segmentLength);
+        }
+    }
+
+    _thread = std::thread(&SegmentWriter::_run, this);
 }
 
-template <typename ResultType /*= Data*/, typename ...ArgTypes>
-ResultType Tree::compileData(const std::string& expression, const ArgTypes&... args) const
+template <typename ValueType>
+bool SegmentWriter<ValueType>::putRow(const ValueType * row, int64_t timestamp /*= 0*/)
 {
-    DataView argExp(expression);
-    std::vector<DataView> argList = { DataView(args)... };
+    _Slot * slot = &_slots[_writeSlot];
 
-    std::vector<mdsdsc_t *> dscList = { argExp.getDescriptor() };
-    for (const auto& arg : argList) {
-        dscList.push_back(arg.getDescriptor());
+    // Only take the lock at segment boundaries, to make sure the slot isn't still being written
+    if (_rows == 0) {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _rethrow();
+
+        if (_pending == _slots.size()) {
+            ++_backpressureCount;
+
+            if (_overflowPolicy == OverflowPolicy::Drop) {
+                ++_droppedRowCount;
+
+                // Keep the timebase of a fixed rate signal in step with the dropped rows
+                ++_nextRow;
+                return false;
+            }
+
+            _written.wait(lock, [&]() { return (_pending < _slots.size() || _error); });
+            _rethrow();
+        }
+
+        slot->FirstRow = _nextRow;
     }
 
-    mdsdsc_xd_t out = MDSDSC_XD_INITIALIZER;
-    int status = TdiIntrinsic(OPC_COMPILE, dscList.size(), dscList.data(), &out);
-    if (IS_NOT_OK(status)) {
-        throwException(status);
+    std::copy(row, row + _rowSize, slot->Values.data() + _rows * _rowSize);
+    if (_timestamped) {
+        slot->Timestamps[_rows] = timestamp;
     }
 
-    return Data(std::move(out), getTree()).releaseAndConvert<ResultType>();
+    ++_rows;
+    ++_nextRow;
+
+    if (_rows == _segmentLength) {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _submit();
+    }
+
+    return true;
 }
 
-template <typename ResultType /*= Data*/, typename ...ArgTypes>
-ResultType Tree::executeData(const std::string& expression, const ArgTypes&... args) const
+template <typename ValueType>
+void SegmentWriter<ValueType>::flush()
 {
-    DataView argExp(expression);
-    std::vector<DataView> argList = { DataView(args)... };
+    std::unique_lock<std::mutex> lock(_mutex);
+    _rethrow();
 
-    std::vector<mdsdsc_t *> dscList = { argExp.getDescriptor() };
-    for (const auto& arg : argList) {
-        dscList.push_back(arg.getDescriptor());
+    if (_rows > 0) {
+        _submit();
     }
 
-    mdsdsc_xd_t out = MDSDSC_XD_INITIALIZER;
-    int status = _TdiIntrinsic(getContext(), OPC_EXECUTE, dscList.size(), dscList.data(), &out);
-    if (IS_NOT_OK(status)) {
-        throwException(status);
-    }
+    _written.wait(lock, [&]() { return (_pending == 0 || _error); });
+    _rethrow();
+}
 
-    return Data(std::move(out), getTree()).releaseAndConvert<ResultType>();
+template <typename ValueType>
+size_t SegmentWriter<ValueType>::getPendingSegmentCount() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _pending;
 }
 
-template <typename ResultType>
-inline ResultType Tree::_getDBI(int16_t code) const
+template <typename ValueType>
+inline void SegmentWriter<ValueType>::_submit()
 {
-    ResultType value = {};
-    dbi_itm itm_lst[] = {
-        { sizeof(value), code, &value, nullptr },
-        { 0, DbiEND_OF_LIST, nullptr, nullptr },
-    };
+    _slots[_writeSlot].Rows = _rows;
+    _rows = 0;
+
+    ++_pending;
+    _writeSlot = (_writeSlot + 1) % _slots.size();
+    _ready.notify_one();
+}
+
+template <typename ValueType>
+void SegmentWriter<ValueType>::_run()
+{
+    std::unique_lock<std::mutex> lock(_mutex);
 
-    int status = _TreeGetDbi(getDBID(), itm_lst);
-    if (IS_NOT_OK(status)) {
-        throwException(status);
-    }
+    while (true) {
+        _ready.wait(lock, [&]() { return (_pending > 0 || _stop); });
+        if (_pending == 0) {
+            break;
+        }
 
-    return value;
+        _Slot& slot = _slots[_flushSlot];
+
+        lock.unlock();
+        try {
+            _write(slot);
+            ++_segmentCount;
+        }
+        catch (...) {
+            lock.lock();
+            if (!_error) {
+                _error = std::current_exception();
+            }
+            lock.unlock();
+        }
+        lock.lock();
+
+        _flushSlot = (_flushSlot + 1) % _slots.size();
+        --_pending;
+        _written.notify_all();
+    }
 }
 
-inline std::string Tree::_getStringDBI(int16_t code, int16_t size) const
+template <typename ValueType>
+void SegmentWriter<ValueType>::_write(const _Slot& slot)
 {
-    std::string buffer;
-    buffer.resize(size);
+    std::vector<uint32_t> dims = _rowDims;
+    dims.push_back(_segmentLength);
 
-    int retlen = 0;
-    dbi_itm itemList[] = {
-        { size, code, (void *)buffer.data(), &retlen },
-        { 0, DbiEND_OF_LIST, nullptr, nullptr },
-    };
+    // The whole segment is allocated, and the rows after slot.Rows are left empty
+    Data values = Data::FromArray(slot.Values, dims);
 
-    int status = _TreeGetDbi(getDBID(), itemList);
-    if (IS_NOT_OK(status)) {
-        throwException(status);
+    if (_timestamped) {
+        // makeTimestampedSegment() takes a non-const pointer, but doesn't modify the timestamps
+        _node.makeTimestampedSegment(const_cast<int64_t *>(slot.Timestamps.data()), values, -1, slot.Rows);
+    }
+    else {
+        double start = _start + _delta * slot.FirstRow;
+        double end = start + _delta * (slot.Rows - 1);
+        _node.makeSegment(start, end, Range(start, end, _delta), values, -1, slot.Rows);
     }
+}
 
-    buffer.resize(retlen);
+template <typename ValueType>
+inline void SegmentWriter<ValueType>::_rethrow()
+{
+    if (_error) {
+        std::exception_ptr error = _error;
+        _error = nullptr;
+        std::rethrow_exception(error);
+    }
+}
+
+template <typename ValueArrayType, typename DimensionType>
+SegmentReader<ValueArrayType, DimensionType>::SegmentReader(
+    const TreeNode& node,
+    size_t prefetch /*= 2*/,
+    int first /*= 0*/,
+    int last /*= -1*/
+)
+    : _node(node)
+    , _prefetch(prefetch)
+    , _first(first)
+    , _last(last)
+    , _next(first)
+{
+    if (_last < 0) {
+        _last = _node.getNumSegments() - 1;
+    }
+
+    if (_prefetch > 0 && _first <= _last) {
+        const Tree * tree = _node.getTree();
+        _tree = std::make_unique<Tree>(
+            tree->getTreeName(),
+            tree->getShot(),
+            Mode::ReadOnly,
+            tree->getTreePath()
+        );
 
-    return buffer;
+        _thread = std::thread(&SegmentReader::_run, this);
+    }
 }
 
-inline void Tree::_setDBI(int16_t code, int value) const
+template <typename ValueArrayType, typename DimensionType>
+SegmentReader<ValueArrayType, DimensionType>::~SegmentReader()
 {
-    int retlen = 0;
-    dbi_itm itemList[] = {
-        { sizeof(value), code, &value },
-        { 0, DbiEND_OF_LIST, nullptr, nullptr },
-    };
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stop = true;
+    }
+    _taken.notify_one();
 
-    int status = _TreeSetDbi(getDBID(), itemList);
-    if (IS_NOT_OK(status)) {
-        throwException(status);
+    if (_thread.joinable()) {
+        _thread.join();
     }
 }
 
-inline void Device::addParts(std::vector<DevicePart>&& parts) const
+template <typename ValueArrayType, typename DimensionType>
+bool SegmentReader<ValueArrayType, DimensionType>::next(SegmentData<ValueArrayType, DimensionType>& segment)
 {
-    auto defaultNode = getTree()->getDefaultNode();
-    getTree()->setDefaultNode(*this);
+    if (_next > _last) {
+        return false;
+    }
 
-    for (const auto& part : parts)
-    {
-        printf("Adding %s (%s)\n", part.Path.c_str(), to_string(part.Usage).c_str());
-        addNode(part.Path, part.Usage);
+    if (!_thread.joinable()) {
+        auto [values, dimension] = _node.getSegment<ValueArrayType, DimensionType>(_next);
+        segment.Index = _next++;
+        segment.Values = std::move(values);
+        segment.Dimension = std::move(dimension);
+        return true;
     }
 
-    for (const auto& part : parts) {
+    std::unique_lock<std::mutex> lock(_mutex);
+    if (_ready.empty() && !_error) {
+        ++_stallCount;
+        _read.wait(lock, [&]() { return (!_ready.empty() || _error); });
+    }
 
-        printf("Setting %s (%s)\n", part.Path.c_str(), to_string(part.Usage).c_str());
-        auto node = getNode(part.Path);
+    // Segments read before the error are still returned first
+    if (_ready.empty()) {
+        _next = _last + 1;
+        std::rethrow_exception(_error);
+    }
 
-        if (!part.ValueExpression.empty()) {
-            node.putRecord(getTree()->compileData(part.ValueExpression));
-        }
-        else if (part.Value) {
-            node.putRecord(*part.Value);
-        }
+    segment = std::move(_ready.front());
+    _ready.pop_front();
+    ++_next;
 
-        node.setFlagsOn(part.Flags);
+    lock.unlock();
+    _taken.notify_one();
 
-        if (part.Callback) {
-            part.Callback(node);
+    return true;
+}
+
+template <typename ValueArrayType, typename DimensionType>
+size_t SegmentReader<ValueArrayType, DimensionType>::getStallCount() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _stallCount;
+}
+
+template <typename ValueArrayType, typename DimensionType>
+void SegmentReader<ValueArrayType, DimensionType>::_run()
+{
+    // NIDs are the same in every Tree opened on the same shot
+    TreeNode node(_tree.get(), _node.getNID());
+
+    for (int index = _first; index <= _last; ++index) {
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _taken.wait(lock, [&]() { return (_ready.size() < _prefetch || _stop); });
+            if (_stop) {
+                return;
+            }
         }
-    }
 
-    for (auto& part : parts)
-    {
-        if (part.Value) {
-            delete part.Value;
-            part.Value = nullptr;
+        SegmentData<ValueArrayType, DimensionType> segment;
+        segment.Index = index;
+
+        try {
+            auto [values, dimension] = node.getSegment<ValueArrayType, DimensionType>(index);
+            segment.Values = std::move(values);
+            segment.Dimension = std::move(dimension);
+        }
+        catch (...) {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _error = std::current_exception();
+            _read.notify_one();
+            return;
         }
 
-        for (auto& it : part.XNCI) {
-            if (it.second) {
-                delete it.second;
-                it.second = nullptr;
-            }
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _ready.push_back(std::move(segment));
         }
+        _read.notify_one();
     }
-
-    getTree()->setDefaultNode(defaultNode);
 }
 
-inline void Connection::connect(const std::string& hostspec)
+template <typename ValueArrayType>
+SignalView<ValueArrayType>::SignalView(const Signal& signal)
 {
-    if (hostspec == "local") {
-        _local = true;
+    mdsdsc_r_t * dsc = signal.getRecordDescriptor();
+    if (!dsc) {
+        return;
+    }
+
+    auto getChild = [&](size_t index) -> mdsdsc_t * {
+        return _unwrapDescriptor(index < dsc->ndesc ? dsc->dscptrs[index] : nullptr);
+    };
+
+    // Values that are already an array can be copied out directly, anything else, e.g. an
+    // expression of $VALUE, needs the whole signal to evaluate. Either way the array is kept
+    // as it is, instead of being copied again into a std::vector.
+    mdsdsc_t * dscValue = getChild(0);
+    if (dscValue && dscValue->class_ == CLASS_A) {
+        _values = DataRef(dscValue, signal.getTree()).clone<ValueArrayType>();
     }
     else {
-        // TODO: SetCompressionLevel
-        _id = ConnectToMds(const_cast<char *>(hostspec.c_str()));
-        if (_id == InvalidConnectionID) {
-            // TODO:
-            throw MDSplusException();
-        }
+        _values = signal.getData<ValueArrayType>();
     }
 
-    _hostspec = hostspec;
-}
+    mdsdsc_t * dscDimension = getChild(2);
+    if (!dscDimension) {
+        return;
+    }
 
-inline void Connection::disconnect()
-{
-    _local = false;
+    // Uniform dimensions don't need to be evaluated
+    std::optional<Timebase> timebase = Timebase::FromDescriptor(dscDimension);
+    if (timebase) {
+        _timebase = std::move(*timebase);
+        return;
+    }
 
-    if (_id != InvalidConnectionID) {
-        DisconnectFromMds(_id);
-        _id = InvalidConnectionID;
+    if (dscDimension->class_ == CLASS_A) {
+        _timebase = Timebase(DataRef(dscDimension, signal.getTree()).clone<Float64Array>().getValues());
+        return;
     }
+
+    _timebase = Timebase(Data::Execute<Float64Array>("DIM_OF($)", signal).getValues());
 }
 
-inline Data Connection::_get(const std::string& expression, std::vector<DataView>&& argList) const
-{
-    int status;
-    int argIndex = 0;
-    uint8_t numberOfArgs = argList.size() + 1;
+template <
+    typename StartIndexType,
+    typename EndIndexType,
+    typename DimensionType,
+    typename ValueType
+>
+void MultiChannelWriter::makeSegment(
+    const StartIndexType& startIndex,
+    const EndIndexType& endIndex,
+    const DimensionType& dimension,
+    const ValueType * block,
+    uint32_t samples,
+    int rowsFilled /*= -1*/
+) {
+    // Built once, and copied by reference into each channel's makeSegment()
+    DataView argStartIndex(startIndex);
+    DataView argEndIndex(endIndex);
+    DataView argDimension(dimension);
 
-    status = SendArg(
-        _id,
-        argIndex,
-        DTYPE_T,
-        numberOfArgs,
-        expression.size(),
-        0,
-        nullptr,
-        const_cast<char *>(expression.data())
-    );
-    if (IS_NOT_OK(status)) {
-        throwException(status);
+    if (_compressionEnabled) {
+        std::vector<Data> compressed = _compressChannels(block, samples);
+
+        // The compressed records no longer have a shape to count the rows from
+        if (rowsFilled < 0) {
+            rowsFilled = int(samples);
+        }
+
+        for (size_t i = 0; i < _channels.size(); ++i) {
+            _channels[i].makeSegment(argStartIndex, argEndIndex, argDimension, compressed[i], -1, rowsFilled);
+        }
+        return;
     }
 
-    ++argIndex;
+    for (size_t i = 0; i < _channels.size(); ++i) {
+        DataView argValues(block + i * samples, samples);
+        _channels[i].makeSegment(argStartIndex, argEndIndex, argDimension, argValues, -1, rowsFilled);
+    }
+}
 
-    for (auto& arg : argList) {
-        status = MDSplusERROR;
+template <typename ValueType>
+void MultiChannelWriter::makeTimestampedSegment(
+    const int64_t * timestamps,
+    const ValueType * block,
+    uint32_t samples,
+    int rowsFilled /*= -1*/
+) {
+    for (size_t i = 0; i < _channels.size(); ++i) {
+        DataView argValues(block + i * samples, samples);
 
-        mdsdsc_t * dscArg = arg.getDescriptor();
+        // makeTimestampedSegment() takes a non-const pointer, but doesn't modify the timestamps
+        _channels[i].makeTimestampedSegment(const_cast<int64_t *>(timestamps), argValues, -1, rowsFilled);
+    }
+}
 
-        if (dscArg->class_ == CLASS_S) {
-            mdsdsc_s_t * scalar = reinterpret_cast<mdsdsc_s_t *>(dscArg);
-            status = SendArg(
-                _id,
-                argIndex,
-                scalar->dtype,
-                numberOfArgs,
-                scalar->length,
-                0,
-                nullptr,
-                scalar->pointer
-            );
-        }
-        else if (dscArg->class_ == CLASS_A) {
-            array_coeff * array = reinterpret_cast<array_coeff *>(dscArg);
-            status = SendArg(
-                _id,
-                argIndex,
-                array->dtype,
-                numberOfArgs,
-                array->length,
-                array->dimct,
-                reinterpret_cast<int *>(array->m),
-                array->pointer
-            );
-        }
+inline uint32_t MultiChannelWriter::_getSamples(size_t blockSize) const
+{
+    if (_channels.empty() || blockSize % _channels.size() != 0) {
+        throwException(TreeFAILURE);
+    }
 
-        // TODO: Throw exception for unsupported types
+    return uint32_t(blockSize / _channels.size());
+}
 
-        if (IS_NOT_OK(status)) {
-            throwException(status);
+template <typename ValueType>
+std::vector<Data> MultiChannelWriter::_compressChannels(const ValueType * block, uint32_t samples)
+{
+    // Reading the NCI uses the channels' Tree, so do it before starting any threads
+    std::vector<CompressionMethod> methods = _compressionMethods;
+    for (size_t i = 0; i < _channels.size(); ++i) {
+        if (methods[i] == CompressionMethod::Default) {
+            methods[i] = CompressionMethod(_channels[i].getCompressionMethod());
         }
-
-        ++argIndex;
     }
 
-    // Switch to temporary variables and building a descriptor :(
+    std::vector<Data> compressed(_channels.size());
+    std::vector<uint64_t> outputBytes(_channels.size());
 
-    array_coeff * response = (array_coeff *)calloc(1, sizeof(array_coeff));
-    mdsdsc_xd_t dscResponse = {
-        .length = 0,
-        .dtype = DTYPE_DSC,
-        .class_ = CLASS_XD,
-        .pointer = (mdsdsc_t *)response,
-        .l_length = sizeof(array_coeff),
-    };
+    std::mutex errorMutex;
+    std::exception_ptr error;
 
-    void * message = nullptr;
-    status = GetAnswerInfoTO(
-        _id,
-        reinterpret_cast<char *>(&response->dtype),
-        reinterpret_cast<short *>(&response->length),
-        reinterpret_cast<char *>(&response->dimct),
-        reinterpret_cast<int *>(response->m),
-        reinterpret_cast<int *>(&response->length),
-        reinterpret_cast<void **>(&response->pointer),
-        &message,
-        -1
-    );
-    if (IS_NOT_OK(status)) {
-        if (response->dtype == DTYPE_T) {
-            printf("%.*s\n", response->length, response->pointer);
-            fflush(stdout);
+    size_t threadCount = std::min(_threadCount, _channels.size());
+    auto worker = [&](size_t index) {
+        try {
+            for (size_t i = index; i < _channels.size(); i += threadCount) {
+                compressed[i] = compress(DataView(block + i * samples, samples), methods[i]);
+                outputBytes[i] = compressed[i].getTotalSize();
+            }
+        }
+        catch (...) {
+            std::lock_guard<std::mutex> lock(errorMutex);
+            if (!error) {
+                error = std::current_exception();
+            }
         }
+    };
 
-        throwException(status);
+    auto start = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < threadCount; ++i) {
+        threads.emplace_back(worker, i);
     }
 
-    if (response->dimct == 0) {
-        response->class_ = CLASS_S;
+    worker(0);
+
+    for (auto& thread : threads) {
+        thread.join();
     }
-    else {
-        response->class_ = CLASS_A;
 
-        // Calculate arsize
-        arsize_t size = 1;
-        for (int i = 0; i < response->dimct; ++i) {
-            size *= response->m[i];
-        }
-        response->arsize = size * response->length;
+    if (error) {
+        std::rethrow_exception(error);
     }
 
-    switch (response->dtype) {
-    case DTYPE_F:
-        response->dtype = DTYPE_FLOAT;
-        break;
-    case DTYPE_D:
-        response->dtype = DTYPE_DOUBLE;
-        break;
-    case DTYPE_FC:
-        response->dtype = DTYPE_FLOAT_COMPLEX;
-        break;
-    case DTYPE_DC:
-        response->dtype = DTYPE_DOUBLE_COMPLEX;
-        break;
-    default: ;
+    _compressionStats.Duration += std::chrono::steady_clock::now() - start;
+    _compressionStats.Segments += _channels.size();
+    _compressionStats.InputBytes += uint64_t(_channels.size()) * samples * sizeof(ValueType);
+    for (uint64_t bytes : outputBytes) {
+        _compressionStats.OutputBytes += bytes;
     }
 
-    return Data(std::move(dscResponse));
+    return compressed;
 }
 
 #ifdef MDSPLUS_IMPLEMENTATION
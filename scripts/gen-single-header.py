@@ -182,6 +182,7 @@ output_file.write('\n')
 
 includes.remove('optional')
 includes.remove('span')
+includes.remove('mdspan')
 
 for include in sorted(includes):
     if '.h' not in include:
@@ -198,6 +199,11 @@ output_file.write('    #include <span>\n')
 output_file.write('#endif\n')
 output_file.write('\n')
 
+output_file.write('#if __has_include(<mdspan>)\n')
+output_file.write('    #include <mdspan>\n')
+output_file.write('#endif\n')
+output_file.write('\n')
+
 ## C Includes
 
 output_file.write('extern "C" {\n')
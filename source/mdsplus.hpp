@@ -13,7 +13,13 @@ namespace mdsplus { }
 #include <mdsplusplus/Exceptions.hpp>
 
 #include <mdsplusplus/Version.hpp>
+#include <mdsplusplus/Trace.hpp>
+#include <mdsplusplus/Decimate.hpp>
+#include <mdsplusplus/Arena.hpp>
 #include <mdsplusplus/Data.hpp>
+#include <mdsplusplus/Timebase.hpp>
+#include <mdsplusplus/DataRef.hpp>
+#include <mdsplusplus/DataVisitor.hpp>
 #include <mdsplusplus/TreeNode.hpp>
 #include <mdsplusplus/Tree.hpp>
 #include <mdsplusplus/DataView.hpp>
@@ -24,8 +30,16 @@ namespace mdsplus { }
 #include <mdsplusplus/Record.hpp>
 #include <mdsplusplus/Connection.hpp>
 #include <mdsplusplus/Device.hpp>
+#include <mdsplusplus/ShotScanner.hpp>
+#include <mdsplusplus/TreeCache.hpp>
+#include <mdsplusplus/Compression.hpp>
+#include <mdsplusplus/SegmentWriter.hpp>
+#include <mdsplusplus/SegmentReader.hpp>
+#include <mdsplusplus/SignalView.hpp>
+#include <mdsplusplus/MultiChannelWriter.hpp>
 
 #include <mdsplusplus/Data.inc.hpp>
+#include <mdsplusplus/Arena.inc.hpp>
 #include <mdsplusplus/String.inc.hpp>
 // #include <mdsplusplus/Scalar.inc.hpp>
 #include <mdsplusplus/Array.inc.hpp>
@@ -35,6 +49,12 @@ namespace mdsplus { }
 #include <mdsplusplus/Tree.inc.hpp>
 #include <mdsplusplus/Device.inc.hpp>
 #include <mdsplusplus/Connection.inc.hpp>
+#include <mdsplusplus/ShotScanner.inc.hpp>
+#include <mdsplusplus/TreeCache.inc.hpp>
+#include <mdsplusplus/SegmentWriter.inc.hpp>
+#include <mdsplusplus/SegmentReader.inc.hpp>
+#include <mdsplusplus/SignalView.inc.hpp>
+#include <mdsplusplus/MultiChannelWriter.inc.hpp>
 
 #endif // MDSPLUS_HPP
 
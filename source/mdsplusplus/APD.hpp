@@ -1,10 +1,16 @@
 #ifndef MDSPLUS_APD_HPP
 #define MDSPLUS_APD_HPP
 
+#include <atomic>
+#include <iterator>
 #include <map>
+#include <memory>
+#include <string_view>
+#include <type_traits>
 #include <unordered_map>
 
 #include "Array.hpp"
+#include "DataRef.hpp"
 #include "DataView.hpp"
 
 namespace mdsplus {
@@ -32,6 +38,9 @@ public:
 
 protected:
 
+    template <typename APDType>
+    friend class APDBuilder;
+
     inline mdsdsc_t ** _getDescriptorArray() const {
         return reinterpret_cast<mdsdsc_t **>(getPointer());
     }
@@ -41,9 +50,10 @@ protected:
     {
         std::vector<DataView> argList = { DataView(args)... };
 
+        // DataView refers to a Data argument with a DTYPE_DSC, which shouldn't end up in the APD
         std::vector<mdsdsc_t *> dscList;
         for (size_t i = 0; i < argList.size(); ++i) {
-            dscList.push_back(argList[i].getDescriptor());
+            dscList.push_back(_unwrapDescriptor(argList[i].getDescriptor()));
         }
 
         _append(dtype, dscList);
@@ -60,14 +70,8 @@ protected:
         // TODO: Replace the 0 above with dscList.size() once a cast to arsize_t is added
         dsc.arsize = arsize_t(dscList.size() * sizeof(mdsdsc_t *));
 
-        mdsdsc_xd_t tmpXD = std::move(_xd);
-
-        int status = MdsCopyDxXd((mdsdsc_t *)&dsc, &_xd);
-        if (IS_NOT_OK(status)) {
-            throwException(status);
-        }
-
-        MdsFree1Dx(&tmpXD, nullptr);
+        // dscList refers to the old values, which are only freed once they have been copied
+        _copyFrom((mdsdsc_t *)&dsc);
     }
 
 }; // class APD
@@ -102,11 +106,19 @@ public:
         return "List";
     }
 
+    ///
+    /// Append values to the list.
+    ///
+    /// This copies the whole list each time, use ListBuilder to build a list from many values.
+    ///
     template <typename ...ArgTypes>
     inline void append(ArgTypes ...args) {
         _append(__dtype, args...);
     }
 
+    ///
+    /// Copy every value into a Data of its own, iterate over the list instead to avoid the copies.
+    ///
     inline std::vector<Data> getValues() const
     {
         int status;
@@ -131,29 +143,38 @@ public:
         return std::move(values);
     }
 
+    ///
+    /// The value at index, without copying it.
+    ///
+    [[nodiscard]]
+    inline DataRef operator[](size_t index) const {
+        return DataRef(_getDescriptorArray()[index], getTree());
+    }
+
     // STL Compatibility
 
+    ///
+    /// Iterates over the values as DataRefs, which refer to the list's own descriptors.
+    ///
+    /// Nothing is copied, call DataRef::clone() to keep a value after the list has gone.
+    ///
     struct Iterator
     {
     public:
 
+        using iterator_category = std::forward_iterator_tag;
+        using difference_type = std::ptrdiff_t;
+        using value_type = DataRef;
+        using pointer = mdsdsc_t *;
+        using reference = DataRef;
+
         Iterator(size_t index, const List * list)
             : _index(index)
             , _list(list)
         { }
 
-        inline Data operator*() const
-        {
-            mdsdsc_xd_t out = MDSDSC_XD_INITIALIZER;
-            mdsdsc_a_t * dsc = _list->getArrayDescriptor();
-
-            mdsdsc_t * tmp = _list->_getDescriptorArray()[_index];
-            int status = MdsCopyDxXd(tmp, &out);
-            if (IS_NOT_OK(status)) {
-                throwException(status);
-            }
-
-            return Data(std::move(out), _list->getTree());
+        inline DataRef operator*() const {
+            return (*_list)[_index];
         }
 
         inline mdsdsc_t * operator->() const {
@@ -225,8 +246,8 @@ public:
 
         std::vector<mdsdsc_t *> dscList = _getValues<mdsdsc_t *>();
         for (size_t i = 0; i < keys.size(); ++i) {
-            dscList.push_back(keys[i].getDescriptor());
-            dscList.push_back(values[i].getDescriptor());
+            dscList.push_back(_unwrapDescriptor(keys[i].getDescriptor()));
+            dscList.push_back(_unwrapDescriptor(values[i].getDescriptor()));
         }
         
         DESCRIPTOR_APD(dsc, dtype_t(__dtype), dscList.data(), 0);
@@ -234,10 +255,7 @@ public:
         // TODO: Replace the 0 above with dscList.size() once a cast to arsize_t is added
         dsc.arsize = arsize_t(dscList.size() * sizeof(mdsdsc_t *));
 
-        int status = MdsCopyDxXd((mdsdsc_t *)&dsc, &_xd);
-        if (IS_NOT_OK(status)) {
-            throwException(status);
-        }
+        _copyFrom((mdsdsc_t *)&dsc);
     }
 
     template <typename ...ArgTypes,
@@ -246,15 +264,86 @@ public:
         : APD(__dtype, args...)
     { }
 
+    // The index refers to the APD, which moves with it
+    inline Dictionary(Dictionary&& other)
+        : APD(std::move(other))
+        , _index(other._index.exchange(nullptr))
+    { }
+
+    inline Dictionary& operator=(Dictionary&& other)
+    {
+        if (this != &other) {
+            // Frees our index through _onValueReplaced()
+            APD::operator=(std::move(other));
+            _index = other._index.exchange(nullptr);
+        }
+        return *this;
+    }
+
+    inline ~Dictionary() {
+        delete _index.load();
+    }
+
     inline const char * getClassName() const override {
         return "Dictionary";
     }
 
+    ///
+    /// Append a key and value to the dictionary.
+    ///
+    /// This copies the whole dictionary each time, use DictionaryBuilder to build a dictionary from many values.
+    ///
     template <typename KeyType, typename ValueType>
     void append(KeyType key, ValueType value) {
         _append(__dtype, key, value);
     }
 
+    ///
+    /// Find the value of a string key, without copying it.
+    ///
+    /// The first lookup builds a hash index of the string and integer keys, so later lookups
+    /// don't search every key. Several threads can search the same dictionary at the same time,
+    /// and if they race to build the index, only one of them is kept. The index and the returned
+    /// DataRef are invalidated by
+    /// anything that replaces the value, e.g. append() or assignment.
+    ///
+    /// @returns The value, or an empty DataRef if the key isn't found.
+    ///
+    [[nodiscard]]
+    inline DataRef find(std::string_view key) const {
+        const _Index& index = _getIndex();
+        auto it = index.Strings.find(key);
+        return (it == index.Strings.end() ? DataRef() : _getValueRef(it->second));
+    }
+
+    template <typename KeyType,
+        typename std::enable_if<std::is_integral<KeyType>::value, bool>::type = true>
+    [[nodiscard]]
+    inline DataRef find(KeyType key) const {
+        const _Index& index = _getIndex();
+        auto it = index.Integers.find(int64_t(key));
+        return (it == index.Integers.end() ? DataRef() : _getValueRef(it->second));
+    }
+
+    template <typename KeyType>
+    [[nodiscard]]
+    inline bool contains(const KeyType& key) const {
+        return bool(find(key));
+    }
+
+    ///
+    /// Find the value of a key, without copying it, and throw TdiBAD_INDEX if it isn't found.
+    ///
+    template <typename KeyType>
+    [[nodiscard]]
+    inline DataRef operator[](const KeyType& key) const {
+        DataRef value = find(key);
+        if (!value) {
+            throwException(TdiBAD_INDEX);
+        }
+        return value;
+    }
+
     inline std::tuple<std::vector<Data>, std::vector<Data>> getKeysAndValues() const {
         int status;
 
@@ -282,8 +371,8 @@ public:
                 throwException(status);
             }
             
-            // keys.emplace(std::move(outKey), getTree());
-            // values.emplace(std::move(outValue), getTree());
+            keys.emplace_back(std::move(outKey), getTree());
+            values.emplace_back(std::move(outValue), getTree());
         }
 
 
@@ -328,8 +417,311 @@ public:
         return std::move(values);
     }
 
+    // STL Compatibility
+
+    ///
+    /// Iterates over the { key, value } pairs as DataRefs, which refer to the dictionary's own descriptors.
+    ///
+    struct Iterator
+    {
+    public:
+
+        using iterator_category = std::forward_iterator_tag;
+        using difference_type = std::ptrdiff_t;
+        using value_type = std::pair<DataRef, DataRef>;
+        using pointer = void;
+        using reference = std::pair<DataRef, DataRef>;
+
+        Iterator(size_t index, const Dictionary * dictionary)
+            : _index(index)
+            , _dictionary(dictionary)
+        { }
+
+        inline std::pair<DataRef, DataRef> operator*() const {
+            return {
+                _dictionary->_getValueRef(_index),
+                _dictionary->_getValueRef(_index + 1),
+            };
+        }
+
+        inline Iterator& operator++() {
+            _index += 2;
+            return *this;
+        }
+
+        inline Iterator operator++(int) {
+            Iterator tmp = *this;
+            ++(*this);
+            return tmp;
+        }
+
+        inline friend bool operator==(const Iterator& a, const Iterator& b) {
+            return (a._index == b._index && a._dictionary == b._dictionary);
+        };
+
+        inline friend bool operator!=(const Iterator& a, const Iterator& b) {
+            return (a._index != b._index || a._dictionary != b._dictionary);
+        };
+
+    private:
+
+        size_t _index;
+
+        const Dictionary * _dictionary;
+
+    };
+
+    inline Iterator begin() const {
+        return Iterator(0, this);
+    }
+
+    inline Iterator end() const {
+        // An odd trailing key without a value is skipped
+        return Iterator(getSize() - (getSize() % 2), this);
+    }
+
+protected:
+
+    // Also called by ScopedArena, so it can't allocate or throw
+    inline void _onValueReplaced() noexcept override {
+        delete _index.exchange(nullptr, std::memory_order_acq_rel);
+    }
+
+private:
+
+    // Position of the value for each key, keys are views into the APD
+    struct _Index
+    {
+        std::unordered_map<std::string_view, size_t> Strings = {};
+
+        std::unordered_map<int64_t, size_t> Integers = {};
+    };
+
+    // Only allocated by the first find(), so a Dictionary that is never searched doesn't pay for it
+    mutable std::atomic<_Index *> _index = nullptr;
+
+    inline DataRef _getValueRef(size_t position) const {
+        return DataRef(_getDescriptorArray()[position], getTree());
+    }
+
+    inline const _Index& _getIndex() const
+    {
+        _Index * index = _index.load(std::memory_order_acquire);
+        if (index) {
+            return *index;
+        }
+
+        auto built = std::make_unique<_Index>();
+        _buildIndex(*built);
+
+        // If another thread published its index first, use that one and discard ours
+        if (_index.compare_exchange_strong(index, built.get(), std::memory_order_acq_rel)) {
+            return *built.release();
+        }
+        return *index;
+    }
+
+    inline void _buildIndex(_Index& index) const
+    {
+        mdsdsc_t ** dscList = _getDescriptorArray();
+        size_t size = (dscList ? getSize() : 0);
+
+        // emplace() keeps the first of any duplicate keys, same as a linear search
+        for (size_t i = 0; i + 1 < size; i += 2) {
+            mdsdsc_t * key = dscList[i];
+            if (!key || (key->class_ != CLASS_S && key->class_ != CLASS_D)) {
+                continue;
+            }
+
+            switch (key->dtype) {
+            case DTYPE_T:
+                index.Strings.emplace(std::string_view(key->pointer, key->length), i + 1);
+                break;
+            case DTYPE_B:
+                index.Integers.emplace(*reinterpret_cast<int8_t *>(key->pointer), i + 1);
+                break;
+            case DTYPE_BU:
+                index.Integers.emplace(*reinterpret_cast<uint8_t *>(key->pointer), i + 1);
+                break;
+            case DTYPE_W:
+                index.Integers.emplace(*reinterpret_cast<int16_t *>(key->pointer), i + 1);
+                break;
+            case DTYPE_WU:
+                index.Integers.emplace(*reinterpret_cast<uint16_t *>(key->pointer), i + 1);
+                break;
+            case DTYPE_L:
+                index.Integers.emplace(*reinterpret_cast<int32_t *>(key->pointer), i + 1);
+                break;
+            case DTYPE_LU:
+                index.Integers.emplace(*reinterpret_cast<uint32_t *>(key->pointer), i + 1);
+                break;
+            case DTYPE_Q:
+            case DTYPE_QU:
+                index.Integers.emplace(*reinterpret_cast<int64_t *>(key->pointer), i + 1);
+                break;
+            default: ;
+            }
+        }
+    }
+
 }; // class Dictionary
 
+///
+/// Collects the values of a List or Dictionary, and builds its descriptor once at the end.
+///
+/// Each value is copied into a Data of its own as it is appended, or moved in without copying,
+/// and the values are kept in a vector that grows geometrically. build() then copies them into
+/// a single APD, so building from N values is O(N) instead of the O(N^2) of repeated append().
+///
+template <typename APDType>
+class APDBuilder
+{
+public:
+
+    APDBuilder() = default;
+
+    inline explicit APDBuilder(size_t capacity) {
+        _values.reserve(capacity);
+    }
+
+    [[nodiscard]]
+    inline size_t getSize() const {
+        return _values.size();
+    }
+
+    inline void reserve(size_t capacity) {
+        _values.reserve(capacity);
+    }
+
+    inline void clear() {
+        _values.clear();
+    }
+
+    ///
+    /// Build the List or Dictionary, the builder can still be appended to afterwards.
+    ///
+    [[nodiscard]]
+    inline APDType build() const &
+    {
+        std::vector<mdsdsc_t *> dscList(_values.size());
+        for (size_t i = 0; i < _values.size(); ++i) {
+            dscList[i] = _values[i].getDescriptor();
+        }
+
+        mdsdsc_a_t dsc = _getDescriptor(dscList);
+
+        APDType result;
+        static_cast<APD&>(result)._copyFrom((mdsdsc_t *)&dsc);
+        return result;
+    }
+
+    ///
+    /// Build the List or Dictionary from a builder that is given up, e.g. std::move(builder).build().
+    ///
+    /// The values are adopted by the result instead of being copied a second time, except for
+    /// those that can't be, see Data::_canAdopt(). The builder is left empty.
+    ///
+    [[nodiscard]]
+    inline APDType build() &&
+    {
+        // Left out of the copy, and filled in once they have been adopted
+        std::vector<mdsdsc_t *> dscList(_values.size());
+        for (size_t i = 0; i < _values.size(); ++i) {
+            dscList[i] = (APD::_canAdopt(_values[i]) ? nullptr : _values[i].getDescriptor());
+        }
+
+        mdsdsc_a_t dsc = _getDescriptor(dscList);
+
+        APDType result;
+        APD& apd = result;
+        apd._copyFrom((mdsdsc_t *)&dsc);
+
+        mdsdsc_t ** out = apd._getDescriptorArray();
+        for (size_t i = 0; i < _values.size(); ++i) {
+            if (APD::_canAdopt(_values[i])) {
+                out[i] = apd._adopt(std::move(_values[i]));
+            }
+        }
+
+        _values.clear();
+        return result;
+    }
+
+protected:
+
+    std::vector<Data> _values;
+
+    static inline mdsdsc_a_t _getDescriptor(std::vector<mdsdsc_t *>& dscList) {
+        return mdsdsc_a_t{
+            .length = sizeof(mdsdsc_t *),
+            .dtype = dtype_t(APDType::__dtype),
+            .class_ = CLASS_APD,
+            .pointer = reinterpret_cast<char *>(dscList.data()),
+            .scale = 0,
+            .digits = 0,
+            .aflags = aflags_t{
+                .binscale = false,
+                .redim = true,
+                .column = true,
+                .coeff = false,
+                .bounds = false,
+            },
+            .dimct = 1,
+            .arsize = arsize_t(dscList.size() * sizeof(mdsdsc_t *)),
+        };
+    }
+
+    template <typename ValueType>
+    inline void _append(ValueType&& value)
+    {
+        using BaseType = std::remove_cv_t<std::remove_reference_t<ValueType>>;
+
+        // Data given up by the caller is moved in without being copied
+        if constexpr (std::is_base_of_v<Data, BaseType> && !std::is_lvalue_reference_v<ValueType>) {
+            _values.emplace_back(std::move(value));
+        }
+        else {
+            DataView argValue(value);
+
+            mdsdsc_xd_t xd = MDSDSC_XD_INITIALIZER;
+            int status = MdsCopyDxXd(_unwrapDescriptor(argValue.getDescriptor()), &xd);
+            if (IS_NOT_OK(status)) {
+                throwException(status);
+            }
+
+            _values.emplace_back(std::move(xd), argValue.getTree());
+        }
+    }
+
+}; // class APDBuilder
+
+class ListBuilder : public APDBuilder<List>
+{
+public:
+
+    using APDBuilder<List>::APDBuilder;
+
+    template <typename ValueType>
+    inline void append(ValueType&& value) {
+        _append(std::forward<ValueType>(value));
+    }
+
+}; // class ListBuilder
+
+class DictionaryBuilder : public APDBuilder<Dictionary>
+{
+public:
+
+    using APDBuilder<Dictionary>::APDBuilder;
+
+    template <typename KeyType, typename ValueType>
+    inline void append(KeyType&& key, ValueType&& value) {
+        _append(std::forward<KeyType>(key));
+        _append(std::forward<ValueType>(value));
+    }
+
+}; // class DictionaryBuilder
+
 // TODO: Tuple
 
 } // namespace mdsplus
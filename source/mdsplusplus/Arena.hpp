@@ -0,0 +1,358 @@
+#ifndef MDSPLUS_ARENA_HPP
+#define MDSPLUS_ARENA_HPP
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+extern "C" {
+
+    // Needed for mdsdsc*_t, <dtypedef.h>, <classdef.h>
+    #include <mdsdescrip.h>
+
+} // extern "C"
+
+namespace mdsplus {
+
+class Data;
+
+///
+/// An opt-in arena for the values built by Data, Array, APD and Record on the current thread.
+///
+/// While a ScopedArena is alive, values built from descriptors, e.g. by the constructors of
+/// Array, List, Dictionary and the Record types, or by clone(), are copied into large blocks
+/// owned by the arena instead of each being allocated with MdsCopyDxXd(). The blocks are all
+/// freed at once when the arena is destroyed, so building many short-lived values costs a few
+/// allocations instead of one or more per value.
+///
+/// Values read from a Tree or returned by TDI are still allocated by MDSplus as usual.
+///
+/// Any Data that is still alive when its arena is destroyed, or whose XD is given away with
+/// release(), is first copied into a normal XD, so nothing is left pointing into a freed block.
+/// Arenas are scoped to a thread, and can be nested, in which case the innermost one is used.
+///
+/// A Data built in an arena can be moved to and destroyed on another thread while the arena is
+/// alive, but it must not be in use on another thread while the arena is being destroyed.
+///
+/// @code{.cpp}
+/// {
+///     ScopedArena arena;
+///     for (...) {
+///         Signal signal(values, nullptr, dimension);
+///         ...
+///     }
+/// } // Everything is freed here
+/// @endcode
+///
+class ScopedArena
+{
+public:
+
+    static constexpr size_t DefaultBlockSize = 64 * 1024;
+
+    ///
+    /// The innermost arena on the current thread, or nullptr if there isn't one.
+    ///
+    [[nodiscard]]
+    static inline ScopedArena * GetActive() {
+        return _getActive();
+    }
+
+    ///
+    /// @param blockSize The size of each block, values larger than this get a block of their own.
+    ///
+    explicit inline ScopedArena(size_t blockSize = DefaultBlockSize)
+        : _blockSize(blockSize)
+        , _previous(_getActive())
+    {
+        _getActive() = this;
+    }
+
+    // Data in the arena refers to this object
+    ScopedArena(const ScopedArena&) = delete;
+    ScopedArena& operator=(const ScopedArena&) = delete;
+
+    ~ScopedArena();
+
+    ///
+    /// The number of bytes copied into the arena, including alignment.
+    ///
+    [[nodiscard]]
+    inline size_t getBytesUsed() const {
+        return _bytesUsed;
+    }
+
+    [[nodiscard]]
+    inline size_t getBlockCount() const {
+        return _blocks.size();
+    }
+
+    ///
+    /// The number of Data that refer to values in the arena.
+    ///
+    [[nodiscard]]
+    inline size_t getLiveCount() const {
+        std::lock_guard<std::mutex> lock(_liveMutex);
+        return _liveCount;
+    }
+
+private:
+
+    friend class Data;
+
+    static constexpr size_t Alignment = alignof(std::max_align_t);
+
+    size_t _blockSize;
+
+    ScopedArena * _previous;
+
+    std::vector<std::unique_ptr<char[]>> _blocks;
+
+    char * _cursor = nullptr;
+
+    size_t _remaining = 0;
+
+    size_t _bytesUsed = 0;
+
+    // The Data that refer to values in the arena, linked through Data::_arenaPrevious and _arenaNext
+    // so that tracking them never allocates
+    Data * _live = nullptr;
+
+    size_t _liveCount = 0;
+
+    // Only allocation is tied to the arena's thread, a Data in it can be moved or destroyed anywhere
+    mutable std::mutex _liveMutex;
+
+    static inline ScopedArena *& _getActive() {
+        static thread_local ScopedArena * active = nullptr;
+        return active;
+    }
+
+    static constexpr size_t _align(size_t size) {
+        return (size + Alignment - 1) & ~(Alignment - 1);
+    }
+
+    void _register(Data * data);
+
+    void _unregister(Data * data);
+
+    // Put to in from's place in the list, when a Data is moved
+    void _replace(Data * from, Data * to);
+
+    inline char * _allocate(size_t size)
+    {
+        size = _align(size);
+        _bytesUsed += size;
+
+        // Large values get their own block, so the rest of the current block isn't wasted
+        if (size > _blockSize) {
+            _blocks.emplace_back(new char[size]);
+            return _blocks.back().get();
+        }
+
+        if (size > _remaining) {
+            _blocks.emplace_back(new char[_blockSize]);
+            _cursor = _blocks.back().get();
+            _remaining = _blockSize;
+        }
+
+        char * pointer = _cursor;
+        _cursor += size;
+        _remaining -= size;
+        return pointer;
+    }
+
+    ///
+    /// Copy dsc into the arena as a single block and point xd at it, in the same layout as
+    /// MdsCopyDxXd() would use.
+    ///
+    /// @returns false if dsc contains a class that can't be copied, e.g. CLASS_CA, in which case
+    /// it has to be copied with MdsCopyDxXd() instead.
+    ///
+    inline bool _copyInto(const mdsdsc_t * dsc, mdsdsc_xd_t& xd)
+    {
+        size_t size = 0;
+        if (!dsc || !_measure(dsc, size)) {
+            return false;
+        }
+
+        char * cursor = _allocate(size);
+        xd.pointer = _copy(dsc, cursor);
+        xd.l_length = l_length_t(size);
+        return true;
+    }
+
+    // The size of an array descriptor, including a0, m and the bounds if they are present
+    static inline size_t _getArrayHeaderSize(const mdsdsc_a_t * dsc) {
+        if (!dsc->aflags.coeff) {
+            return sizeof(mdsdsc_a_t);
+        }
+
+        size_t size = offsetof(array_coeff, m) + (dsc->dimct * sizeof(uint32_t));
+        if (dsc->aflags.bounds) {
+            size += dsc->dimct * 2 * sizeof(int32_t);
+        }
+        return size;
+    }
+
+    // Add the space needed to copy dsc to size, false if it can't be copied into an arena
+    static bool _measure(const mdsdsc_t * dsc, size_t& size)
+    {
+        if (!dsc) {
+            return true;
+        }
+
+        switch (dsc->class_) {
+        case CLASS_XD:
+        case CLASS_XS:
+            return _measure(reinterpret_cast<const mdsdsc_xd_t *>(dsc)->pointer, size);
+
+        case CLASS_S:
+        case CLASS_D:
+            size += _align(sizeof(mdsdsc_s_t));
+            if (dsc->dtype == DTYPE_DSC) {
+                return _measure(reinterpret_cast<const mdsdsc_t *>(dsc->pointer), size);
+            }
+            size += _align(dsc->length);
+            return true;
+
+        case CLASS_A: {
+            const mdsdsc_a_t * dscArray = reinterpret_cast<const mdsdsc_a_t *>(dsc);
+            if (dscArray->dtype == DTYPE_DSC) {
+                return false;
+            }
+            size += _align(_getArrayHeaderSize(dscArray)) + _align(dscArray->arsize);
+            return true;
+        }
+
+        case CLASS_APD: {
+            const mdsdsc_a_t * dscArray = reinterpret_cast<const mdsdsc_a_t *>(dsc);
+            size += _align(_getArrayHeaderSize(dscArray)) + _align(dscArray->arsize);
+
+            mdsdsc_t ** dscList = reinterpret_cast<mdsdsc_t **>(dscArray->pointer);
+            for (size_t i = 0; i < dscArray->arsize / sizeof(mdsdsc_t *); ++i) {
+                if (!_measure(dscList[i], size)) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        case CLASS_R: {
+            const mdsdsc_r_t * dscRecord = reinterpret_cast<const mdsdsc_r_t *>(dsc);
+            size += _align(offsetof(mdsdsc_r_t, dscptrs) + (dscRecord->ndesc * sizeof(mdsdsc_t *)));
+            if (dscRecord->pointer) {
+                size += _align(dscRecord->length);
+            }
+
+            for (size_t i = 0; i < dscRecord->ndesc; ++i) {
+                if (!_measure(dscRecord->dscptrs[i], size)) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        default:
+            return false;
+        }
+    }
+
+    static inline char * _bump(char *& cursor, size_t size) {
+        char * pointer = cursor;
+        cursor += _align(size);
+        return pointer;
+    }
+
+    // Copy dsc to cursor, which must have the space counted by _measure()
+    static mdsdsc_t * _copy(const mdsdsc_t * dsc, char *& cursor)
+    {
+        if (!dsc) {
+            return nullptr;
+        }
+
+        switch (dsc->class_) {
+        case CLASS_XD:
+        case CLASS_XS:
+            return _copy(reinterpret_cast<const mdsdsc_xd_t *>(dsc)->pointer, cursor);
+
+        case CLASS_S:
+        case CLASS_D: {
+            mdsdsc_t * out = reinterpret_cast<mdsdsc_t *>(_bump(cursor, sizeof(mdsdsc_s_t)));
+            *out = *dsc;
+            out->class_ = CLASS_S;
+
+            if (dsc->dtype == DTYPE_DSC) {
+                out->pointer = reinterpret_cast<char *>(_copy(reinterpret_cast<const mdsdsc_t *>(dsc->pointer), cursor));
+            }
+            else {
+                out->pointer = _bump(cursor, dsc->length);
+                if (dsc->length > 0) {
+                    std::memcpy(out->pointer, dsc->pointer, dsc->length);
+                }
+            }
+            return out;
+        }
+
+        case CLASS_A:
+        case CLASS_APD: {
+            const mdsdsc_a_t * dscArray = reinterpret_cast<const mdsdsc_a_t *>(dsc);
+            size_t headerSize = _getArrayHeaderSize(dscArray);
+
+            mdsdsc_a_t * out = reinterpret_cast<mdsdsc_a_t *>(_bump(cursor, headerSize));
+            std::memcpy(out, dscArray, headerSize);
+
+            out->pointer = _bump(cursor, dscArray->arsize);
+            if (dscArray->arsize > 0) {
+                std::memcpy(out->pointer, dscArray->pointer, dscArray->arsize);
+            }
+
+            // a0 is the address of element zero, which may be outside of the array
+            if (dscArray->aflags.coeff) {
+                const array_coeff * in = reinterpret_cast<const array_coeff *>(dscArray);
+                reinterpret_cast<array_coeff *>(out)->a0 = out->pointer + (in->a0 - in->pointer);
+            }
+
+            if (dsc->class_ == CLASS_APD) {
+                mdsdsc_t ** dscList = reinterpret_cast<mdsdsc_t **>(out->pointer);
+                for (size_t i = 0; i < dscArray->arsize / sizeof(mdsdsc_t *); ++i) {
+                    dscList[i] = _copy(dscList[i], cursor);
+                }
+            }
+            return reinterpret_cast<mdsdsc_t *>(out);
+        }
+
+        case CLASS_R: {
+            const mdsdsc_r_t * dscRecord = reinterpret_cast<const mdsdsc_r_t *>(dsc);
+            size_t headerSize = offsetof(mdsdsc_r_t, dscptrs) + (dscRecord->ndesc * sizeof(mdsdsc_t *));
+
+            mdsdsc_r_t * out = reinterpret_cast<mdsdsc_r_t *>(_bump(cursor, headerSize));
+            std::memcpy(out, dscRecord, headerSize);
+
+            if (dscRecord->pointer) {
+                out->pointer = reinterpret_cast<uint8_t *>(_bump(cursor, dscRecord->length));
+                std::memcpy(out->pointer, dscRecord->pointer, dscRecord->length);
+            }
+
+            for (size_t i = 0; i < dscRecord->ndesc; ++i) {
+                out->dscptrs[i] = _copy(dscRecord->dscptrs[i], cursor);
+            }
+            return reinterpret_cast<mdsdsc_t *>(out);
+        }
+
+        default:
+            // Rejected by _measure()
+            assert(false);
+            return nullptr;
+        }
+    }
+
+}; // class ScopedArena
+
+} // namespace mdsplus
+
+#endif // MDSPLUS_ARENA_HPP
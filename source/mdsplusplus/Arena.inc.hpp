@@ -0,0 +1,82 @@
+#ifndef MDSPLUS_ARENA_INC_HPP
+#define MDSPLUS_ARENA_INC_HPP
+
+#include "Arena.hpp"
+#include "Data.hpp"
+
+namespace mdsplus {
+
+inline ScopedArena::~ScopedArena()
+{
+    // Arenas must be destroyed in the reverse order they were created in
+    assert(_getActive() == this);
+    _getActive() = _previous;
+
+    // Anything still alive escaped the scope, and is moved out before the blocks are freed
+    std::lock_guard<std::mutex> lock(_liveMutex);
+    for (Data * data = _live; data; ) {
+        Data * next = data->_arenaNext;
+        data->_arenaPrevious = nullptr;
+        data->_arenaNext = nullptr;
+        data->_promote();
+        data = next;
+    }
+    _live = nullptr;
+    _liveCount = 0;
+}
+
+inline void ScopedArena::_register(Data * data)
+{
+    std::lock_guard<std::mutex> lock(_liveMutex);
+    data->_arenaPrevious = nullptr;
+    data->_arenaNext = _live;
+    if (_live) {
+        _live->_arenaPrevious = data;
+    }
+    _live = data;
+    ++_liveCount;
+}
+
+inline void ScopedArena::_unregister(Data * data)
+{
+    std::lock_guard<std::mutex> lock(_liveMutex);
+    if (data->_arenaPrevious) {
+        data->_arenaPrevious->_arenaNext = data->_arenaNext;
+    }
+    else {
+        _live = data->_arenaNext;
+    }
+
+    if (data->_arenaNext) {
+        data->_arenaNext->_arenaPrevious = data->_arenaPrevious;
+    }
+
+    data->_arenaPrevious = nullptr;
+    data->_arenaNext = nullptr;
+    --_liveCount;
+}
+
+inline void ScopedArena::_replace(Data * from, Data * to)
+{
+    std::lock_guard<std::mutex> lock(_liveMutex);
+    to->_arenaPrevious = from->_arenaPrevious;
+    to->_arenaNext = from->_arenaNext;
+
+    if (to->_arenaPrevious) {
+        to->_arenaPrevious->_arenaNext = to;
+    }
+    else {
+        _live = to;
+    }
+
+    if (to->_arenaNext) {
+        to->_arenaNext->_arenaPrevious = to;
+    }
+
+    from->_arenaPrevious = nullptr;
+    from->_arenaNext = nullptr;
+}
+
+} // namespace mdsplus
+
+#endif // MDSPLUS_ARENA_INC_HPP
@@ -103,6 +103,7 @@ protected:
                 _setValues(dtype, values.data(), values.size());
             }
             else {
+                _checkDimensions(values.size(), dims);
                 _setValues(dtype, values.data(), dims.data(), dims.size());
             }
         }
@@ -123,12 +124,25 @@ protected:
                 _setValues(dtype, values.data(), values.size());
             }
             else {
+                _checkDimensions(values.size(), dims);
                 _setValues(dtype, values.data(), dims.data(), dims.size());
             }
         }
 
     #endif
 
+    // The dimensions must describe exactly count values, or _setValues() would read past the end
+    static inline void _checkDimensions(size_t count, const std::vector<uint32_t>& dims) {
+        size_t expected = 1;
+        for (uint32_t dim : dims) {
+            expected *= dim;
+        }
+
+        if (count != expected) {
+            throwException(TreeFAILURE);
+        }
+    }
+
     template <typename CType>
     inline void _setValues(DType dtype, const CType * values, uint32_t count) {
         _setValues(dtype, values, &count, 1);
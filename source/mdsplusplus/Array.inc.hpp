@@ -29,11 +29,15 @@ inline void Array::_setValues(DType dtype, const CType * values, const uint32_t
 {
     // TODO: Overwrite existing values if the shape/type is the same
 
-    uint32_t count = dims[0];
-    for (dimct_t i = 1; i < dimCount; ++i) {
-        count *= dims[dimCount];
+    if (dimCount == 0 || dimCount > MAX_DIMS) {
+        throwException(TreeFAILURE);
     }
-    
+
+    uint32_t count = 1;
+    for (dimct_t i = 0; i < dimCount; ++i) {
+        count *= dims[i];
+    }
+
     array_coeff dsc = {
         .length = sizeof(CType),
         .dtype = dtype_t(dtype),
@@ -54,17 +58,14 @@ inline void Array::_setValues(DType dtype, const CType * values, const uint32_t
         .m = { count, 0, 0, 0, 0, 0, 0, 0, },
     };
 
-    if (dims && dimCount > 0) {
+    if (dimCount > 1) {
         dsc.aflags.coeff = true;
         for (size_t i = 0; i < dimCount; ++i) {
             dsc.m[i] = dims[i];
         }
     }
 
-    int status = MdsCopyDxXd((mdsdsc_t *)&dsc, &_xd);
-    if (IS_NOT_OK(status)) {
-        throwException(status);
-    }
+    _copyFrom((mdsdsc_t *)&dsc);
 }
 
 #ifdef __cpp_lib_span
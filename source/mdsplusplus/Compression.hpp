@@ -0,0 +1,127 @@
+#ifndef MDSPLUS_COMPRESSION_HPP
+#define MDSPLUS_COMPRESSION_HPP
+
+#include "Data.hpp"
+#include "DataView.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+extern "C" {
+
+    // Needed for MdsCompress()
+    #include <mdsshr.h>
+
+} // extern "C"
+
+namespace mdsplus {
+
+///
+/// The compression methods known to treeshr, numbered the same as NciCOMPRESSION_METHOD.
+///
+enum class CompressionMethod
+{
+    /// Whatever the node is configured with, see TreeNode::getCompressionMethod().
+    Default = -1,
+
+    /// The delta compression built into MdsShr.
+    Standard = 0,
+
+    Gzip = 1,
+};
+
+inline std::string to_string(const CompressionMethod& method)
+{
+    switch (method) {
+    case CompressionMethod::Default: return "CompressionMethod::Default";
+    case CompressionMethod::Standard: return "CompressionMethod::Standard";
+    case CompressionMethod::Gzip: return "CompressionMethod::Gzip";
+    }
+
+    return "?";
+}
+
+///
+/// The amount of data compressed, and how long it took.
+///
+struct CompressionStats
+{
+    size_t Segments = 0;
+
+    uint64_t InputBytes = 0;
+
+    uint64_t OutputBytes = 0;
+
+    /// The time spent compressing, with every worker running at once.
+    std::chrono::nanoseconds Duration = {};
+
+    [[nodiscard]]
+    inline double getRatio() const {
+        return (OutputBytes > 0 ? double(InputBytes) / double(OutputBytes) : 0.0);
+    }
+
+    ///
+    /// The number of uncompressed bytes compressed per second.
+    ///
+    [[nodiscard]]
+    inline double getThroughput() const {
+        double seconds = std::chrono::duration<double>(Duration).count();
+        return (seconds > 0.0 ? double(InputBytes) / seconds : 0.0);
+    }
+
+}; // struct CompressionStats
+
+///
+/// Compress an array with MdsCompress(), without needing a Tree.
+///
+/// The result is a compressed record that can be passed to TreeNode::makeSegment() with an
+/// explicit rowsFilled, as it no longer has the shape of the original values. If the values
+/// don't compress, MdsCompress() returns them unchanged.
+///
+/// @param method Which method to use, CompressionMethod::Default is the same as Standard.
+///
+inline Data compress(const DataView& values, CompressionMethod method = CompressionMethod::Standard)
+{
+    mdsdsc_t * dscValues = _unwrapDescriptor(values.getDescriptor());
+
+    // The shared library and routine for each method, same as the table in treeshr
+    std::string_view image;
+    std::string_view routine;
+    if (method == CompressionMethod::Gzip) {
+        image = "MdsShr";
+        routine = "gzip";
+    }
+
+    mdsdsc_t dscImage = {
+        .length = length_t(image.size()),
+        .dtype = DTYPE_T,
+        .class_ = CLASS_S,
+        .pointer = const_cast<char *>(image.data()),
+    };
+
+    mdsdsc_t dscRoutine = {
+        .length = length_t(routine.size()),
+        .dtype = DTYPE_T,
+        .class_ = CLASS_S,
+        .pointer = const_cast<char *>(routine.data()),
+    };
+
+    mdsdsc_xd_t xd = MDSDSC_XD_INITIALIZER;
+    int status = MdsCompress(
+        (image.empty() ? nullptr : &dscImage),
+        (routine.empty() ? nullptr : &dscRoutine),
+        dscValues,
+        &xd
+    );
+    if (IS_NOT_OK(status)) {
+        throwException(status);
+    }
+
+    return Data(std::move(xd), values.getTree());
+}
+
+} // namespace mdsplus
+
+#endif // MDSPLUS_COMPRESSION_HPP
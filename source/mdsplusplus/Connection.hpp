@@ -132,7 +132,6 @@ public:
 
     const Dictionary& execute()
     {
-        printf("%s\n", to_string(List(_queries).serialize()).c_str());
         Data result = _conn->get("GetManyExecute($)", List(_queries).serialize());
 
         if (result.getClass() == Class::S) {
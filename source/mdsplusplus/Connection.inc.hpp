@@ -2,6 +2,7 @@
 #define MDSPLUS_CONNECTION_INC_HPP
 
 #include "Connection.hpp"
+#include "Trace.hpp"
 
 // TODO: Move this somewhere better
 extern "C" {
@@ -71,6 +72,11 @@ inline Data Connection::_get(const std::string& expression, std::vector<DataView
     int argIndex = 0;
     uint8_t numberOfArgs = argList.size() + 1;
 
+    TraceScope span(TraceEvent::Network);
+    if (span) {
+        span.setName(_hostspec + " " + expression);
+    }
+
     status = SendArg(
         _id,
         argIndex,
@@ -82,9 +88,11 @@ inline Data Connection::_get(const std::string& expression, std::vector<DataView
         const_cast<char *>(expression.data())
     );
     if (IS_NOT_OK(status)) {
+        span.setStatus(status);
         throwException(status);
     }
-    
+
+    span.addBytes(expression.size());
     ++argIndex;
 
     for (auto& arg : argList) {
@@ -122,9 +130,11 @@ inline Data Connection::_get(const std::string& expression, std::vector<DataView
         // TODO: Throw exception for unsupported types
 
         if (IS_NOT_OK(status)) {
+            span.setStatus(status);
             throwException(status);
         }
 
+        span.addBytes(Trace::GetSize(dscArg));
         ++argIndex;
     }
 
@@ -139,6 +149,8 @@ inline Data Connection::_get(const std::string& expression, std::vector<DataView
         .l_length = sizeof(array_coeff),
     };
 
+    // numbytes is an int, writing it into response->length would overwrite dtype and class_
+    int numberOfBytes = 0;
     void * message = nullptr;
     status = GetAnswerInfoTO(
         _id,
@@ -146,15 +158,17 @@ inline Data Connection::_get(const std::string& expression, std::vector<DataView
         reinterpret_cast<short *>(&response->length),
         reinterpret_cast<char *>(&response->dimct),
         reinterpret_cast<int *>(response->m),
-        reinterpret_cast<int *>(&response->length),
+        &numberOfBytes,
         reinterpret_cast<void **>(&response->pointer),
         &message,
         -1
     );
+    span.setStatus(status);
+    span.addBytes(numberOfBytes);
     if (IS_NOT_OK(status)) {
-        if (response->dtype == DTYPE_T) {
-            printf("%.*s\n", response->length, response->pointer);
-            fflush(stdout);
+        if (response->dtype == DTYPE_T && response->pointer) {
+            // The server's error text, only kept when tracing
+            span.setMessage(std::string_view(response->pointer, numberOfBytes));
         }
 
         throwException(status);
@@ -2,11 +2,15 @@
 #define MDSPLUS_DATA_HPP
 
 #include "Exceptions.hpp"
+#include "Arena.hpp"
 
 #include <cassert>
+#include <complex>
 #include <cstdint>
 #include <cstring>
+#include <memory>
 #include <string>
+#include <type_traits>
 #include <vector>
 
 #if __has_include(<span>)
@@ -135,6 +139,42 @@ inline constexpr bool operator==(const DType lhs, const dtype_t rhs) {
 
 class Tree;
 
+///
+/// Follow a reference to a descriptor, which is how DataView passes Data and DataRef, to the
+/// descriptor it refers to. Anything else, including nullptr, is returned unchanged.
+///
+inline mdsdsc_t * _unwrapDescriptor(mdsdsc_t * dsc) {
+    if (dsc && dsc->class_ == CLASS_S && dsc->dtype == DTYPE_DSC) {
+        return reinterpret_cast<mdsdsc_t *>(dsc->pointer);
+    }
+    return dsc;
+}
+
+inline const mdsdsc_t * _unwrapDescriptor(const mdsdsc_t * dsc) {
+    return _unwrapDescriptor(const_cast<mdsdsc_t *>(dsc));
+}
+
+///
+/// The dtype that stores values of CType, or DTYPE_MISSING if there isn't one.
+///
+template <typename CType>
+inline constexpr dtype_t _getDTypeForCType()
+{
+    if constexpr (std::is_same_v<CType, int8_t>) return DTYPE_B;
+    else if constexpr (std::is_same_v<CType, int16_t>) return DTYPE_W;
+    else if constexpr (std::is_same_v<CType, int32_t>) return DTYPE_L;
+    else if constexpr (std::is_same_v<CType, int64_t>) return DTYPE_Q;
+    else if constexpr (std::is_same_v<CType, uint8_t>) return DTYPE_BU;
+    else if constexpr (std::is_same_v<CType, uint16_t>) return DTYPE_WU;
+    else if constexpr (std::is_same_v<CType, uint32_t>) return DTYPE_LU;
+    else if constexpr (std::is_same_v<CType, uint64_t>) return DTYPE_QU;
+    else if constexpr (std::is_same_v<CType, float>) return DTYPE_FS;
+    else if constexpr (std::is_same_v<CType, double>) return DTYPE_FT;
+    else if constexpr (std::is_same_v<CType, std::complex<float>>) return DTYPE_FSC;
+    else if constexpr (std::is_same_v<CType, std::complex<double>>) return DTYPE_FTC;
+    else return DTYPE_MISSING;
+}
+
 ///
 /// MDSplus Data base class
 ///
@@ -146,6 +186,9 @@ public:
     static constexpr Class __class = Class::Missing;
     static constexpr DType __dtype = DType::Missing;
 
+    /// Scalars and strings of up to this many bytes are stored inside the Data, instead of in an allocated XD.
+    static constexpr size_t InlineSize = 16;
+
     template <typename ResultType = Data, typename ...ArgTypes>
     static ResultType Compile(const std::string& expression, const ArgTypes& ...args);
 
@@ -176,7 +219,8 @@ public:
         return Execute<ResultType>(expression, args...);
     }
 
-    inline Data() = default;
+    // Not defaulted, so _inline is left uninitialized until it is used
+    inline Data() { }
 
     inline Data(mdsdsc_xd_t && xd, Tree * tree = nullptr)
         : _xd(xd)
@@ -186,7 +230,7 @@ public:
     }
 
     inline virtual ~Data() {
-        MdsFree1Dx(&_xd, nullptr);
+        _free();
     }
 
     // Disallow copy and assign
@@ -196,8 +240,7 @@ public:
     // Enable move operators
     inline Data(Data&& other)
     {
-        _xd = other._xd;
-        other._xd = MDSDSC_XD_INITIALIZER;
+        _take(other);
 
         _tree = other._tree;
         other._tree = nullptr;
@@ -205,10 +248,12 @@ public:
 
     Data& operator=(Data&& other)
     {
-        MdsFree1Dx(&_xd, nullptr);
+        if (this == &other) {
+            return *this;
+        }
 
-        _xd = other._xd;
-        other._xd = MDSDSC_XD_INITIALIZER;
+        _free();
+        _take(other);
 
         _tree = other._tree;
         other._tree = nullptr;
@@ -238,6 +283,24 @@ public:
         return _xd.pointer;
     }
 
+    ///
+    /// The total size of the descriptors and values in bytes, e.g. of a compressed record.
+    ///
+    [[nodiscard]]
+    inline size_t getTotalSize() const {
+        if (_isInline()) {
+            return sizeof(_inline.Descriptor) + _inline.Descriptor.length;
+        }
+
+        size_t size = _xd.l_length;
+        if (_adopted) {
+            for (const Data& child : *_adopted) {
+                size += child.getTotalSize();
+            }
+        }
+        return size;
+    }
+
     [[nodiscard]]
     inline length_t getLength() const {
         mdsdsc_t * dsc = getDescriptor();
@@ -262,8 +325,25 @@ public:
         return (dsc ? dsc->pointer : nullptr);
     }
 
+    ///
+    /// Give up ownership of the XD, which must then be freed with MdsFree1Dx().
+    ///
+    /// A value stored inline or in a ScopedArena, or one that refers to adopted children, is
+    /// copied into a newly allocated XD first.
+    ///
     [[nodiscard]]
     inline mdsdsc_xd_t release() {
+        if (_isInline() || _arena || _adopted) {
+            mdsdsc_xd_t xd = MDSDSC_XD_INITIALIZER;
+            int status = MdsCopyDxXd(getDescriptor(), &xd);
+            if (IS_NOT_OK(status)) {
+                throwException(status);
+            }
+
+            _free();
+            return xd;
+        }
+
         mdsdsc_xd_t tmp = std::move(_xd);
         _xd = MDSDSC_XD_INITIALIZER;
         return tmp;
@@ -554,10 +634,167 @@ protected:
 
     Tree * _tree = nullptr;
 
+    ///
+    /// Store a scalar or string in _inline and point _xd at it, without allocating anything.
+    ///
+    /// @returns false if the value is larger than InlineSize, and nothing was changed.
+    ///
+    inline bool _setInline(dtype_t dtype, const void * value, length_t length)
+    {
+        if (length > InlineSize) {
+            return false;
+        }
+
+        // The value may point into the one being freed, e.g. a substring of this String
+        alignas(16) char buffer[InlineSize];
+        std::memcpy(buffer, value, length);
+
+        _free();
+
+        std::memcpy(_inline.Value, buffer, length);
+        _inline.Descriptor = {
+            .length = length,
+            .dtype = dtype,
+            .class_ = CLASS_S,
+            .pointer = _inline.Value,
+        };
+
+        _xd.pointer = reinterpret_cast<mdsdsc_t *>(&_inline.Descriptor);
+        _xd.l_length = 0;
+        return true;
+    }
+
+    [[nodiscard]]
+    inline bool _isInline() const {
+        return (_xd.pointer == reinterpret_cast<const mdsdsc_t *>(&_inline.Descriptor));
+    }
+
+    ///
+    /// Called whenever the value is freed or replaced, for subclasses that keep anything derived
+    /// from it, e.g. the index of a Dictionary.
+    ///
+    virtual void _onValueReplaced() noexcept { }
+
+    // Free the XD, if it was allocated, must be used instead of MdsFree1Dx(&_xd)
+    inline void _free()
+    {
+        _onValueReplaced();
+
+        if (_isInline()) {
+            _xd = MDSDSC_XD_INITIALIZER;
+        }
+        else if (_arena) {
+            // The arena frees the memory itself once it is destroyed
+            _arena->_unregister(this);
+            _arena = nullptr;
+            _xd = MDSDSC_XD_INITIALIZER;
+        }
+        else {
+            MdsFree1Dx(&_xd, nullptr);
+        }
+
+        // Only after the descriptors that refer to them are gone
+        _adopted.reset();
+    }
+
+    // Take the value from other, which is left empty
+    inline void _take(Data& other)
+    {
+        _xd = other._xd;
+        if (other._isInline()) {
+            _inline = other._inline;
+            _inline.Descriptor.pointer = _inline.Value;
+            _xd.pointer = reinterpret_cast<mdsdsc_t *>(&_inline.Descriptor);
+        }
+        else if (other._arena) {
+            _arena = other._arena;
+            _arena->_replace(&other, this);
+            other._arena = nullptr;
+        }
+
+        _adopted = std::move(other._adopted);
+        other._xd = MDSDSC_XD_INITIALIZER;
+    }
+
+    ///
+    /// Whether child can be moved into this Data by _adopt(), instead of being copied.
+    ///
+    /// Values stored inline or in a ScopedArena move when their Data does, so they can't be
+    /// referred to from another descriptor.
+    ///
+    [[nodiscard]]
+    static inline bool _canAdopt(const Data& child) {
+        return (child.getDescriptor() && !child._isInline() && !child._arena);
+    }
+
+    ///
+    /// Take ownership of child, so that this Data's descriptors can refer to it without copying it,
+    /// e.g. a large array in a Record. It is freed along with this Data's XD.
+    ///
+    /// @returns The descriptor of child, which stays where it is.
+    ///
+    inline mdsdsc_t * _adopt(Data&& child)
+    {
+        assert(_canAdopt(child));
+
+        if (!_adopted) {
+            _adopted = std::make_unique<std::vector<Data>>();
+        }
+
+        _adopted->push_back(std::move(child));
+        return _adopted->back().getDescriptor();
+    }
+
+    ///
+    /// Replace the value with a copy of dsc, in the active ScopedArena if there is one.
+    ///
+    /// The old value is only freed after dsc has been copied, so dsc can refer to it.
+    ///
+    inline void _copyFrom(const mdsdsc_t * dsc)
+    {
+        mdsdsc_xd_t xd = MDSDSC_XD_INITIALIZER;
+
+        ScopedArena * arena = ScopedArena::GetActive();
+        if (arena && arena->_copyInto(dsc, xd)) {
+            _free();
+            _xd = xd;
+            _arena = arena;
+            _arena->_register(this);
+            return;
+        }
+
+        int status = MdsCopyDxXd(dsc, &xd);
+        if (IS_NOT_OK(status)) {
+            throwException(status);
+        }
+
+        _free();
+        _xd = xd;
+    }
+
     int _intrinsic(opcode_t opcode, int narg, mdsdsc_t *list[], mdsdsc_xd_t * out) const;
 
     template <typename ResultType>
     inline ResultType _clone() const {
+        // A copy of an inline value is also inline
+        if constexpr (std::is_default_constructible_v<ResultType>) {
+            if (_isInline()) {
+                ResultType result;
+                Data& data = result;
+                data._setInline(_inline.Descriptor.dtype, _inline.Value, _inline.Descriptor.length);
+                data._tree = _tree;
+                return result;
+            }
+
+            if (ScopedArena::GetActive()) {
+                ResultType result;
+                Data& data = result;
+                data._copyFrom(getDescriptor());
+                data._tree = _tree;
+                return result;
+            }
+        }
+
         mdsdsc_xd_t xd = MDSDSC_XD_INITIALIZER;
         int status = MdsCopyDxXd(getDescriptor(), &xd);
         if (IS_NOT_OK(status)) {
@@ -584,6 +821,47 @@ protected:
     template <typename ResultType>
     ResultType _convertToArray();
 
+private:
+
+    friend class ScopedArena;
+
+    // Set while _xd points into an arena, see _copyFrom()
+    ScopedArena * _arena = nullptr;
+
+    // The other Data in the same arena, see ScopedArena::_live
+    Data * _arenaPrevious = nullptr;
+
+    Data * _arenaNext = nullptr;
+
+    // Children that _xd refers to without owning them, see _adopt()
+    std::unique_ptr<std::vector<Data>> _adopted;
+
+    // Copy the value out of an arena that is being destroyed into a newly allocated XD
+    inline void _promote() noexcept
+    {
+        mdsdsc_xd_t xd = MDSDSC_XD_INITIALIZER;
+        int status = MdsCopyDxXd(_xd.pointer, &xd);
+
+        // There is nowhere to report a failure, so the value is lost instead of left dangling
+        _xd = (IS_NOT_OK(status) ? mdsdsc_xd_t(MDSDSC_XD_INITIALIZER) : xd);
+        _arena = nullptr;
+
+        // The copy includes any adopted children
+        _adopted.reset();
+
+        // Anything derived from the old descriptors, e.g. a Dictionary's index, refers to the arena
+        _onValueReplaced();
+    }
+
+    // Only initialized while _xd points at it, see _setInline()
+    struct
+    {
+        mdsdsc_s_t Descriptor;
+
+        alignas(16) char Value[InlineSize];
+
+    } _inline;
+
 }; // class Data
 
 static const Data EmptyData;
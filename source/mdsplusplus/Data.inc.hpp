@@ -4,6 +4,8 @@
 #include "Data.hpp"
 #include "DataView.hpp"
 #include "Tree.hpp"
+#include "Trace.hpp"
+#include "Timebase.hpp"
 
 namespace mdsplus {
 
@@ -220,8 +222,12 @@ ResultType Data::Compile(const std::string& expression, const ArgTypes& ...args)
         dscList.push_back(arg.getDescriptor());
     }
 
+    TraceScope span(TraceEvent::TDI, expression);
+
     mdsdsc_xd_t out = MDSDSC_XD_INITIALIZER;
     int status = TdiIntrinsic(OPC_COMPILE, dscList.size(), dscList.data(), &out);
+    span.setStatus(status);
+    span.addBytes(out.l_length);
     if (IS_NOT_OK(status)) {
         throwException(status);
     }
@@ -240,8 +246,12 @@ ResultType Data::Execute(const std::string& expression, const ArgTypes& ...args)
         dscList.push_back(arg.getDescriptor());
     }
 
+    TraceScope span(TraceEvent::TDI, expression);
+
     mdsdsc_xd_t out = MDSDSC_XD_INITIALIZER;
     int status = TdiIntrinsic(OPC_EXECUTE, dscList.size(), dscList.data(), &out);
+    span.setStatus(status);
+    span.addBytes(out.l_length);
     if (IS_NOT_OK(status)) {
         throwException(status);
     }
@@ -268,6 +278,15 @@ inline ResultType Data::_convertToScalar()
 {
     int status;
 
+    // Move an inline or arena value across as it is, instead of allocating an XD for it in release()
+    if ((_isInline() || _arena) &&
+        getClass() == ResultType::__class &&
+        getDType() == ResultType::__dtype) {
+        ResultType result;
+        static_cast<Data&>(result) = std::move(*this);
+        return result;
+    }
+
     mdsdsc_xd_t xd = release();
     mdsdsc_t * dsc = xd.pointer;
 
@@ -318,6 +337,56 @@ inline ResultType Data::_convertToArray()
 {
     int status;
 
+    // Uniform ranges and dimensions are generated natively, instead of being evaluated by DATA()
+    if constexpr (std::is_floating_point_v<typename ResultType::__ctype>) {
+        std::optional<Timebase> timebase = Timebase::FromDescriptor(getDescriptor());
+        if (timebase) {
+            using CType = typename ResultType::__ctype;
+
+            mdsdsc_a_t dsc = {
+                .length = sizeof(CType),
+                .dtype = dtype_t(ResultType::__dtype),
+                .class_ = CLASS_A,
+                .pointer = nullptr,
+                .scale = 0,
+                .digits = 0,
+                .aflags = aflags_t{
+                    .binscale = false,
+                    .redim = true,
+                    .column = true,
+                    .coeff = false,
+                    .bounds = false,
+                },
+                .dimct = 1,
+                .arsize = arsize_t(timebase->size() * sizeof(CType)),
+            };
+
+            // Allocate the array without copying anything into it, and then fill it in place
+            mdsdsc_xd_t xd = MDSDSC_XD_INITIALIZER;
+            length_t length = sizeof(CType);
+            dtype_t dtype = dsc.dtype;
+            status = MdsGet1DxA(&dsc, &length, &dtype, &xd);
+            if (IS_NOT_OK(status)) {
+                throwException(status);
+            }
+
+            timebase->getTimes(reinterpret_cast<CType *>(reinterpret_cast<mdsdsc_a_t *>(xd.pointer)->pointer));
+
+            Tree * tree = getTree();
+            _free();
+            return ResultType(std::move(xd), tree);
+        }
+    }
+
+    // Move an arena value across as it is, instead of allocating an XD for it in release()
+    if (_arena &&
+        getClass() == ResultType::__class &&
+        getDType() == ResultType::__dtype) {
+        ResultType result;
+        static_cast<Data&>(result) = std::move(*this);
+        return result;
+    }
+
     mdsdsc_xd_t xd = release();
     mdsdsc_t * dsc = xd.pointer;
 
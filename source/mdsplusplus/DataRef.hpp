@@ -0,0 +1,322 @@
+#ifndef MDSPLUS_DATA_REF_HPP
+#define MDSPLUS_DATA_REF_HPP
+
+#include "Data.hpp"
+
+#include <cstring>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#if __has_include(<span>)
+    #include <span>
+#endif
+
+extern "C" {
+
+    // Needed for mdsdsc*_t, <dtypedef.h>, <classdef.h>
+    #include <mdsdescrip.h>
+
+} // extern "C"
+
+namespace mdsplus {
+
+///
+/// A non-owning reference to a descriptor inside another Data, e.g. a value in a List or Dictionary.
+///
+/// Nothing is copied to create one, and it is only valid for as long as the Data it refers to is
+/// alive and unmodified. Use clone() to get a Data that owns a copy of the value.
+///
+class DataRef
+{
+public:
+
+    DataRef() = default;
+
+    inline DataRef(mdsdsc_t * dsc, Tree * tree = nullptr)
+        : _dsc(dsc)
+        , _tree(tree)
+    { }
+
+    [[nodiscard]]
+    inline mdsdsc_t * getDescriptor() const {
+        return _dsc;
+    }
+
+    [[nodiscard]]
+    inline Tree * getTree() const {
+        return _tree;
+    }
+
+    ///
+    /// False for a DataRef that doesn't refer to anything, e.g. a key that wasn't found.
+    ///
+    inline explicit operator bool() const {
+        return (_dsc != nullptr);
+    }
+
+    [[nodiscard]]
+    inline length_t getLength() const {
+        return (_dsc ? _dsc->length : 0);
+    }
+
+    [[nodiscard]]
+    inline Class getClass() const {
+        return (_dsc ? Class(_dsc->class_) : Class::Missing);
+    }
+
+    [[nodiscard]]
+    inline DType getDType() const {
+        return (_dsc ? DType(_dsc->dtype) : DType::Missing);
+    }
+
+    [[nodiscard]]
+    inline void * getPointer() const {
+        return (_dsc ? _dsc->pointer : nullptr);
+    }
+
+    ///
+    /// The text of a string, without copying it, or an empty string_view if this isn't a string.
+    ///
+    [[nodiscard]]
+    inline std::string_view getStringView() const {
+        if (_dsc && _dsc->dtype == DTYPE_T && (_dsc->class_ == CLASS_S || _dsc->class_ == CLASS_D)) {
+            return std::string_view(_dsc->pointer, _dsc->length);
+        }
+
+        return {};
+    }
+
+    ///
+    /// Copy the value into a Data that owns it, converted to ResultType.
+    ///
+    template <typename ResultType = Data>
+    [[nodiscard]]
+    inline ResultType clone() const {
+        mdsdsc_xd_t xd = MDSDSC_XD_INITIALIZER;
+        int status = MdsCopyDxXd(_dsc, &xd);
+        if (IS_NOT_OK(status)) {
+            throwException(status);
+        }
+
+        return Data(std::move(xd), _tree).releaseAndConvert<ResultType>();
+    }
+
+protected:
+
+    mdsdsc_t * _dsc = nullptr;
+
+    Tree * _tree = nullptr;
+
+}; // class DataRef
+
+///
+/// A non-owning reference to a scalar, e.g. a CLASS_S Int32 or a NID.
+///
+class ScalarRef : public DataRef
+{
+public:
+
+    using DataRef::DataRef;
+
+    ///
+    /// Whether the value is stored as CType, with no conversion.
+    ///
+    template <typename CType>
+    [[nodiscard]]
+    inline bool holds() const {
+        return (_dsc && _dsc->dtype == _getDTypeForCType<CType>() && _dsc->length == sizeof(CType));
+    }
+
+    ///
+    /// Read the value in place, it must be stored as CType, see holds().
+    ///
+    template <typename CType>
+    [[nodiscard]]
+    inline CType getValue() const {
+        if (!holds<CType>()) {
+            throw TdiInvalidDataType();
+        }
+
+        // The value is not necessarily aligned
+        CType value;
+        std::memcpy(&value, _dsc->pointer, sizeof(value));
+        return value;
+    }
+
+}; // class ScalarRef
+
+///
+/// A non-owning reference to an array, the values are read where they are.
+///
+class ArrayRef : public DataRef
+{
+public:
+
+    using DataRef::DataRef;
+
+    [[nodiscard]]
+    inline mdsdsc_a_t * getArrayDescriptor() const {
+        return reinterpret_cast<mdsdsc_a_t *>(_dsc);
+    }
+
+    ///
+    /// The number of elements in the array.
+    ///
+    [[nodiscard]]
+    inline size_t size() const {
+        mdsdsc_a_t * dsc = getArrayDescriptor();
+        return (dsc && dsc->length > 0 ? dsc->arsize / dsc->length : 0);
+    }
+
+    [[nodiscard]]
+    inline std::vector<uint32_t> getDims() const {
+        array_coeff * dsc = reinterpret_cast<array_coeff *>(_dsc);
+        if (!dsc) {
+            return {};
+        }
+
+        if (!dsc->aflags.coeff) {
+            return { uint32_t(size()) };
+        }
+
+        return std::vector<uint32_t>(dsc->m, dsc->m + dsc->dimct);
+    }
+
+    ///
+    /// Whether the values are stored as CType, with no conversion.
+    ///
+    template <typename CType>
+    [[nodiscard]]
+    inline bool holds() const {
+        return (_dsc && _dsc->dtype == _getDTypeForCType<CType>() && _dsc->length == sizeof(CType));
+    }
+
+    ///
+    /// A pointer to the values where they are, they must be stored as CType, see holds().
+    ///
+    template <typename CType>
+    [[nodiscard]]
+    inline const CType * getValues() const {
+        if (!holds<CType>()) {
+            throw TdiInvalidDataType();
+        }
+
+        return reinterpret_cast<const CType *>(_dsc->pointer);
+    }
+
+    #ifdef __cpp_lib_span
+
+        template <typename CType>
+        [[nodiscard]]
+        inline std::span<const CType> getSpan() const {
+            return std::span<const CType>(getValues<CType>(), size());
+        }
+
+    #endif
+
+    ///
+    /// The string at index in an array of strings, without the padding if trim is true.
+    ///
+    /// Throws TdiInvalidDataType if the values aren't strings, and TdiBadIndex if index is out of range.
+    ///
+    [[nodiscard]]
+    inline std::string_view getStringViewAt(size_t index, bool trim = true) const {
+        if (_dsc && _dsc->dtype != DTYPE_T) {
+            throw TdiInvalidDataType();
+        }
+
+        if (index >= size()) {
+            throw TdiBadIndex();
+        }
+
+        std::string_view value(_dsc->pointer + (index * _dsc->length), _dsc->length);
+        if (trim) {
+            size_t end = value.find_last_not_of(' ');
+            value = value.substr(0, (end == std::string_view::npos ? 0 : end + 1));
+        }
+        return value;
+    }
+
+}; // class ArrayRef
+
+///
+/// A non-owning reference to a record, e.g. a Signal or Function.
+///
+class RecordRef : public DataRef
+{
+public:
+
+    using DataRef::DataRef;
+
+    [[nodiscard]]
+    inline mdsdsc_r_t * getRecordDescriptor() const {
+        return reinterpret_cast<mdsdsc_r_t *>(_dsc);
+    }
+
+    [[nodiscard]]
+    inline size_t getNumDescriptors() const {
+        mdsdsc_r_t * dsc = getRecordDescriptor();
+        return (dsc ? dsc->ndesc : 0);
+    }
+
+    ///
+    /// The child at index, which doesn't refer to anything if it is missing.
+    ///
+    [[nodiscard]]
+    inline DataRef getDescriptorAt(size_t index) const {
+        mdsdsc_r_t * dsc = getRecordDescriptor();
+        return DataRef((dsc && index < dsc->ndesc ? dsc->dscptrs[index] : nullptr), _tree);
+    }
+
+    ///
+    /// The opcode of a Function, or 0 for any other record.
+    ///
+    [[nodiscard]]
+    inline opcode_t getOpcode() const {
+        mdsdsc_r_t * dsc = getRecordDescriptor();
+        if (!dsc || dsc->dtype != DTYPE_FUNCTION || !dsc->pointer) {
+            return 0;
+        }
+
+        opcode_t opcode;
+        std::memcpy(&opcode, dsc->pointer, sizeof(opcode));
+        return opcode;
+    }
+
+}; // class RecordRef
+
+///
+/// A non-owning reference to a List, Tuple or Dictionary.
+///
+class APDRef : public DataRef
+{
+public:
+
+    using DataRef::DataRef;
+
+    [[nodiscard]]
+    inline size_t size() const {
+        mdsdsc_a_t * dsc = reinterpret_cast<mdsdsc_a_t *>(_dsc);
+        return (dsc ? dsc->arsize / sizeof(mdsdsc_t *) : 0);
+    }
+
+    [[nodiscard]]
+    inline DataRef at(size_t index) const {
+        if (index >= size()) {
+            throw TdiBadIndex();
+        }
+
+        return DataRef(reinterpret_cast<mdsdsc_t **>(_dsc->pointer)[index], _tree);
+    }
+
+    [[nodiscard]]
+    inline DataRef operator[](size_t index) const {
+        return at(index);
+    }
+
+}; // class APDRef
+
+} // namespace mdsplus
+
+#endif // MDSPLUS_DATA_REF_HPP
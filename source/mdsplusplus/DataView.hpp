@@ -2,13 +2,17 @@
 #define MDSPLUS_DATA_VIEW_HPP
 
 #include "Data.hpp"
+#include "DataRef.hpp"
 #include "TreeNode.hpp"
 
 #include <type_traits>
-#include <typeindex>
 #include <complex>
 #include <vector>
 
+#if __has_include(<mdspan>)
+    #include <mdspan>
+#endif
+
 extern "C" {
 
     // Needed for mdsdsc*_t, <dtypedef.h>, <classdef.h>
@@ -72,6 +76,17 @@ public:
         , _tree(value.getTree())
     { }
 
+    // Same as for Data, a reference to the descriptor it refers to
+    inline DataView(const DataRef& value)
+        : _dsc(array_coeff{
+            .length = 0,
+            .dtype = DTYPE_DSC,
+            .class_ = CLASS_S,
+            .pointer = reinterpret_cast<char *>(value.getDescriptor()),
+        })
+        , _tree(value.getTree())
+    { }
+
     template <typename CType,
         typename std::enable_if<is_valid_ctype<CType>::value, bool>::type = true>
     inline DataView(const std::vector<CType>& values)
@@ -96,8 +111,54 @@ public:
         })
     { }
 
+    // Refers to count values without copying them, e.g. one channel of a larger block
+    template <typename CType,
+        typename std::enable_if<is_valid_ctype<CType>::value, bool>::type = true>
+    inline DataView(const CType * values, uint32_t count)
+        : _dsc(array_coeff{
+            .length = sizeof(CType),
+            .dtype = _getDTypeForCType<CType>(),
+            .class_ = CLASS_A,
+            .pointer = const_cast<char *>(reinterpret_cast<const char *>(values)),
+            .scale = 0,
+            .digits = 0,
+            .aflags = aflags_t{
+                .binscale = false,
+                .redim = true,
+                .column = true,
+                .coeff = true,
+                .bounds = false,
+            },
+            .dimct = 1,
+            .arsize = arsize_t(count * sizeof(CType)),
+            .a0 = const_cast<char *>(reinterpret_cast<const char *>(values)),
+            .m = { count, 0, 0, 0, 0, 0, 0, 0 },
+        })
+    { }
+
+    ///
+    /// Refers to a multi-dimensional array without copying it, e.g. a camera frame.
+    ///
+    /// The dimensions are in MDSplus order, with the first varying fastest and the last being
+    /// the rows of a segment, so a frame of width x height is { width, height }.
+    ///
+    template <typename CType,
+        typename std::enable_if<is_valid_ctype<CType>::value, bool>::type = true>
+    inline DataView(const CType * values, const std::vector<uint32_t>& dims)
+    {
+        _setArray(values, dims.data(), dims.size());
+    }
+
     #ifdef __cpp_lib_span
 
+        template <typename CType,
+            typename std::enable_if<is_valid_ctype<CType>::value, bool>::type = true>
+        inline DataView(std::span<const CType> values, const std::vector<uint32_t>& dims)
+        {
+            _checkCount(values.size(), dims);
+            _setArray(values.data(), dims.data(), dims.size());
+        }
+
         template <typename CType,
             typename std::enable_if<is_valid_ctype<CType>::value, bool>::type = true>
         inline DataView(std::span<const CType> values)
@@ -121,9 +182,50 @@ public:
                 .m = { static_cast<uint32_t>(values.size()), 0, 0, 0, 0, 0, 0, 0 },
             })
         { }
-        
+
     #endif
 
+    #ifdef __cpp_lib_mdspan
+
+        ///
+        /// Refers to the memory of an mdspan without copying it.
+        ///
+        /// A std::layout_right (C order) mdspan has its extents reversed into MDSplus order, so the
+        /// first extent becomes the rows of a segment. A std::layout_left mdspan keeps its extents.
+        ///
+        template <typename ElementType, typename Extents, typename Layout, typename Accessor,
+            typename std::enable_if<is_valid_ctype<std::remove_const_t<ElementType>>::value, bool>::type = true>
+        inline DataView(std::mdspan<ElementType, Extents, Layout, Accessor> values)
+        {
+            static_assert(
+                std::is_same_v<Layout, std::layout_right> || std::is_same_v<Layout, std::layout_left>,
+                "Only contiguous mdspan layouts can be passed without copying"
+            );
+            static_assert(
+                std::is_same_v<Accessor, std::default_accessor<ElementType>>,
+                "Only mdspans over plain memory can be passed without copying"
+            );
+            static_assert(Extents::rank() > 0 && Extents::rank() <= MAX_DIMS);
+
+            uint32_t dims[MAX_DIMS] = {};
+            for (size_t i = 0; i < Extents::rank(); ++i) {
+                if constexpr (std::is_same_v<Layout, std::layout_right>) {
+                    dims[i] = uint32_t(values.extent(Extents::rank() - 1 - i));
+                }
+                else {
+                    dims[i] = uint32_t(values.extent(i));
+                }
+            }
+
+            _setArray(
+                static_cast<const std::remove_const_t<ElementType> *>(values.data_handle()),
+                dims,
+                Extents::rank()
+            );
+        }
+
+    #endif // __cpp_lib_mdspan
+
     template <typename CType,
         typename std::enable_if<is_valid_ctype<CType>::value, bool>::type = true>
     inline DataView(const CType& value)
@@ -186,48 +288,53 @@ private:
     Tree * _tree = nullptr;
 
     template <typename CType>
-    inline dtype_t _getDTypeForCType()
+    inline void _setArray(const CType * values, const uint32_t * dims, size_t dimCount)
     {
-        std::type_index id = typeid(CType);
-        if (id == typeid(int8_t)) {
-            return DTYPE_B;
-        }
-        else if (id == typeid(int16_t)) {
-            return DTYPE_W;
-        }
-        else if (id == typeid(int32_t)) {
-            return DTYPE_L;
+        if (dimCount == 0 || dimCount > MAX_DIMS) {
+            throwException(TreeFAILURE);
         }
-        else if (id == typeid(int64_t)) {
-            return DTYPE_Q;
-        }
-        else if (id == typeid(uint8_t)) {
-            return DTYPE_BU;
-        }
-        else if (id == typeid(uint16_t)) {
-            return DTYPE_WU;
-        }
-        else if (id == typeid(uint32_t)) {
-            return DTYPE_LU;
-        }
-        else if (id == typeid(uint64_t)) {
-            return DTYPE_QU;
-        }
-        else if (id == typeid(float)) {
-            return DTYPE_FS;
-        }
-        else if (id == typeid(double)) {
-            return DTYPE_FT;
+
+        uint32_t count = 1;
+        for (size_t i = 0; i < dimCount; ++i) {
+            count *= dims[i];
         }
-        else if (id == typeid(std::complex<float>)) {
-            return DTYPE_FSC;
+
+        _dsc = array_coeff{
+            .length = sizeof(CType),
+            .dtype = _getDTypeForCType<CType>(),
+            .class_ = CLASS_A,
+            .pointer = const_cast<char *>(reinterpret_cast<const char *>(values)),
+            .scale = 0,
+            .digits = 0,
+            .aflags = aflags_t{
+                .binscale = false,
+                .redim = true,
+                .column = true,
+                .coeff = true,
+                .bounds = false,
+            },
+            .dimct = dimct_t(dimCount),
+            .arsize = arsize_t(count * sizeof(CType)),
+            .a0 = const_cast<char *>(reinterpret_cast<const char *>(values)),
+            .m = { 0, 0, 0, 0, 0, 0, 0, 0 },
+        };
+
+        for (size_t i = 0; i < dimCount; ++i) {
+            _dsc.m[i] = dims[i];
         }
-        else if (id == typeid(std::complex<double>)) {
-            return DTYPE_FTC;
+    }
+
+    static inline void _checkCount(size_t count, const std::vector<uint32_t>& dims)
+    {
+        size_t expected = 1;
+        for (uint32_t dim : dims) {
+            expected *= dim;
         }
 
-        return DTYPE_MISSING;
-    };
+        if (count != expected) {
+            throwException(TreeFAILURE);
+        }
+    }
 
 };
 
@@ -0,0 +1,160 @@
+#ifndef MDSPLUS_DATA_VISITOR_HPP
+#define MDSPLUS_DATA_VISITOR_HPP
+
+#include "Data.hpp"
+#include "DataRef.hpp"
+
+extern "C" {
+
+    // Needed for mdsdsc*_t, <dtypedef.h>, <classdef.h>
+    #include <mdsdescrip.h>
+
+} // extern "C"
+
+namespace mdsplus {
+
+///
+/// Callbacks for walk(), override the ones needed.
+///
+/// Every callback receives a borrowed reference into the descriptors being walked, so nothing is
+/// copied, and the references are only valid until walk() returns. Use clone() on one to keep it.
+///
+class DataVisitor
+{
+public:
+
+    virtual ~DataVisitor() = default;
+
+    ///
+    /// Called before the children of a record, e.g. a Signal.
+    ///
+    /// @returns false to skip the children, and endRecord().
+    ///
+    virtual bool visitRecord(const RecordRef& record) {
+        return true;
+    }
+
+    virtual void endRecord(const RecordRef& record) { }
+
+    ///
+    /// Called before the elements of a List, Tuple or Dictionary.
+    ///
+    /// @returns false to skip the elements, and endAPD().
+    ///
+    virtual bool visitAPD(const APDRef& apd) {
+        return true;
+    }
+
+    virtual void endAPD(const APDRef& apd) { }
+
+    ///
+    /// Called for every scalar that isn't a string, including NIDs.
+    ///
+    virtual void visitScalar(const ScalarRef& scalar) { }
+
+    ///
+    /// Called for strings, and also paths and identifiers, see DataRef::getDType().
+    ///
+    virtual void visitString(const DataRef& string, std::string_view value) { }
+
+    virtual void visitArray(const ArrayRef& array) { }
+
+    ///
+    /// Called for a compressed array, which can't be read without decompressing a copy of it.
+    ///
+    virtual void visitCompressedArray(const DataRef& array) { }
+
+    ///
+    /// Called for an empty child, e.g. the raw value of most Signals.
+    ///
+    virtual void visitMissing() { }
+
+    ///
+    /// Called for anything else.
+    ///
+    virtual void visitOther(const DataRef& other) { }
+
+}; // class DataVisitor
+
+///
+/// Walk every descriptor under ref depth first, calling visitor for each one.
+///
+/// References to descriptors and XDs are followed without being visited.
+///
+inline void walk(const DataRef& ref, DataVisitor& visitor)
+{
+    mdsdsc_t * dsc = ref.getDescriptor();
+    while (dsc) {
+        mdsdsc_t * next = _unwrapDescriptor(dsc);
+        if (dsc->class_ == CLASS_XD || dsc->class_ == CLASS_XS) {
+            next = reinterpret_cast<mdsdsc_xd_t *>(dsc)->pointer;
+        }
+
+        if (next == dsc) {
+            break;
+        }
+        dsc = next;
+    }
+
+    if (!dsc) {
+        visitor.visitMissing();
+        return;
+    }
+
+    Tree * tree = ref.getTree();
+
+    switch (dsc->class_) {
+    case CLASS_S:
+    case CLASS_D:
+        if (dsc->dtype == DTYPE_T || dsc->dtype == DTYPE_PATH || dsc->dtype == DTYPE_IDENT) {
+            visitor.visitString(DataRef(dsc, tree), std::string_view(dsc->pointer, dsc->length));
+        }
+        else {
+            visitor.visitScalar(ScalarRef(dsc, tree));
+        }
+        break;
+
+    case CLASS_A:
+        visitor.visitArray(ArrayRef(dsc, tree));
+        break;
+
+    case CLASS_CA:
+        visitor.visitCompressedArray(DataRef(dsc, tree));
+        break;
+
+    case CLASS_APD: {
+        APDRef apd(dsc, tree);
+        if (visitor.visitAPD(apd)) {
+            for (size_t i = 0; i < apd.size(); ++i) {
+                walk(apd[i], visitor);
+            }
+            visitor.endAPD(apd);
+        }
+        break;
+    }
+
+    case CLASS_R: {
+        RecordRef record(dsc, tree);
+        if (visitor.visitRecord(record)) {
+            for (size_t i = 0; i < record.getNumDescriptors(); ++i) {
+                walk(record.getDescriptorAt(i), visitor);
+            }
+            visitor.endRecord(record);
+        }
+        break;
+    }
+
+    default:
+        visitor.visitOther(DataRef(dsc, tree));
+        break;
+    }
+}
+
+inline void walk(const Data& data, DataVisitor& visitor)
+{
+    walk(DataRef(data.getDescriptor(), data.getTree()), visitor);
+}
+
+} // namespace mdsplus
+
+#endif // MDSPLUS_DATA_VISITOR_HPP
@@ -0,0 +1,92 @@
+#ifndef MDSPLUS_DECIMATE_HPP
+#define MDSPLUS_DECIMATE_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+namespace mdsplus {
+
+///
+/// The minimum, maximum and mean of each group of samples, as computed by decimate().
+///
+template <typename ValueType>
+struct Decimated
+{
+    std::vector<ValueType> Min = {};
+
+    std::vector<ValueType> Max = {};
+
+    std::vector<double> Mean = {};
+
+}; // struct Decimated
+
+///
+/// Reduce every factor samples to their minimum, maximum and mean, for overview plots.
+///
+/// The last group is shorter if count is not a multiple of factor. The inner loops work
+/// on a fixed number of independent lanes, so that compilers can vectorize them without
+/// needing to reorder floating point additions.
+///
+template <typename ValueType>
+Decimated<ValueType> decimate(const ValueType * values, size_t count, size_t factor)
+{
+    static constexpr size_t Lanes = 8;
+
+    Decimated<ValueType> result;
+    if (count == 0 || factor == 0) {
+        return result;
+    }
+
+    size_t groups = (count + factor - 1) / factor;
+    result.Min.resize(groups);
+    result.Max.resize(groups);
+    result.Mean.resize(groups);
+
+    for (size_t group = 0; group < groups; ++group) {
+        const ValueType * first = values + group * factor;
+        size_t size = std::min(factor, count - group * factor);
+
+        ValueType min[Lanes];
+        ValueType max[Lanes];
+        double sum[Lanes];
+        for (size_t lane = 0; lane < Lanes; ++lane) {
+            min[lane] = first[0];
+            max[lane] = first[0];
+            sum[lane] = 0.0;
+        }
+
+        size_t i = 0;
+        for (; i + Lanes <= size; i += Lanes) {
+            for (size_t lane = 0; lane < Lanes; ++lane) {
+                ValueType value = first[i + lane];
+                min[lane] = (value < min[lane] ? value : min[lane]);
+                max[lane] = (value > max[lane] ? value : max[lane]);
+                sum[lane] += double(value);
+            }
+        }
+
+        // Remainder that doesn't fill all of the lanes
+        for (size_t lane = 0; i < size; ++i, ++lane) {
+            ValueType value = first[i];
+            min[lane] = (value < min[lane] ? value : min[lane]);
+            max[lane] = (value > max[lane] ? value : max[lane]);
+            sum[lane] += double(value);
+        }
+
+        result.Min[group] = *std::min_element(min, min + Lanes);
+        result.Max[group] = *std::max_element(max, max + Lanes);
+
+        double total = 0.0;
+        for (size_t lane = 0; lane < Lanes; ++lane) {
+            total += sum[lane];
+        }
+        result.Mean[group] = total / double(size);
+    }
+
+    return result;
+}
+
+} // namespace mdsplus
+
+#endif // MDSPLUS_DECIMATE_HPP
@@ -12,13 +12,10 @@ inline void Device::addParts(std::vector<DevicePart>&& parts) const
 
     for (const auto& part : parts)
     {
-        printf("Adding %s (%s)\n", part.Path.c_str(), to_string(part.Usage).c_str());
         addNode(part.Path, part.Usage);
     }
 
     for (const auto& part : parts) {
-
-        printf("Setting %s (%s)\n", part.Path.c_str(), to_string(part.Usage).c_str());
         auto node = getNode(part.Path);
         
         if (!part.ValueExpression.empty()) {
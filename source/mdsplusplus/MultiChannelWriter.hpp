@@ -0,0 +1,179 @@
+#ifndef MDSPLUS_MULTI_CHANNEL_WRITER_HPP
+#define MDSPLUS_MULTI_CHANNEL_WRITER_HPP
+
+#include "TreeNode.hpp"
+#include "DataView.hpp"
+#include "Compression.hpp"
+
+#include <vector>
+
+namespace mdsplus {
+
+///
+/// Writes one segment to each of a list of channels from a single block of samples.
+///
+/// The block is laid out channel-major, so the samples of each channel are contiguous and are
+/// passed to treeshr without being copied. The start, end and dimension descriptors are built
+/// once per block and shared by every channel.
+///
+/// Every channel is written from the calling thread with the channels' own Tree, since a Tree
+/// cannot be written from more than one thread, and every subtree has a single datafile.
+///
+/// With compression enabled, makeSegment() first compresses every channel on getThreadCount()
+/// threads, with no Tree involved, and then writes the compressed records. This spreads the
+/// compression across cores, where treeshr would compress the channels one at a time while
+/// holding the datafile.
+///
+class MultiChannelWriter
+{
+public:
+
+    inline MultiChannelWriter(const std::vector<TreeNode>& channels)
+        : _channels(channels)
+        , _compressionMethods(channels.size(), CompressionMethod::Default)
+    { }
+
+    [[nodiscard]]
+    inline const std::vector<TreeNode>& getChannels() const {
+        return _channels;
+    }
+
+    [[nodiscard]]
+    inline size_t getThreadCount() const {
+        return _threadCount;
+    }
+
+    ///
+    /// Set the number of threads used to compress the channels, 1 compresses them all on the calling thread.
+    ///
+    inline void setThreadCount(size_t threadCount) {
+        _threadCount = std::max<size_t>(threadCount, 1);
+    }
+
+    [[nodiscard]]
+    inline bool isCompressionEnabled() const {
+        return _compressionEnabled;
+    }
+
+    ///
+    /// Compress segments on the worker threads in makeSegment(), instead of leaving it to treeshr.
+    ///
+    inline void setCompressionEnabled(bool enabled) {
+        _compressionEnabled = enabled;
+    }
+
+    [[nodiscard]]
+    inline CompressionMethod getCompressionMethod(size_t channel) const {
+        return _compressionMethods.at(channel);
+    }
+
+    ///
+    /// Set the compression method of one channel, CompressionMethod::Default uses the node's own method.
+    ///
+    inline void setCompressionMethod(size_t channel, CompressionMethod method) {
+        _compressionMethods.at(channel) = method;
+    }
+
+    inline void setCompressionMethod(CompressionMethod method) {
+        std::fill(_compressionMethods.begin(), _compressionMethods.end(), method);
+    }
+
+    ///
+    /// The totals for every segment compressed since the writer was created, or since resetCompressionStats().
+    ///
+    [[nodiscard]]
+    inline const CompressionStats& getCompressionStats() const {
+        return _compressionStats;
+    }
+
+    inline void resetCompressionStats() {
+        _compressionStats = {};
+    }
+
+    ///
+    /// Write one segment to every channel, with the same start, end and dimension.
+    ///
+    /// @param block getChannels().size() * samples values, where channel i starts at block + i * samples.
+    /// @param samples The number of samples per channel.
+    ///
+    template <
+        typename StartIndexType,
+        typename EndIndexType,
+        typename DimensionType,
+        typename ValueType
+    >
+    void makeSegment(
+        const StartIndexType& startIndex,
+        const EndIndexType& endIndex,
+        const DimensionType& dimension,
+        const ValueType * block,
+        uint32_t samples,
+        int rowsFilled = -1
+    );
+
+    template <
+        typename StartIndexType,
+        typename EndIndexType,
+        typename DimensionType,
+        typename ValueType
+    >
+    inline void makeSegment(
+        const StartIndexType& startIndex,
+        const EndIndexType& endIndex,
+        const DimensionType& dimension,
+        const std::vector<ValueType>& block,
+        int rowsFilled = -1
+    ) {
+        makeSegment(startIndex, endIndex, dimension, block.data(), _getSamples(block.size()), rowsFilled);
+    }
+
+    ///
+    /// Write one timestamped segment to every channel, with the same timestamps.
+    ///
+    /// @param timestamps One timestamp per sample.
+    /// @param block getChannels().size() * samples values, where channel i starts at block + i * samples.
+    ///
+    template <typename ValueType>
+    void makeTimestampedSegment(
+        const int64_t * timestamps,
+        const ValueType * block,
+        uint32_t samples,
+        int rowsFilled = -1
+    );
+
+    template <typename ValueType>
+    inline void makeTimestampedSegment(
+        const std::vector<int64_t>& timestamps,
+        const std::vector<ValueType>& block,
+        int rowsFilled = -1
+    ) {
+        uint32_t samples = _getSamples(block.size());
+        if (timestamps.size() != samples) {
+            throwException(TreeFAILURE);
+        }
+        makeTimestampedSegment(timestamps.data(), block.data(), samples, rowsFilled);
+    }
+
+private:
+
+    std::vector<TreeNode> _channels;
+
+    size_t _threadCount = 1;
+
+    bool _compressionEnabled = false;
+
+    std::vector<CompressionMethod> _compressionMethods;
+
+    CompressionStats _compressionStats;
+
+    uint32_t _getSamples(size_t blockSize) const;
+
+    // Compress every channel's share of the block, split between _threadCount threads
+    template <typename ValueType>
+    std::vector<Data> _compressChannels(const ValueType * block, uint32_t samples);
+
+}; // class MultiChannelWriter
+
+} // namespace mdsplus
+
+#endif // MDSPLUS_MULTI_CHANNEL_WRITER_HPP
@@ -0,0 +1,140 @@
+#ifndef MDSPLUS_MULTI_CHANNEL_WRITER_INC_HPP
+#define MDSPLUS_MULTI_CHANNEL_WRITER_INC_HPP
+
+#include "MultiChannelWriter.hpp"
+#include "TreeNode.hpp"
+#include "DataView.hpp"
+
+#include <chrono>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+namespace mdsplus {
+
+template <
+    typename StartIndexType,
+    typename EndIndexType,
+    typename DimensionType,
+    typename ValueType
+>
+void MultiChannelWriter::makeSegment(
+    const StartIndexType& startIndex,
+    const EndIndexType& endIndex,
+    const DimensionType& dimension,
+    const ValueType * block,
+    uint32_t samples,
+    int rowsFilled /*= -1*/
+) {
+    // Built once, and copied by reference into each channel's makeSegment()
+    DataView argStartIndex(startIndex);
+    DataView argEndIndex(endIndex);
+    DataView argDimension(dimension);
+
+    if (_compressionEnabled) {
+        std::vector<Data> compressed = _compressChannels(block, samples);
+
+        // The compressed records no longer have a shape to count the rows from
+        if (rowsFilled < 0) {
+            rowsFilled = int(samples);
+        }
+
+        for (size_t i = 0; i < _channels.size(); ++i) {
+            _channels[i].makeSegment(argStartIndex, argEndIndex, argDimension, compressed[i], -1, rowsFilled);
+        }
+        return;
+    }
+
+    for (size_t i = 0; i < _channels.size(); ++i) {
+        DataView argValues(block + i * samples, samples);
+        _channels[i].makeSegment(argStartIndex, argEndIndex, argDimension, argValues, -1, rowsFilled);
+    }
+}
+
+template <typename ValueType>
+void MultiChannelWriter::makeTimestampedSegment(
+    const int64_t * timestamps,
+    const ValueType * block,
+    uint32_t samples,
+    int rowsFilled /*= -1*/
+) {
+    for (size_t i = 0; i < _channels.size(); ++i) {
+        DataView argValues(block + i * samples, samples);
+
+        // makeTimestampedSegment() takes a non-const pointer, but doesn't modify the timestamps
+        _channels[i].makeTimestampedSegment(const_cast<int64_t *>(timestamps), argValues, -1, rowsFilled);
+    }
+}
+
+inline uint32_t MultiChannelWriter::_getSamples(size_t blockSize) const
+{
+    if (_channels.empty() || blockSize % _channels.size() != 0) {
+        throwException(TreeFAILURE);
+    }
+
+    return uint32_t(blockSize / _channels.size());
+}
+
+template <typename ValueType>
+std::vector<Data> MultiChannelWriter::_compressChannels(const ValueType * block, uint32_t samples)
+{
+    // Reading the NCI uses the channels' Tree, so do it before starting any threads
+    std::vector<CompressionMethod> methods = _compressionMethods;
+    for (size_t i = 0; i < _channels.size(); ++i) {
+        if (methods[i] == CompressionMethod::Default) {
+            methods[i] = CompressionMethod(_channels[i].getCompressionMethod());
+        }
+    }
+
+    std::vector<Data> compressed(_channels.size());
+    std::vector<uint64_t> outputBytes(_channels.size());
+
+    std::mutex errorMutex;
+    std::exception_ptr error;
+
+    size_t threadCount = std::min(_threadCount, _channels.size());
+    auto worker = [&](size_t index) {
+        try {
+            for (size_t i = index; i < _channels.size(); i += threadCount) {
+                compressed[i] = compress(DataView(block + i * samples, samples), methods[i]);
+                outputBytes[i] = compressed[i].getTotalSize();
+            }
+        }
+        catch (...) {
+            std::lock_guard<std::mutex> lock(errorMutex);
+            if (!error) {
+                error = std::current_exception();
+            }
+        }
+    };
+
+    auto start = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < threadCount; ++i) {
+        threads.emplace_back(worker, i);
+    }
+
+    worker(0);
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    if (error) {
+        std::rethrow_exception(error);
+    }
+
+    _compressionStats.Duration += std::chrono::steady_clock::now() - start;
+    _compressionStats.Segments += _channels.size();
+    _compressionStats.InputBytes += uint64_t(_channels.size()) * samples * sizeof(ValueType);
+    for (uint64_t bytes : outputBytes) {
+        _compressionStats.OutputBytes += bytes;
+    }
+
+    return compressed;
+}
+
+} // namespace mdsplus
+
+#endif // MDSPLUS_MULTI_CHANNEL_WRITER_INC_HPP
@@ -62,6 +62,53 @@ public:
 
 protected:
 
+    ///
+    /// Copy dsc, whose children are the descriptors of args in order, except for the arguments
+    /// given up by the caller with std::move(), which are adopted by the Record as they are.
+    ///
+    /// Only the record itself and any small children are allocated, so building a Signal around
+    /// a large array doesn't copy the array again.
+    ///
+    template <typename ...ArgTypes>
+    void _build(mdsdsc_r_t * dsc, ArgTypes&& ...args)
+    {
+        // The extra element keeps the array from being empty
+        Data * adoptable[] = { _getAdoptable<ArgTypes>(args)..., nullptr };
+
+        // Left out of the copy, and filled in once they have been adopted
+        for (size_t i = 0; i < sizeof...(args); ++i) {
+            if (adoptable[i]) {
+                dsc->dscptrs[i] = nullptr;
+            }
+        }
+
+        _copyFrom((mdsdsc_t *)dsc);
+
+        mdsdsc_r_t * out = getRecordDescriptor();
+        for (size_t i = 0; i < sizeof...(args); ++i) {
+            if (adoptable[i]) {
+                out->dscptrs[i] = _adopt(std::move(*adoptable[i]));
+            }
+        }
+    }
+
+    template <typename ArgType>
+    static inline Data * _getAdoptable(ArgType& arg)
+    {
+        using BaseType = std::remove_reference_t<ArgType>;
+
+        // Only arguments passed as rvalues, e.g. with std::move(), can be taken
+        if constexpr (std::is_base_of_v<Data, BaseType> &&
+                      !std::is_const_v<BaseType> &&
+                      !std::is_lvalue_reference_v<ArgType>) {
+            if (_canAdopt(arg)) {
+                return &arg;
+            }
+        }
+
+        return nullptr;
+    }
+
     void _setTree(Tree * tree)
     {
         // Don't overwrite our tree with nullptr
@@ -136,9 +183,9 @@ public:
         typename ValidationType
     >
     Param(
-        const ValueType& value,
-        const HelpType& help,
-        const ValidationType& validation
+        ValueType&& value,
+        HelpType&& help,
+        ValidationType&& validation
     ) {
         DataView argValue(value);
         DataView argHelp(help);
@@ -154,10 +201,11 @@ public:
             argValidation.getDescriptor()
         );
 
-        int status = MdsCopyDxXd((mdsdsc_t *)&dsc, &_xd);
-        if (IS_NOT_OK(status)) {
-            throwException(status);
-        }
+        _build((mdsdsc_r_t *)&dsc,
+            std::forward<ValueType>(value),
+            std::forward<HelpType>(help),
+            std::forward<ValidationType>(validation)
+        );
     }
 
     template <typename ValueType = Data>
@@ -194,9 +242,9 @@ public:
         typename DimensionType
     >
     Signal(
-        const ValueType& value,
-        const RawType& raw,
-        const DimensionType& dimension = {}
+        ValueType&& value,
+        RawType&& raw,
+        DimensionType&& dimension = {}
     ) {
         DataView argValue(value);
         DataView argRaw(raw);
@@ -212,10 +260,11 @@ public:
             argDimension.getDescriptor()
         );
 
-        int status = MdsCopyDxXd((mdsdsc_t *)&dsc, &_xd);
-        if (IS_NOT_OK(status)) {
-            throwException(status);
-        }
+        _build((mdsdsc_r_t *)&dsc,
+            std::forward<ValueType>(value),
+            std::forward<RawType>(raw),
+            std::forward<DimensionType>(dimension)
+        );
     }
 
     template <
@@ -224,9 +273,9 @@ public:
         typename ...DimensionTypes
     >
     Signal(
-        const ValueType& value,
-        const RawType& raw,
-        const DimensionTypes& ...dimensions
+        ValueType&& value,
+        RawType&& raw,
+        DimensionTypes&& ...dimensions
     ) {
         DataView argValue(value);
         DataView argRaw(raw);
@@ -246,10 +295,11 @@ public:
             _setTree(argDimensions[i].getTree());
         }
 
-        int status = MdsCopyDxXd((mdsdsc_t *)&dsc, &_xd);
-        if (IS_NOT_OK(status)) {
-            throwException(status);
-        }
+        _build((mdsdsc_r_t *)&dsc,
+            std::forward<ValueType>(value),
+            std::forward<RawType>(raw),
+            std::forward<DimensionTypes>(dimensions)...
+        );
     }
 
     template <typename ValueType = Data>
@@ -292,7 +342,7 @@ public:
     MDSPLUS_RECORD_BOOTSTRAP(Dimension, DType::Dimension)
 
     template <typename WindowType, typename AxisType>
-    Dimension(const WindowType& window, const AxisType& axis)
+    Dimension(WindowType&& window, AxisType&& axis)
     {
         DataView tmpWindow(window);
         DataView tmpAxis(axis);
@@ -305,10 +355,10 @@ public:
             tmpAxis.getDescriptor()
         );
 
-        int status = MdsCopyDxXd((mdsdsc_t *)&dsc, &_xd);
-        if (IS_NOT_OK(status)) {
-            throwException(status);
-        }
+        _build((mdsdsc_r_t *)&dsc,
+            std::forward<WindowType>(window),
+            std::forward<AxisType>(axis)
+        );
     }
 
     template <typename WindowType = Data>
@@ -339,9 +389,9 @@ public:
         typename ValueType
     >
     Window(
-        const StartIndexType& startIndex,
-        const EndIndexType& endIndex,
-        const ValueType& valueAtIndex0
+        StartIndexType&& startIndex,
+        EndIndexType&& endIndex,
+        ValueType&& valueAtIndex0
     ) {
         DataView argStartIndex(startIndex);
         DataView argEndIndex(endIndex);
@@ -357,10 +407,11 @@ public:
             argValueAtIndex0.getDescriptor()
         );
 
-        int status = MdsCopyDxXd((mdsdsc_t *)&dsc, &_xd);
-        if (IS_NOT_OK(status)) {
-            throwException(status);
-        }
+        _build((mdsdsc_r_t *)&dsc,
+            std::forward<StartIndexType>(startIndex),
+            std::forward<EndIndexType>(endIndex),
+            std::forward<ValueType>(valueAtIndex0)
+        );
     }
 
     template <typename StartIndexType = Data>
@@ -394,14 +445,11 @@ public:
     Function(opcode_t opcode)
     {
         DESCRIPTOR_FUNCTION_0(dsc, &opcode);
-        int status = MdsCopyDxXd((mdsdsc_t *)&dsc, &_xd);
-        if (IS_NOT_OK(status)) {
-            throwException(status);
-        }
+        _copyFrom((mdsdsc_t *)&dsc);
     }
 
     template <typename ...ArgTypes>
-    Function(opcode_t opcode, const ArgTypes& ...args)
+    Function(opcode_t opcode, ArgTypes&& ...args)
     {
         // TODO: #define MAX_ARGS 255 ?
         static_assert(sizeof...(args) <= 255, "Function's are limited to 254 arguments");
@@ -415,10 +463,9 @@ public:
             _setTree(argList[i].getTree());
         }
 
-        int status = MdsCopyDxXd((mdsdsc_t *)&dsc, &_xd);
-        if (IS_NOT_OK(status)) {
-            throwException(status);
-        }
+        _build((mdsdsc_r_t *)&dsc,
+            std::forward<ArgTypes>(args)...
+        );
     }
 
     Data call() const;
@@ -446,9 +493,9 @@ public:
         typename DeltaType = Data
     >
     Range(
-        const BeginType& begin,
-        const EndingType& ending,
-        const DeltaType& delta
+        BeginType&& begin,
+        EndingType&& ending,
+        DeltaType&& delta
     ) {
         DataView argBegin(begin);
         DataView argEnding(ending);
@@ -464,10 +511,11 @@ public:
             argDelta.getDescriptor()
         );
 
-        int status = MdsCopyDxXd((mdsdsc_t *)&dsc, &_xd);
-        if (IS_NOT_OK(status)) {
-            throwException(status);
-        }
+        _build((mdsdsc_r_t *)&dsc,
+            std::forward<BeginType>(begin),
+            std::forward<EndingType>(ending),
+            std::forward<DeltaType>(delta)
+        );
     }
 
     template <typename BeginType = Data>
@@ -508,7 +556,7 @@ public:
     MDSPLUS_RECORD_BOOTSTRAP(WithUnits, DType::WithUnits)
 
     template <typename ValueType, typename UnitsType>
-    WithUnits(const ValueType& value, const UnitsType& units)
+    WithUnits(ValueType&& value, UnitsType&& units)
     {
         DataView argValue(value);
         DataView argUnits(units);
@@ -521,10 +569,10 @@ public:
             argUnits.getDescriptor()
         );
 
-        int status = MdsCopyDxXd((mdsdsc_t *)&dsc, &_xd);
-        if (IS_NOT_OK(status)) {
-            throwException(status);
-        }
+        _build((mdsdsc_r_t *)&dsc,
+            std::forward<ValueType>(value),
+            std::forward<UnitsType>(units)
+        );
     }
 
     template <typename ValueType = Data>
@@ -552,7 +600,7 @@ public:
     MDSPLUS_RECORD_BOOTSTRAP(WithError, DType::WithError)
 
     template <typename ValueType, typename ErrorType>
-    WithError(const ValueType& value, const ErrorType& error)
+    WithError(ValueType&& value, ErrorType&& error)
     {
         DataView argValue(value);
         DataView argError(error);
@@ -565,10 +613,10 @@ public:
             argError.getDescriptor()
         );
 
-        int status = MdsCopyDxXd((mdsdsc_t *)&dsc, &_xd);
-        if (IS_NOT_OK(status)) {
-            throwException(status);
-        }
+        _build((mdsdsc_r_t *)&dsc,
+            std::forward<ValueType>(value),
+            std::forward<ErrorType>(error)
+        );
     }
 
     template <typename ValueType = Data>
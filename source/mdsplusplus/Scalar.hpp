@@ -30,19 +30,8 @@ protected:
     template <typename CType>
     inline void _setValue(DType dtype, CType value)
     {
-        int status;
-
-        mdsdsc_s_t dsc = {
-            .length = sizeof(CType),
-            .dtype = dtype_t(dtype),
-            .class_ = class_t(__class),
-            .pointer = (char *)&value,
-        };
-
-        status = MdsCopyDxXd((mdsdsc_t *)&dsc, &_xd);
-        if (IS_NOT_OK(status)) {
-            throwException(status);
-        }
+        static_assert(sizeof(CType) <= InlineSize, "Every scalar type is stored inline");
+        _setInline(dtype_t(dtype), &value, sizeof(CType));
     }
 
     template <typename CType>
@@ -0,0 +1,126 @@
+#ifndef MDSPLUS_SEGMENT_READER_HPP
+#define MDSPLUS_SEGMENT_READER_HPP
+
+#include "Data.hpp"
+#include "TreeNode.hpp"
+#include "Tree.hpp"
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace mdsplus {
+
+///
+/// A single segment read by a SegmentReader.
+///
+template <typename ValueArrayType = Data, typename DimensionType = Data>
+struct SegmentData
+{
+    int Index = -1;
+
+    ValueArrayType Values = {};
+
+    DimensionType Dimension = {};
+
+}; // struct SegmentData
+
+///
+/// Reads the segments of a node in order, reading ahead on a background thread.
+///
+/// While the caller processes one segment, the next prefetch segments are read and converted
+/// on the background thread, so replaying a long signal is limited by the caller instead of
+/// by the disk. The background thread opens its own read-only Tree on the same shot, since a
+/// single Tree cannot be read from more than one thread, so the node's Tree can still be used
+/// by the caller while the reader is running.
+///
+/// Data read by the background thread refers to its Tree, and so must not be evaluated after
+/// the reader has been destroyed.
+///
+template <typename ValueArrayType = Data, typename DimensionType = Data>
+class SegmentReader
+{
+public:
+
+    ///
+    /// @param prefetch The number of segments to read ahead, 0 reads each segment in next() instead.
+    /// @param first The index of the first segment to read.
+    /// @param last The index of the last segment to read, or -1 for the last segment at construction.
+    ///
+    SegmentReader(const TreeNode& node, size_t prefetch = 2, int first = 0, int last = -1);
+
+    // The background thread refers to this object
+    SegmentReader(const SegmentReader&) = delete;
+    SegmentReader& operator=(const SegmentReader&) = delete;
+
+    ~SegmentReader();
+
+    ///
+    /// Move the next segment into segment, waiting for it to be read if needed.
+    ///
+    /// If reading a segment failed, the exception is rethrown here, in order.
+    ///
+    /// @returns false once every segment has been returned.
+    ///
+    bool next(SegmentData<ValueArrayType, DimensionType>& segment);
+
+    [[nodiscard]]
+    inline int getFirst() const {
+        return _first;
+    }
+
+    [[nodiscard]]
+    inline int getLast() const {
+        return _last;
+    }
+
+    [[nodiscard]]
+    inline size_t getPrefetch() const {
+        return _prefetch;
+    }
+
+    ///
+    /// The number of times next() had to wait for a segment that had not been read yet.
+    ///
+    [[nodiscard]]
+    size_t getStallCount() const;
+
+private:
+
+    TreeNode _node;
+
+    size_t _prefetch;
+
+    int _first;
+
+    int _last;
+
+    // The index of the next segment returned by next()
+    int _next;
+
+    std::unique_ptr<Tree> _tree;
+
+    // Guarded by _mutex
+    std::deque<SegmentData<ValueArrayType, DimensionType>> _ready;
+    std::exception_ptr _error;
+    bool _stop = false;
+    size_t _stallCount = 0;
+
+    mutable std::mutex _mutex;
+
+    // Signalled when a segment has been read, or when there is room to read another
+    std::condition_variable _read;
+    std::condition_variable _taken;
+
+    std::thread _thread;
+
+    void _run();
+
+}; // class SegmentReader
+
+} // namespace mdsplus
+
+#endif // MDSPLUS_SEGMENT_READER_HPP
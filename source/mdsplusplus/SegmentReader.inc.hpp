@@ -0,0 +1,138 @@
+#ifndef MDSPLUS_SEGMENT_READER_INC_HPP
+#define MDSPLUS_SEGMENT_READER_INC_HPP
+
+#include "SegmentReader.hpp"
+#include "TreeNode.hpp"
+#include "Tree.hpp"
+
+namespace mdsplus {
+
+template <typename ValueArrayType, typename DimensionType>
+SegmentReader<ValueArrayType, DimensionType>::SegmentReader(
+    const TreeNode& node,
+    size_t prefetch /*= 2*/,
+    int first /*= 0*/,
+    int last /*= -1*/
+)
+    : _node(node)
+    , _prefetch(prefetch)
+    , _first(first)
+    , _last(last)
+    , _next(first)
+{
+    if (_last < 0) {
+        _last = _node.getNumSegments() - 1;
+    }
+
+    if (_prefetch > 0 && _first <= _last) {
+        const Tree * tree = _node.getTree();
+        _tree = std::make_unique<Tree>(
+            tree->getTreeName(),
+            tree->getShot(),
+            Mode::ReadOnly,
+            tree->getTreePath()
+        );
+
+        _thread = std::thread(&SegmentReader::_run, this);
+    }
+}
+
+template <typename ValueArrayType, typename DimensionType>
+SegmentReader<ValueArrayType, DimensionType>::~SegmentReader()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stop = true;
+    }
+    _taken.notify_one();
+
+    if (_thread.joinable()) {
+        _thread.join();
+    }
+}
+
+template <typename ValueArrayType, typename DimensionType>
+bool SegmentReader<ValueArrayType, DimensionType>::next(SegmentData<ValueArrayType, DimensionType>& segment)
+{
+    if (_next > _last) {
+        return false;
+    }
+
+    if (!_thread.joinable()) {
+        auto [values, dimension] = _node.getSegment<ValueArrayType, DimensionType>(_next);
+        segment.Index = _next++;
+        segment.Values = std::move(values);
+        segment.Dimension = std::move(dimension);
+        return true;
+    }
+
+    std::unique_lock<std::mutex> lock(_mutex);
+    if (_ready.empty() && !_error) {
+        ++_stallCount;
+        _read.wait(lock, [&]() { return (!_ready.empty() || _error); });
+    }
+
+    // Segments read before the error are still returned first
+    if (_ready.empty()) {
+        _next = _last + 1;
+        std::rethrow_exception(_error);
+    }
+
+    segment = std::move(_ready.front());
+    _ready.pop_front();
+    ++_next;
+
+    lock.unlock();
+    _taken.notify_one();
+
+    return true;
+}
+
+template <typename ValueArrayType, typename DimensionType>
+size_t SegmentReader<ValueArrayType, DimensionType>::getStallCount() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _stallCount;
+}
+
+template <typename ValueArrayType, typename DimensionType>
+void SegmentReader<ValueArrayType, DimensionType>::_run()
+{
+    // NIDs are the same in every Tree opened on the same shot
+    TreeNode node(_tree.get(), _node.getNID());
+
+    for (int index = _first; index <= _last; ++index) {
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _taken.wait(lock, [&]() { return (_ready.size() < _prefetch || _stop); });
+            if (_stop) {
+                return;
+            }
+        }
+
+        SegmentData<ValueArrayType, DimensionType> segment;
+        segment.Index = index;
+
+        try {
+            auto [values, dimension] = node.getSegment<ValueArrayType, DimensionType>(index);
+            segment.Values = std::move(values);
+            segment.Dimension = std::move(dimension);
+        }
+        catch (...) {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _error = std::current_exception();
+            _read.notify_one();
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _ready.push_back(std::move(segment));
+        }
+        _read.notify_one();
+    }
+}
+
+} // namespace mdsplus
+
+#endif // MDSPLUS_SEGMENT_READER_INC_HPP
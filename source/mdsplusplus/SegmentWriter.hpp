@@ -0,0 +1,234 @@
+#ifndef MDSPLUS_SEGMENT_WRITER_HPP
+#define MDSPLUS_SEGMENT_WRITER_HPP
+
+#include "TreeNode.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace mdsplus {
+
+///
+/// What SegmentWriter::putRow() does when every segment in the buffer is waiting to be written.
+///
+enum class OverflowPolicy
+{
+    /// Wait for the background thread to write a segment.
+    Block,
+
+    /// Discard the row and count it in getDroppedRowCount().
+    Drop,
+};
+
+///
+/// Buffers rows in memory and writes them to a node as whole segments from a background thread.
+///
+/// The buffer is allocated up front as a ring of segments, so putRow() only copies the row
+/// and never allocates or calls into treeshr. Each time a segment is filled it is handed to
+/// the background thread, which writes it with makeTimestampedSegment(), or with makeSegment()
+/// and a Range dimension when the writer was created with a fixed sample rate.
+///
+/// putRow() must only be called from one thread at a time. While the writer is running, the
+/// Tree must not be used from any other thread, as the background thread is writing to it.
+///
+/// If writing a segment fails, the exception is rethrown by the next call to putRow() or flush().
+///
+template <typename ValueType>
+class SegmentWriter
+{
+public:
+
+    ///
+    /// Write rows with a timestamp each, using makeTimestampedSegment().
+    ///
+    /// @param segmentLength The number of rows in each segment.
+    /// @param bufferSegments The number of segments in the ring buffer, at least 2.
+    /// @param rowDims The dimensions of each row, empty for a single value per row.
+    ///
+    SegmentWriter(
+        const TreeNode& node,
+        uint32_t segmentLength,
+        size_t bufferSegments = 4,
+        const std::vector<uint32_t>& rowDims = {}
+    );
+
+    ///
+    /// Write rows sampled at a fixed rate, using makeSegment() with a Range dimension.
+    ///
+    /// @param start The time of the first row.
+    /// @param delta The time between rows.
+    ///
+    SegmentWriter(
+        const TreeNode& node,
+        double start,
+        double delta,
+        uint32_t segmentLength,
+        size_t bufferSegments = 4,
+        const std::vector<uint32_t>& rowDims = {}
+    );
+
+    // The background thread refers to this object
+    SegmentWriter(const SegmentWriter&) = delete;
+    SegmentWriter& operator=(const SegmentWriter&) = delete;
+
+    ///
+    /// Write any buffered rows and stop the background thread.
+    ///
+    /// Errors cannot be thrown from here, call flush() first to see them.
+    ///
+    ~SegmentWriter();
+
+    ///
+    /// Append a row to the current segment, with a timestamp if the writer is timestamped.
+    ///
+    /// @param row A pointer to getRowSize() values.
+    /// @returns false if the row was dropped because of OverflowPolicy::Drop.
+    ///
+    bool putRow(const ValueType * row, int64_t timestamp = 0);
+
+    ///
+    /// Append a row of a single value, only valid when getRowSize() is 1.
+    ///
+    inline bool putRow(const ValueType& value, int64_t timestamp = 0) {
+        if (_rowSize != 1) {
+            throwException(TreeFAILURE);
+        }
+        return putRow(&value, timestamp);
+    }
+
+    inline bool putRow(const std::vector<ValueType>& row, int64_t timestamp = 0) {
+        if (row.size() != _rowSize) {
+            throwException(TreeFAILURE);
+        }
+        return putRow(row.data(), timestamp);
+    }
+
+    ///
+    /// Write the current partially filled segment, and wait until everything buffered has been written.
+    ///
+    void flush();
+
+    [[nodiscard]]
+    inline OverflowPolicy getOverflowPolicy() const {
+        return _overflowPolicy;
+    }
+
+    inline void setOverflowPolicy(OverflowPolicy policy) {
+        _overflowPolicy = policy;
+    }
+
+    [[nodiscard]]
+    inline size_t getRowSize() const {
+        return _rowSize;
+    }
+
+    [[nodiscard]]
+    inline uint32_t getSegmentLength() const {
+        return _segmentLength;
+    }
+
+    ///
+    /// The number of segments that have been written.
+    ///
+    [[nodiscard]]
+    inline size_t getSegmentCount() const {
+        return _segmentCount;
+    }
+
+    ///
+    /// The number of times putRow() found the buffer full, and either waited or dropped the row.
+    ///
+    [[nodiscard]]
+    inline size_t getBackpressureCount() const {
+        return _backpressureCount;
+    }
+
+    [[nodiscard]]
+    inline size_t getDroppedRowCount() const {
+        return _droppedRowCount;
+    }
+
+    ///
+    /// The number of full segments waiting to be written.
+    ///
+    [[nodiscard]]
+    size_t getPendingSegmentCount() const;
+
+private:
+
+    struct _Slot
+    {
+        std::vector<ValueType> Values = {};
+
+        std::vector<int64_t> Timestamps = {};
+
+        // Set when the slot is submitted
+        uint32_t Rows = 0;
+
+        // Index of the first row in the whole signal, used to compute times for Range dimensions
+        uint64_t FirstRow = 0;
+    };
+
+    TreeNode _node;
+
+    bool _timestamped;
+
+    double _start = 0.0;
+
+    double _delta = 0.0;
+
+    uint32_t _segmentLength;
+
+    std::vector<uint32_t> _rowDims;
+
+    size_t _rowSize = 1;
+
+    OverflowPolicy _overflowPolicy = OverflowPolicy::Block;
+
+    std::vector<_Slot> _slots;
+
+    // Only used by the thread calling putRow()
+    size_t _writeSlot = 0;
+    uint32_t _rows = 0;
+    uint64_t _nextRow = 0;
+
+    // Guarded by _mutex
+    size_t _flushSlot = 0;
+    size_t _pending = 0;
+    bool _stop = false;
+    std::exception_ptr _error;
+
+    mutable std::mutex _mutex;
+
+    // Signalled when a segment is ready to be written, or when one has been written
+    std::condition_variable _ready;
+    std::condition_variable _written;
+
+    std::atomic<size_t> _segmentCount = 0;
+
+    std::atomic<size_t> _backpressureCount = 0;
+
+    std::atomic<size_t> _droppedRowCount = 0;
+
+    std::thread _thread;
+
+    void _initialize(size_t bufferSegments);
+
+    // Hand the current slot to the background thread
+    void _submit();
+
+    void _run();
+
+    void _write(const _Slot& slot);
+
+    void _rethrow();
+
+}; // class SegmentWriter
+
+} // namespace mdsplus
+
+#endif // MDSPLUS_SEGMENT_WRITER_HPP
@@ -0,0 +1,234 @@
+#ifndef MDSPLUS_SEGMENT_WRITER_INC_HPP
+#define MDSPLUS_SEGMENT_WRITER_INC_HPP
+
+#include "SegmentWriter.hpp"
+#include "TreeNode.hpp"
+#include "Record.hpp"
+
+#include <algorithm>
+
+namespace mdsplus {
+
+template <typename ValueType>
+inline SegmentWriter<ValueType>::SegmentWriter(
+    const TreeNode& node,
+    uint32_t segmentLength,
+    size_t bufferSegments /*= 4*/,
+    const std::vector<uint32_t>& rowDims /*= {}*/
+)
+    : _node(node)
+    , _timestamped(true)
+    , _segmentLength(segmentLength)
+    , _rowDims(rowDims)
+{
+    _initialize(bufferSegments);
+}
+
+template <typename ValueType>
+inline SegmentWriter<ValueType>::SegmentWriter(
+    const TreeNode& node,
+    double start,
+    double delta,
+    uint32_t segmentLength,
+    size_t bufferSegments /*= 4*/,
+    const std::vector<uint32_t>& rowDims /*= {}*/
+)
+    : _node(node)
+    , _timestamped(false)
+    , _start(start)
+    , _delta(delta)
+    , _segmentLength(segmentLength)
+    , _rowDims(rowDims)
+{
+    _initialize(bufferSegments);
+}
+
+template <typename ValueType>
+inline SegmentWriter<ValueType>::~SegmentWriter()
+{
+    try {
+        if (_rows > 0) {
+            std::unique_lock<std::mutex> lock(_mutex);
+
+            // There is always room for the current slot, it was reserved by putRow()
+            _submit();
+        }
+    }
+    catch (...) { }
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stop = true;
+    }
+    _ready.notify_one();
+
+    if (_thread.joinable()) {
+        _thread.join();
+    }
+}
+
+template <typename ValueType>
+inline void SegmentWriter<ValueType>::_initialize(size_t bufferSegments)
+{
+    if (_segmentLength == 0) {
+        throwException(TreeFAILURE);
+    }
+
+    for (uint32_t dim : _rowDims) {
+        _rowSize *= dim;
+    }
+
+    // One slot is filled by putRow() while the others are written
+    _slots.resize(std::max<size_t>(bufferSegments, 2));
+    for (auto& slot : _slots) {
+        slot.Values.resize(_rowSize * _segmentLength);
+        if (_timestamped) {
+            slot.Timestamps.resize(_segmentLength);
+        }
+    }
+
+    _thread = std::thread(&SegmentWriter::_run, this);
+}
+
+template <typename ValueType>
+bool SegmentWriter<ValueType>::putRow(const ValueType * row, int64_t timestamp /*= 0*/)
+{
+    _Slot * slot = &_slots[_writeSlot];
+
+    // Only take the lock at segment boundaries, to make sure the slot isn't still being written
+    if (_rows == 0) {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _rethrow();
+
+        if (_pending == _slots.size()) {
+            ++_backpressureCount;
+
+            if (_overflowPolicy == OverflowPolicy::Drop) {
+                ++_droppedRowCount;
+
+                // Keep the timebase of a fixed rate signal in step with the dropped rows
+                ++_nextRow;
+                return false;
+            }
+
+            _written.wait(lock, [&]() { return (_pending < _slots.size() || _error); });
+            _rethrow();
+        }
+
+        slot->FirstRow = _nextRow;
+    }
+
+    std::copy(row, row + _rowSize, slot->Values.data() + _rows * _rowSize);
+    if (_timestamped) {
+        slot->Timestamps[_rows] = timestamp;
+    }
+
+    ++_rows;
+    ++_nextRow;
+
+    if (_rows == _segmentLength) {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _submit();
+    }
+
+    return true;
+}
+
+template <typename ValueType>
+void SegmentWriter<ValueType>::flush()
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    _rethrow();
+
+    if (_rows > 0) {
+        _submit();
+    }
+
+    _written.wait(lock, [&]() { return (_pending == 0 || _error); });
+    _rethrow();
+}
+
+template <typename ValueType>
+size_t SegmentWriter<ValueType>::getPendingSegmentCount() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _pending;
+}
+
+template <typename ValueType>
+inline void SegmentWriter<ValueType>::_submit()
+{
+    _slots[_writeSlot].Rows = _rows;
+    _rows = 0;
+
+    ++_pending;
+    _writeSlot = (_writeSlot + 1) % _slots.size();
+    _ready.notify_one();
+}
+
+template <typename ValueType>
+void SegmentWriter<ValueType>::_run()
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+
+    while (true) {
+        _ready.wait(lock, [&]() { return (_pending > 0 || _stop); });
+        if (_pending == 0) {
+            break;
+        }
+
+        _Slot& slot = _slots[_flushSlot];
+
+        lock.unlock();
+        try {
+            _write(slot);
+            ++_segmentCount;
+        }
+        catch (...) {
+            lock.lock();
+            if (!_error) {
+                _error = std::current_exception();
+            }
+            lock.unlock();
+        }
+        lock.lock();
+
+        _flushSlot = (_flushSlot + 1) % _slots.size();
+        --_pending;
+        _written.notify_all();
+    }
+}
+
+template <typename ValueType>
+void SegmentWriter<ValueType>::_write(const _Slot& slot)
+{
+    std::vector<uint32_t> dims = _rowDims;
+    dims.push_back(_segmentLength);
+
+    // The whole segment is allocated, and the rows after slot.Rows are left empty
+    Data values = Data::FromArray(slot.Values, dims);
+
+    if (_timestamped) {
+        // makeTimestampedSegment() takes a non-const pointer, but doesn't modify the timestamps
+        _node.makeTimestampedSegment(const_cast<int64_t *>(slot.Timestamps.data()), values, -1, slot.Rows);
+    }
+    else {
+        double start = _start + _delta * slot.FirstRow;
+        double end = start + _delta * (slot.Rows - 1);
+        _node.makeSegment(start, end, Range(start, end, _delta), values, -1, slot.Rows);
+    }
+}
+
+template <typename ValueType>
+inline void SegmentWriter<ValueType>::_rethrow()
+{
+    if (_error) {
+        std::exception_ptr error = _error;
+        _error = nullptr;
+        std::rethrow_exception(error);
+    }
+}
+
+} // namespace mdsplus
+
+#endif // MDSPLUS_SEGMENT_WRITER_INC_HPP
@@ -0,0 +1,172 @@
+#ifndef MDSPLUS_SHOT_SCANNER_HPP
+#define MDSPLUS_SHOT_SCANNER_HPP
+
+#include "Data.hpp"
+#include "Tree.hpp"
+
+#include <climits>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace mdsplus {
+
+///
+/// The values read from a single shot by a ShotScanner.
+///
+template <typename DataType = Data>
+struct ShotData
+{
+    int Shot = 0;
+
+    /// Status of opening the shot, the values are only valid if this is OK.
+    int Status = MDSplusSUCCESS;
+
+    /// One value per path passed to the ShotScanner, in the same order.
+    std::vector<DataType> Values = {};
+
+    /// One status per value, e.g. TreeNODATA if the node is empty in this shot.
+    std::vector<int> ValueStatus = {};
+
+    inline bool isOK() const {
+        return IS_OK(Status);
+    }
+
+}; // struct ShotData
+
+///
+/// Reads a fixed list of nodes across many shots of the same tree.
+///
+/// Each worker keeps a single Tree open and reopens it for every shot, so the
+/// DBID context is reused instead of being reallocated per shot. The paths are
+/// resolved to NIDs on the first shot that opens successfully, and those NIDs
+/// are reused for every shot made from the same model. Before reusing them, a
+/// few of the paths are resolved again in the new shot, and if any of them
+/// resolve differently, the paths are resolved again for that model. A model
+/// that only differs in nodes that aren't checked will still be read with the
+/// old NIDs, so scan shots from very different models separately.
+///
+class ShotScanner
+{
+public:
+
+    inline ShotScanner(
+        const std::string& treename,
+        const std::vector<std::string>& paths,
+        const std::string& path = {}
+    )
+        : _treename(treename)
+        , _path(path)
+        , _paths(paths)
+    { }
+
+    [[nodiscard]]
+    inline std::string getTreeName() const {
+        return _treename;
+    }
+
+    [[nodiscard]]
+    inline const std::vector<std::string>& getNodePaths() const {
+        return _paths;
+    }
+
+    [[nodiscard]]
+    inline const std::vector<int>& getShots() const {
+        return _shots;
+    }
+
+    inline void setShots(const std::vector<int>& shots) {
+        _shots = shots;
+    }
+
+    ///
+    /// Scan every shot found by Tree::getShotDB() between lower and higher, inclusive.
+    ///
+    inline void setShotRange(int lower = INT_MIN, int higher = INT_MAX) {
+        _shots = Tree::getShotDB(_treename, _path, lower, higher);
+    }
+
+    [[nodiscard]]
+    inline size_t getThreadCount() const {
+        return _threadCount;
+    }
+
+    ///
+    /// Set the number of worker threads, each with its own Tree, 0 will use std::thread::hardware_concurrency().
+    ///
+    inline void setThreadCount(size_t threadCount) {
+        _threadCount = threadCount;
+    }
+
+    ///
+    /// Read every shot, calling callback(ShotData<DataType>&&) once per shot.
+    ///
+    /// With more than one thread, the callback is called concurrently from the
+    /// worker threads and shots are not delivered in order. The first exception
+    /// thrown by the callback stops the scan and is rethrown to the caller.
+    ///
+    template <typename DataType = Data, typename CallbackType>
+    void scan(CallbackType callback) const;
+
+    ///
+    /// Read every shot and return the results in the same order as getShots().
+    ///
+    template <typename DataType = Data>
+    [[nodiscard]]
+    std::vector<ShotData<DataType>> read() const;
+
+private:
+
+    std::string _treename;
+
+    std::string _path;
+
+    std::vector<std::string> _paths;
+
+    std::vector<int> _shots;
+
+    size_t _threadCount = 1;
+
+    /// The NIDs of every path in one model.
+    struct _ResolvedNIDs
+    {
+        std::vector<int> NIDs;
+
+        std::vector<int> Status;
+
+        /// Indices of the paths that are resolved again to check if a shot uses this model.
+        std::vector<size_t> Probes;
+
+    }; // struct _ResolvedNIDs
+
+    /// Every model seen during a scan, shared by the workers.
+    struct _ModelCache
+    {
+        std::mutex Mutex;
+
+        std::vector<std::shared_ptr<const _ResolvedNIDs>> Models;
+
+    }; // struct _ModelCache
+
+    template <typename DataType, typename CallbackType>
+    void _scan(CallbackType callback) const;
+
+    std::shared_ptr<const _ResolvedNIDs> _getNIDs(
+        const Tree& tree,
+        const std::shared_ptr<const _ResolvedNIDs>& current,
+        _ModelCache& cache
+    ) const;
+
+    std::shared_ptr<const _ResolvedNIDs> _resolveNIDs(const Tree& tree) const;
+
+    bool _matchesModel(const Tree& tree, const _ResolvedNIDs& resolved) const;
+
+    template <typename DataType>
+    void _readValues(Tree& tree, const _ResolvedNIDs& resolved, ShotData<DataType>& result) const;
+
+}; // class ShotScanner
+
+} // namespace mdsplus
+
+#endif // MDSPLUS_SHOT_SCANNER_HPP
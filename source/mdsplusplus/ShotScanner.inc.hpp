@@ -0,0 +1,244 @@
+#ifndef MDSPLUS_SHOT_SCANNER_INC_HPP
+#define MDSPLUS_SHOT_SCANNER_INC_HPP
+
+#include "ShotScanner.hpp"
+#include "Tree.hpp"
+#include "TreeNode.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+namespace mdsplus {
+
+template <typename DataType /*= Data*/, typename CallbackType>
+inline void ShotScanner::scan(CallbackType callback) const
+{
+    _scan<DataType>([&](size_t index, ShotData<DataType>&& result) {
+        (void)index;
+        callback(std::move(result));
+    });
+}
+
+template <typename DataType /*= Data*/>
+inline std::vector<ShotData<DataType>> ShotScanner::read() const
+{
+    // Each worker writes to its own slot, so no locking is needed
+    std::vector<ShotData<DataType>> results(_shots.size());
+    _scan<DataType>([&](size_t index, ShotData<DataType>&& result) {
+        results[index] = std::move(result);
+    });
+
+    return results;
+}
+
+template <typename DataType, typename CallbackType>
+inline void ShotScanner::_scan(CallbackType callback) const
+{
+    if (_shots.empty()) {
+        return;
+    }
+
+    size_t threadCount = _threadCount;
+    if (threadCount == 0) {
+        threadCount = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+    }
+    threadCount = std::min(threadCount, _shots.size());
+
+    // NIDs are shared by every worker, and resolved by whichever opens a shot of a new model first
+    _ModelCache cache;
+
+    std::atomic<size_t> nextIndex = 0;
+    std::atomic<bool> stop = false;
+
+    std::mutex errorMutex;
+    std::exception_ptr error;
+
+    auto worker = [&]() {
+        try {
+            // Reopening the same Tree reuses its DBID instead of allocating a new one per shot
+            Tree tree;
+            tree.setTreePath(_path);
+
+            // Consecutive shots usually come from the same model, so check the last one first
+            std::shared_ptr<const _ResolvedNIDs> resolved;
+
+            while (!stop) {
+                size_t index = nextIndex++;
+                if (index >= _shots.size()) {
+                    break;
+                }
+
+                ShotData<DataType> result;
+                result.Shot = _shots[index];
+
+                try {
+                    tree.open(_treename, result.Shot, Mode::ReadOnly);
+                }
+                catch (const MDSplusException& e) {
+                    result.Status = e.getStatus();
+                }
+
+                if (result.isOK()) {
+                    resolved = _getNIDs(tree, resolved, cache);
+                    _readValues(tree, *resolved, result);
+                }
+
+                callback(index, std::move(result));
+            }
+        }
+        catch (...) {
+            std::lock_guard<std::mutex> lock(errorMutex);
+            if (!error) {
+                error = std::current_exception();
+            }
+            stop = true;
+        }
+    };
+
+    if (threadCount == 1) {
+        worker();
+    }
+    else {
+        std::vector<std::thread> threads;
+        threads.reserve(threadCount);
+        for (size_t i = 0; i < threadCount; ++i) {
+            threads.emplace_back(worker);
+        }
+
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+inline std::shared_ptr<const ShotScanner::_ResolvedNIDs> ShotScanner::_getNIDs(
+    const Tree& tree,
+    const std::shared_ptr<const _ResolvedNIDs>& current,
+    _ModelCache& cache
+) const
+{
+    if (current && _matchesModel(tree, *current)) {
+        return current;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(cache.Mutex);
+        for (const auto& model : cache.Models) {
+            if (model != current && _matchesModel(tree, *model)) {
+                return model;
+            }
+        }
+    }
+
+    // Resolve outside of the lock, two workers racing on the same new model only costs a duplicate entry
+    auto resolved = _resolveNIDs(tree);
+
+    std::lock_guard<std::mutex> lock(cache.Mutex);
+    cache.Models.push_back(resolved);
+    return resolved;
+}
+
+inline std::shared_ptr<const ShotScanner::_ResolvedNIDs> ShotScanner::_resolveNIDs(const Tree& tree) const
+{
+    auto resolved = std::make_shared<_ResolvedNIDs>();
+    resolved->NIDs.resize(_paths.size(), -1);
+    resolved->Status.resize(_paths.size(), TreeNNF);
+
+    for (size_t i = 0; i < _paths.size(); ++i) {
+        try {
+            resolved->NIDs[i] = tree.getNode(_paths[i]).getNID();
+            resolved->Status[i] = MDSplusSUCCESS;
+        }
+        catch (const MDSplusException& e) {
+            resolved->Status[i] = e.getStatus();
+        }
+    }
+
+    // Probe the first and last paths that resolved, since nodes added to a model shift the NIDs
+    // of everything after them, and the first path that didn't, in case it was added
+    auto isOK = [&](size_t i) { return IS_OK(resolved->Status[i]); };
+    for (size_t i = 0; i < _paths.size(); ++i) {
+        if (isOK(i)) {
+            resolved->Probes.push_back(i);
+            break;
+        }
+    }
+
+    for (size_t i = _paths.size(); i > 0; --i) {
+        if (isOK(i - 1)) {
+            if (resolved->Probes.empty() || resolved->Probes.front() != i - 1) {
+                resolved->Probes.push_back(i - 1);
+            }
+            break;
+        }
+    }
+
+    for (size_t i = 0; i < _paths.size(); ++i) {
+        if (!isOK(i)) {
+            resolved->Probes.push_back(i);
+            break;
+        }
+    }
+
+    return resolved;
+}
+
+inline bool ShotScanner::_matchesModel(const Tree& tree, const _ResolvedNIDs& resolved) const
+{
+    for (size_t i : resolved.Probes) {
+        int nid = -1;
+        int status = MDSplusSUCCESS;
+        try {
+            nid = tree.getNode(_paths[i]).getNID();
+        }
+        catch (const MDSplusException& e) {
+            status = e.getStatus();
+        }
+
+        if (status != resolved.Status[i] || (IS_OK(status) && nid != resolved.NIDs[i])) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+template <typename DataType>
+inline void ShotScanner::_readValues(Tree& tree, const _ResolvedNIDs& resolved, ShotData<DataType>& result) const
+{
+    result.Values.reserve(resolved.NIDs.size());
+    result.ValueStatus.reserve(resolved.NIDs.size());
+
+    for (size_t i = 0; i < resolved.NIDs.size(); ++i) {
+        if (IS_NOT_OK(resolved.Status[i])) {
+            result.Values.emplace_back();
+            result.ValueStatus.push_back(resolved.Status[i]);
+            continue;
+        }
+
+        try {
+            DataType value = TreeNode(&tree, resolved.NIDs[i]).getData<DataType>();
+
+            // The worker's Tree is reopened for the next shot, so don't keep a reference to it
+            value.setTree(nullptr);
+
+            result.Values.push_back(std::move(value));
+            result.ValueStatus.push_back(MDSplusSUCCESS);
+        }
+        catch (const MDSplusException& e) {
+            result.Values.emplace_back();
+            result.ValueStatus.push_back(e.getStatus());
+        }
+    }
+}
+
+} // namespace mdsplus
+
+#endif // MDSPLUS_SHOT_SCANNER_INC_HPP
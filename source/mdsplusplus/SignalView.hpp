@@ -0,0 +1,114 @@
+#ifndef MDSPLUS_SIGNAL_VIEW_HPP
+#define MDSPLUS_SIGNAL_VIEW_HPP
+
+#include "Data.hpp"
+#include "Array.hpp"
+#include "Record.hpp"
+#include "Timebase.hpp"
+
+#include <algorithm>
+
+namespace mdsplus {
+
+///
+/// The values and first dimension of a Signal, each resolved once when the view is created.
+///
+/// Getting the values or dimensions of a Signal directly copies and evaluates them on every call.
+/// A SignalView does this once, and if the first dimension is uniform, see Timebase::FromDescriptor(),
+/// it is kept as a uniform Timebase instead of being evaluated into an array of times.
+///
+/// @code{.cpp}
+/// SignalView<Float64Array> view(node.getRecord<Signal>());
+/// auto [first, last] = view.getTimebase().getIndexRange(1.0, 2.0);
+/// for (size_t i = first; i < last; ++i) {
+///     process(view.getTime(i), view[i]);
+/// }
+/// @endcode
+///
+template <typename ValueArrayType = Float64Array>
+class SignalView
+{
+public:
+
+    using ValueType = typename ValueArrayType::__ctype;
+
+    explicit SignalView(const Signal& signal);
+
+    ///
+    /// The number of values, which can be fewer than the number of times.
+    ///
+    [[nodiscard]]
+    inline size_t size() const {
+        return _values.getSize();
+    }
+
+    ///
+    /// The values, copied out of the Signal once when the view was created.
+    ///
+    [[nodiscard]]
+    inline const ValueArrayType& getValues() const {
+        return _values;
+    }
+
+    [[nodiscard]]
+    inline const ValueType * data() const {
+        return _values.begin();
+    }
+
+    #ifdef __cpp_lib_span
+
+        [[nodiscard]]
+        inline std::span<const ValueType> getSpan() const {
+            return std::span<const ValueType>(_values.begin(), size());
+        }
+
+    #endif // __cpp_lib_span
+
+    [[nodiscard]]
+    inline const Timebase& getTimebase() const {
+        return _timebase;
+    }
+
+    [[nodiscard]]
+    inline ValueType operator[](size_t index) const {
+        return data()[index];
+    }
+
+    ///
+    /// The time of value index, throws TdiBadIndex if there is no such time.
+    ///
+    [[nodiscard]]
+    inline double getTime(size_t index) const {
+        return _timebase.getTime(index);
+    }
+
+    ///
+    /// The index of the last value at or before time, see Timebase::getIndex().
+    ///
+    [[nodiscard]]
+    inline size_t getIndex(double time) const {
+        return std::min(_timebase.getIndex(time), (size() == 0 ? 0 : size() - 1));
+    }
+
+    ///
+    /// The value of the last sample at or before time, throws TdiBadIndex if there are no values.
+    ///
+    [[nodiscard]]
+    inline ValueType getValueAt(double time) const {
+        if (size() == 0) {
+            throw TdiBadIndex();
+        }
+        return data()[getIndex(time)];
+    }
+
+private:
+
+    ValueArrayType _values;
+
+    Timebase _timebase;
+
+}; // class SignalView
+
+} // namespace mdsplus
+
+#endif // MDSPLUS_SIGNAL_VIEW_HPP
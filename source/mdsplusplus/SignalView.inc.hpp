@@ -0,0 +1,55 @@
+#ifndef MDSPLUS_SIGNAL_VIEW_INC_HPP
+#define MDSPLUS_SIGNAL_VIEW_INC_HPP
+
+#include "SignalView.hpp"
+#include "DataRef.hpp"
+#include "Scalar.hpp"
+
+namespace mdsplus {
+
+template <typename ValueArrayType>
+SignalView<ValueArrayType>::SignalView(const Signal& signal)
+{
+    mdsdsc_r_t * dsc = signal.getRecordDescriptor();
+    if (!dsc) {
+        return;
+    }
+
+    auto getChild = [&](size_t index) -> mdsdsc_t * {
+        return _unwrapDescriptor(index < dsc->ndesc ? dsc->dscptrs[index] : nullptr);
+    };
+
+    // Values that are already an array can be copied out directly, anything else, e.g. an
+    // expression of $VALUE, needs the whole signal to evaluate. Either way the array is kept
+    // as it is, instead of being copied again into a std::vector.
+    mdsdsc_t * dscValue = getChild(0);
+    if (dscValue && dscValue->class_ == CLASS_A) {
+        _values = DataRef(dscValue, signal.getTree()).clone<ValueArrayType>();
+    }
+    else {
+        _values = signal.getData<ValueArrayType>();
+    }
+
+    mdsdsc_t * dscDimension = getChild(2);
+    if (!dscDimension) {
+        return;
+    }
+
+    // Uniform dimensions don't need to be evaluated
+    std::optional<Timebase> timebase = Timebase::FromDescriptor(dscDimension);
+    if (timebase) {
+        _timebase = std::move(*timebase);
+        return;
+    }
+
+    if (dscDimension->class_ == CLASS_A) {
+        _timebase = Timebase(DataRef(dscDimension, signal.getTree()).clone<Float64Array>().getValues());
+        return;
+    }
+
+    _timebase = Timebase(Data::Execute<Float64Array>("DIM_OF($)", signal).getValues());
+}
+
+} // namespace mdsplus
+
+#endif // MDSPLUS_SIGNAL_VIEW_INC_HPP
@@ -3,6 +3,8 @@
 
 #include "Data.hpp"
 
+#include <algorithm>
+
 #if __has_include(<string_view>)
     #include <string_view>
 #endif
@@ -212,20 +214,43 @@ public:
     [[nodiscard]]
     std::string getValueAt(size_t index) const;
 
+    #ifdef __cpp_lib_string_view
+
+        ///
+        /// The value at index, without copying it.
+        ///
+        /// Every value is padded with spaces to the length of the longest, which are removed
+        /// unless trim is false. Warning: this will not be null-terminated.
+        ///
+        [[nodiscard]]
+        std::string_view getStringViewAt(size_t index, bool trim = true) const;
+
+        ///
+        /// Every value, without copying them, see getStringViewAt().
+        ///
+        [[nodiscard]]
+        std::vector<std::string_view> getStringViews(bool trim = true) const;
+
+    #endif // __cpp_lib_string_view
+
     [[nodiscard]]
     size_t getSize() const;
 
-    void setValues(
+    inline void setValues(
         const std::vector<std::string>& values,
         const std::vector<uint32_t>& dims = {}
-    );
+    ) {
+        _setValues(values.data(), values.size(), dims);
+    }
 
     #ifdef __cpp_lib_string_view
 
-        void setValues(
+        inline void setValues(
             const std::vector<std::string_view>& values,
             const std::vector<uint32_t>& dims = {}
-        );
+        ) {
+            _setValues(values.data(), values.size(), dims);
+        }
 
     #endif // __cpp_lib_string_view
 
@@ -235,7 +260,7 @@ public:
             std::span<const std::string> values,
             const std::vector<uint32_t>& dims = {}
         ) {
-            setValues(values, dims);
+            _setValues(values.data(), values.size(), dims);
         }
 
     #endif
@@ -307,9 +332,11 @@ public:
 
 protected:
 
+    // Pads every value to the longest and writes them straight into a newly allocated XD
+    template <typename StringType>
     void _setValues(
-        const std::string& buffer,
-        length_t length,
+        const StringType * values,
+        size_t count,
         const std::vector<uint32_t>& dims
     );
 
@@ -2,11 +2,18 @@
 #define MDSPLUS_STRING_INC_HPP
 
 #include "String.hpp"
+#include "DataRef.hpp"
+
+#include <limits>
 
 namespace mdsplus {
 
 inline void String::setValue(const char * value, length_t length)
 {
+    if (_setInline(DTYPE_T, value, length)) {
+        return;
+    }
+
     mdsdsc_s_t dsc = {
         length,
         DTYPE_T,
@@ -14,11 +21,7 @@ inline void String::setValue(const char * value, length_t length)
         (char *)value
     };
 
-    // TODO: Verify that this does free the existing XD
-    int status = MdsCopyDxXd((mdsdsc_t *)&dsc, &_xd);
-    if (IS_NOT_OK(status)) {
-        throwException(status);
-    }
+    _copyFrom((mdsdsc_t *)&dsc);
 }
 
 inline std::vector<std::string> StringArray::getValues() const
@@ -53,74 +56,62 @@ inline size_t StringArray::getSize() const
     return 0;
 }
 
-inline void StringArray::setValues(
-    const std::vector<std::string>& values,
-    const std::vector<uint32_t>& dims /*= {}*/
-) {
-    length_t maxSize = 0;
-    for (const auto& value : values) {
-        if (value.size() > maxSize) {
-            maxSize = value.size();
-        }
+#ifdef __cpp_lib_string_view
+
+    inline std::string_view StringArray::getStringViewAt(size_t index, bool trim /*= true*/) const
+    {
+        return ArrayRef(getDescriptor(), getTree()).getStringViewAt(index, trim);
     }
 
-    std::string buffer;
-    for (const auto& value : values) {
-        buffer += value;
-        for (length_t i = value.size(); i < maxSize; ++i) {
-            buffer.push_back(' ');
+    inline std::vector<std::string_view> StringArray::getStringViews(bool trim /*= true*/) const
+    {
+        std::vector<std::string_view> values(size());
+        for (size_t i = 0; i < values.size(); ++i) {
+            values[i] = getStringViewAt(i, trim);
         }
+        return values;
     }
 
-    if (dims.empty()) {
-        _setValues(buffer, maxSize, { length_t(values.size()) });
-    }
-    else {
-        _setValues(buffer, maxSize, dims);
+#endif // __cpp_lib_string_view
+
+template <typename StringType>
+inline void StringArray::_setValues(
+    const StringType * values,
+    size_t count,
+    const std::vector<uint32_t>& dims
+) {
+    std::vector<uint32_t> shape = dims;
+    if (shape.empty()) {
+        shape.push_back(uint32_t(count));
     }
-}
 
-#ifdef __cpp_lib_string_view
+    size_t expected = 1;
+    for (uint32_t dim : shape) {
+        expected *= dim;
+    }
 
-    inline void StringArray::setValues(
-        const std::vector<std::string_view>& values,
-        const std::vector<uint32_t>& dims /*= {}*/
-    ) {
-        length_t maxSize = 0;
-        for (const auto& value : values) {
-            if (value.size() > maxSize) {
-                maxSize = value.size();
-            }
-        }
+    if (shape.size() > MAX_DIMS || expected != count) {
+        throwException(TreeFAILURE);
+    }
 
-        std::string buffer;
-        for (const auto& value : values) {
-            buffer += value;
-            for (length_t i = value.size(); i < maxSize; ++i) {
-                buffer.push_back(' ');
-            }
-        }
+    // Zero length elements would make the number of elements impossible to compute from arsize
+    size_t maxSize = 1;
+    for (size_t i = 0; i < count; ++i) {
+        maxSize = std::max(maxSize, values[i].size());
+    }
 
-        if (dims.empty()) {
-            _setValues(buffer, maxSize, { length_t(values.size()) });
-        }
-        else {
-            _setValues(buffer, maxSize, dims);
-        }
+    // Every element is padded to the longest one, which has to fit in the descriptor's length and arsize
+    if (maxSize > std::numeric_limits<length_t>::max() || count > std::numeric_limits<arsize_t>::max() / maxSize) {
+        throwException(TreeBUFFEROVF);
     }
 
-#endif // __cpp_lib_string_view
+    length_t length = length_t(maxSize);
 
-inline void StringArray::_setValues(
-    const std::string& buffer,
-    length_t length,
-    const std::vector<uint32_t>& dims
-) {
     array_coeff dsc = {
         .length = length,
         .dtype = DTYPE_T,
         .class_ = CLASS_A,
-        .pointer = const_cast<char *>(buffer.data()),
+        .pointer = nullptr,
         .scale = 0,
         .digits = 0,
         .aflags = aflags_t{
@@ -130,20 +121,34 @@ inline void StringArray::_setValues(
             .coeff = true,
             .bounds = false,
         },
-        .dimct = dimct_t(dims.size()),
-        .arsize = arsize_t(buffer.size()),
-        .a0 = const_cast<char *>(buffer.data()),
+        .dimct = dimct_t(shape.size()),
+        .arsize = arsize_t(count * length),
+        .a0 = nullptr,
         .m = { 0 },
     };
 
-    for (size_t i = 0; i < dims.size(); ++i) {
-        dsc.m[i] = dims[i];
+    for (size_t i = 0; i < shape.size(); ++i) {
+        dsc.m[i] = shape[i];
     }
 
-    int status = MdsCopyDxXd((mdsdsc_t *)&dsc, &_xd);
+    // Allocate the array without copying anything into it, and then fill it in place
+    mdsdsc_xd_t xd = MDSDSC_XD_INITIALIZER;
+    dtype_t dtype = DTYPE_T;
+    int status = MdsGet1DxA((mdsdsc_a_t *)&dsc, &length, &dtype, &xd);
     if (IS_NOT_OK(status)) {
         throwException(status);
     }
+
+    char * buffer = reinterpret_cast<mdsdsc_a_t *>(xd.pointer)->pointer;
+    for (size_t i = 0; i < count; ++i) {
+        size_t size = values[i].size();
+        std::memcpy(buffer, values[i].data(), size);
+        std::memset(buffer + size, ' ', length - size);
+        buffer += length;
+    }
+
+    _free();
+    _xd = xd;
 }
 
 } // namespace mdsplus
@@ -0,0 +1,345 @@
+#ifndef MDSPLUS_TIMEBASE_HPP
+#define MDSPLUS_TIMEBASE_HPP
+
+#include "Data.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <utility>
+#include <vector>
+
+extern "C" {
+
+    // Needed for mdsdsc*_t, <dtypedef.h>, <classdef.h>
+    #include <mdsdescrip.h>
+
+} // extern "C"
+
+namespace mdsplus {
+
+///
+/// The first dimension of a signal, either uniform or an explicit array of times.
+///
+/// A uniform timebase, e.g. from a Range, only stores its start, delta and count, and computes
+/// each time when it is asked for, so it costs the same for 100M samples as it does for 10.
+///
+class Timebase
+{
+public:
+
+    /// Times within this fraction of a step of a uniform sample are treated as that sample, to allow for rounding.
+    static constexpr double Tolerance = 1e-6;
+
+    ///
+    /// Evaluate a dimension natively, if it is one of the common uniform cases:
+    ///
+    /// * Range(begin, ending, delta)
+    /// * Dimension(Window(startIdx, endIdx, valueAtIdx0), Range(begin, ending, delta))
+    ///
+    /// where each argument is a numeric scalar, and begin and ending can be omitted in a Dimension.
+    /// Nothing is copied or allocated to read the arguments.
+    ///
+    /// @returns std::nullopt for anything else, e.g. a Range of arrays, which has to be evaluated
+    /// with TDI instead.
+    ///
+    [[nodiscard]]
+    static std::optional<Timebase> FromDescriptor(const mdsdsc_t * dsc);
+
+    Timebase() = default;
+
+    ///
+    /// A uniform timebase of count samples, where sample i is at start + (i * delta).
+    ///
+    inline Timebase(double start, double delta, size_t count)
+        : _uniform(true)
+        , _start(start)
+        , _delta(delta)
+        , _count(count)
+    { }
+
+    ///
+    /// An explicit timebase, the times must be in increasing order.
+    ///
+    inline Timebase(std::vector<double>&& times)
+        : _count(times.size())
+        , _times(std::move(times))
+    { }
+
+    [[nodiscard]]
+    inline bool isUniform() const {
+        return _uniform;
+    }
+
+    [[nodiscard]]
+    inline size_t size() const {
+        return _count;
+    }
+
+    [[nodiscard]]
+    inline bool empty() const {
+        return (_count == 0);
+    }
+
+    ///
+    /// The time of the first sample, or 0 if there are none.
+    ///
+    [[nodiscard]]
+    inline double getStart() const {
+        if (_uniform) {
+            return _start;
+        }
+        return (_times.empty() ? 0.0 : _times.front());
+    }
+
+    ///
+    /// The time between samples, or 0 if the timebase isn't uniform.
+    ///
+    [[nodiscard]]
+    inline double getDelta() const {
+        return (_uniform ? _delta : 0.0);
+    }
+
+    ///
+    /// The time of sample index, throws TdiBadIndex if there is no such sample.
+    ///
+    [[nodiscard]]
+    inline double getTime(size_t index) const {
+        if (index >= _count) {
+            throw TdiBadIndex();
+        }
+        return (_uniform ? _start + (double(index) * _delta) : _times[index]);
+    }
+
+    [[nodiscard]]
+    inline double operator[](size_t index) const {
+        return getTime(index);
+    }
+
+    ///
+    /// The index of the last sample at or before time, or 0 if time is before the first sample.
+    ///
+    [[nodiscard]]
+    inline size_t getIndex(double time) const
+    {
+        if (_count == 0) {
+            return 0;
+        }
+
+        if (_uniform) {
+            // Clamped before the conversion, which is undefined for values that don't fit in a size_t, or NaN
+            double index = std::floor(((time - _start) / _delta) + Tolerance);
+            if (!(index > 0.0)) {
+                return 0;
+            }
+            return size_t(std::min(index, double(_count - 1)));
+        }
+
+        auto it = std::upper_bound(_times.begin(), _times.end(), time);
+        return (it == _times.begin() ? 0 : size_t(it - _times.begin()) - 1);
+    }
+
+    ///
+    /// The indices of the samples with times in [start, end], as [first, last).
+    ///
+    [[nodiscard]]
+    inline std::pair<size_t, size_t> getIndexRange(double start, double end) const
+    {
+        if (_uniform) {
+            double first = std::ceil(((start - _start) / _delta) - Tolerance);
+            double last = std::floor(((end - _start) / _delta) + Tolerance) + 1.0;
+
+            size_t begin = size_t(std::clamp(first, 0.0, double(_count)));
+            return { begin, std::max(begin, size_t(std::clamp(last, 0.0, double(_count)))) };
+        }
+
+        auto first = std::lower_bound(_times.begin(), _times.end(), start);
+        auto last = std::upper_bound(first, _times.end(), end);
+        return { size_t(first - _times.begin()), size_t(last - _times.begin()) };
+    }
+
+    ///
+    /// Write every time in the timebase to times, which must have room for size() values.
+    ///
+    template <typename TimeType = double>
+    inline void getTimes(TimeType * times) const
+    {
+        if (!_uniform) {
+            for (size_t i = 0; i < _count; ++i) {
+                times[i] = TimeType(_times[i]);
+            }
+            return;
+        }
+
+        // Computed from the index instead of by accumulating delta, which would also drift
+        for (size_t i = 0; i < _count; ++i) {
+            times[i] = TimeType(_start + (double(i) * _delta));
+        }
+    }
+
+    ///
+    /// Every time in the timebase, which computes all of them for a uniform timebase.
+    ///
+    template <typename TimeType = double>
+    [[nodiscard]]
+    inline std::vector<TimeType> getTimes() const
+    {
+        std::vector<TimeType> times(_count);
+        getTimes(times.data());
+        return times;
+    }
+
+private:
+
+    bool _uniform = false;
+
+    double _start = 0.0;
+
+    double _delta = 0.0;
+
+    size_t _count = 0;
+
+    // Only used if the timebase isn't uniform
+    std::vector<double> _times;
+
+    template <typename CType>
+    static inline double _read(const char * pointer) {
+        CType value;
+        std::memcpy(&value, pointer, sizeof(value));
+        return double(value);
+    }
+
+    // Read a numeric scalar in place, false for anything else
+    static inline bool _getScalar(const mdsdsc_t * dsc, double& value)
+    {
+        dsc = _unwrapDescriptor(dsc);
+        if (!dsc || dsc->class_ != CLASS_S || !dsc->pointer) {
+            return false;
+        }
+
+        switch (dsc->dtype) {
+        case DTYPE_B: value = _read<int8_t>(dsc->pointer); return true;
+        case DTYPE_BU: value = _read<uint8_t>(dsc->pointer); return true;
+        case DTYPE_W: value = _read<int16_t>(dsc->pointer); return true;
+        case DTYPE_WU: value = _read<uint16_t>(dsc->pointer); return true;
+        case DTYPE_L: value = _read<int32_t>(dsc->pointer); return true;
+        case DTYPE_LU: value = _read<uint32_t>(dsc->pointer); return true;
+        case DTYPE_Q: value = _read<int64_t>(dsc->pointer); return true;
+        case DTYPE_QU: value = _read<uint64_t>(dsc->pointer); return true;
+        case DTYPE_FS: value = _read<float>(dsc->pointer); return true;
+        case DTYPE_FT: value = _read<double>(dsc->pointer); return true;
+        default: return false;
+        }
+    }
+
+    // Read an argument that can be omitted, false if it is present but isn't a numeric scalar
+    static inline bool _getOptionalScalar(const mdsdsc_t * dsc, double& value, bool& present)
+    {
+        present = (_unwrapDescriptor(dsc) != nullptr);
+        return (!present || _getScalar(dsc, value));
+    }
+
+}; // class Timebase
+
+inline std::optional<Timebase> Timebase::FromDescriptor(const mdsdsc_t * dsc)
+{
+    dsc = _unwrapDescriptor(dsc);
+    if (!dsc || dsc->class_ != CLASS_R) {
+        return std::nullopt;
+    }
+
+    const mdsdsc_r_t * dscRecord = reinterpret_cast<const mdsdsc_r_t *>(dsc);
+
+    const mdsdsc_t * dscWindow = nullptr;
+    const mdsdsc_t * dscAxis = dsc;
+    if (dsc->dtype == DTYPE_DIMENSION) {
+        if (dscRecord->ndesc < 2) {
+            return std::nullopt;
+        }
+
+        dscWindow = _unwrapDescriptor(dscRecord->dscptrs[0]);
+        dscAxis = _unwrapDescriptor(dscRecord->dscptrs[1]);
+    }
+
+    if (!dscAxis || dscAxis->class_ != CLASS_R || dscAxis->dtype != DTYPE_RANGE) {
+        return std::nullopt;
+    }
+
+    const mdsdsc_r_t * dscRange = reinterpret_cast<const mdsdsc_r_t *>(dscAxis);
+    if (dscRange->ndesc < 2) {
+        return std::nullopt;
+    }
+
+    double begin = 0.0, ending = 0.0, delta = 1.0;
+    bool hasBegin, hasEnding, hasDelta;
+    if (!_getOptionalScalar(dscRange->dscptrs[0], begin, hasBegin) ||
+        !_getOptionalScalar(dscRange->dscptrs[1], ending, hasEnding) ||
+        !_getOptionalScalar(dscRange->ndesc > 2 ? dscRange->dscptrs[2] : nullptr, delta, hasDelta)) {
+        return std::nullopt;
+    }
+
+    if (!(delta > 0.0)) {
+        return std::nullopt;
+    }
+
+    if (!dscWindow) {
+        if (!hasBegin || !hasEnding) {
+            return std::nullopt;
+        }
+
+        double last = std::floor(((ending - begin) / delta) + Tolerance);
+        return Timebase(begin, delta, (last < 0.0 ? 0 : size_t(last) + 1));
+    }
+
+    if (dscWindow->class_ != CLASS_R || dscWindow->dtype != DTYPE_WINDOW) {
+        return std::nullopt;
+    }
+
+    const mdsdsc_r_t * dscWindowRecord = reinterpret_cast<const mdsdsc_r_t *>(dscWindow);
+    if (dscWindowRecord->ndesc < 2) {
+        return std::nullopt;
+    }
+
+    // An unbounded window can only be evaluated by TDI
+    double startIdx, endIdx, valueAtIdx0 = 0.0;
+    bool hasValueAtIdx0;
+    if (!_getScalar(dscWindowRecord->dscptrs[0], startIdx) ||
+        !_getScalar(dscWindowRecord->dscptrs[1], endIdx) ||
+        !_getOptionalScalar(dscWindowRecord->ndesc > 2 ? dscWindowRecord->dscptrs[2] : nullptr, valueAtIdx0, hasValueAtIdx0)) {
+        return std::nullopt;
+    }
+
+    // Index 0 is at the first point of the axis at or after valueAtIdx0
+    double origin;
+    if (hasBegin) {
+        origin = begin;
+        if (hasValueAtIdx0) {
+            origin += std::ceil(((valueAtIdx0 - begin) / delta) - Tolerance) * delta;
+        }
+    }
+    else if (hasValueAtIdx0) {
+        origin = valueAtIdx0;
+    }
+    else {
+        return std::nullopt;
+    }
+
+    // The window is clipped to the ends of the axis
+    double first = startIdx;
+    double last = endIdx;
+    if (hasBegin) {
+        first = std::max(first, std::ceil(((begin - origin) / delta) - Tolerance));
+    }
+    if (hasEnding) {
+        last = std::min(last, std::floor(((ending - origin) / delta) + Tolerance));
+    }
+
+    size_t count = (last < first ? 0 : size_t(last - first) + 1);
+    return Timebase(origin + (first * delta), delta, count);
+}
+
+} // namespace mdsplus
+
+#endif // MDSPLUS_TIMEBASE_HPP
@@ -0,0 +1,264 @@
+#ifndef MDSPLUS_TRACE_HPP
+#define MDSPLUS_TRACE_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+extern "C" {
+
+    #include <mdsdescrip.h>
+
+    // Needed for MDSplusSUCCESS
+    #include <mdsshr_messages.h>
+
+} // extern "C"
+
+namespace mdsplus {
+
+enum class TraceEvent
+{
+    // Tree::open()
+    Open,
+
+    // Reading records and segments from a tree
+    Read,
+
+    // Writing records and segments to a tree
+    Write,
+
+    // Compiling or executing TDI expressions
+    TDI,
+
+    // A round trip to an mdsip server
+    Network,
+};
+
+inline std::string to_string(const TraceEvent& event)
+{
+    switch (event) {
+    case TraceEvent::Open: return "TraceEvent::Open";
+    case TraceEvent::Read: return "TraceEvent::Read";
+    case TraceEvent::Write: return "TraceEvent::Write";
+    case TraceEvent::TDI: return "TraceEvent::TDI";
+    case TraceEvent::Network: return "TraceEvent::Network";
+    }
+
+    return "?";
+}
+
+///
+/// A single traced operation, passed to the sink once the operation has finished.
+///
+struct TraceSpan
+{
+    TraceEvent Event;
+
+    /// What the operation acted on, e.g. the tree and shot, node path, or expression.
+    std::string Name = {};
+
+    int Status = MDSplusSUCCESS;
+
+    /// The number of bytes read, written, or sent and received.
+    size_t Bytes = 0;
+
+    std::chrono::steady_clock::time_point Start = {};
+
+    std::chrono::nanoseconds Duration = {};
+
+    /// Any additional text, e.g. the error message returned by an mdsip server.
+    std::string Message = {};
+
+}; // struct TraceSpan
+
+///
+/// Process-wide tracing of tree, TDI and network operations.
+///
+/// Tracing is off until a sink is set. While it is off, every traced operation only
+/// pays for a single relaxed atomic load, no clocks are read and no strings are built.
+///
+/// The sink is called from whichever thread ran the operation, so it must be thread safe.
+///
+class Trace
+{
+public:
+
+    using Sink = std::function<void(const TraceSpan&)>;
+
+    [[nodiscard]]
+    static inline bool isEnabled() {
+        return _getEnabled().load(std::memory_order_relaxed);
+    }
+
+    ///
+    /// Set the function that receives every TraceSpan, or nullptr to turn tracing off.
+    ///
+    static inline void setSink(Sink sink)
+    {
+        std::lock_guard<std::mutex> lock(_getMutex());
+        _getSink() = (sink ? std::make_shared<Sink>(std::move(sink)) : nullptr);
+        _getEnabled().store(_getSink() != nullptr, std::memory_order_relaxed);
+    }
+
+    ///
+    /// A sink that prints one line per span to stderr, e.g. Trace::setSink(Trace::Print).
+    ///
+    static inline void Print(const TraceSpan& span)
+    {
+        fprintf(
+            stderr,
+            "%s %s status=%d bytes=%zu duration=%.3fms%s%s\n",
+            to_string(span.Event).c_str(),
+            span.Name.c_str(),
+            span.Status,
+            span.Bytes,
+            std::chrono::duration<double, std::milli>(span.Duration).count(),
+            (span.Message.empty() ? "" : " "),
+            span.Message.c_str()
+        );
+    }
+
+    static inline void emit(const TraceSpan& span)
+    {
+        std::shared_ptr<Sink> sink;
+        {
+            std::lock_guard<std::mutex> lock(_getMutex());
+            sink = _getSink();
+        }
+
+        // Call the sink without holding the lock, so it can trace or change the sink itself
+        if (sink) {
+            (*sink)(span);
+        }
+    }
+
+    ///
+    /// The number of bytes described by a descriptor, as far as it can be known without walking it.
+    ///
+    static inline size_t GetSize(const mdsdsc_t * dsc)
+    {
+        if (!dsc) {
+            return 0;
+        }
+
+        switch (dsc->class_) {
+        case CLASS_XD:
+            return reinterpret_cast<const mdsdsc_xd_t *>(dsc)->l_length;
+        case CLASS_A:
+        case CLASS_CA:
+        case CLASS_APD:
+            return reinterpret_cast<const mdsdsc_a_t *>(dsc)->arsize;
+        case CLASS_S:
+        case CLASS_D:
+            return dsc->length;
+        default: ;
+        }
+
+        return 0;
+    }
+
+private:
+
+    static inline std::atomic<bool>& _getEnabled() {
+        static std::atomic<bool> enabled = false;
+        return enabled;
+    }
+
+    static inline std::mutex& _getMutex() {
+        static std::mutex mutex;
+        return mutex;
+    }
+
+    static inline std::shared_ptr<Sink>& _getSink() {
+        static std::shared_ptr<Sink> sink;
+        return sink;
+    }
+
+}; // class Trace
+
+///
+/// Times an operation and passes it to the Trace sink when it goes out of scope.
+///
+/// Everything is skipped when tracing is off, so callers that need to build an
+/// expensive name should only do so if the scope is enabled, e.g.
+///
+///     TraceScope span(TraceEvent::Read);
+///     if (span) {
+///         span.setName(getFullPath());
+///     }
+///
+class TraceScope
+{
+public:
+
+    inline explicit TraceScope(TraceEvent event, std::string_view name = {})
+        : _enabled(Trace::isEnabled())
+    {
+        if (_enabled) {
+            _span.Event = event;
+            _span.Name = name;
+            _span.Start = std::chrono::steady_clock::now();
+        }
+    }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+    inline ~TraceScope()
+    {
+        if (_enabled) {
+            _span.Duration = std::chrono::steady_clock::now() - _span.Start;
+
+            // Exceptions can't escape a destructor, and a broken sink shouldn't break the caller
+            try {
+                Trace::emit(_span);
+            }
+            catch (...) { }
+        }
+    }
+
+    [[nodiscard]]
+    inline explicit operator bool() const {
+        return _enabled;
+    }
+
+    inline void setName(std::string_view name) {
+        if (_enabled) {
+            _span.Name = name;
+        }
+    }
+
+    inline void setStatus(int status) {
+        if (_enabled) {
+            _span.Status = status;
+        }
+    }
+
+    inline void addBytes(size_t bytes) {
+        if (_enabled) {
+            _span.Bytes += bytes;
+        }
+    }
+
+    inline void setMessage(std::string_view message) {
+        if (_enabled) {
+            _span.Message = message;
+        }
+    }
+
+private:
+
+    bool _enabled;
+
+    TraceSpan _span = { TraceEvent::Open };
+
+}; // class TraceScope
+
+} // namespace mdsplus
+
+#endif // MDSPLUS_TRACE_HPP
@@ -3,7 +3,12 @@
 
 #include "TreeNode.hpp"
 
+#include <atomic>
 #include <climits>
+#include <filesystem>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
 
 extern "C" {
 
@@ -34,6 +39,9 @@ Mode from_string(const std::string& mode); // TODO: Rename?
 
 class Tree : public TreeNode
 {
+    // For the segment index used by TreeNode::readWindow()
+    friend class TreeNode;
+
 public:
 
     // TODO: Rename public? global? ~~current~~? 
@@ -44,6 +52,17 @@ public:
         TreeSwitchDbid(getDBID());
     }
 
+    ///
+    /// Find all of the shots of a tree by searching its path for <tree>_<shot>.tree files.
+    ///
+    /// The path defaults to <tree>_path, and can list multiple directories separated by ';'.
+    /// The contents of each directory are cached and only rescanned when the modification
+    /// time of the directory changes, so repeated queries only stat() the directories.
+    ///
+    /// @param lower The lowest shot number to include.
+    /// @param higher The highest shot number to include.
+    /// @returns The sorted list of shots, without the model (-1).
+    ///
     static std::vector<int> getShotDB(
         const std::string& treename,
         const std::string& path = "",
@@ -51,6 +70,11 @@ public:
         int higher = INT_MAX
     );
 
+    ///
+    /// Forget the directory contents cached by getShotDB().
+    ///
+    static void clearShotDBCache();
+
     Tree() = default;
 
     inline Tree(const std::string& treename, int shot, Mode mode = Mode::Normal, const std::string& path = {})
@@ -88,19 +112,23 @@ public:
     inline Tree(Tree&& other)
     {
         // TODO: Improve
+        std::swap(_path, other._path);
         std::swap(_treename, other._treename);
         std::swap(_shot, other._shot);
         std::swap(_mode, other._mode);
         std::swap(_dbid, other._dbid);
+        std::swap(_segmentIndexes, other._segmentIndexes);
     }
 
     inline Tree& operator=(Tree&& other)
     {
         // TODO: Improve
+        std::swap(_path, other._path);
         std::swap(_treename, other._treename);
         std::swap(_shot, other._shot);
         std::swap(_mode, other._mode);
         std::swap(_dbid, other._dbid);
+        std::swap(_segmentIndexes, other._segmentIndexes);
         return *this;
     }
 
@@ -139,14 +167,37 @@ public:
         return _mode;
     }
 
+    [[nodiscard]]
+    inline std::string getTreePath() const {
+        return _path;
+    }
+
+    // Takes effect on the next call to open()
+    inline void setTreePath(const std::string& path) {
+        _path = path;
+    }
+
     inline int64_t getDatafileSize() {
         return _TreeGetDatafileSize(getDBID());
     }
 
     std::string getFileName(const std::string& subtree = {});
 
+    ///
+    /// Open a tree, using the path from the constructor or setTreePath() in place of <tree>_path if it is set.
+    ///
+    /// Opening with a path override cannot run concurrently with other opens in the same process,
+    /// opens without an override can.
+    ///
+    /// treeshr only reads <tree>_path from the environment, so the override is set there with
+    /// setenv() for the duration of the open. Only opens through this class wait for it, so any
+    /// other code in the process that reads the environment, e.g. getenv() or TreeOpen() called
+    /// directly, still has to be kept from running at the same time by the caller.
+    ///
     void open(const std::string& treename, int shot, Mode mode = Mode::Normal);
 
+    void open(const std::string& treename, int shot, Mode mode, const std::string& path);
+
     inline void reopen() {
         open(getTreeName(), getShot(), getMode());
     }
@@ -231,6 +282,45 @@ public:
 
 private:
 
+    struct _ShotDBDirectory
+    {
+        std::filesystem::file_time_type LastWriteTime = {};
+
+        // Set when the directory was scanned too soon after it was modified to trust its time
+        bool Stale = true;
+
+        // Shot numbers for each lowercase tree name, sorted
+        std::unordered_map<std::string, std::vector<int>> Shots = {};
+    };
+
+    // The start and end of every segment of a node, as doubles
+    struct _SegmentIndex
+    {
+        std::vector<double> Starts = {};
+
+        std::vector<double> Ends = {};
+
+        bool Loaded = false;
+
+        // The value of _getSegmentWriteCount() when the index was last refreshed
+        uint64_t WriteCount = 0;
+    };
+
+    static std::shared_mutex& _getOpenMutex();
+
+    static std::mutex& _getShotDBMutex();
+
+    // Incremented by every segment or record written by any Tree in this process, see TreeNode::readWindow()
+    static std::atomic<uint64_t>& _getSegmentWriteCount();
+
+    static std::unordered_map<std::string, _ShotDBDirectory>& _getShotDBCache();
+
+    static std::vector<std::filesystem::path> _getShotDBDirectories(const std::string& treename, const std::string& path);
+
+    static void _expandShotDBDirectory(const std::string& pattern, std::vector<std::filesystem::path>& directories);
+
+    static void _scanShotDBDirectory(const std::filesystem::path& directory, _ShotDBDirectory& entry);
+
     void * _dbid = nullptr;
 
     std::string _path;
@@ -241,6 +331,13 @@ private:
 
     Mode _mode = Mode::Normal;
 
+    mutable std::mutex _segmentIndexMutex;
+
+    // Indexed by NID, see TreeNode::readWindow()
+    mutable std::unordered_map<int, _SegmentIndex> _segmentIndexes;
+
+    int _open();
+
     template <typename ResultType>
     ResultType _getDBI(int16_t code) const;
 
@@ -5,6 +5,12 @@
 #include "TreeNode.hpp"
 #include "DataView.hpp"
 #include "String.hpp"
+#include "Trace.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <string_view>
 
 namespace mdsplus {
 
@@ -14,8 +20,195 @@ inline std::vector<int> Tree::getShotDB(
     int lower /*= INT_MIN */,
     int higher /*= INT_MAX */
 ) {
-    // TODO:
-    return {};
+    std::string lowerTreename(treename);
+    for (auto& c : lowerTreename) {
+        c = ::tolower(c);
+    }
+
+    const auto& directories = _getShotDBDirectories(lowerTreename, path);
+
+    std::vector<int> shots;
+
+    std::lock_guard<std::mutex> lock(_getShotDBMutex());
+    auto& cache = _getShotDBCache();
+
+    for (const auto& directory : directories) {
+        std::error_code ec;
+        auto lastWriteTime = std::filesystem::last_write_time(directory, ec);
+        if (ec) {
+            // Missing directories are skipped, the same as when opening a tree
+            continue;
+        }
+
+        auto& entry = cache[directory.string()];
+        if (entry.Stale || entry.LastWriteTime != lastWriteTime) {
+            entry.LastWriteTime = lastWriteTime;
+            _scanShotDBDirectory(directory, entry);
+        }
+
+        auto it = entry.Shots.find(lowerTreename);
+        if (it != entry.Shots.end()) {
+            const auto& treeShots = it->second;
+            auto first = std::lower_bound(treeShots.begin(), treeShots.end(), lower);
+            auto last = std::upper_bound(first, treeShots.end(), higher);
+            shots.insert(shots.end(), first, last);
+        }
+    }
+
+    // The same shot can be found in more than one directory
+    std::sort(shots.begin(), shots.end());
+    shots.erase(std::unique(shots.begin(), shots.end()), shots.end());
+
+    return shots;
+}
+
+inline void Tree::clearShotDBCache()
+{
+    std::lock_guard<std::mutex> lock(_getShotDBMutex());
+    _getShotDBCache().clear();
+}
+
+inline std::mutex& Tree::_getShotDBMutex()
+{
+    static std::mutex mutex;
+    return mutex;
+}
+
+inline std::atomic<uint64_t>& Tree::_getSegmentWriteCount()
+{
+    static std::atomic<uint64_t> count = 0;
+    return count;
+}
+
+inline std::unordered_map<std::string, Tree::_ShotDBDirectory>& Tree::_getShotDBCache()
+{
+    static std::unordered_map<std::string, _ShotDBDirectory> cache;
+    return cache;
+}
+
+inline std::vector<std::filesystem::path> Tree::_getShotDBDirectories(const std::string& treename, const std::string& path)
+{
+    std::string treePath = path;
+    if (treePath.empty()) {
+        // Don't read the environment while Tree::open() is overriding a path
+        std::shared_lock<std::shared_mutex> lock(_getOpenMutex());
+
+        std::string envName = treename + "_path";
+        const char * envPath = ::getenv(envName.c_str());
+        if (!envPath) {
+            envPath = ::getenv("default_tree_path");
+        }
+
+        if (envPath) {
+            treePath = envPath;
+        }
+    }
+
+    // e.g. /trees/~t/ -> /trees/mytree/
+    size_t pos = 0;
+    while ((pos = treePath.find("~t", pos)) != std::string::npos) {
+        treePath.replace(pos, 2, treename);
+        pos += treename.size();
+    }
+
+    std::vector<std::filesystem::path> directories;
+
+    size_t begin = 0;
+    while (begin <= treePath.size()) {
+        size_t end = treePath.find(';', begin);
+        if (end == std::string::npos) {
+            end = treePath.size();
+        }
+
+        std::string entry = treePath.substr(begin, end - begin);
+        begin = end + 1;
+
+        // Trim whitespace
+        entry.erase(0, entry.find_first_not_of(" \t"));
+        entry.erase(entry.find_last_not_of(" \t") + 1);
+
+        // Remote paths, e.g. server::/trees/, cannot be searched locally
+        if (entry.empty() || entry.find("::") != std::string::npos) {
+            continue;
+        }
+
+        _expandShotDBDirectory(entry, directories);
+    }
+
+    return directories;
+}
+
+inline void Tree::_expandShotDBDirectory(const std::string& pattern, std::vector<std::filesystem::path>& directories)
+{
+    // Directories can contain ~a through ~j, which are replaced with digits of the shot number
+    size_t tilde = pattern.find('~');
+    if (tilde == std::string::npos) {
+        directories.emplace_back(pattern);
+        return;
+    }
+
+    // Search every subdirectory in place of the directory name containing the ~
+    size_t slash = pattern.rfind('/', tilde);
+    std::string parent = (slash == std::string::npos ? "." : pattern.substr(0, slash + 1));
+
+    size_t next = pattern.find('/', tilde);
+    std::string rest = (next == std::string::npos ? "" : pattern.substr(next));
+
+    std::error_code ec;
+    std::filesystem::directory_iterator it(parent, ec);
+    for (; !ec && it != std::filesystem::directory_iterator(); it.increment(ec)) {
+        if (it->is_directory(ec)) {
+            _expandShotDBDirectory(it->path().string() + rest, directories);
+        }
+    }
+}
+
+inline void Tree::_scanShotDBDirectory(const std::filesystem::path& directory, _ShotDBDirectory& entry)
+{
+    static constexpr std::string_view extension = ".tree";
+
+    entry.Shots.clear();
+
+    // A file added within the resolution of the filesystem's timestamps would not change the
+    // modification time, so anything modified recently is scanned again on the next query
+    auto age = std::filesystem::file_time_type::clock::now() - entry.LastWriteTime;
+    entry.Stale = (age < std::chrono::seconds(2));
+
+    std::error_code ec;
+    std::filesystem::directory_iterator it(directory, ec);
+    for (; !ec && it != std::filesystem::directory_iterator(); it.increment(ec)) {
+        // e.g. mytree_123.tree
+        const std::string filename = it->path().filename().string();
+        if (filename.size() <= extension.size() ||
+            filename.compare(filename.size() - extension.size(), extension.size(), extension) != 0) {
+            continue;
+        }
+
+        const char * end = filename.data() + filename.size() - extension.size();
+
+        size_t underscore = filename.rfind('_', filename.size() - extension.size() - 1);
+        if (underscore == std::string::npos || underscore == 0) {
+            continue;
+        }
+
+        const char * begin = filename.data() + underscore + 1;
+        if (begin == end || !::isdigit(*begin)) {
+            // e.g. mytree_model.tree
+            continue;
+        }
+
+        int shot = 0;
+        auto result = std::from_chars(begin, end, shot);
+        if (result.ec != std::errc() || result.ptr != end) {
+            continue;
+        }
+
+        entry.Shots[filename.substr(0, underscore)].push_back(shot);
+    }
+
+    for (auto& it : entry.Shots) {
+        std::sort(it.second.begin(), it.second.end());
+    }
 }
 
 inline std::string Tree::getFileName(const std::string& subtree /*= {}*/)
@@ -60,48 +253,51 @@ inline void Tree::open(const std::string& treename, int shot, Mode mode /*= Mode
     _treename = treename;
     _shot = shot;
     _mode = mode;
-    
-    std::string env_name;
-    const char * old_path = nullptr;
-    if (!_path.empty()) {
-        std::string lower(_treename);
-        for (auto& c : lower) {
-            c = ::tolower(c);
-        }
 
-        std::string env_name = lower + "_path";
-
-        old_path = ::getenv(env_name.c_str());
-        ::setenv(env_name.c_str(), _path.c_str(), true);
+    {
+        std::lock_guard<std::mutex> lock(_segmentIndexMutex);
+        _segmentIndexes.clear();
     }
 
-    printf("%d\n", _shot);
+    TraceScope span(TraceEvent::Open);
+    if (span) {
+        span.setName(_treename + ", " + std::to_string(_shot));
+    }
 
-    switch (_mode) {
-    case Mode::Normal:
-        status = _TreeOpen(&_dbid, _treename.c_str(), _shot, 0);
-        break;
-    case Mode::ReadOnly:
-        status = _TreeOpen(&_dbid, _treename.c_str(), _shot, 1);
-        break;
-    case Mode::Edit:
-        status = _TreeOpenEdit(&_dbid, _treename.c_str(), _shot);
-        break;
-    case Mode::New:
-        status = _TreeOpenNew(&_dbid, _treename.c_str(), _shot);
-        break;
-    default: ;
+    if (_path.empty()) {
+        std::shared_lock<std::shared_mutex> lock(_getOpenMutex());
+        status = _open();
     }
+    else {
+        // TreeOpen only reads <tree>_path from the environment, so the override has to be set
+        // there for the duration of the open. Holding the lock exclusively ensures no other
+        // open, or getShotDB(), can see it.
+        std::unique_lock<std::shared_mutex> lock(_getOpenMutex());
+
+        std::string envName(_treename);
+        for (auto& c : envName) {
+            c = ::tolower(c);
+        }
+        envName += "_path";
+
+        // The pointer returned by getenv() is not guaranteed to survive setenv()
+        const char * envPath = ::getenv(envName.c_str());
+        bool hasOldPath = (envPath != nullptr);
+        std::string oldPath = (hasOldPath ? envPath : "");
+
+        ::setenv(envName.c_str(), _path.c_str(), true);
 
-    if (!_path.empty()) {
-        if (old_path) {
-            ::setenv(env_name.c_str(), old_path, true);
+        status = _open();
+
+        if (hasOldPath) {
+            ::setenv(envName.c_str(), oldPath.c_str(), true);
         }
         else {
-            ::unsetenv(env_name.c_str());
+            ::unsetenv(envName.c_str());
         }
     }
 
+    span.setStatus(status);
     if (IS_NOT_OK(status)) {
         throwException(status);
     }
@@ -111,6 +307,35 @@ inline void Tree::open(const std::string& treename, int shot, Mode mode /*= Mode
     _nid = 0;
 }
 
+inline void Tree::open(const std::string& treename, int shot, Mode mode, const std::string& path)
+{
+    _path = path;
+    open(treename, shot, mode);
+}
+
+inline int Tree::_open()
+{
+    switch (_mode) {
+    case Mode::Normal:
+        return _TreeOpen(&_dbid, _treename.c_str(), _shot, 0);
+    case Mode::ReadOnly:
+        return _TreeOpen(&_dbid, _treename.c_str(), _shot, 1);
+    case Mode::Edit:
+        return _TreeOpenEdit(&_dbid, _treename.c_str(), _shot);
+    case Mode::New:
+        return _TreeOpenNew(&_dbid, _treename.c_str(), _shot);
+    default: ;
+    }
+
+    return TreeFAILURE;
+}
+
+inline std::shared_mutex& Tree::_getOpenMutex()
+{
+    static std::shared_mutex mutex;
+    return mutex;
+}
+
 inline void Tree::close()
 {
     int status = _TreeClose(&_dbid, nullptr, 0);
@@ -118,6 +343,11 @@ inline void Tree::close()
         throwException(status);
     }
 
+    {
+        std::lock_guard<std::mutex> lock(_segmentIndexMutex);
+        _segmentIndexes.clear();
+    }
+
     // Cleanup TreeNode
     _tree = nullptr;
     _nid = -1;
@@ -225,8 +455,12 @@ ResultType Tree::compileData(const std::string& expression, const ArgTypes&... a
         dscList.push_back(arg.getDescriptor());
     }
 
+    TraceScope span(TraceEvent::TDI, expression);
+
     mdsdsc_xd_t out = MDSDSC_XD_INITIALIZER;
     int status = TdiIntrinsic(OPC_COMPILE, dscList.size(), dscList.data(), &out);
+    span.setStatus(status);
+    span.addBytes(out.l_length);
     if (IS_NOT_OK(status)) {
         throwException(status);
     }
@@ -245,8 +479,12 @@ ResultType Tree::executeData(const std::string& expression, const ArgTypes&... a
         dscList.push_back(arg.getDescriptor());
     }
 
+    TraceScope span(TraceEvent::TDI, expression);
+
     mdsdsc_xd_t out = MDSDSC_XD_INITIALIZER;
     int status = _TdiIntrinsic(getContext(), OPC_EXECUTE, dscList.size(), dscList.data(), &out);
+    span.setStatus(status);
+    span.addBytes(out.l_length);
     if (IS_NOT_OK(status)) {
         throwException(status);
     }
@@ -0,0 +1,126 @@
+#ifndef MDSPLUS_TREE_CACHE_HPP
+#define MDSPLUS_TREE_CACHE_HPP
+
+#include "Tree.hpp"
+
+#include <future>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <tuple>
+
+namespace mdsplus {
+
+///
+/// Shares read-only Trees between everything in the process that opens the same shot.
+///
+/// The first call to open() for a (tree, shot, path) opens it with Mode::ReadOnly, and
+/// every following call returns a handle to the same Tree until it is evicted. Callers
+/// opening a shot that another thread is still opening wait for that open to finish
+/// instead of opening it again.
+///
+/// Once more than getMaxOpen() shots have been opened, the least recently used shots that
+/// no handle refers to are closed first. If every shot is in use, the least recently used
+/// one is dropped from the cache and closed when its last handle is released.
+///
+/// TreeNodes and Data read through a handle refer to its Tree, so the handle has to be
+/// kept alive for as long as they are used.
+///
+class TreeCache
+{
+public:
+
+    using Handle = std::shared_ptr<const Tree>;
+
+    ///
+    /// The cache shared by the whole process.
+    ///
+    static TreeCache& GetGlobal() {
+        static TreeCache cache;
+        return cache;
+    }
+
+    inline explicit TreeCache(size_t maxOpen = 16)
+        : _maxOpen(maxOpen)
+    { }
+
+    // Handles refer to Trees owned by the cache
+    TreeCache(const TreeCache&) = delete;
+    TreeCache& operator=(const TreeCache&) = delete;
+
+    ///
+    /// Return a handle to the read-only Tree for this shot, opening it if it isn't already open.
+    ///
+    /// Shot 0 means the current shot, which can change at any time, so it is always opened
+    /// directly and never cached.
+    ///
+    /// @param path Used in place of <tree>_path, see Tree::setTreePath().
+    ///
+    Handle open(const std::string& treename, int shot, const std::string& path = {});
+
+    ///
+    /// Drop a shot from the cache, e.g. after it has been rewritten. Existing handles stay valid.
+    ///
+    void erase(const std::string& treename, int shot, const std::string& path = {});
+
+    ///
+    /// Drop every shot from the cache. Existing handles stay valid.
+    ///
+    void clear();
+
+    [[nodiscard]]
+    size_t getMaxOpen() const;
+
+    void setMaxOpen(size_t maxOpen);
+
+    ///
+    /// The number of shots currently held by the cache.
+    ///
+    [[nodiscard]]
+    size_t getOpenCount() const;
+
+    [[nodiscard]]
+    size_t getHitCount() const;
+
+    [[nodiscard]]
+    size_t getMissCount() const;
+
+private:
+
+    // Lowercase tree name, shot, path
+    using _Key = std::tuple<std::string, int, std::string>;
+
+    struct _Entry
+    {
+        // Ready once the Tree has finished opening
+        std::shared_future<Handle> Future;
+
+        // Position in _recent
+        std::list<_Key>::iterator Recent;
+    };
+
+    mutable std::mutex _mutex;
+
+    size_t _maxOpen;
+
+    size_t _hitCount = 0;
+
+    size_t _missCount = 0;
+
+    // Most recently used first
+    std::list<_Key> _recent;
+
+    std::map<_Key, _Entry> _entries;
+
+    static _Key _makeKey(const std::string& treename, int shot, const std::string& path);
+
+    // Must be called with _mutex locked
+    void _evict();
+
+}; // class TreeCache
+
+} // namespace mdsplus
+
+#endif // MDSPLUS_TREE_CACHE_HPP
@@ -0,0 +1,169 @@
+#ifndef MDSPLUS_TREE_CACHE_INC_HPP
+#define MDSPLUS_TREE_CACHE_INC_HPP
+
+#include "TreeCache.hpp"
+#include "Tree.hpp"
+
+#include <chrono>
+
+namespace mdsplus {
+
+inline TreeCache::Handle TreeCache::open(const std::string& treename, int shot, const std::string& path /*= {}*/)
+{
+    if (shot == 0) {
+        return std::make_shared<const Tree>(treename, shot, Mode::ReadOnly, path);
+    }
+
+    _Key key = _makeKey(treename, shot, path);
+
+    std::promise<Handle> promise;
+
+    std::unique_lock<std::mutex> lock(_mutex);
+
+    auto it = _entries.find(key);
+    if (it != _entries.end()) {
+        ++_hitCount;
+        _recent.splice(_recent.begin(), _recent, it->second.Recent);
+        auto future = it->second.Future;
+
+        // Wait outside of the lock, in case another thread is still opening it
+        lock.unlock();
+        return future.get();
+    }
+
+    ++_missCount;
+    _recent.push_front(key);
+    _entries.emplace(key, _Entry{ promise.get_future().share(), _recent.begin() });
+
+    lock.unlock();
+
+    Handle tree;
+    try {
+        tree = std::make_shared<const Tree>(treename, shot, Mode::ReadOnly, path);
+    }
+    catch (...) {
+        lock.lock();
+        it = _entries.find(key);
+        if (it != _entries.end()) {
+            _recent.erase(it->second.Recent);
+            _entries.erase(it);
+        }
+        lock.unlock();
+
+        // Anyone waiting on this open gets the same exception
+        promise.set_exception(std::current_exception());
+        throw;
+    }
+
+    promise.set_value(tree);
+
+    lock.lock();
+    _evict();
+
+    return tree;
+}
+
+inline void TreeCache::erase(const std::string& treename, int shot, const std::string& path /*= {}*/)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    auto it = _entries.find(_makeKey(treename, shot, path));
+    if (it != _entries.end()) {
+        _recent.erase(it->second.Recent);
+        _entries.erase(it);
+    }
+}
+
+inline void TreeCache::clear()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _recent.clear();
+    _entries.clear();
+}
+
+inline size_t TreeCache::getMaxOpen() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _maxOpen;
+}
+
+inline void TreeCache::setMaxOpen(size_t maxOpen)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _maxOpen = maxOpen;
+    _evict();
+}
+
+inline size_t TreeCache::getOpenCount() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _entries.size();
+}
+
+inline size_t TreeCache::getHitCount() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _hitCount;
+}
+
+inline size_t TreeCache::getMissCount() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _missCount;
+}
+
+inline TreeCache::_Key TreeCache::_makeKey(const std::string& treename, int shot, const std::string& path)
+{
+    // Tree names are case insensitive
+    std::string lowerTreename(treename);
+    for (auto& c : lowerTreename) {
+        c = ::tolower(c);
+    }
+
+    return _Key(std::move(lowerTreename), shot, path);
+}
+
+inline void TreeCache::_evict()
+{
+    auto isReady = [](const _Entry& entry) {
+        return (entry.Future.wait_for(std::chrono::seconds(0)) == std::future_status::ready);
+    };
+
+    while (_entries.size() > _maxOpen) {
+        // Prefer the least recently used shot that nothing is using, so it is actually closed
+        auto victim = _entries.end();
+        auto fallback = _entries.end();
+
+        for (auto recent = _recent.rbegin(); recent != _recent.rend(); ++recent) {
+            auto it = _entries.find(*recent);
+            if (!isReady(it->second)) {
+                // Still being opened
+                continue;
+            }
+
+            if (fallback == _entries.end()) {
+                fallback = it;
+            }
+
+            if (it->second.Future.get().use_count() == 1) {
+                victim = it;
+                break;
+            }
+        }
+
+        if (victim == _entries.end()) {
+            victim = fallback;
+        }
+
+        if (victim == _entries.end()) {
+            break;
+        }
+
+        _recent.erase(victim->second.Recent);
+        _entries.erase(victim);
+    }
+}
+
+} // namespace mdsplus
+
+#endif // MDSPLUS_TREE_CACHE_INC_HPP
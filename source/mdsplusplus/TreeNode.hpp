@@ -3,6 +3,7 @@
 
 #include "Data.hpp"
 #include "Exceptions.hpp"
+#include "Trace.hpp"
 
 #ifdef __cpp_lib_optional
     #include <optional>
@@ -66,6 +67,21 @@ static_assert(sizeof(TreeNodeFlags) == sizeof(uint32_t),
 
 std::string to_string(const TreeNodeFlags& flags);
 
+///
+/// The shape of a single segment, as returned by TreeNode::getSegmentInfo().
+///
+struct SegmentInfo
+{
+    DType Type = DType::Missing;
+
+    /// The dimensions of the whole segment, the last of which is the number of rows it can hold.
+    std::vector<uint32_t> Dimensions = {};
+
+    /// The number of rows that have been written so far.
+    int RowsFilled = 0;
+
+}; // struct SegmentInfo
+
 class Tree;
 class DataView;
 
@@ -498,6 +514,11 @@ public:
     template <typename ValueType>
     void putRow(int segmentLength, const ValueType& value, int64_t timestamp);
 
+    ///
+    /// Write one or more rows into the last segment, e.g. one allocated by beginSegment().
+    ///
+    /// @param index The row to start writing at, or -1 to write after the last filled row.
+    ///
     template <typename ValueArrayType>
     void putSegment(const ValueArrayType& values, int index = -1);
 
@@ -509,6 +530,72 @@ public:
     template <typename ValueArrayType>
     void putTimestampedSegment(int64_t * timestamps, const ValueArrayType& values);
 
+    ///
+    /// Allocate a segment with initialValues, to be filled in later with putSegment().
+    ///
+    /// The shape and type of the segment come from initialValues, and the last dimension is the
+    /// number of rows. Nothing is marked as filled until putSegment() writes to it.
+    ///
+    /// @param index The index of the segment to replace, or -1 to add a new segment.
+    ///
+    template <
+        typename StartIndexType,
+        typename EndIndexType,
+        typename DimensionType,
+        typename ValueArrayType
+    >
+    void beginSegment(
+        const StartIndexType& startIndex,
+        const EndIndexType& endIndex,
+        const DimensionType& dimension,
+        const ValueArrayType& initialValues,
+        int index = -1
+    ) const;
+
+    ///
+    /// Allocate a timestamped segment with initialValues, to be filled in later with putTimestampedSegment().
+    ///
+    template <typename ValueArrayType>
+    void beginTimestampedSegment(const ValueArrayType& initialValues, int index = -1) const;
+
+    ///
+    /// Allocate a segment of rows rows of zeros, each of rowDims values, without building the values first.
+    ///
+    template <
+        typename ValueType,
+        typename StartIndexType,
+        typename EndIndexType,
+        typename DimensionType
+    >
+    void allocateSegment(
+        const StartIndexType& startIndex,
+        const EndIndexType& endIndex,
+        const DimensionType& dimension,
+        uint32_t rows,
+        const std::vector<uint32_t>& rowDims = {},
+        int index = -1
+    ) const;
+
+    template <typename ValueType>
+    void allocateTimestampedSegment(uint32_t rows, const std::vector<uint32_t>& rowDims = {}, int index = -1) const;
+
+    ///
+    /// Replace the start, end and dimension of a segment, e.g. once a segment from beginSegment() is full.
+    ///
+    /// @param index The index of the segment, or -1 for the last segment.
+    ///
+    template <
+        typename StartIndexType,
+        typename EndIndexType,
+        typename DimensionType
+    >
+    void updateSegment(
+        const StartIndexType& startIndex,
+        const EndIndexType& endIndex,
+        const DimensionType& dimension,
+        int index = -1
+    ) const;
+
     template <
         typename StartIndexType,
         typename EndIndexType,
@@ -541,17 +628,61 @@ public:
         int rowsFilled = -1
     ) const;
 
-    // template <typename StartIndexType, typename EndIndexType, typename DimensionType, typename ValueArrayType>
-    // void makeSegmentMinMax(
-    //     const StartIndexType& startIndex,
-    //     const EndIndexType& endIndex,
-    //     const DimensionType& dimension,
-    //     const ValueArrayType& values,
-    //     const TreeNode& resampleNode,
-    //     int resampleFactor,
-    //     int index = -1,
-    //     int rowsFilled = -1
-    // ) const;
+    ///
+    /// Write a segment, and have treeshr write its minimum and maximum every resampleFactor samples to resampleNode.
+    ///
+    template <
+        typename StartIndexType,
+        typename EndIndexType,
+        typename DimensionType,
+        typename ValueArrayType
+    >
+    void makeSegmentMinMax(
+        const StartIndexType& startIndex,
+        const EndIndexType& endIndex,
+        const DimensionType& dimension,
+        const ValueArrayType& values,
+        const TreeNode& resampleNode,
+        int resampleFactor,
+        int index = -1,
+        int rowsFilled = -1
+    ) const;
+
+    ///
+    /// Write a segment sampled at a fixed rate, along with segments of its minimum, maximum and mean every factor samples.
+    ///
+    /// The decimated values are computed by decimate() before anything is written. The time of each
+    /// decimated sample is the time of the first sample it was computed from. The mean is written
+    /// as Float64. Any of minNode, maxNode and meanNode can be a default constructed TreeNode to skip it.
+    ///
+    /// @param start The time of the first sample.
+    /// @param delta The time between samples.
+    ///
+    template <typename ValueType>
+    void makeSegmentDecimated(
+        double start,
+        double delta,
+        const ValueType * values,
+        uint32_t count,
+        uint32_t factor,
+        const TreeNode& minNode,
+        const TreeNode& maxNode,
+        const TreeNode& meanNode = {}
+    ) const;
+
+    template <typename ValueType>
+    inline void makeSegmentDecimated(
+        double start,
+        double delta,
+        const std::vector<ValueType>& values,
+        uint32_t factor,
+        const TreeNode& minNode,
+        const TreeNode& maxNode,
+        const TreeNode& meanNode = {}
+    ) const
+    {
+        makeSegmentDecimated(start, delta, values.data(), uint32_t(values.size()), factor, minNode, maxNode, meanNode);
+    }
 
     // template <typename TimestampArrayType, typename ValueArrayType>
     // inline void makeTimestampedSegment(
@@ -588,6 +719,59 @@ public:
         int rowsFilled = -1
     ) const;
 
+    ///
+    /// Get the number of segments stored in this node, or 0 if it is not segmented.
+    ///
+    [[nodiscard]]
+    int getNumSegments() const;
+
+    ///
+    /// Read a single segment without assembling the rest of the signal.
+    ///
+    /// The values are returned as an array that owns the segment's memory, its values can
+    /// be accessed without copying through e.g. Float64Array::getSpan() and getDimensions().
+    ///
+    /// @param index The index of the segment, from 0 to getNumSegments() - 1.
+    /// @returns A tuple of { values, dimension }.
+    ///
+    template <typename ValueArrayType = Data, typename DimensionType = Data>
+    [[nodiscard]]
+    std::tuple<ValueArrayType, DimensionType> getSegment(int index) const;
+
+    ///
+    /// Read the start and end of a single segment, e.g. the first and last timestamp.
+    ///
+    /// @returns A tuple of { start, end }.
+    ///
+    template <typename StartType = Data, typename EndType = StartType>
+    [[nodiscard]]
+    std::tuple<StartType, EndType> getSegmentLimits(int index) const;
+
+    ///
+    /// Read the type and shape of a single segment without reading its values.
+    ///
+    /// @param index The index of the segment, or -1 for the last segment.
+    ///
+    [[nodiscard]]
+    SegmentInfo getSegmentInfo(int index = -1) const;
+
+    ///
+    /// Read the rows of a segmented signal whose time is between start and end, inclusive.
+    ///
+    /// Only the segments overlapping the window are read, and the rows outside of it are trimmed.
+    /// The start and end of every segment are cached by the Tree and searched with a binary search,
+    /// so repeated calls don't read anything but the segments themselves. The cache is refreshed
+    /// after any segment or record is written through this library, in any Tree. Segments written
+    /// by other processes are not detected until the tree is reopened. The cached times are stored
+    /// as doubles.
+    ///
+    /// @tparam ValueArrayType The type to read the values as, e.g. Float32Array.
+    /// @returns A tuple of { values, times }, where the values of multi-dimensional rows are concatenated.
+    ///
+    template <typename ValueArrayType>
+    [[nodiscard]]
+    std::tuple<std::vector<typename ValueArrayType::__ctype>, std::vector<double>> readWindow(double start, double end) const;
+
     template <typename ValueType>
     void setSegmentScale(const ValueType& value);
 
@@ -656,8 +840,15 @@ public:
         [[nodiscard]]
         std::optional<Data> tryGetData() const
         {
+            TraceScope span(TraceEvent::Read);
+            if (span) {
+                span.setName(getFullPath());
+            }
+
             mdsdsc_xd_t xd = MDSDSC_XD_INITIALIZER;
             int status = _TreeGetRecord(getDBID(), _nid, &xd);
+            span.setStatus(status);
+            span.addBytes(xd.l_length);
             if (status == TreeNODATA) {
                 return std::nullopt;
             }
@@ -679,6 +870,17 @@ protected:
     template <typename ResultType>
     ResultType _getNCI(nci_t code) const;
 
+    // Returns at least count zeros, used to allocate segments without building a new array every time
+    template <typename ValueType>
+    static const ValueType * _getZeros(size_t count);
+
+    // Returns the range [first, last) of segments overlapping start and end
+    std::pair<int, int> _findSegments(double start, double end) const;
+
+    // Marks the segment indexes used by readWindow() as out of date, reindex also drops this node's
+    // index for writes that add segments or can change the limits of any segment
+    void _onSegmentsWritten(bool reindex = false) const;
+
     std::string _getStringNCI(nci_t code, int16_t size) const;
 
     std::vector<int> _getNIDArrayNCI(nci_t code, nci_t codeForNumberOf) const;
@@ -4,6 +4,8 @@
 #include "TreeNode.hpp"
 #include "Tree.hpp"
 #include "DataView.hpp"
+#include "Trace.hpp"
+#include "Decimate.hpp"
 
 #include <algorithm>
 
@@ -347,8 +349,15 @@ inline std::vector<std::string> TreeNode::getTags() const
 
 inline Data TreeNode::getRecord() const
 {
+    TraceScope span(TraceEvent::Read);
+    if (span) {
+        span.setName(getFullPath());
+    }
+
     mdsdsc_xd_t xd = MDSDSC_XD_INITIALIZER;
     int status = _TreeGetRecord(getDBID(), _nid, &xd);
+    span.setStatus(status);
+    span.addBytes(xd.l_length);
     if (IS_NOT_OK(status)) {
         throwException(status);
     }
@@ -358,8 +367,16 @@ inline Data TreeNode::getRecord() const
 
 inline void TreeNode::putRecord(const Data& data) const
 {
+    TraceScope span(TraceEvent::Write);
+    if (span) {
+        span.setName(getFullPath());
+    }
+
     mdsdsc_t * dsc = data.getDescriptor();
     int status = _TreePutRecord(getDBID(), _nid, dsc, 0);
+    _onSegmentsWritten(true);
+    span.setStatus(status);
+    span.addBytes(Trace::GetSize(dsc));
     if (IS_NOT_OK(status)) {
         throwException(status);
     }
@@ -485,6 +502,11 @@ inline std::vector<TreeNode> TreeNode::_getTreeNodeArrayNCI(nci_t code, nci_t co
 template <typename ValueType>
 void TreeNode::putRow(int segmentLength, const ValueType& value, int64_t timestamp)
 {
+    TraceScope span(TraceEvent::Write);
+    if (span) {
+        span.setName(getFullPath());
+    }
+
     DataView argValue(value);
 
     int status = _TreePutRow(
@@ -494,6 +516,9 @@ void TreeNode::putRow(int segmentLength, const ValueType& value, int64_t timesta
         &timestamp,
         (mdsdsc_a_t *)argValue.getDescriptor()
     );
+    _onSegmentsWritten();
+    span.setStatus(status);
+    span.addBytes(Trace::GetSize(argValue.getDescriptor()));
     if (IS_NOT_OK(status)) {
         throwException(status);
     }
@@ -502,14 +527,24 @@ void TreeNode::putRow(int segmentLength, const ValueType& value, int64_t timesta
 template <typename ValueArrayType>
 void TreeNode::putSegment(const ValueArrayType& values, int index /*= -1*/)
 {
+    TraceScope span(TraceEvent::Write);
+    if (span) {
+        span.setName(getFullPath());
+    }
+
     DataView argValues(values);
 
+    mdsdsc_a_t * dscValues = (mdsdsc_a_t *)_unwrapDescriptor(argValues.getDescriptor());
+
     int status = _TreePutSegment(
         getDBID(),
         getNID(),
         index,
-        (mdsdsc_a_t *)argValues.getDescriptor()
+        dscValues
     );
+    _onSegmentsWritten();
+    span.setStatus(status);
+    span.addBytes(Trace::GetSize((mdsdsc_t *)dscValues));
     if (IS_NOT_OK(status)) {
         throwException(status);
     }
@@ -518,14 +553,24 @@ void TreeNode::putSegment(const ValueArrayType& values, int index /*= -1*/)
 template <typename ValueArrayType>
 void TreeNode::putTimestampedSegment(int64_t * timestamps, const ValueArrayType& values)
 {
+    TraceScope span(TraceEvent::Write);
+    if (span) {
+        span.setName(getFullPath());
+    }
+
     DataView argValues(values);
 
+    mdsdsc_a_t * dscValues = (mdsdsc_a_t *)_unwrapDescriptor(argValues.getDescriptor());
+
     int status = _TreePutTimestampedSegment(
         getDBID(),
         getNID(),
         timestamps,
-        (mdsdsc_a_t *)argValues.getDescriptor()
+        dscValues
     );
+    _onSegmentsWritten();
+    span.setStatus(status);
+    span.addBytes(Trace::GetSize((mdsdsc_t *)dscValues));
     if (IS_NOT_OK(status)) {
         throwException(status);
     }
@@ -545,24 +590,46 @@ inline std::tuple<DataType, UnitsType> TreeNode::getDataWithUnits() const {
     return { data.releaseAndConvert<DataType>(), std::move(units) };
 }
 
+// The number of rows in a segment's values, which is the last and slowest varying dimension,
+// e.g. the number of frames in an array of { width, height, frames }
 inline int _getMaxRowsFilled(mdsdsc_a_t * dsc)
 {
-    // TODO: Investigate, taken from TreeNode:makeSegment() in tree.py
-    if (dsc->class_ == CLASS_R) {
-        return 1;
-    }
-    else if (dsc->class_ == CLASS_A) {
-        // TODO: Verify
-        if (dsc->aflags.coeff) {
+    switch (dsc->class_) {
+    case CLASS_A:
+    case CLASS_CA:
+        if (dsc->aflags.coeff && dsc->dimct > 0) {
             array_coeff * dscCoeff = (array_coeff *)dsc;
             return dscCoeff->m[dscCoeff->dimct - 1];
         }
-        else {
+        else if (dsc->length > 0) {
             return (dsc->arsize / dsc->length);
         }
+        return 0;
+
+    // A single row, same as TreeNode.makeSegment() in tree.py
+    case CLASS_S:
+    case CLASS_R:
+        return 1;
+
+    default:
+        return -1;
+    }
+}
+
+// Default rowsFilled to every row, and reject rows that aren't in the values
+inline int _getRowsFilled(mdsdsc_a_t * dsc, int rowsFilled)
+{
+    int maxRowsFilled = _getMaxRowsFilled(dsc);
+    if (rowsFilled < 0) {
+        return maxRowsFilled;
     }
 
-    return -1;
+    // A record, e.g. compressed values, has no shape to check against
+    if (dsc->class_ != CLASS_R && maxRowsFilled >= 0 && rowsFilled > maxRowsFilled) {
+        throwException(TreeBUFFEROVF);
+    }
+
+    return rowsFilled;
 }
 
 template <
@@ -580,21 +647,19 @@ void TreeNode::makeSegment(
     int rowsFilled /*= -1*/
 ) const
 {
+    TraceScope span(TraceEvent::Write);
+    if (span) {
+        span.setName(getFullPath());
+    }
+
     DataView argStartIndex(startIndex);
     DataView argEndIndex(endIndex);
     DataView argDimension(dimension);
     DataView argValues(values);
 
-    mdsdsc_a_t * dscValues = (mdsdsc_a_t *)argValues.getDescriptor();
-    
-    // Hack?
-    if (dscValues->dtype == DTYPE_DSC) {
-        dscValues = (mdsdsc_a_t *)dscValues->pointer;
-    }
+    mdsdsc_a_t * dscValues = (mdsdsc_a_t *)_unwrapDescriptor(argValues.getDescriptor());
 
-    if (rowsFilled < 0) {
-        rowsFilled = _getMaxRowsFilled(dscValues);
-    }
+    rowsFilled = _getRowsFilled(dscValues, rowsFilled);
 
     int status = _TreeMakeSegment(
         getDBID(),
@@ -606,6 +671,9 @@ void TreeNode::makeSegment(
         index,
         rowsFilled
     );
+    _onSegmentsWritten(true);
+    span.setStatus(status);
+    span.addBytes(Trace::GetSize((mdsdsc_t *)dscValues));
     if (IS_NOT_OK(status)) {
         throwException(status);
     }
@@ -628,15 +696,19 @@ void TreeNode::makeSegmentResampled(
     int rowsFilled /*= -1*/
 ) const
 {
+    TraceScope span(TraceEvent::Write);
+    if (span) {
+        span.setName(getFullPath());
+    }
+
     DataView argStartIndex(startIndex);
     DataView argEndIndex(endIndex);
     DataView argDimension(dimension);
     DataView argValues(values);
 
-    mdsdsc_a_t * dscValues = (mdsdsc_a_t *)argValues.getDescriptor();
-    if (rowsFilled < 0) {
-        rowsFilled = _getMaxRowsFilled(dscValues);
-    }
+    mdsdsc_a_t * dscValues = (mdsdsc_a_t *)_unwrapDescriptor(argValues.getDescriptor());
+
+    rowsFilled = _getRowsFilled(dscValues, rowsFilled);
 
     int status = _TreeMakeSegmentResampled(
         getDBID(),
@@ -650,54 +722,102 @@ void TreeNode::makeSegmentResampled(
         resampleNode.getNID(),
         resampleFactor
     );
+    _onSegmentsWritten(true);
+    span.setStatus(status);
+    span.addBytes(Trace::GetSize((mdsdsc_t *)dscValues));
+    if (IS_NOT_OK(status)) {
+        throwException(status);
+    }
+}
+
+template <
+    typename StartIndexType,
+    typename EndIndexType,
+    typename DimensionType,
+    typename ValueArrayType
+>
+void TreeNode::makeSegmentMinMax(
+    const StartIndexType& startIndex,
+    const EndIndexType& endIndex,
+    const DimensionType& dimension,
+    const ValueArrayType& values,
+    const TreeNode& resampleNode,
+    int resampleFactor,
+    int index /*= -1*/,
+    int rowsFilled /*= -1*/
+) const
+{
+    TraceScope span(TraceEvent::Write);
+    if (span) {
+        span.setName(getFullPath());
+    }
+
+    DataView argStartIndex(startIndex);
+    DataView argEndIndex(endIndex);
+    DataView argDimension(dimension);
+    DataView argValues(values);
+
+    mdsdsc_a_t * dscValues = (mdsdsc_a_t *)_unwrapDescriptor(argValues.getDescriptor());
+
+    rowsFilled = _getRowsFilled(dscValues, rowsFilled);
+
+    int status = _TreeMakeSegmentMinMax(
+        getDBID(),
+        getNID(),
+        argStartIndex.getDescriptor(),
+        argEndIndex.getDescriptor(),
+        argDimension.getDescriptor(),
+        dscValues,
+        index,
+        rowsFilled,
+        resampleNode.getNID(),
+        resampleFactor
+    );
+    _onSegmentsWritten(true);
+    span.setStatus(status);
+    span.addBytes(Trace::GetSize((mdsdsc_t *)dscValues));
     if (IS_NOT_OK(status)) {
         throwException(status);
     }
 }
 
-// template <
-//     typename StartIndexType,
-//     typename EndIndexType,
-//     typename DimensionType,
-//     typename ValueArrayType
-// >
-// void TreeNode::makeSegmentMinMax(
-//     const StartIndexType& startIndex,
-//     const EndIndexType& endIndex,
-//     const DimensionType& dimension,
-//     const ValueArrayType& values,
-//     const TreeNode& resampleNode,
-//     int resampleFactor,
-//     int index /*= -1*/,
-//     int rowsFilled /*= -1*/
-// ) const
-// {
-//     Argument argStartIndex(startIndex);
-//     Argument argEndIndex(endIndex);
-//     Argument argDimension(dimension);
-//     Argument argValues(values);
-
-//     mdsdsc_a_t * dscValues = (mdsdsc_a_t *)argValues.getDescriptor();
-//     if (rowsFilled < 0) {
-//         rowsFilled = _getMaxRowsFilled(dscValues);
-//     }
-
-//     int status = _TreeMakeSegmentMinMax(
-//         getDBID(),
-//         getNID(),
-//         argStartIndex.getDescriptor(),
-//         argEndIndex.getDescriptor(),
-//         argDimension.getDescriptor(),
-//         dscValues,
-//         index,
-//         rowsFilled,
-//         resampleNode.getNID(),
-//         resampleFactor
-//     );
-//     if (IS_NOT_OK(status)) {
-//         throwException(status);
-//     }
-// }
+template <typename ValueType>
+void TreeNode::makeSegmentDecimated(
+    double start,
+    double delta,
+    const ValueType * values,
+    uint32_t count,
+    uint32_t factor,
+    const TreeNode& minNode,
+    const TreeNode& maxNode,
+    const TreeNode& meanNode /*= {}*/
+) const
+{
+    if (count == 0 || factor == 0) {
+        throwException(TreeFAILURE);
+    }
+
+    auto decimated = decimate(values, count, factor);
+
+    double end = start + delta * (count - 1);
+    makeSegment(start, end, Range(start, end, delta), DataView(values, count));
+
+    double decimatedDelta = delta * factor;
+    double decimatedEnd = start + decimatedDelta * (decimated.Min.size() - 1);
+    Range decimatedDimension(start, decimatedEnd, decimatedDelta);
+
+    if (minNode.getNID() >= 0) {
+        minNode.makeSegment(start, decimatedEnd, decimatedDimension, decimated.Min);
+    }
+
+    if (maxNode.getNID() >= 0) {
+        maxNode.makeSegment(start, decimatedEnd, decimatedDimension, decimated.Max);
+    }
+
+    if (meanNode.getNID() >= 0) {
+        meanNode.makeSegment(start, decimatedEnd, decimatedDimension, decimated.Mean);
+    }
+}
 
 template <typename ValueArrayType>
 void TreeNode::makeTimestampedSegment(
@@ -707,12 +827,16 @@ void TreeNode::makeTimestampedSegment(
     int rowsFilled /*= -1*/
 ) const
 {
+    TraceScope span(TraceEvent::Write);
+    if (span) {
+        span.setName(getFullPath());
+    }
+
     DataView argValues(values);
 
-    mdsdsc_a_t * dscValues = (mdsdsc_a_t *)argValues.getDescriptor();
-    if (rowsFilled < 0) {
-        rowsFilled = _getMaxRowsFilled(dscValues);
-    }
+    mdsdsc_a_t * dscValues = (mdsdsc_a_t *)_unwrapDescriptor(argValues.getDescriptor());
+
+    rowsFilled = _getRowsFilled(dscValues, rowsFilled);
 
     int status = _TreeMakeTimestampedSegment(
         getDBID(),
@@ -722,11 +846,365 @@ void TreeNode::makeTimestampedSegment(
         index,
         rowsFilled
     );
+    _onSegmentsWritten(true);
+    span.setStatus(status);
+    span.addBytes(Trace::GetSize((mdsdsc_t *)dscValues));
     if (IS_NOT_OK(status)) {
         throwException(status);
     }
 }
 
+template <
+    typename StartIndexType,
+    typename EndIndexType,
+    typename DimensionType,
+    typename ValueArrayType
+>
+void TreeNode::beginSegment(
+    const StartIndexType& startIndex,
+    const EndIndexType& endIndex,
+    const DimensionType& dimension,
+    const ValueArrayType& initialValues,
+    int index /*= -1*/
+) const
+{
+    TraceScope span(TraceEvent::Write);
+    if (span) {
+        span.setName(getFullPath());
+    }
+
+    DataView argStartIndex(startIndex);
+    DataView argEndIndex(endIndex);
+    DataView argDimension(dimension);
+    DataView argValues(initialValues);
+
+    mdsdsc_a_t * dscValues = (mdsdsc_a_t *)_unwrapDescriptor(argValues.getDescriptor());
+
+    int status = _TreeBeginSegment(
+        getDBID(),
+        getNID(),
+        argStartIndex.getDescriptor(),
+        argEndIndex.getDescriptor(),
+        argDimension.getDescriptor(),
+        dscValues,
+        index
+    );
+    _onSegmentsWritten(true);
+    span.setStatus(status);
+    span.addBytes(Trace::GetSize((mdsdsc_t *)dscValues));
+    if (IS_NOT_OK(status)) {
+        throwException(status);
+    }
+}
+
+template <typename ValueArrayType>
+void TreeNode::beginTimestampedSegment(const ValueArrayType& initialValues, int index /*= -1*/) const
+{
+    TraceScope span(TraceEvent::Write);
+    if (span) {
+        span.setName(getFullPath());
+    }
+
+    DataView argValues(initialValues);
+
+    mdsdsc_a_t * dscValues = (mdsdsc_a_t *)_unwrapDescriptor(argValues.getDescriptor());
+
+    int status = _TreeBeginTimestampedSegment(
+        getDBID(),
+        getNID(),
+        dscValues,
+        index
+    );
+    _onSegmentsWritten(true);
+    span.setStatus(status);
+    span.addBytes(Trace::GetSize((mdsdsc_t *)dscValues));
+    if (IS_NOT_OK(status)) {
+        throwException(status);
+    }
+}
+
+template <
+    typename ValueType,
+    typename StartIndexType,
+    typename EndIndexType,
+    typename DimensionType
+>
+void TreeNode::allocateSegment(
+    const StartIndexType& startIndex,
+    const EndIndexType& endIndex,
+    const DimensionType& dimension,
+    uint32_t rows,
+    const std::vector<uint32_t>& rowDims /*= {}*/,
+    int index /*= -1*/
+) const
+{
+    std::vector<uint32_t> dims = rowDims;
+    dims.push_back(rows);
+
+    size_t count = 1;
+    for (uint32_t dim : dims) {
+        count *= dim;
+    }
+
+    const ValueType * zeros = _getZeros<ValueType>(count);
+    beginSegment(startIndex, endIndex, dimension, DataView(zeros, dims), index);
+}
+
+template <typename ValueType>
+const ValueType * TreeNode::_getZeros(size_t count)
+{
+    // Only ever read, so it can be shared by every call on this thread and only grows
+    thread_local std::vector<ValueType> zeros;
+    if (zeros.size() < count) {
+        zeros.resize(count);
+    }
+    return zeros.data();
+}
+
+template <typename ValueType>
+void TreeNode::allocateTimestampedSegment(
+    uint32_t rows,
+    const std::vector<uint32_t>& rowDims /*= {}*/,
+    int index /*= -1*/
+) const
+{
+    std::vector<uint32_t> dims = rowDims;
+    dims.push_back(rows);
+
+    size_t count = 1;
+    for (uint32_t dim : dims) {
+        count *= dim;
+    }
+
+    const ValueType * zeros = _getZeros<ValueType>(count);
+    beginTimestampedSegment(DataView(zeros, dims), index);
+}
+
+template <
+    typename StartIndexType,
+    typename EndIndexType,
+    typename DimensionType
+>
+void TreeNode::updateSegment(
+    const StartIndexType& startIndex,
+    const EndIndexType& endIndex,
+    const DimensionType& dimension,
+    int index /*= -1*/
+) const
+{
+    TraceScope span(TraceEvent::Write);
+    if (span) {
+        span.setName(getFullPath());
+    }
+
+    DataView argStartIndex(startIndex);
+    DataView argEndIndex(endIndex);
+    DataView argDimension(dimension);
+
+    int status = _TreeUpdateSegment(
+        getDBID(),
+        getNID(),
+        argStartIndex.getDescriptor(),
+        argEndIndex.getDescriptor(),
+        argDimension.getDescriptor(),
+        index
+    );
+    _onSegmentsWritten(true);
+    span.setStatus(status);
+    if (IS_NOT_OK(status)) {
+        throwException(status);
+    }
+}
+
+inline int TreeNode::getNumSegments() const
+{
+    int numSegments = 0;
+    int status = _TreeGetNumSegments(getDBID(), getNID(), &numSegments);
+    if (IS_NOT_OK(status)) {
+        throwException(status);
+    }
+
+    return numSegments;
+}
+
+template <typename ValueArrayType /*= Data*/, typename DimensionType /*= Data*/>
+std::tuple<ValueArrayType, DimensionType> TreeNode::getSegment(int index) const
+{
+    TraceScope span(TraceEvent::Read);
+    if (span) {
+        span.setName(getFullPath() + "[" + std::to_string(index) + "]");
+    }
+
+    mdsdsc_xd_t values = MDSDSC_XD_INITIALIZER;
+    mdsdsc_xd_t dimension = MDSDSC_XD_INITIALIZER;
+    int status = _TreeGetSegment(getDBID(), getNID(), index, &values, &dimension);
+    span.setStatus(status);
+    span.addBytes(values.l_length + dimension.l_length);
+    if (IS_NOT_OK(status)) {
+        MdsFree1Dx(&values, nullptr);
+        MdsFree1Dx(&dimension, nullptr);
+        throwException(status);
+    }
+
+    return {
+        Data(std::move(values), getTree()).releaseAndConvert<ValueArrayType>(),
+        Data(std::move(dimension), getTree()).releaseAndConvert<DimensionType>(),
+    };
+}
+
+template <typename StartType /*= Data*/, typename EndType /*= StartType*/>
+std::tuple<StartType, EndType> TreeNode::getSegmentLimits(int index) const
+{
+    mdsdsc_xd_t start = MDSDSC_XD_INITIALIZER;
+    mdsdsc_xd_t end = MDSDSC_XD_INITIALIZER;
+    int status = _TreeGetSegmentLimits(getDBID(), getNID(), index, &start, &end);
+    if (IS_NOT_OK(status)) {
+        MdsFree1Dx(&start, nullptr);
+        MdsFree1Dx(&end, nullptr);
+        throwException(status);
+    }
+
+    return {
+        Data(std::move(start), getTree()).releaseAndConvert<StartType>(),
+        Data(std::move(end), getTree()).releaseAndConvert<EndType>(),
+    };
+}
+
+inline SegmentInfo TreeNode::getSegmentInfo(int index /*= -1*/) const
+{
+    char dtype = 0;
+    char dimct = 0;
+    int dims[MAX_DIMS] = {};
+    int nextRow = 0;
+    int status = _TreeGetSegmentInfo(getDBID(), getNID(), index, &dtype, &dimct, dims, &nextRow);
+    if (IS_NOT_OK(status)) {
+        throwException(status);
+    }
+
+    SegmentInfo info;
+    info.Type = DType(static_cast<uint8_t>(dtype));
+    info.Dimensions.assign(dims, dims + dimct);
+    info.RowsFilled = nextRow;
+    return info;
+}
+
+template <typename ValueArrayType>
+std::tuple<std::vector<typename ValueArrayType::__ctype>, std::vector<double>> TreeNode::readWindow(double start, double end) const
+{
+    std::vector<typename ValueArrayType::__ctype> values;
+    std::vector<double> times;
+
+    auto [first, last] = _findSegments(start, end);
+    for (int index = first; index < last; ++index) {
+        auto [segmentValues, segmentTimes] = getSegment<ValueArrayType, Float64Array>(index);
+
+        const auto& dims = segmentValues.getDimensions();
+        if (dims.empty() || dims.back() == 0) {
+            continue;
+        }
+
+        // The values of a partially filled segment can be shorter than its dimension
+        size_t rows = std::min<size_t>(dims.back(), segmentTimes.getSize());
+        size_t rowSize = segmentValues.getSize() / dims.back();
+
+        const double * timesBegin = segmentTimes.begin();
+        const double * timesEnd = timesBegin + rows;
+        const double * windowBegin = std::lower_bound(timesBegin, timesEnd, start);
+        const double * windowEnd = std::upper_bound(windowBegin, timesEnd, end);
+
+        times.insert(times.end(), windowBegin, windowEnd);
+
+        const auto * valuesBegin = segmentValues.begin();
+        values.insert(
+            values.end(),
+            valuesBegin + (windowBegin - timesBegin) * rowSize,
+            valuesBegin + (windowEnd - timesBegin) * rowSize
+        );
+    }
+
+    return { std::move(values), std::move(times) };
+}
+
+inline std::pair<int, int> TreeNode::_findSegments(double start, double end) const
+{
+    // Convert a list of segment limits, or an array of them, to doubles
+    auto toDoubles = [](Data&& data) {
+        std::vector<double> limits;
+        if (data.getClass() == Class::APD) {
+            for (auto limit : data.releaseAndConvert<List>()) {
+                limits.push_back(limit.clone<Float64>().getValue());
+            }
+        }
+        else if (data.getClass() != Class::Missing) {
+            limits = data.releaseAndConvert<Float64Array>().getValues();
+        }
+        return limits;
+    };
+
+    Tree * tree = getTree();
+
+    // Read before refreshing, so that a segment written during the refresh is picked up next time
+    uint64_t writeCount = Tree::_getSegmentWriteCount().load(std::memory_order_acquire);
+
+    std::lock_guard<std::mutex> lock(tree->_segmentIndexMutex);
+    auto& index = tree->_segmentIndexes[_nid];
+
+    bool reload = !index.Loaded;
+    if (index.Loaded && index.WriteCount != writeCount) {
+        int numSegments = getNumSegments();
+        if (index.Starts.size() != size_t(numSegments)) {
+            reload = true;
+        }
+        else if (numSegments > 0) {
+            // Rows can still be added to the last segment, which moves its end
+            auto [lastStart, lastEnd] = getSegmentLimits<Float64>(numSegments - 1);
+            index.Starts.back() = lastStart.getValue();
+            index.Ends.back() = lastEnd.getValue();
+        }
+    }
+
+    if (reload) {
+        int count = 0;
+        mdsdsc_xd_t startList = MDSDSC_XD_INITIALIZER;
+        mdsdsc_xd_t endList = MDSDSC_XD_INITIALIZER;
+        int status = _TreeGetSegmentTimesXd(getDBID(), getNID(), &count, &startList, &endList);
+        if (IS_NOT_OK(status)) {
+            MdsFree1Dx(&startList, nullptr);
+            MdsFree1Dx(&endList, nullptr);
+            index = {};
+            throwException(status);
+        }
+
+        index.Starts = toDoubles(Data(std::move(startList), tree));
+        index.Ends = toDoubles(Data(std::move(endList), tree));
+        if (index.Starts.size() != index.Ends.size()) {
+            index = {};
+            throwException(TreeFAILURE);
+        }
+
+        index.Loaded = true;
+    }
+
+    index.WriteCount = writeCount;
+
+    // Segments are written in order, so both the starts and the ends are sorted
+    int first = std::lower_bound(index.Ends.begin(), index.Ends.end(), start) - index.Ends.begin();
+    int last = std::upper_bound(index.Starts.begin(), index.Starts.end(), end) - index.Starts.begin();
+
+    return { first, std::max(first, last) };
+}
+
+inline void TreeNode::_onSegmentsWritten(bool reindex /*= false*/) const
+{
+    Tree::_getSegmentWriteCount().fetch_add(1, std::memory_order_release);
+
+    Tree * tree = getTree();
+    if (reindex && tree) {
+        std::lock_guard<std::mutex> lock(tree->_segmentIndexMutex);
+        tree->_segmentIndexes.erase(_nid);
+    }
+}
+
 template <typename ValueType>
 void TreeNode::setSegmentScale(const ValueType& value)
 {
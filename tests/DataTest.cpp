@@ -42,6 +42,413 @@ TEST(Data, Metadata)
     ASSERT_EQ(data.convert<Int32>(), value);
 }
 
+TEST(Data, ArrayDimensions)
+{
+    auto array = Int32Array({ 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12 }, { 2, 3, 2 });
+    ASSERT_EQ(array.getDimensions(), std::vector<uint32_t>({ 2, 3, 2 }));
+    ASSERT_EQ(array.getValues().size(), 12);
+    ASSERT_EQ(array.getValues().back(), 12);
+
+    auto vector = Float64Array(std::vector<double>(6), { 3, 2 });
+    ASSERT_EQ(vector.getDimensions(), std::vector<uint32_t>({ 3, 2 }));
+
+    // The dimensions have to match the number of values
+    ASSERT_THROW(Int32Array({ 1, 2, 3, 4, 5 }, { 2, 3 }), MDSplusException);
+}
+
+TEST(Data, ListBuilder)
+{
+    ListBuilder builder;
+    for (int32_t i = 0; i < 1000; ++i) {
+        builder.append(i);
+    }
+
+    // Moved in without being copied
+    builder.append(String("last"));
+
+    auto list = builder.build();
+    ASSERT_EQ(list.getSize(), 1001);
+
+    auto values = list.getValues();
+    ASSERT_EQ(values[0].convert<Int32>().getValue(), 0);
+    ASSERT_EQ(values[999].convert<Int32>().getValue(), 999);
+    ASSERT_EQ(values[1000].convert<String>().getValue(), "last");
+
+    // The values are adopted instead of being copied again, which leaves the builder empty
+    auto adopted = std::move(builder).build();
+    ASSERT_EQ(adopted.getSize(), 1001);
+    ASSERT_EQ(adopted[1000].getStringView(), "last");
+    ASSERT_EQ(builder.getSize(), 0);
+
+    DictionaryBuilder dictionaryBuilder(2);
+    dictionaryBuilder.append(std::string_view("one"), 1);
+    dictionaryBuilder.append(std::string_view("two"), Float64(2.0));
+    ASSERT_EQ(dictionaryBuilder.build().getSize(), 4);
+}
+
+TEST(Data, DictionaryFind)
+{
+    DictionaryBuilder builder;
+    for (int32_t i = 0; i < 100; ++i) {
+        builder.append("key" + std::to_string(i), i);
+    }
+    builder.append(int16_t(7), String("seven"));
+
+    auto dictionary = builder.build();
+
+    ASSERT_TRUE(dictionary.contains("key42"));
+    ASSERT_FALSE(dictionary.contains("key100"));
+    ASSERT_EQ(dictionary["key42"].clone<Int32>().getValue(), 42);
+
+    // Integer keys match regardless of their width
+    ASSERT_EQ(dictionary[7].getStringView(), "seven");
+    ASSERT_EQ(dictionary.find(int64_t(7)).getStringView(), "seven");
+
+    ASSERT_FALSE(dictionary.find("missing"));
+    ASSERT_THROW((void)dictionary["missing"], MDSplusException);
+
+    // Appending invalidates the index
+    dictionary.append("extra", 1.5);
+    ASSERT_TRUE(dictionary.contains("extra"));
+
+    auto [keys, values] = dictionary.getKeysAndValues();
+    ASSERT_EQ(keys.size(), 102);
+
+    // So does replacing the value through a reference to the base class
+    Data& data = dictionary;
+    data = Dictionary(std::string("other"), 2);
+    ASSERT_FALSE(dictionary.contains("key42"));
+    ASSERT_TRUE(dictionary.contains("other"));
+
+    // Data keys and values are stored by value, not as references to the arguments
+    Int32 value(5);
+    Dictionary withData(String("k"), value);
+    ASSERT_EQ(withData.find("k").clone<Int32>().getValue(), 5);
+
+    withData.append(String("l"), Float64(6.0));
+    ASSERT_EQ(withData.find("k").clone<Int32>().getValue(), 5);
+    ASSERT_EQ(withData.find("l").clone<Float64>().getValue(), 6.0);
+
+    // The index moves with the dictionary
+    Dictionary moved = std::move(withData);
+    ASSERT_TRUE(moved.contains("l"));
+}
+
+TEST(Data, ListIteration)
+{
+    auto list = List(Int32(1), String("two"), Float64(3.0));
+
+    // The elements refer to the list's own descriptors
+    size_t index = 0;
+    for (DataRef value : list) {
+        ASSERT_EQ(value.getDescriptor(), list[index].getDescriptor());
+        ++index;
+    }
+    ASSERT_EQ(index, 3);
+
+    ASSERT_EQ(list[0].getDType(), DType::L);
+    ASSERT_EQ(list[1].getStringView(), "two");
+
+    // An owning copy outlives the list
+    Float64 copy = list[2].clone<Float64>();
+    list = List();
+    ASSERT_EQ(copy.getValue(), 3.0);
+
+    auto dictionary = Dictionary("a", 1, "b", 2);
+
+    std::vector<std::string_view> keys;
+    for (const auto& [key, value] : dictionary) {
+        keys.push_back(key.getStringView());
+    }
+    ASSERT_EQ(keys, std::vector<std::string_view>({ "a", "b" }));
+}
+
+TEST(Data, StringArray)
+{
+    std::vector<std::string> names = { "a", "bbb", "", "cc" };
+    auto array = StringArray(names);
+    ASSERT_EQ(array.getSize(), 4);
+
+    // Padded to the longest value
+    ASSERT_EQ(array.getValueAt(0), "a  ");
+    ASSERT_EQ(array.getStringViewAt(0, false), "a  ");
+
+    ASSERT_EQ(array.getStringViewAt(1), "bbb");
+    ASSERT_EQ(array.getStringViewAt(2), "");
+    ASSERT_EQ(array.getStringViews(), std::vector<std::string_view>({ "a", "bbb", "", "cc" }));
+
+    auto grid = StringArray({ std::string_view("x"), "y", "z", "w" }, { 2, 2 });
+    ASSERT_EQ(grid.getStringViewAt(3), "w");
+
+    ASSERT_THROW(StringArray({ std::string_view("x"), "y", "z" }, { 2, 2 }), MDSplusException);
+    ASSERT_THROW((void)array.getStringViewAt(4), MDSplusException);
+
+    // Longer than the 16 bit length of a descriptor
+    std::vector<std::string> tooLong = { "a", std::string(70000, 'x') };
+    ASSERT_THROW(StringArray(tooLong), MDSplusException);
+}
+
+TEST(Data, InlineScalars)
+{
+    auto value = Int32(42);
+    ASSERT_EQ(value.getTotalSize(), sizeof(mdsdsc_s_t) + sizeof(int32_t));
+
+    // Moving has to carry the inline value along with it
+    std::vector<Int32> values;
+    for (int32_t i = 0; i < 100; ++i) {
+        values.emplace_back(i);
+    }
+    ASSERT_EQ(values[99].getValue(), 99);
+
+    Data data = std::move(value);
+    ASSERT_EQ(data.getDType(), DType::L);
+    ASSERT_EQ(data.convert<Int32>().getValue(), 42);
+    ASSERT_EQ(data.releaseAndConvert<Int32>().getValue(), 42);
+
+    auto copy = Float64(1.5).clone();
+    ASSERT_EQ(copy.getValue(), 1.5);
+
+    // Strings longer than Data::InlineSize are allocated as before
+    auto name = String("short");
+    auto longName = String(std::string(Data::InlineSize + 1, 'x'));
+    ASSERT_EQ(name.getValue(), "short");
+    ASSERT_EQ(longName.getValue().size(), Data::InlineSize + 1);
+
+    name.setValue(longName.getStringView());
+    ASSERT_EQ(name.getValue(), longName.getValue());
+
+    // Setting a value from part of itself, whether the old value was allocated or inline
+    auto self = String("abcdefghijklmnopqrst");
+    self.setValue(self.getStringView().substr(0, 4));
+    ASSERT_EQ(self.getValue(), "abcd");
+
+    self.setValue(self.getStringView().substr(1, 2));
+    ASSERT_EQ(self.getValue(), "bc");
+
+    ASSERT_EQ(Int32(7) + 1, Int32(8));
+}
+
+TEST(Data, ScopedArena)
+{
+    ASSERT_EQ(ScopedArena::GetActive(), nullptr);
+
+    Int32Array escaped;
+    Dictionary dictionary;
+    {
+        ScopedArena arena;
+        ASSERT_EQ(ScopedArena::GetActive(), &arena);
+
+        for (int i = 0; i < 100; ++i) {
+            auto signal = Signal(Int32Array({ 1, 2, 3 }), nullptr, Int32Array({ 0, 1, 2 }));
+            ASSERT_EQ(signal.getValue<Int32Array>().getValues(), std::vector<int32_t>({ 1, 2, 3 }));
+        }
+        ASSERT_EQ(arena.getLiveCount(), 0);
+        ASSERT_GT(arena.getBytesUsed(), 0);
+
+        auto list = List(1, "two", Float64Array({ 3.0 }));
+        list.append(4);
+        ASSERT_EQ(list.size(), 4);
+        ASSERT_EQ(list[3].clone<Int32>().getValue(), 4);
+
+        // Values given away are copied out of the arena first
+        auto array = Int32Array({ 4, 5, 6 });
+        mdsdsc_xd_t xd = array.release();
+        Int32Array released(std::move(xd));
+
+        escaped = Int32Array({ 7, 8, 9 });
+        ASSERT_EQ(arena.getLiveCount(), 2);
+
+        dictionary.append(std::string("key"), 10);
+        ASSERT_TRUE(dictionary.contains("key"));
+
+        // Values in the arena can be moved to and destroyed on another thread while it is alive
+        size_t live = arena.getLiveCount();
+        auto moved = Int32Array({ 10, 11 });
+        ASSERT_EQ(arena.getLiveCount(), live + 1);
+
+        std::thread([value = std::move(moved)]() {
+            ASSERT_EQ(value.getValues(), std::vector<int32_t>({ 10, 11 }));
+        }).join();
+        ASSERT_EQ(arena.getLiveCount(), live);
+    }
+
+    // Anything still alive is moved out when the arena is destroyed
+    ASSERT_EQ(ScopedArena::GetActive(), nullptr);
+    ASSERT_EQ(escaped.getValues(), std::vector<int32_t>({ 7, 8, 9 }));
+
+    // Along with anything derived from it
+    ASSERT_EQ(dictionary["key"].clone<Int32>().getValue(), 10);
+}
+
+TEST(Data, RecordAdoptsChildren)
+{
+    auto values = Float64Array(std::vector<double>(1000, 1.5));
+    auto dimension = Range(0.0, 999.0, 1.0);
+    mdsdsc_t * dscValues = values.getDescriptor();
+
+    // Arguments that are moved in are referred to as they are, instead of being copied
+    auto signal = Signal(std::move(values), nullptr, std::move(dimension));
+    ASSERT_EQ(signal.getRecordDescriptor()->dscptrs[0], dscValues);
+    ASSERT_EQ(values.getDescriptor(), nullptr);
+    ASSERT_GT(signal.getTotalSize(), 1000 * sizeof(double));
+
+    auto moved = std::move(signal);
+    ASSERT_EQ(moved.getValue<Float64Array>().getValues(), std::vector<double>(1000, 1.5));
+    ASSERT_EQ(moved.getDimensionAt<Range>().getEnding<Float64>().getValue(), 999.0);
+
+    // Released records own all of their children
+    Data data(moved.release());
+    ASSERT_EQ(data.getDType(), DType::Signal);
+    ASSERT_NE(((mdsdsc_r_t *)data.getDescriptor())->dscptrs[0], dscValues);
+
+    // Small values and lvalues are still copied
+    auto units = String("seconds");
+    auto withUnits = WithUnits(Int32(5), units);
+    ASSERT_EQ(withUnits.getUnits<String>().getValue(), "seconds");
+    ASSERT_EQ(units.getValue(), "seconds");
+}
+
+TEST(Data, SignalView)
+{
+    std::vector<double> values(1000);
+    for (size_t i = 0; i < values.size(); ++i) {
+        values[i] = double(i) * 2.0;
+    }
+
+    // A Range of scalars is kept as a uniform timebase
+    auto signal = Signal(Float64Array(values), nullptr, Range(10.0, 10.999, 0.001));
+    SignalView<Float64Array> view(signal);
+    const Timebase& timebase = view.getTimebase();
+    ASSERT_TRUE(timebase.isUniform());
+    ASSERT_EQ(timebase.size(), 1000);
+    ASSERT_EQ(view.size(), 1000);
+    ASSERT_DOUBLE_EQ(view.getTime(500), 10.5);
+    ASSERT_EQ(view.getIndex(10.5004), 500);
+    ASSERT_EQ(view.getIndex(0.0), 0);
+    ASSERT_EQ(view.getIndex(100.0), 999);
+    ASSERT_EQ(view.getIndex(1e300), 999);
+    ASSERT_EQ(view.getValueAt(10.0025), 4.0);
+    ASSERT_EQ(view[999], 1998.0);
+    ASSERT_EQ(view.data()[1], 2.0);
+    ASSERT_EQ(view.getValues().getValues(), values);
+
+#ifdef __cpp_lib_span
+    ASSERT_EQ(view.getSpan().data(), view.data());
+    ASSERT_EQ(view.getSpan().size(), 1000);
+#endif
+    ASSERT_THROW((void)view.getTime(1000), MDSplusException);
+
+    auto [first, last] = timebase.getIndexRange(10.1, 10.2);
+    ASSERT_EQ(first, 100);
+    ASSERT_EQ(last, 201);
+
+    // Explicit times are searched instead
+    auto explicitSignal = Signal(Float64Array({ 1.0, 2.0, 3.0 }), nullptr, Float64Array({ 0.0, 0.5, 2.0 }));
+    SignalView<Float64Array> explicitView(explicitSignal);
+    ASSERT_FALSE(explicitView.getTimebase().isUniform());
+    ASSERT_EQ(explicitView.getIndex(1.0), 1);
+    ASSERT_EQ(explicitView.getValueAt(2.5), 3.0);
+    ASSERT_EQ(explicitView.getTimebase().getIndexRange(0.25, 2.0), std::make_pair(size_t(1), size_t(3)));
+
+    // There is nothing to return from an empty signal
+    SignalView<Float64Array> emptyView(Signal(Float64Array(std::vector<double>()), nullptr, Range(0.0, -1.0, 1.0)));
+    ASSERT_THROW((void)emptyView.getValueAt(0.0), MDSplusException);
+    ASSERT_THROW((void)emptyView.getTime(0), MDSplusException);
+}
+
+TEST(Data, NativeTimebase)
+{
+    auto range = Range(0.0, 0.9, 0.1);
+    auto times = range.getData<Float64Array>().getValues();
+    ASSERT_EQ(times.size(), 10);
+    ASSERT_DOUBLE_EQ(times[3], 0.3);
+    ASSERT_DOUBLE_EQ(times[9], 0.9);
+
+    // Window(startIdx, endIdx, valueAtIdx0) selects samples around valueAtIdx0
+    auto dimension = Dimension(Window(-10, 9, 1.0), Range(nullptr, nullptr, 0.5));
+    auto timebase = Timebase::FromDescriptor(dimension.getDescriptor());
+    ASSERT_TRUE(timebase.has_value());
+    ASSERT_EQ(timebase->size(), 20);
+    ASSERT_DOUBLE_EQ(timebase->getStart(), -4.0);
+    ASSERT_DOUBLE_EQ(timebase->getTime(19), 5.5);
+    ASSERT_EQ(dimension.getData<Float32Array>().getValues().size(), 20);
+
+    // The window is clipped to the ends of the axis
+    auto clipped = Dimension(Window(-10, 100, 1.0), Range(0.0, 2.0, 0.5));
+    timebase = Timebase::FromDescriptor(clipped.getDescriptor());
+    ASSERT_TRUE(timebase.has_value());
+    ASSERT_EQ(timebase->getTimes(), std::vector<double>({ 0.0, 0.5, 1.0, 1.5, 2.0 }));
+
+    // Anything else is left to TDI
+    ASSERT_FALSE(Timebase::FromDescriptor(Range(Float64Array({ 0.0, 1.0 }), 2.0, 0.5).getDescriptor()).has_value());
+    ASSERT_FALSE(Timebase::FromDescriptor(Int32Array({ 1, 2, 3 }).getDescriptor()).has_value());
+}
+
+TEST(Data, DataVisitor)
+{
+    struct Counter : public DataVisitor
+    {
+        size_t Records = 0;
+        size_t Missing = 0;
+        size_t Values = 0;
+        double Sum = 0.0;
+        std::vector<std::string> Strings;
+
+        bool visitRecord(const RecordRef& record) override {
+            ++Records;
+
+            // Functions aren't descended into
+            return (record.getDType() != DType::Function);
+        }
+
+        void visitScalar(const ScalarRef& scalar) override {
+            if (scalar.holds<int32_t>()) {
+                Sum += scalar.getValue<int32_t>();
+            }
+        }
+
+        void visitString(const DataRef& string, std::string_view value) override {
+            Strings.emplace_back(value);
+        }
+
+        void visitArray(const ArrayRef& array) override {
+            Values += array.size();
+            if (array.holds<double>()) {
+                const double * values = array.getValues<double>();
+                for (size_t i = 0; i < array.size(); ++i) {
+                    Sum += values[i];
+                }
+            }
+        }
+
+        void visitMissing() override {
+            ++Missing;
+        }
+    };
+
+    auto signal = Signal(
+        WithUnits(Float64Array({ 1.0, 2.0, 3.0 }), "V"),
+        nullptr,
+        Range(0, 2, 1)
+    );
+    auto list = List(signal.clone(), "name", Function(OPC_ADD, 100, 200));
+
+    Counter counter;
+    walk(list, counter);
+    ASSERT_EQ(counter.Records, 4);
+    ASSERT_EQ(counter.Missing, 1);
+    ASSERT_EQ(counter.Values, 3);
+    ASSERT_EQ(counter.Sum, 9.0);
+    ASSERT_EQ(counter.Strings, std::vector<std::string>({ "V", "name" }));
+
+    // References are only valid while the Data they refer to is alive
+    auto values = signal.getValue<WithUnits>().getValue<Float64Array>();
+    ArrayRef array(values.getDescriptor());
+    ASSERT_THROW((void)array.getValues<float>(), TdiInvalidDataType);
+    ASSERT_EQ(array.getDims(), std::vector<uint32_t>({ 3 }));
+    ASSERT_THROW((void)array.getStringViewAt(0), TdiInvalidDataType);
+}
+
 int main(int argc, char * argv[])
 {
     ::testing::InitGoogleTest(&argc, argv);
@@ -6,6 +6,9 @@ using namespace mdsplus;
 
 #include "Util.hpp"
 
+#include <fstream>
+#include <thread>
+
 class TreeFixture : public ::testing::Test
 {
 protected:
@@ -123,6 +126,40 @@ TEST_F(TreeFixture, Open)
     ASSERT_EQ(tree.getShot(), SHOT);
 }
 
+TEST_F(TreeFixture, OpenWithPath)
+{
+    std::string path = getenv(TREE_PATH_ENV);
+    unsetenv(TREE_PATH_ENV);
+
+    Tree tree(TREE_NAME, SHOT, Mode::ReadOnly, path);
+    ASSERT_TRUE(tree.isOpen());
+    ASSERT_EQ(tree.getTreePath(), path);
+
+    // The override must not leak into the environment
+    ASSERT_EQ(getenv(TREE_PATH_ENV), nullptr);
+
+    setenv(TREE_PATH_ENV, "/nonexistent", true);
+    tree.reopen();
+    ASSERT_TRUE(tree.isOpen());
+    ASSERT_STREQ(getenv(TREE_PATH_ENV), "/nonexistent");
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; ++i) {
+        threads.emplace_back([&]() {
+            for (int j = 0; j < 10; ++j) {
+                Tree other(TREE_NAME, SHOT, Mode::ReadOnly, path);
+                EXPECT_EQ(other.getNode("A:B").getData(), Int32(12345));
+            }
+        });
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    ASSERT_STREQ(getenv(TREE_PATH_ENV), "/nonexistent");
+}
+
 TEST_F(TreeFixture, GetNode)
 {
     Tree tree(TREE_NAME, SHOT, Mode::ReadOnly);
@@ -168,6 +205,528 @@ TEST_F(TreeFixture, Josh)
     printf("%s\n", to_string(data).c_str());
 }
 
+TEST_F(TreeFixture, GetShotDB)
+{
+    const auto& tempdir = _tempdirList.front();
+
+    // Only the filenames matter
+    std::ofstream(tempdir / "mdspp_100.tree");
+    std::ofstream(tempdir / "mdspp_model.tree");
+    std::ofstream(tempdir / "mdspp_200.characteristics");
+    std::ofstream(tempdir / "mdsppother_300.tree");
+
+    ASSERT_EQ(Tree::getShotDB(TREE_NAME), std::vector<int>({ SHOT, 100 }));
+    ASSERT_EQ(Tree::getShotDB(TREE_NAME_UPPER), std::vector<int>({ SHOT, 100 }));
+    ASSERT_EQ(Tree::getShotDB(TREE_NAME, "", 50, 100), std::vector<int>({ 100 }));
+    ASSERT_EQ(Tree::getShotDB(TREE_NAME, "", 101), std::vector<int>());
+
+    // New files are found even though the directory was cached
+    std::ofstream(tempdir / "mdspp_1000.tree");
+    ASSERT_EQ(Tree::getShotDB(TREE_NAME), std::vector<int>({ SHOT, 100, 1000 }));
+
+    auto otherTempdir = MakeTempDir();
+    _tempdirList.push_back(otherTempdir);
+
+    std::ofstream(std::filesystem::path(otherTempdir) / "mdspp_100.tree");
+    std::ofstream(std::filesystem::path(otherTempdir) / "mdspp_2000.tree");
+
+    std::string path = tempdir.string() + ";" + otherTempdir + ";/nonexistent";
+    ASSERT_EQ(Tree::getShotDB(TREE_NAME, path), std::vector<int>({ SHOT, 100, 1000, 2000 }));
+
+    Tree::clearShotDBCache();
+    ASSERT_EQ(Tree::getShotDB(TREE_NAME, path), std::vector<int>({ SHOT, 100, 1000, 2000 }));
+}
+
+TEST_F(TreeFixture, ShotScanner)
+{
+    ShotScanner scanner(TREE_NAME, { "A:B", "A:B:C", "SCALAR:DOUBLE", "MISSING" });
+    scanner.setShots({ SHOT, SHOT + 1 });
+
+    auto results = scanner.read();
+    ASSERT_EQ(results.size(), 2);
+
+    ASSERT_EQ(results[0].Shot, SHOT);
+    ASSERT_TRUE(results[0].isOK());
+    ASSERT_EQ(results[0].Values.size(), 4);
+    ASSERT_EQ(results[0].Values[0], Int32(12345));
+    ASSERT_EQ(results[0].Values[1], String("Hello, World!"));
+    ASSERT_EQ(results[0].Values[2], Float64(0.00042));
+    ASSERT_EQ(results[0].ValueStatus[3], TreeNNF);
+
+    // There is no pulse file for SHOT + 1
+    ASSERT_EQ(results[1].Shot, SHOT + 1);
+    ASSERT_FALSE(results[1].isOK());
+
+    ShotScanner typedScanner(TREE_NAME, { "SCALAR:L", "SCALAR:Q" });
+    typedScanner.setShots({ SHOT, SHOT, SHOT });
+    typedScanner.setThreadCount(2);
+
+    std::atomic<size_t> count = 0;
+    typedScanner.scan<Int64>([&](ShotData<Int64>&& result) {
+        ASSERT_TRUE(result.isOK());
+        ASSERT_EQ(result.Values[0].getValue(), -42);
+        ASSERT_EQ(result.Values[1].getValue(), -42);
+        ++count;
+    });
+    ASSERT_EQ(count, 3);
+}
+
+TEST_F(TreeFixture, ShotScannerModels)
+{
+    // A shot made from a different model, where the extra node shifts the NIDs of every other node
+    {
+        Tree tree(TREE_NAME, SHOT + 2, Mode::New);
+        tree.addNode("EXTRA", Usage::Numeric);
+        tree.addNode("A", Usage::Any);
+        tree.addNode("A:B", Usage::Numeric).putRecord(Int32(54321));
+        tree.addNode("MISSING", Usage::Numeric).putRecord(Int32(7));
+        tree.write();
+    }
+
+    ShotScanner scanner(TREE_NAME, { "A:B", "SCALAR:DOUBLE", "MISSING" });
+    scanner.setShots({ SHOT, SHOT + 2, SHOT });
+
+    auto results = scanner.read();
+    ASSERT_EQ(results.size(), 3);
+
+    for (size_t i : { 0, 2 }) {
+        ASSERT_TRUE(results[i].isOK());
+        ASSERT_EQ(results[i].Values[0], Int32(12345));
+        ASSERT_EQ(results[i].Values[1], Float64(0.00042));
+        ASSERT_EQ(results[i].ValueStatus[2], TreeNNF);
+    }
+
+    ASSERT_TRUE(results[1].isOK());
+    ASSERT_EQ(results[1].Values[0], Int32(54321));
+    ASSERT_EQ(results[1].ValueStatus[1], TreeNNF);
+    ASSERT_EQ(results[1].Values[2], Int32(7));
+}
+
+TEST_F(TreeFixture, TreeCache)
+{
+    Tree(TREE_NAME, SHOT, Mode::Normal).createPulse(SHOT + 1);
+
+    TreeCache cache(1);
+
+    auto tree = cache.open(TREE_NAME, SHOT);
+    ASSERT_TRUE(tree->isOpenReadOnly());
+    ASSERT_EQ(tree->getNode("A:B").getData(), Int32(12345));
+
+    // Tree names are case insensitive
+    ASSERT_EQ(cache.open(TREE_NAME_UPPER, SHOT), tree);
+    ASSERT_EQ(cache.getHitCount(), 1);
+    ASSERT_EQ(cache.getMissCount(), 1);
+
+    // SHOT is still in use, so it is dropped from the cache but stays open
+    auto other = cache.open(TREE_NAME, SHOT + 1);
+    ASSERT_EQ(cache.getOpenCount(), 1);
+    ASSERT_EQ(tree->getNode("A:B").getData(), Int32(12345));
+    ASSERT_NE(cache.open(TREE_NAME, SHOT), tree);
+
+    cache.setMaxOpen(4);
+    ASSERT_EQ(cache.open(TREE_NAME, SHOT + 1), cache.open(TREE_NAME, SHOT + 1));
+
+    ASSERT_THROW(cache.open(TREE_NAME, SHOT + 2), MDSplusException);
+    ASSERT_EQ(cache.getOpenCount(), 2);
+
+    cache.clear();
+    ASSERT_EQ(cache.getOpenCount(), 0);
+    ASSERT_EQ(other->getNode("A:B").getData(), Int32(12345));
+}
+
+TEST_F(TreeFixture, Trace)
+{
+    ASSERT_FALSE(Trace::isEnabled());
+
+    std::vector<TraceSpan> spans;
+    Trace::setSink([&](const TraceSpan& span) {
+        spans.push_back(span);
+    });
+    ASSERT_TRUE(Trace::isEnabled());
+
+    {
+        Tree tree(TREE_NAME, SHOT, Mode::Normal);
+        (void)tree.getNode("A:B").getData();
+        tree.getNode("A:B").putRecord(Int32(54321));
+        tree.executeData("1 + 2");
+    }
+
+    Trace::setSink(nullptr);
+    ASSERT_FALSE(Trace::isEnabled());
+
+    ASSERT_EQ(spans.size(), 4);
+
+    ASSERT_EQ(spans[0].Event, TraceEvent::Open);
+    ASSERT_EQ(spans[0].Name, std::string(TREE_NAME) + ", " + std::to_string(SHOT));
+    ASSERT_EQ(spans[0].Status, MDSplusSUCCESS);
+
+    ASSERT_EQ(spans[1].Event, TraceEvent::Read);
+    ASSERT_EQ(spans[1].Name, "\\MDSPP::TOP:A:B");
+    ASSERT_GT(spans[1].Bytes, 0);
+
+    ASSERT_EQ(spans[2].Event, TraceEvent::Write);
+    ASSERT_EQ(spans[2].Bytes, sizeof(int32_t));
+
+    ASSERT_EQ(spans[3].Event, TraceEvent::TDI);
+    ASSERT_EQ(spans[3].Name, "1 + 2");
+
+    // Nothing is traced once the sink is removed
+    Tree(TREE_NAME, SHOT, Mode::ReadOnly);
+    ASSERT_EQ(spans.size(), 4);
+}
+
+TEST_F(TreeFixture, GetSegment)
+{
+    Tree tree(TREE_NAME, SHOT, Mode::Normal);
+
+    auto node = tree.getNode("RECORD:SIG");
+    ASSERT_EQ(node.getNumSegments(), 0);
+
+    node.makeSegment(0.0, 0.3, Range(0.0, 0.3, 0.1), Float64Array({ 0, 1, 2, 3 }));
+    node.makeSegment(0.4, 0.7, Range(0.4, 0.7, 0.1), Float64Array({ 4, 5, 6, 7 }));
+    ASSERT_EQ(node.getNumSegments(), 2);
+
+    auto [values, dimension] = node.getSegment<Float64Array>(1);
+    ASSERT_EQ(values.getValues(), std::vector<double>({ 4, 5, 6, 7 }));
+    ASSERT_EQ(values.getSpan().data(), values.begin());
+
+    auto [start, end] = node.getSegmentLimits<Float64>(1);
+    ASSERT_DOUBLE_EQ(start.getValue(), 0.4);
+    ASSERT_DOUBLE_EQ(end.getValue(), 0.7);
+
+    auto info = node.getSegmentInfo(0);
+    ASSERT_EQ(info.Type, Float64Array::__dtype);
+    ASSERT_EQ(info.Dimensions, std::vector<uint32_t>({ 4 }));
+    ASSERT_EQ(info.RowsFilled, 4);
+}
+
+TEST_F(TreeFixture, ReadWindow)
+{
+    Tree tree(TREE_NAME, SHOT, Mode::Normal);
+
+    auto node = tree.getNode("RECORD:SIG");
+    node.makeSegment(0.0, 0.3, Range(0.0, 0.3, 0.1), Float64Array({ 0, 1, 2, 3 }));
+    node.makeSegment(0.4, 0.7, Range(0.4, 0.7, 0.1), Float64Array({ 4, 5, 6, 7 }));
+    node.makeSegment(0.8, 1.1, Range(0.8, 1.1, 0.1), Float64Array({ 8, 9, 10, 11 }));
+
+    auto [values, times] = node.readWindow<Float64Array>(0.35, 0.85);
+    ASSERT_EQ(values, std::vector<double>({ 4, 5, 6, 7, 8 }));
+    ASSERT_EQ(times.size(), 5);
+    ASSERT_DOUBLE_EQ(times.front(), 0.4);
+    ASSERT_DOUBLE_EQ(times.back(), 0.8);
+
+    auto [empty, emptyTimes] = node.readWindow<Float64Array>(2.0, 3.0);
+    ASSERT_TRUE(empty.empty());
+
+    // Segments added after the index was cached are found
+    node.makeSegment(1.2, 1.5, Range(1.2, 1.5, 0.1), Float64Array({ 12, 13, 14, 15 }));
+
+    auto [added, addedTimes] = node.readWindow<Float64Array>(1.05, 1.25);
+    ASSERT_EQ(added, std::vector<double>({ 11, 12 }));
+
+    // As are segments written through another Tree in the same process
+    Tree(TREE_NAME, SHOT, Mode::Normal).getNode("RECORD:SIG").makeSegment(
+        1.6, 1.9, Range(1.6, 1.9, 0.1), Float64Array({ 16, 17, 18, 19 })
+    );
+
+    auto [other, otherTimes] = node.readWindow<Float64Array>(1.55, 1.65);
+    ASSERT_EQ(other, std::vector<double>({ 16 }));
+}
+
+TEST_F(TreeFixture, SegmentWriter)
+{
+    Tree tree(TREE_NAME, SHOT, Mode::Normal);
+
+    auto node = tree.getNode("RECORD:SIG");
+
+    {
+        SegmentWriter<int32_t> writer(node, 4, 2);
+        for (int32_t i = 0; i < 10; ++i) {
+            ASSERT_TRUE(writer.putRow(i, 1000 + i));
+        }
+
+        writer.flush();
+        ASSERT_EQ(writer.getSegmentCount(), 3);
+        ASSERT_EQ(writer.getPendingSegmentCount(), 0);
+        ASSERT_EQ(writer.getDroppedRowCount(), 0);
+    }
+
+    ASSERT_EQ(node.getNumSegments(), 3);
+
+    auto [values, timestamps] = node.getSegment<Int32Array, Int64Array>(1);
+    ASSERT_EQ(values.getValues(), std::vector<int32_t>({ 4, 5, 6, 7 }));
+    ASSERT_EQ(timestamps.getValues(), std::vector<int64_t>({ 1004, 1005, 1006, 1007 }));
+
+    auto other = tree.getNode("A");
+
+    {
+        // Rows of 2 values sampled every 0.5
+        SegmentWriter<double> writer(other, 0.0, 0.5, 3, 4, { 2 });
+        for (int i = 0; i < 6; ++i) {
+            writer.putRow(std::vector<double>({ double(i), double(-i) }));
+        }
+
+        // A single value is not a whole row
+        ASSERT_THROW(writer.putRow(42.0), MDSplusException);
+    }
+
+    ASSERT_EQ(other.getNumSegments(), 2);
+
+    auto [window, times] = other.readWindow<Float64Array>(1.0, 1.5);
+    ASSERT_EQ(window, std::vector<double>({ 2, -2, 3, -3 }));
+    ASSERT_EQ(times, std::vector<double>({ 1.0, 1.5 }));
+}
+
+TEST_F(TreeFixture, MultiChannelWriter)
+{
+    Tree tree(TREE_NAME, SHOT, Mode::Normal);
+
+    MultiChannelWriter writer({ tree.getNode("A"), tree.getNode("RECORD:SIG") });
+
+    // 2 channels x 3 samples
+    std::vector<float> block = { 1, 2, 3, -1, -2, -3 };
+    writer.makeSegment(0.0, 0.2, Range(0.0, 0.2, 0.1), block);
+
+    writer.setThreadCount(2);
+    block = { 4, 5, 6, -4, -5, -6 };
+    writer.makeSegment(0.3, 0.5, Range(0.3, 0.5, 0.1), block);
+
+    ASSERT_THROW(writer.makeSegment(0.6, 0.8, Range(0.6, 0.8, 0.1), std::vector<float>(5)), MDSplusException);
+
+    for (const auto& [path, sign] : { std::pair{ "A", 1.0f }, std::pair{ "RECORD:SIG", -1.0f } }) {
+        auto node = tree.getNode(path);
+        ASSERT_EQ(node.getNumSegments(), 2);
+
+        auto [first, firstDimension] = node.getSegment<Float32Array>(0);
+        ASSERT_EQ(first.getValues(), std::vector<float>({ sign * 1, sign * 2, sign * 3 }));
+
+        auto [second, secondDimension] = node.getSegment<Float32Array>(1);
+        ASSERT_EQ(second.getValues(), std::vector<float>({ sign * 4, sign * 5, sign * 6 }));
+    }
+}
+
+TEST(Tree, Decimate)
+{
+    std::vector<int16_t> values(21);
+    for (size_t i = 0; i < values.size(); ++i) {
+        values[i] = int16_t((i % 2 == 0) ? i : -int(i));
+    }
+
+    // 2 full groups of 10, and a last group of 1
+    auto decimated = decimate(values.data(), values.size(), 10);
+    ASSERT_EQ(decimated.Min, std::vector<int16_t>({ -9, -19, 20 }));
+    ASSERT_EQ(decimated.Max, std::vector<int16_t>({ 8, 18, 20 }));
+    ASSERT_EQ(decimated.Mean, std::vector<double>({ -0.5, -0.5, 20.0 }));
+
+    ASSERT_TRUE(decimate(values.data(), 0, 10).Min.empty());
+}
+
+TEST_F(TreeFixture, MakeSegmentDecimated)
+{
+    Tree tree(TREE_NAME, SHOT, Mode::Normal);
+
+    auto node = tree.getNode("A");
+    auto minNode = tree.getNode("RECORD:SIG");
+
+    std::vector<float> values = { 3, 1, 4, 1, 5, 9, 2, 6 };
+    node.makeSegmentDecimated(0.0, 0.5, values, 4, minNode, TreeNode());
+
+    auto [full, fullDimension] = node.getSegment<Float32Array>(0);
+    ASSERT_EQ(full.getValues(), values);
+
+    auto [min, minDimension] = minNode.getSegment<Float32Array>(0);
+    ASSERT_EQ(min.getValues(), std::vector<float>({ 1, 2 }));
+
+    // The groups are { 3, 1, 4, 1 } and { 5, 9, 2, 6 }
+    auto decimated = decimate(values.data(), values.size(), 4);
+    ASSERT_EQ(decimated.Min, min.getValues());
+    ASSERT_EQ(decimated.Max, std::vector<float>({ 4, 9 }));
+    ASSERT_EQ(decimated.Mean, std::vector<double>({ 2.25, 5.5 }));
+
+    auto [window, times] = minNode.readWindow<Float32Array>(0.0, 2.0);
+    ASSERT_EQ(times, std::vector<double>({ 0.0, 2.0 }));
+
+    ASSERT_THROW(node.makeSegmentDecimated(4.0, 0.5, values, 0, minNode, TreeNode()), MDSplusException);
+}
+
+TEST_F(TreeFixture, MakeSegmentWithDims)
+{
+    Tree tree(TREE_NAME, SHOT, Mode::Normal);
+
+    auto node = tree.getNode("A");
+
+    // 2 frames of 3 x 2 pixels, written without copying into an Array first
+    std::vector<uint16_t> frames = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12 };
+    node.makeSegment(0.0, 1.0, Range(0.0, 1.0, 1.0), DataView(frames.data(), { 3, 2, 2 }));
+
+    auto info = node.getSegmentInfo(0);
+    ASSERT_EQ(info.Dimensions, std::vector<uint32_t>({ 3, 2, 2 }));
+    ASSERT_EQ(info.RowsFilled, 2);
+
+    auto [values, dimension] = node.getSegment<UInt16Array>(0);
+    ASSERT_EQ(values.getDimensions(), std::vector<uint32_t>({ 3, 2, 2 }));
+    ASSERT_EQ(values.getValues(), frames);
+
+#ifdef __cpp_lib_span
+    std::span<const uint16_t> frame(frames.data(), 6);
+    node.makeSegment(2.0, 2.0, Range(2.0, 2.0, 1.0), DataView(frame, { 3, 2, 1 }));
+    ASSERT_EQ(node.getNumSegments(), 2);
+
+    ASSERT_THROW(DataView(frame, { 3, 3, 1 }), MDSplusException);
+#endif
+}
+
+TEST_F(TreeFixture, MakeSegmentResampled)
+{
+    Tree tree(TREE_NAME, SHOT, Mode::Normal);
+
+    auto node = tree.getNode("A");
+    auto resampleNode = tree.getNode("RECORD:SIG");
+
+    // Room for 4 rows, with only the first 3 filled
+    node.makeSegmentResampled(0.0, 0.3, Range(0.0, 0.3, 0.1), Float32Array({ 1, 2, 3, 0 }), resampleNode, 2, -1, 3);
+
+    auto info = node.getSegmentInfo(0);
+    ASSERT_EQ(info.Dimensions, std::vector<uint32_t>({ 4 }));
+    ASSERT_EQ(info.RowsFilled, 3);
+
+    ASSERT_THROW(
+        node.makeSegmentResampled(0.4, 0.7, Range(0.4, 0.7, 0.1), Float32Array({ 1, 2, 3, 4 }), resampleNode, 2, -1, 5),
+        MDSplusException
+    );
+}
+
+TEST_F(TreeFixture, PartiallyFilledSegment)
+{
+    Tree tree(TREE_NAME, SHOT, Mode::Normal);
+
+    auto node = tree.getNode("A");
+
+    {
+        // Frames of 2 x 2, 3 frames per segment, so the second segment is left partially filled
+        SegmentWriter<int16_t> writer(node, 3, 2, { 2, 2 });
+        for (int16_t i = 0; i < 4; ++i) {
+            writer.putRow(std::vector<int16_t>({ i, i, i, i }), 100 + i);
+        }
+    }
+
+    ASSERT_EQ(node.getNumSegments(), 2);
+
+    auto first = node.getSegmentInfo(0);
+    ASSERT_EQ(first.Dimensions, std::vector<uint32_t>({ 2, 2, 3 }));
+    ASSERT_EQ(first.RowsFilled, 3);
+
+    auto last = node.getSegmentInfo(1);
+    ASSERT_EQ(last.Dimensions, std::vector<uint32_t>({ 2, 2, 3 }));
+    ASSERT_EQ(last.RowsFilled, 1);
+
+    auto [values, timestamps] = node.getSegment<Int16Array, Int64Array>(1);
+    ASSERT_EQ(values.getDimensions(), std::vector<uint32_t>({ 2, 2, 1 }));
+    ASSERT_EQ(values.getValues(), std::vector<int16_t>({ 3, 3, 3, 3 }));
+    ASSERT_EQ(timestamps.getValues(), std::vector<int64_t>({ 103 }));
+
+    // There are only 3 rows to fill
+    std::vector<int16_t> frames(12);
+    std::vector<int64_t> times = { 200, 201, 202 };
+    ASSERT_THROW(
+        node.makeTimestampedSegment(times.data(), DataView(frames.data(), { 2, 2, 3 }), -1, 4),
+        MDSplusException
+    );
+}
+
+TEST_F(TreeFixture, BeginSegment)
+{
+    Tree tree(TREE_NAME, SHOT, Mode::Normal);
+
+    auto node = tree.getNode("A");
+
+    // Allocate 6 rows up front, and fill them 3 at a time
+    node.allocateSegment<float>(0.0, 0.5, Range(0.0, 0.5, 0.1), 6);
+    ASSERT_EQ(node.getSegmentInfo(0).RowsFilled, 0);
+
+    node.putSegment(std::vector<float>({ 1, 2, 3 }));
+    ASSERT_EQ(node.getSegmentInfo(0).RowsFilled, 3);
+
+    node.putSegment(std::vector<float>({ 4, 5, 6 }));
+    node.updateSegment(1.0, 1.5, Range(1.0, 1.5, 0.1));
+
+    auto [values, dimension] = node.getSegment<Float32Array>(0);
+    ASSERT_EQ(values.getValues(), std::vector<float>({ 1, 2, 3, 4, 5, 6 }));
+
+    auto [start, end] = node.getSegmentLimits<Float64, Float64>(0);
+    ASSERT_EQ(start.getValue(), 1.0);
+    ASSERT_EQ(end.getValue(), 1.5);
+
+    auto other = tree.getNode("RECORD:SIG");
+
+    // Frames of 2 values
+    other.allocateTimestampedSegment<int32_t>(4, { 2 });
+    std::vector<int32_t> rows = { 1, 2, 3, 4 };
+    other.putTimestampedSegment(std::vector<int64_t>({ 10, 11 }), DataView(rows.data(), { 2, 2 }));
+
+    auto [frames, timestamps] = other.getSegment<Int32Array, Int64Array>(0);
+    ASSERT_EQ(frames.getValues(), std::vector<int32_t>({ 1, 2, 3, 4 }));
+    ASSERT_EQ(timestamps.getValues(), std::vector<int64_t>({ 10, 11 }));
+}
+
+TEST_F(TreeFixture, CompressedMultiChannelWriter)
+{
+    Tree tree(TREE_NAME, SHOT, Mode::Normal);
+
+    MultiChannelWriter writer({ tree.getNode("A"), tree.getNode("RECORD:SIG") });
+    writer.setThreadCount(2);
+    writer.setCompressionEnabled(true);
+    writer.setCompressionMethod(1, CompressionMethod::Standard);
+
+    // 2 channels x 1000 samples of a slow ramp, which compresses well
+    std::vector<int32_t> block(2000);
+    for (size_t i = 0; i < block.size(); ++i) {
+        block[i] = int32_t(i / 10);
+    }
+    writer.makeSegment(0, 999, Range(0, 999, 1), block);
+
+    auto stats = writer.getCompressionStats();
+    ASSERT_EQ(stats.Segments, 2);
+    ASSERT_EQ(stats.InputBytes, block.size() * sizeof(int32_t));
+    ASSERT_GT(stats.getRatio(), 1.0);
+
+    for (size_t channel = 0; channel < 2; ++channel) {
+        auto node = writer.getChannels()[channel];
+        ASSERT_EQ(node.getSegmentInfo(0).RowsFilled, 1000);
+
+        auto [values, dimension] = node.getSegment<Int32Array>(0);
+        ASSERT_EQ(values.getValues(), std::vector<int32_t>(block.begin() + channel * 1000, block.begin() + (channel + 1) * 1000));
+    }
+
+    writer.resetCompressionStats();
+    ASSERT_EQ(writer.getCompressionStats().Segments, 0);
+}
+
+TEST_F(TreeFixture, SegmentReader)
+{
+    Tree tree(TREE_NAME, SHOT, Mode::Normal);
+
+    auto node = tree.getNode("A");
+    for (int i = 0; i < 5; ++i) {
+        std::vector<int32_t> values = { i, i + 1 };
+        node.makeSegment(2 * i, 2 * i + 1, Range(2 * i, 2 * i + 1, 1), values);
+    }
+
+    for (size_t prefetch : { 0, 2 }) {
+        SegmentReader<Int32Array, Int32Array> reader(node, prefetch, 1);
+        ASSERT_EQ(reader.getLast(), 4);
+
+        SegmentData<Int32Array, Int32Array> segment;
+        for (int i = 1; i <= 4; ++i) {
+            ASSERT_TRUE(reader.next(segment));
+            ASSERT_EQ(segment.Index, i);
+            ASSERT_EQ(segment.Values.getValues(), std::vector<int32_t>({ i, i + 1 }));
+            ASSERT_EQ(segment.Dimension.getValues(), std::vector<int32_t>({ 2 * i, 2 * i + 1 }));
+        }
+        ASSERT_FALSE(reader.next(segment));
+    }
+}
+
 int main(int argc, char * argv[])
 {
     ::testing::InitGoogleTest(&argc, argv);